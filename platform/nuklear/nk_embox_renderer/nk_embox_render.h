@@ -431,6 +431,8 @@ static inline void draw(struct fb_info *fb, struct nk_context *ctx, int width, i
 
 	const struct nk_command *cmd;
 
+	fb_update_begin(fb);
+
 	/* iterate over and execute each draw command */
 	nk_foreach(cmd, ctx)
 	{
@@ -577,6 +579,8 @@ static inline void draw(struct fb_info *fb, struct nk_context *ctx, int width, i
 	}
 	nk_clear(ctx);
 
+	fb_update_end(fb);
+
 	/* delay for remove flickering */
 	for (int i = 0; i < 100000000000; i++) {
 	}
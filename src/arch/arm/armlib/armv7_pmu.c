@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief ARMv7-A performance monitors extension (PMUv1/PMUv2)
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <hal/pmu.h>
+
+#include <embox/unit.h>
+#include <framework/mod/options.h>
+
+#define PMU_IRQ_ROUTED    OPTION_GET(BOOLEAN, irq_routed)
+#define PMU_IRQ_NR        OPTION_GET(NUMBER, irq_nr)
+
+#define PMCR_E            (1 << 0)
+#define PMCR_P            (1 << 1)
+#define PMCR_N_SHIFT      11
+#define PMCR_N_MASK       0x1F
+
+static const uint32_t armv7_pmu_events[PMU_EV_TOTAL] = {
+	[PMU_EV_CYCLES]        = 0x11, /* CPU_CYCLES */
+	[PMU_EV_INSTRUCTIONS]  = 0x08, /* INST_RETIRED */
+	[PMU_EV_CACHE_MISSES]  = 0x03, /* L1D_CACHE_REFILL */
+	[PMU_EV_BRANCH_MISSES] = 0x10, /* BR_MIS_PRED */
+};
+
+static int pmu_counters;
+
+EMBOX_UNIT_INIT(armv7_pmu_init);
+
+static inline uint32_t pmcr_read(void) {
+	uint32_t val;
+	__asm__ __volatile__("mrc p15, 0, %0, c9, c12, 0" : "=r" (val));
+	return val;
+}
+
+static inline void pmcr_write(uint32_t val) {
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 0" : : "r" (val));
+}
+
+static inline void pmselr_write(uint32_t cnt) {
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 5" : : "r" (cnt));
+	__asm__ __volatile__("isb");
+}
+
+int pmu_counters_total(void) {
+	return pmu_counters;
+}
+
+int pmu_counter_setup(int cnt, enum pmu_event ev, int irq_on_overflow) {
+	uint32_t mask;
+
+	if (cnt < 0 || cnt >= pmu_counters || ev >= PMU_EV_TOTAL) {
+		return -EINVAL;
+	}
+
+	mask = 1 << cnt;
+
+	/* PMCNTENCLR */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 2" : : "r" (mask));
+
+	pmselr_write(cnt);
+	/* PMXEVTYPER */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c13, 1"
+			: : "r" (armv7_pmu_events[ev]));
+	/* PMXEVCNTR */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c13, 2" : : "r" (0));
+
+	if (irq_on_overflow) {
+		/* PMINTENSET */
+		__asm__ __volatile__("mcr p15, 0, %0, c9, c14, 1" : : "r" (mask));
+	} else {
+		/* PMINTENCLR */
+		__asm__ __volatile__("mcr p15, 0, %0, c9, c14, 2" : : "r" (mask));
+	}
+
+	return 0;
+}
+
+void pmu_counter_enable(int cnt) {
+	/* PMCNTENSET */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 1" : : "r" (1 << cnt));
+}
+
+void pmu_counter_disable(int cnt) {
+	/* PMCNTENCLR */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 2" : : "r" (1 << cnt));
+}
+
+uint64_t pmu_counter_read(int cnt) {
+	uint32_t val;
+
+	pmselr_write(cnt);
+	/* PMXEVCNTR */
+	__asm__ __volatile__("mrc p15, 0, %0, c9, c13, 2" : "=r" (val));
+
+	return val;
+}
+
+void pmu_counter_write(int cnt, uint64_t val) {
+	pmselr_write(cnt);
+	/* PMXEVCNTR, counters are 32 bits wide */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c13, 2"
+			: : "r" ((uint32_t) val));
+}
+
+unsigned int pmu_overflow_status(void) {
+	uint32_t val;
+
+	/* PMOVSR */
+	__asm__ __volatile__("mrc p15, 0, %0, c9, c12, 3" : "=r" (val));
+
+	return val & ((1 << pmu_counters) - 1);
+}
+
+void pmu_overflow_clear(unsigned int mask) {
+	/* PMOVSR is write-one-to-clear */
+	__asm__ __volatile__("mcr p15, 0, %0, c9, c12, 3" : : "r" (mask));
+}
+
+int pmu_irq_nr(void) {
+	return PMU_IRQ_ROUTED ? PMU_IRQ_NR : -1;
+}
+
+static int armv7_pmu_init(void) {
+	pmu_counters = (pmcr_read() >> PMCR_N_SHIFT) & PMCR_N_MASK;
+
+	/* Reset event counters and enable the unit, individual counters
+	 * stay disabled until pmu_counter_enable() */
+	pmcr_write(pmcr_read() | PMCR_E | PMCR_P);
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief ARM #memcpy() moving 32 bytes per LDM/STM pair.
+ * @details The destination is aligned first. If the source is aligned the
+ *     same way, blocks of eight words are moved by multiple load/store
+ *     instructions, otherwise each word is merged from two aligned loads,
+ *     since unaligned loads are not supported before ARMv6. Copying is always
+ *     forward, #memmove() relies on it.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define WORD_SZ   4
+#define BLOCK_SZ  (WORD_SZ * 8)
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define merge(cur, next, sh) (((cur) >> (sh)) | ((next) << (32 - (sh))))
+#else
+# define merge(cur, next, sh) (((cur) << (sh)) | ((next) >> (32 - (sh))))
+#endif
+
+static void memcpy_blocks(void *dst, const void *src, size_t blocks) {
+	__asm__ __volatile__(
+		"1:\n\t"
+		"ldmia %1!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		"subs  %2, %2, #1\n\t"
+		"stmia %0!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		"bne   1b"
+		: "+r"(dst), "+r"(src), "+r"(blocks)
+		:
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc", "memory");
+}
+
+/* Only aligned words are read from SRC, the last one may contain bytes past
+ * the end of SRC, but it never crosses a page boundary. */
+static void memcpy_shifted(uint32_t *dst, const char *src, size_t words) {
+	unsigned int sh = ((uintptr_t) src & (WORD_SZ - 1)) * 8;
+	const uint32_t *s = (const uint32_t *) (src - sh / 8);
+	uint32_t cur, next;
+
+	cur = *s++;
+	for (; words; words--) {
+		next = *s++;
+		*dst++ = merge(cur, next, sh);
+		cur = next;
+	}
+}
+
+void *memcpy(void *dst_, const void *src_, size_t n) {
+	char *dst = dst_;
+	const char *src = src_;
+	uint32_t *wdst;
+	const uint32_t *wsrc;
+
+	if (n < WORD_SZ * 4) {
+		goto bytes;
+	}
+
+	for (; (uintptr_t) dst & (WORD_SZ - 1); n--) {
+		*dst++ = *src++;
+	}
+
+	if ((uintptr_t) src & (WORD_SZ - 1)) {
+		memcpy_shifted((uint32_t *) dst, src, n / WORD_SZ);
+		dst += n & ~(WORD_SZ - 1);
+		src += n & ~(WORD_SZ - 1);
+		n &= WORD_SZ - 1;
+		goto bytes;
+	}
+
+	if (n >= BLOCK_SZ) {
+		memcpy_blocks(dst, src, n / BLOCK_SZ);
+		dst += n & ~(BLOCK_SZ - 1);
+		src += n & ~(BLOCK_SZ - 1);
+		n &= BLOCK_SZ - 1;
+	}
+
+	wdst = (uint32_t *) dst;
+	wsrc = (const uint32_t *) src;
+	for (; n >= WORD_SZ; n -= WORD_SZ) {
+		*wdst++ = *wsrc++;
+	}
+	dst = (char *) wdst;
+	src = (const char *) wsrc;
+
+bytes:
+	while (n--) {
+		*dst++ = *src++;
+	}
+
+	return dst_;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief ARM #memmove().
+ * @details Overlapping blocks with the destination above the source are
+ *     copied backward, by LDMDB/STMDB if both are aligned the same way.
+ *     Others are copied by #memcpy().
+ *
+ * @date 17.10.2026
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define WORD_SZ   4
+#define BLOCK_SZ  (WORD_SZ * 8)
+
+static void memmove_blocks_back(void *dst_end, const void *src_end,
+		size_t blocks) {
+	__asm__ __volatile__(
+		"1:\n\t"
+		"ldmdb %1!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		"subs  %2, %2, #1\n\t"
+		"stmdb %0!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+		"bne   1b"
+		: "+r"(dst_end), "+r"(src_end), "+r"(blocks)
+		:
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "cc", "memory");
+}
+
+void *memmove(void *dst_, const void *src_, size_t n) {
+	char *dst = dst_;
+	const char *src = src_;
+
+	if (!(src < dst && dst < src + n)) {
+		return memcpy(dst_, src_, n);
+	}
+
+	src += n;
+	dst += n;
+
+	if ((((uintptr_t) src ^ (uintptr_t) dst) & (WORD_SZ - 1)) == 0) {
+		for (; n && ((uintptr_t) dst & (WORD_SZ - 1)); n--) {
+			*--dst = *--src;
+		}
+		if (n >= BLOCK_SZ) {
+			memmove_blocks_back(dst, src, n / BLOCK_SZ);
+			dst -= n & ~(BLOCK_SZ - 1);
+			src -= n & ~(BLOCK_SZ - 1);
+			n &= BLOCK_SZ - 1;
+		}
+	}
+
+	while (n--) {
+		*--dst = *--src;
+	}
+
+	return dst_;
+}
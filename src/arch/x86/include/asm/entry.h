@@ -31,9 +31,12 @@
 	pushl   %ecx;    \
 	pushl   %ebx;
 
+/* The ABI expects DF clear, while the interrupted code may have it set
+ * (e.g. backward memmove). iret restores it */
 #define SAVE_ALL     \
 	SAVE_ALL_REGS \
-	SETUP_SEGMENTS;
+	SETUP_SEGMENTS; \
+	cld;
 
 #define RESTORE_ALL_REGS \
 	pop   %ebx;      \
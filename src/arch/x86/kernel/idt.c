@@ -109,6 +109,15 @@ static void idt_init_irq(void) {
 	/* Slave PIC */
 	IDT_IRQ(8);  IDT_IRQ(9);  IDT_IRQ(10); IDT_IRQ(11);
 	IDT_IRQ(12); IDT_IRQ(13); IDT_IRQ(14); IDT_IRQ(15);
+	/* I/O APIC pins and MSI */
+	IDT_IRQ(16); IDT_IRQ(17); IDT_IRQ(18); IDT_IRQ(19);
+	IDT_IRQ(20); IDT_IRQ(21); IDT_IRQ(22); IDT_IRQ(23);
+	IDT_IRQ(24); IDT_IRQ(25); IDT_IRQ(26); IDT_IRQ(27);
+	IDT_IRQ(28); IDT_IRQ(29); IDT_IRQ(30); IDT_IRQ(31);
+	IDT_IRQ(32); IDT_IRQ(33); IDT_IRQ(34); IDT_IRQ(35);
+	IDT_IRQ(36); IDT_IRQ(37); IDT_IRQ(38); IDT_IRQ(39);
+	IDT_IRQ(40); IDT_IRQ(41); IDT_IRQ(42); IDT_IRQ(43);
+	IDT_IRQ(44); IDT_IRQ(45); IDT_IRQ(46); IDT_IRQ(47);
 }
 
 #else
@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Intel architectural performance monitoring (CPUID leaf 0xA)
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <asm/msr.h>
+#include <hal/pmu.h>
+
+#include <embox/unit.h>
+#include <framework/mod/options.h>
+
+#include <module/embox/driver/interrupt/lapic.h>
+
+#define PMU_IRQ_ROUTED    OPTION_GET(BOOLEAN, irq_routed)
+#define PMU_IRQ_NR        OPTION_GET(NUMBER, irq_nr)
+
+#define IA32_PMC0             0xC1
+#define IA32_PERFEVTSEL0      0x186
+#define IA32_PERF_GLOBAL_STATUS   0x38E
+#define IA32_PERF_GLOBAL_CTRL     0x38F
+#define IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR    (1 << 16)
+#define PERFEVTSEL_OS     (1 << 17)
+#define PERFEVTSEL_INT    (1 << 20)
+#define PERFEVTSEL_EN     (1 << 22)
+
+#define LAPIC_LVT_MASKED  (1 << 16)
+
+/* Event select and unit mask of architectural events, indexed by
+ * enum pmu_event. Bit of CPUID.0AH:EBX reporting event unavailability
+ * goes along. */
+static const struct {
+	uint8_t evsel;
+	uint8_t umask;
+	uint8_t ebx_bit;
+} x86_pmu_events[PMU_EV_TOTAL] = {
+	[PMU_EV_CYCLES]        = { 0x3C, 0x00, 0 },
+	[PMU_EV_INSTRUCTIONS]  = { 0xC0, 0x00, 1 },
+	[PMU_EV_CACHE_MISSES]  = { 0x2E, 0x41, 4 },
+	[PMU_EV_BRANCH_MISSES] = { 0xC5, 0x00, 6 },
+};
+
+static int pmu_version;
+static int pmu_counters;
+static uint32_t pmu_unavail_events;
+
+EMBOX_UNIT_INIT(x86_pmu_init);
+
+static inline void x86_cpuid(uint32_t leaf, uint32_t *a, uint32_t *b,
+		uint32_t *c, uint32_t *d) {
+	__asm__ __volatile__("cpuid"
+			: "=a"(*a), "=b"(*b), "=c"(*c), "=d"(*d)
+			: "a"(leaf), "c"(0));
+}
+
+static inline uint64_t x86_msr_read64(uint32_t msr) {
+	uint32_t lo, hi;
+
+	ia32_msr_read(msr, &lo, &hi);
+	return ((uint64_t) hi << 32) | lo;
+}
+
+static inline void x86_msr_write64(uint32_t msr, uint64_t val) {
+	ia32_msr_write(msr, (uint32_t) val, (uint32_t) (val >> 32));
+}
+
+int pmu_counters_total(void) {
+	return pmu_counters;
+}
+
+int pmu_counter_setup(int cnt, enum pmu_event ev, int irq_on_overflow) {
+	uint32_t evtsel;
+
+	if (cnt < 0 || cnt >= pmu_counters || ev >= PMU_EV_TOTAL) {
+		return -EINVAL;
+	}
+
+	if (pmu_unavail_events & (1 << x86_pmu_events[ev].ebx_bit)) {
+		return -ENOTSUP;
+	}
+
+	evtsel = x86_pmu_events[ev].evsel
+		| (x86_pmu_events[ev].umask << 8)
+		| PERFEVTSEL_USR | PERFEVTSEL_OS;
+
+	if (irq_on_overflow) {
+		if (!PMU_IRQ_ROUTED) {
+			return -ENOTSUP;
+		}
+		evtsel |= PERFEVTSEL_INT;
+		lapic_write(LAPIC_LVT_PCR, PMU_IRQ_NR + 0x20);
+	}
+
+	ia32_msr_write(IA32_PERFEVTSEL0 + cnt, evtsel, 0);
+	ia32_msr_write(IA32_PMC0 + cnt, 0, 0);
+
+	return 0;
+}
+
+void pmu_counter_enable(int cnt) {
+	uint32_t lo, hi;
+
+	ia32_msr_read(IA32_PERFEVTSEL0 + cnt, &lo, &hi);
+	ia32_msr_write(IA32_PERFEVTSEL0 + cnt, lo | PERFEVTSEL_EN, hi);
+}
+
+void pmu_counter_disable(int cnt) {
+	uint32_t lo, hi;
+
+	ia32_msr_read(IA32_PERFEVTSEL0 + cnt, &lo, &hi);
+	ia32_msr_write(IA32_PERFEVTSEL0 + cnt, lo & ~PERFEVTSEL_EN, hi);
+}
+
+uint64_t pmu_counter_read(int cnt) {
+	return x86_msr_read64(IA32_PMC0 + cnt);
+}
+
+void pmu_counter_write(int cnt, uint64_t val) {
+	/* Only low 32 bits are written, sign-extended to counter width.
+	 * This is exactly what overflow sampling with -period needs. */
+	x86_msr_write64(IA32_PMC0 + cnt, val);
+}
+
+unsigned int pmu_overflow_status(void) {
+	unsigned int mask = 0;
+	int i;
+
+	if (pmu_version >= 2) {
+		return (unsigned int) x86_msr_read64(IA32_PERF_GLOBAL_STATUS)
+			& ((1 << pmu_counters) - 1);
+	}
+
+	/* Version 1 has no status register, counter sign bit is the best
+	 * we can check. */
+	for (i = 0; i < pmu_counters; i++) {
+		if (!(pmu_counter_read(i) & 0x80000000)) {
+			mask |= 1 << i;
+		}
+	}
+
+	return mask;
+}
+
+void pmu_overflow_clear(unsigned int mask) {
+	if (pmu_version >= 2) {
+		x86_msr_write64(IA32_PERF_GLOBAL_OVF_CTRL, mask);
+	}
+
+	/* LVT entry is masked by hardware on each delivery */
+	if (PMU_IRQ_ROUTED) {
+		lapic_write(LAPIC_LVT_PCR,
+				lapic_read(LAPIC_LVT_PCR) & ~LAPIC_LVT_MASKED);
+	}
+}
+
+int pmu_irq_nr(void) {
+	return PMU_IRQ_ROUTED ? PMU_IRQ_NR : -1;
+}
+
+static int x86_pmu_init(void) {
+	uint32_t a, b, c, d;
+
+	x86_cpuid(0, &a, &b, &c, &d);
+	if (a < 0xA) {
+		return 0;
+	}
+
+	x86_cpuid(0xA, &a, &b, &c, &d);
+	pmu_version = a & 0xFF;
+	pmu_counters = (a >> 8) & 0xFF;
+	pmu_unavail_events = b;
+
+	if (pmu_version == 0) {
+		pmu_counters = 0;
+		return 0;
+	}
+
+	if (PMU_IRQ_ROUTED) {
+		lapic_write(LAPIC_LVT_PCR, LAPIC_LVT_MASKED | (PMU_IRQ_NR + 0x20));
+	}
+
+	if (pmu_version >= 2) {
+		/* Let per-counter enable bits alone decide */
+		x86_msr_write64(IA32_PERF_GLOBAL_CTRL, (1ULL << pmu_counters) - 1);
+	}
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief x86 #memcpy() on string instructions.
+ * @details Short copies are done in C, since @c rep has a startup cost of
+ *     tens of cycles. Others align the destination and copy double words with
+ *     @c rep @c movsl. CPUs with ERMS copy large blocks fastest by a single
+ *     @c rep @c movsb. Copying is always forward, #memmove() relies on it.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <framework/mod/options.h>
+
+#define X86_STR_ERMS           OPTION_GET(BOOLEAN, erms)
+#define X86_STR_ERMS_THRESHOLD OPTION_GET(NUMBER, erms_threshold)
+
+#define X86_STR_SMALL          16
+
+void *memcpy(void *dst, const void *src, size_t n) {
+	void *ret = dst;
+	size_t head;
+
+	if (n < X86_STR_SMALL) {
+		char *d = dst;
+		const char *s = src;
+
+		while (n--) {
+			*d++ = *s++;
+		}
+		return ret;
+	}
+
+	if (X86_STR_ERMS && n >= X86_STR_ERMS_THRESHOLD) {
+		__asm__ __volatile__(
+			"rep movsb"
+			: "+D"(dst), "+S"(src), "+c"(n)
+			:
+			: "memory");
+		return ret;
+	}
+
+	head = -(uintptr_t) dst & 3;
+	n -= head;
+
+	__asm__ __volatile__(
+		"rep movsb\n\t"
+		"movl %3, %%ecx\n\t"
+		"shrl $2, %%ecx\n\t"
+		"rep movsl\n\t"
+		"movl %3, %%ecx\n\t"
+		"andl $3, %%ecx\n\t"
+		"rep movsb"
+		: "+D"(dst), "+S"(src), "+c"(head)
+		: "r"(n)
+		: "memory");
+
+	return ret;
+}
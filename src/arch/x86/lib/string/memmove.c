@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @brief x86 #memmove() on string instructions.
+ * @details Overlapping blocks with the destination above the source are
+ *     copied backward with the direction flag set, others by #memcpy().
+ *     Trap entries (SAVE_ALL) clear the flag for handlers.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+void *memmove(void *dst, const void *src, size_t n) {
+	char *d = (char *) dst + n - 1;
+	const char *s = (const char *) src + n - 1;
+	size_t tail;
+
+	if (!((const char *) src < (char *) dst
+			&& (char *) dst < (const char *) src + n)) {
+		return memcpy(dst, src, n);
+	}
+
+	/* Bytes above the last whole double word, then double words */
+	tail = n & 3;
+
+	__asm__ __volatile__(
+		"std\n\t"
+		"rep movsb\n\t"
+		"subl $3, %%esi\n\t"
+		"subl $3, %%edi\n\t"
+		"movl %3, %%ecx\n\t"
+		"shrl $2, %%ecx\n\t"
+		"rep movsl\n\t"
+		"cld"
+		: "+D"(d), "+S"(s), "+c"(tail)
+		: "r"(n)
+		: "memory");
+
+	return dst;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @brief x86 #memset() on string instructions.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define X86_STR_SMALL 16
+
+void *memset(void *addr, int c, size_t n) {
+	void *ret = addr;
+	uint32_t val = (unsigned char) c * 0x01010101U;
+	size_t head;
+
+	if (n < X86_STR_SMALL) {
+		unsigned char *a = addr;
+
+		while (n--) {
+			*a++ = c;
+		}
+		return ret;
+	}
+
+	head = -(uintptr_t) addr & 3;
+	n -= head;
+
+	__asm__ __volatile__(
+		"rep stosb\n\t"
+		"movl %3, %%ecx\n\t"
+		"shrl $2, %%ecx\n\t"
+		"rep stosl\n\t"
+		"movl %3, %%ecx\n\t"
+		"andl $3, %%ecx\n\t"
+		"rep stosb"
+		: "+D"(addr), "+c"(head)
+		: "a"(val), "r"(n)
+		: "memory");
+
+	return ret;
+}
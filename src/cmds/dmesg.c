@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Prints the kernel log history
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <kernel/klog.h>
+
+static void print_usage(void) {
+	printf("Usage: dmesg [-h] [-f] [-s]\n");
+}
+
+int main(int argc, char **argv) {
+	char buf[128];
+	size_t pos = 0, len;
+	int opt;
+
+	getopt_init();
+
+	while (-1 != (opt = getopt(argc, argv, "hfs"))) {
+		switch (opt) {
+		case 'f':
+			klog_flush();
+			break;
+		case 's':
+			printf("%u messages dropped\n", klog_dropped());
+			return 0;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	while ((len = klog_history_read(buf, sizeof(buf), &pos))) {
+		fwrite(buf, 1, len, stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @brief Show per-IRQ statistics
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <kernel/irq.h>
+
+static void print_usage(void) {
+	printf("Usage: lsirq [-a] [-h]\n");
+}
+
+int main(int argc, char **argv) {
+	struct irq_stat stat;
+	const char *name;
+	unsigned int irq_nr;
+	int opt, all = 0;
+
+	while (-1 != (opt = getopt(argc, argv, "ah"))) {
+		switch (opt) {
+		case 'a':
+			all = 1;
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -1;
+		}
+	}
+
+	printf("%4s %10s %10s %12s %12s %s\n", "IRQ", "COUNT", "THREAD",
+			"MAX_NS", "MAX_THR_NS", "DEVICE");
+
+	for (irq_nr = 0; irq_nr < IRQ_NRS_TOTAL; irq_nr++) {
+		if (irq_get_stat(irq_nr, &stat) != 0) {
+			return 0;
+		}
+
+		name = irq_get_dev_name(irq_nr);
+		if (!name && !all) {
+			continue;
+		}
+
+		printf("%4u %10lu %10lu %12llu %12llu %s\n", irq_nr, stat.count,
+				stat.thread_count, (unsigned long long) stat.max_time,
+				(unsigned long long) stat.max_thread_time,
+				name ? name : "-");
+	}
+
+	return 0;
+}
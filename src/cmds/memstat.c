@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Reports statically reserved memory regions
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mem/mem_account.h>
+
+static void print_usage(void) {
+	printf("Usage: memstat [-h] [-m module]\n");
+}
+
+/* embox__net__skbuff -> embox.net.skbuff */
+static void owner_name(const char *mangled, char *buf, size_t size) {
+	size_t n = 0;
+
+	while (*mangled && n < size - 1) {
+		if (mangled[0] == '_' && mangled[1] == '_') {
+			buf[n++] = '.';
+			mangled += 2;
+		} else {
+			buf[n++] = *mangled++;
+		}
+	}
+	buf[n] = '\0';
+}
+
+int main(int argc, char **argv) {
+	const struct mem_account *acc;
+	struct mem_account_stat st;
+	const char *filter = NULL;
+	char owner[64];
+	size_t reserved = 0, idle = 0, region_idle;
+	int opt;
+
+	getopt_init();
+	while (-1 != (opt = getopt(argc, argv, "hm:"))) {
+		switch (opt) {
+		case 'm':
+			filter = optarg;
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	printf("%-32s %-24s %-9s %6s %6s %6s %6s %6s %9s %9s\n",
+			"module", "name", "type", "size", "total", "used", "max",
+			"fail", "reserved", "idle");
+
+	mem_account_foreach(acc) {
+		owner_name(acc->owner, owner, sizeof(owner));
+		if (filter && !strstr(owner, filter)) {
+			continue;
+		}
+
+		memset(&st, 0, sizeof(st));
+		acc->stat(acc->obj, &st);
+
+		printf("%-32s %-24s %-9s %6zu %6zu %6zu %6zu %6u %9zu",
+				owner, acc->name, acc->type, st.obj_size, st.total,
+				st.used, st.max_used, st.failed, st.reserved);
+
+		/* Defined only for regions storing objects in their slots. Chained hash
+		 * tables reserve only buckets, items are allocated by their users */
+		if (st.obj_size && st.total && st.max_used <= st.total) {
+			region_idle = st.obj_size * (st.total - st.max_used);
+			printf(" %9zu\n", region_idle);
+			idle += region_idle;
+		} else {
+			printf(" %9s\n", "-");
+		}
+
+		reserved += st.reserved;
+	}
+
+	printf("\nTotal reserved: %zu bytes, never used: %zu bytes\n",
+			reserved, idle);
+
+	return 0;
+}
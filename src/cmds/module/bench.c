@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief Runs benchmarks of Embox benchmark framework.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <framework/bench/api.h>
+
+static void print_usage(void) {
+	printf("Usage: bench [-h] [-l] [-a] [-w <warmup>] [-n <iterations>] "
+			"[name ...]\n");
+}
+
+static void print_benches(void) {
+	const struct bench *bench;
+	int i = 0;
+
+	bench_foreach(bench) {
+		printf("%3d. %-20s %s\n", ++i, bench->name, bench->description);
+	}
+	printf("\nTotal benchmarks: %d\n", i);
+}
+
+static int run_one(const struct bench *bench, const struct bench_opts *opts) {
+	struct bench_result res;
+	int ret;
+
+	ret = bench_run(bench, opts, &res);
+	if (ret != 0) {
+		printf("bench=%s error=%d\n", bench->name, ret);
+		return ret;
+	}
+
+	bench_report(bench, &res);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	const struct bench *bench;
+	struct bench_opts opts = {
+		.warmup = 10,
+		.iterations = 1000,
+	};
+	int all = 0, ret = 0;
+	int opt, i;
+
+	getopt_init();
+	while (-1 != (opt = getopt(argc, argv, "hlaw:n:"))) {
+		switch (opt) {
+		case 'l':
+			print_benches();
+			return 0;
+		case 'a':
+			all = 1;
+			break;
+		case 'w':
+			opts.warmup = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			opts.iterations = strtoul(optarg, NULL, 0);
+			if (opts.iterations == 0) {
+				printf("bench -n: positive number expected\n");
+				return -EINVAL;
+			}
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (all) {
+		bench_foreach(bench) {
+			ret = run_one(bench, &opts) ? : ret;
+		}
+		return ret;
+	}
+
+	if (optind >= argc) {
+		print_benches();
+		return 0;
+	}
+
+	for (i = optind; i < argc; i++) {
+		bench = bench_lookup(argv[i]);
+		if (!bench) {
+			printf("bench=%s error=%d\n", argv[i], -ENOENT);
+			ret = -ENOENT;
+			continue;
+		}
+		ret = run_one(bench, &opts) ? : ret;
+	}
+
+	return ret;
+}
@@ -139,6 +139,7 @@ int main(int argc, char **argv) {
 			continue;
 		}
 		assert(ci.ci_addrlen == inaddrlen);
+		ci.ci_stdin = -1;
 		ci.ci_basedir = basedir;
 
 		if (USE_PARALLEL_CGI) {
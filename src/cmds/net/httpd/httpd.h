@@ -27,6 +27,7 @@ struct client_info {
 	socklen_t ci_addrlen;
 	int ci_sock;
 	int ci_index;
+	int ci_stdin; /* request body for CGI, -1 to read it from ci_sock */
 
 	const char *ci_basedir;
 };
@@ -39,8 +40,10 @@ struct http_req_uri {
 struct http_req {
 	struct http_req_uri uri;
 	char *method;
+	char *version;
 	char *content_len;
 	char *content_type;
+	char *connection;
 };
 
 extern char *httpd_parse_request(char *str, struct http_req *hreq);
@@ -97,7 +97,12 @@ static pid_t httpd_response_cgi(const struct client_info *cinfo, const struct ht
 
 		httpd_fill_env(hreq, envp, ARRAY_SIZE(envp));
 
-		dup2(cinfo->ci_sock, STDIN_FILENO);
+		if (cinfo->ci_stdin != -1) {
+			dup2(cinfo->ci_stdin, STDIN_FILENO);
+			close(cinfo->ci_stdin);
+		} else {
+			dup2(cinfo->ci_sock, STDIN_FILENO);
+		}
 		dup2(cinfo->ci_sock, STDOUT_FILENO);
 		close(cinfo->ci_sock);
 
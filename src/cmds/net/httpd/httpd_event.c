@@ -0,0 +1,870 @@
+/**
+ * @file
+ * @brief Event-driven HTTP server with persistent connections
+ * @details One thread waits for all connections with poll(). Sockets are
+ *     non-blocking, so a slow client can't stall the others. When a
+ *     connection has a complete request header, it is passed to a fixed
+ *     pool of worker threads. A worker responds to all requests buffered
+ *     for the connection (pipelined ones as well) and gives the connection
+ *     back to the event loop, unless it should be closed. Idle connections
+ *     are closed after a timeout. A CGI request body is passed to the
+ *     script by the event loop as well, so a script which doesn't read it
+ *     holds neither a worker nor the loop.
+ *
+ *     Small static files are kept in memory together with their response
+ *     header. An entry is checked against the file size and modification
+ *     time on each request.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "httpd.h"
+
+#ifdef __EMBUILD_MOD__
+#	include <framework/mod/options.h>
+#	define USE_IP_VER              OPTION_GET(NUMBER,use_ip_ver)
+#	define USE_REAL_CMD            OPTION_GET(BOOLEAN,use_real_cmd)
+#	define HTTPD_MAX_CLIENTS       OPTION_GET(NUMBER,max_clients)
+#	define HTTPD_WORKERS           OPTION_GET(NUMBER,workers)
+#	define HTTPD_KEEPALIVE_TIMEOUT OPTION_GET(NUMBER,keepalive_timeout)
+#	define HTTPD_KEEPALIVE_MAX     OPTION_GET(NUMBER,keepalive_max)
+#	define HTTPD_CACHE_ENTRIES     OPTION_GET(NUMBER,cache_entries)
+#	define HTTPD_CACHE_FILE_MAX    OPTION_GET(NUMBER,cache_file_max)
+#endif /* __EMBUILD_MOD__ */
+
+#define BUFF_SZ     1024
+#define PAGE_INDEX  "index.html"
+
+enum httpd_conn_state {
+	HTTPD_CONN_FREE,
+	HTTPD_CONN_IDLE, /* waited by the event loop */
+	HTTPD_CONN_BUSY, /* queued or served by a worker */
+	HTTPD_CONN_RELAY, /* request body is passed to a script by the event loop */
+};
+
+struct httpd_conn {
+	struct client_info ci;
+	enum httpd_conn_state state;
+	time_t last_active;
+	int requests;
+	struct httpd_conn *next;
+
+	int relay_fd; /* script stdin, -1 if there is nothing to relay */
+	size_t relay_left;
+
+	size_t in_len;
+	char inbuf[BUFF_SZ];
+};
+
+struct httpd_cache_entry {
+	char path[HTTPD_MAX_PATH];
+	time_t mtime;
+	char *data;      /* response header followed by the file */
+	size_t hdr_len;  /* header up to the "Connection: " value */
+	size_t body_len;
+	unsigned int refs;
+	unsigned long used;
+	int stale;
+};
+
+struct httpd_worker_buf {
+	char req[BUFF_SZ + 1];
+	char out[BUFF_SZ];
+};
+
+static struct httpd_conn httpd_conns[HTTPD_MAX_CLIENTS];
+static struct httpd_conn *httpd_queue_head;
+static struct httpd_conn **httpd_queue_tail = &httpd_queue_head;
+static pthread_mutex_t httpd_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t httpd_queue_cond = PTHREAD_COND_INITIALIZER;
+static int httpd_wakeup[2];
+
+static struct httpd_worker_buf httpd_worker_bufs[HTTPD_WORKERS];
+
+static struct httpd_cache_entry httpd_cache[HTTPD_CACHE_ENTRIES];
+static unsigned long httpd_cache_clock;
+static pthread_mutex_t httpd_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *httpd_conn_token(int keep) {
+	return keep ? "keep-alive" : "close";
+}
+
+static int httpd_set_nonblock(int fd, int on) {
+	int flags;
+
+	flags = fcntl(fd, F_GETFL);
+	if (flags == -1) {
+		return -errno;
+	}
+
+	flags = on ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+	if (-1 == fcntl(fd, F_SETFL, flags)) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+/* Writes all @a len bytes, waiting for a non-blocking @a fd if needed */
+static int httpd_write_all(int fd, const char *buf, size_t len) {
+	struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+	ssize_t written;
+	int ret;
+
+	while (len) {
+		written = write(fd, buf, len);
+		if (written >= 0) {
+			buf += written;
+			len -= written;
+			continue;
+		}
+
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno != EAGAIN) {
+			return -errno;
+		}
+
+		ret = poll(&pfd, 1, HTTPD_KEEPALIVE_TIMEOUT * 1000);
+		if (ret == 0) {
+			return -ETIMEDOUT;
+		}
+		if (ret == -1 && errno != EINTR) {
+			return -errno;
+		}
+	}
+
+	return 0;
+}
+
+static int httpd_event_status(const struct httpd_conn *conn, int st,
+		const char *msg, int keep) {
+	char hdr[160];
+	int len;
+
+	len = snprintf(hdr, sizeof(hdr),
+			"HTTP/1.1 %d %s\r\n"
+			"Content-Type: %s\r\n"
+			"Content-Length: 0\r\n"
+			"Connection: %s\r\n"
+			"\r\n",
+			st, msg, "text/plain", httpd_conn_token(keep));
+
+	return httpd_write_all(conn->ci.ci_sock, hdr, len);
+}
+
+static int httpd_header_prefix(char *buf, size_t buf_sz, const char *path,
+		size_t len) {
+	return snprintf(buf, buf_sz,
+			"HTTP/1.1 %d %s\r\n"
+			"Content-Type: %s\r\n"
+			"Content-Length: %u\r\n"
+			"Connection: ",
+			200, "OK", httpd_filename2content_type(path), (unsigned) len);
+}
+
+static void httpd_cache_free(struct httpd_cache_entry *ce) {
+	free(ce->data);
+	ce->data = NULL;
+	ce->stale = 0;
+}
+
+/* Must be called with httpd_cache_lock held */
+static struct httpd_cache_entry *httpd_cache_find(const char *path,
+		const struct stat *st) {
+	struct httpd_cache_entry *ce;
+	int i;
+
+	for (i = 0; i < HTTPD_CACHE_ENTRIES; i++) {
+		ce = &httpd_cache[i];
+		if (!ce->data || ce->stale || strcmp(ce->path, path)) {
+			continue;
+		}
+
+		if (ce->mtime == st->st_mtime && ce->body_len == st->st_size) {
+			return ce;
+		}
+
+		/* The file was changed, drop the entry when it is not sent */
+		if (ce->refs) {
+			ce->stale = 1;
+		} else {
+			httpd_cache_free(ce);
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be called with httpd_cache_lock held */
+static struct httpd_cache_entry *httpd_cache_victim(void) {
+	struct httpd_cache_entry *ce, *victim = NULL;
+	int i;
+
+	for (i = 0; i < HTTPD_CACHE_ENTRIES; i++) {
+		ce = &httpd_cache[i];
+		if (!ce->data) {
+			return ce;
+		}
+		if (!ce->refs && (!victim || ce->used < victim->used)) {
+			victim = ce;
+		}
+	}
+
+	return victim;
+}
+
+static struct httpd_cache_entry *httpd_cache_load(const char *path,
+		const struct stat *st) {
+	struct httpd_cache_entry *ce;
+	char hdr[160];
+	char *data;
+	FILE *file;
+	int hdr_len;
+
+	hdr_len = httpd_header_prefix(hdr, sizeof(hdr), path, st->st_size);
+	if (hdr_len >= sizeof(hdr)) {
+		return NULL;
+	}
+
+	data = malloc(hdr_len + st->st_size);
+	if (!data) {
+		return NULL;
+	}
+	memcpy(data, hdr, hdr_len);
+
+	file = fopen(path, "r");
+	if (!file) {
+		free(data);
+		return NULL;
+	}
+	if (st->st_size != fread(data + hdr_len, 1, st->st_size, file)) {
+		fclose(file);
+		free(data);
+		return NULL;
+	}
+	fclose(file);
+
+	pthread_mutex_lock(&httpd_cache_lock);
+	ce = httpd_cache_find(path, st);
+	if (ce) {
+		/* Loaded by another worker meanwhile */
+		free(data);
+	} else if ((ce = httpd_cache_victim())) {
+		if (ce->data) {
+			httpd_cache_free(ce);
+		}
+		strcpy(ce->path, path);
+		ce->mtime = st->st_mtime;
+		ce->data = data;
+		ce->hdr_len = hdr_len;
+		ce->body_len = st->st_size;
+	} else {
+		/* All entries are being sent */
+		free(data);
+	}
+	if (ce) {
+		ce->refs++;
+		ce->used = ++httpd_cache_clock;
+	}
+	pthread_mutex_unlock(&httpd_cache_lock);
+
+	return ce;
+}
+
+static struct httpd_cache_entry *httpd_cache_get(const char *path,
+		const struct stat *st) {
+	struct httpd_cache_entry *ce;
+
+	if (st->st_size > HTTPD_CACHE_FILE_MAX) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&httpd_cache_lock);
+	ce = httpd_cache_find(path, st);
+	if (ce) {
+		ce->refs++;
+		ce->used = ++httpd_cache_clock;
+	}
+	pthread_mutex_unlock(&httpd_cache_lock);
+
+	if (!ce) {
+		ce = httpd_cache_load(path, st);
+	}
+
+	return ce;
+}
+
+static void httpd_cache_put(struct httpd_cache_entry *ce) {
+	pthread_mutex_lock(&httpd_cache_lock);
+	if (0 == --ce->refs && ce->stale) {
+		httpd_cache_free(ce);
+	}
+	pthread_mutex_unlock(&httpd_cache_lock);
+}
+
+static int httpd_send_cached(const struct httpd_conn *conn,
+		const struct httpd_cache_entry *ce, int keep, char *out) {
+	size_t len, body_part;
+	int ret;
+
+	/* Header and the file start go in one write */
+	memcpy(out, ce->data, ce->hdr_len);
+	len = ce->hdr_len;
+	len += sprintf(out + len, "%s\r\n\r\n", httpd_conn_token(keep));
+
+	body_part = BUFF_SZ - len;
+	if (body_part > ce->body_len) {
+		body_part = ce->body_len;
+	}
+	memcpy(out + len, ce->data + ce->hdr_len, body_part);
+
+	ret = httpd_write_all(conn->ci.ci_sock, out, len + body_part);
+	if (ret) {
+		return ret;
+	}
+
+	return httpd_write_all(conn->ci.ci_sock, ce->data + ce->hdr_len + body_part,
+			ce->body_len - body_part);
+}
+
+static int httpd_send_file(const struct httpd_conn *conn, const char *path,
+		const struct stat *st, int keep, char *out) {
+	size_t len, read_bytes, remain;
+	FILE *file;
+	int ret;
+
+	file = fopen(path, "r");
+	if (!file) {
+		return httpd_event_status(conn, 404, "Not Found", keep);
+	}
+
+	len = httpd_header_prefix(out, BUFF_SZ, path, st->st_size);
+	len += snprintf(out + len, BUFF_SZ - len, "%s\r\n\r\n",
+			httpd_conn_token(keep));
+
+	ret = httpd_write_all(conn->ci.ci_sock, out, len);
+
+	remain = st->st_size;
+	while (!ret && remain) {
+		read_bytes = fread(out, 1, BUFF_SZ, file);
+		if (read_bytes == 0 || read_bytes > remain) {
+			/* The file was changed, Content-Length is wrong already */
+			ret = -EIO;
+			break;
+		}
+		ret = httpd_write_all(conn->ci.ci_sock, out, read_bytes);
+		remain -= read_bytes;
+	}
+
+	fclose(file);
+	return ret;
+}
+
+static int httpd_event_respond_file(const struct httpd_conn *conn,
+		const struct http_req *hreq, int keep, char *out) {
+	struct httpd_cache_entry *ce;
+	char path[HTTPD_MAX_PATH];
+	const char *uri_path;
+	struct stat st;
+	int path_len, ret;
+
+	if (0 == strcmp(hreq->uri.target, "/")) {
+		uri_path = PAGE_INDEX;
+	} else {
+		uri_path = hreq->uri.target;
+	}
+
+	path_len = snprintf(path, sizeof(path), "%s/%s", conn->ci.ci_basedir, uri_path);
+	if (path_len >= sizeof(path)) {
+		return httpd_event_status(conn, 414, "URI Too Long", keep);
+	}
+
+	if (0 != stat(path, &st) || !S_ISREG(st.st_mode)) {
+		httpd_debug("file %s not found", path);
+		return httpd_event_status(conn, 404, "Not Found", keep);
+	}
+
+	ce = httpd_cache_get(path, &st);
+	if (!ce) {
+		return httpd_send_file(conn, path, &st, keep, out);
+	}
+
+	ret = httpd_send_cached(conn, ce, keep, out);
+	httpd_cache_put(ce);
+
+	return ret;
+}
+
+static void httpd_event_cgi(struct httpd_conn *conn, const struct http_req *hreq) {
+	struct client_info *ci = &conn->ci;
+	int body[2] = { -1, -1 };
+	size_t body_len;
+	pid_t child;
+
+	body_len = hreq->content_len ? strtoul(hreq->content_len, NULL, 10) : 0;
+
+	/* The script uses the socket directly, and expects it blocking */
+	httpd_set_nonblock(ci->ci_sock, 0);
+
+	if (conn->in_len && body_len) {
+		if (pipe(body)) {
+			httpd_error("pipe() failure: %s", strerror(errno));
+			httpd_event_status(conn, 500, strerror(errno), 0);
+			return;
+		}
+		fcntl(body[1], F_SETFD, FD_CLOEXEC);
+		ci->ci_stdin = body[0];
+	}
+
+	child = httpd_try_respond_script(ci, hreq);
+	if (!child && USE_REAL_CMD) {
+		child = httpd_try_respond_cmd(ci, hreq);
+	}
+
+	ci->ci_stdin = -1;
+	if (body[0] != -1) {
+		close(body[0]);
+		if (child > 0 && !httpd_set_nonblock(body[1], 1)) {
+			/* The script may read slowly or not at all, so the body is
+			 * passed by the event loop rather than by this worker */
+			conn->relay_fd = body[1];
+			conn->relay_left = body_len;
+			if (conn->in_len > body_len) {
+				conn->in_len = body_len;
+			}
+		} else {
+			close(body[1]);
+		}
+	}
+
+	if (child < 0) {
+		httpd_event_status(conn, 500, strerror(-child), 0);
+	} else if (child == 0) {
+		httpd_event_status(conn, 404, "Not Found", 0);
+	}
+}
+
+static int httpd_keepalive(const struct http_req *hreq) {
+	if (hreq->connection) {
+		if (0 == strcasecmp(hreq->connection, "close")) {
+			return 0;
+		}
+		if (0 == strcasecmp(hreq->connection, "keep-alive")) {
+			return 1;
+		}
+	}
+
+	return hreq->version && 0 == strcmp(hreq->version, "HTTP/1.1");
+}
+
+static char *httpd_header_end(char *buf, size_t len) {
+	size_t i;
+
+	for (i = 3; i < len; i++) {
+		if (buf[i] == '\n' && buf[i - 1] == '\r'
+				&& buf[i - 2] == '\n' && buf[i - 3] == '\r') {
+			return buf + i + 1;
+		}
+	}
+
+	return NULL;
+}
+
+/* Responds to all complete requests. @return 1 if the connection is kept */
+static int httpd_conn_serve(struct httpd_conn *conn,
+		struct httpd_worker_buf *wb) {
+	struct http_req hreq;
+	char *hdr_end;
+	size_t req_len;
+	int keep;
+
+	while ((hdr_end = httpd_header_end(conn->inbuf, conn->in_len))) {
+		req_len = hdr_end - conn->inbuf;
+		memcpy(wb->req, conn->inbuf, req_len);
+		wb->req[req_len] = '\0';
+		conn->in_len -= req_len;
+		memmove(conn->inbuf, hdr_end, conn->in_len);
+
+		memset(&hreq, 0, sizeof(hreq));
+		if (!httpd_parse_request(wb->req, &hreq)) {
+			httpd_event_status(conn, 400, "Bad Request", 0);
+			return 0;
+		}
+
+		httpd_debug("method=%s uri_target=%s uri_query=%s",
+				hreq.method, hreq.uri.target, hreq.uri.query);
+
+		if (0 == strncmp(hreq.uri.target, CGI_PREFIX, strlen(CGI_PREFIX))) {
+			/* Script output has no length, so it ends with the connection */
+			httpd_event_cgi(conn, &hreq);
+			return 0;
+		}
+
+		keep = httpd_keepalive(&hreq)
+			&& ++conn->requests < HTTPD_KEEPALIVE_MAX
+			/* A request body is not expected for files, drop the connection */
+			&& (!hreq.content_len || 0 == strtoul(hreq.content_len, NULL, 10));
+
+		if (httpd_event_respond_file(conn, &hreq, keep, wb->out) || !keep) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void *httpd_worker(void *arg) {
+	struct httpd_worker_buf *wb = arg;
+	struct httpd_conn *conn;
+	int keep, relay;
+
+	while (1) {
+		pthread_mutex_lock(&httpd_queue_lock);
+		while (!httpd_queue_head) {
+			pthread_cond_wait(&httpd_queue_cond, &httpd_queue_lock);
+		}
+		conn = httpd_queue_head;
+		httpd_queue_head = conn->next;
+		if (!httpd_queue_head) {
+			httpd_queue_tail = &httpd_queue_head;
+		}
+		pthread_mutex_unlock(&httpd_queue_lock);
+
+		keep = httpd_conn_serve(conn, wb);
+		relay = conn->relay_fd != -1;
+		if (!keep && !relay) {
+			close(conn->ci.ci_sock);
+		}
+
+		pthread_mutex_lock(&httpd_queue_lock);
+		conn->state = keep ? HTTPD_CONN_IDLE
+				: relay ? HTTPD_CONN_RELAY : HTTPD_CONN_FREE;
+		conn->last_active = time(NULL);
+		pthread_mutex_unlock(&httpd_queue_lock);
+
+		if (keep || relay) {
+			/* The event loop has to wait for the connection again */
+			write(httpd_wakeup[1], "", 1);
+		}
+	}
+
+	return NULL;
+}
+
+static void httpd_conn_close(struct httpd_conn *conn) {
+	close(conn->ci.ci_sock);
+	if (conn->relay_fd != -1) {
+		close(conn->relay_fd);
+		conn->relay_fd = -1;
+	}
+
+	pthread_mutex_lock(&httpd_queue_lock);
+	conn->state = HTTPD_CONN_FREE;
+	pthread_mutex_unlock(&httpd_queue_lock);
+}
+
+static void httpd_conn_queue(struct httpd_conn *conn) {
+	pthread_mutex_lock(&httpd_queue_lock);
+	conn->state = HTTPD_CONN_BUSY;
+	conn->next = NULL;
+	*httpd_queue_tail = conn;
+	httpd_queue_tail = &conn->next;
+	pthread_cond_signal(&httpd_queue_cond);
+	pthread_mutex_unlock(&httpd_queue_lock);
+}
+
+static void httpd_conn_read(struct httpd_conn *conn) {
+	ssize_t read_bytes;
+
+	read_bytes = recv(conn->ci.ci_sock, conn->inbuf + conn->in_len,
+			BUFF_SZ - conn->in_len, 0);
+	if (read_bytes == -1 && (errno == EAGAIN || errno == EINTR)) {
+		return;
+	}
+	if (read_bytes <= 0) {
+		httpd_conn_close(conn);
+		return;
+	}
+
+	conn->in_len += read_bytes;
+	conn->last_active = time(NULL);
+
+	if (httpd_header_end(conn->inbuf, conn->in_len)) {
+		httpd_conn_queue(conn);
+	} else if (conn->in_len == BUFF_SZ) {
+		httpd_event_status(conn, 431, "Request Header Fields Too Large", 0);
+		httpd_conn_close(conn);
+	}
+}
+
+/* Moves the request body from the socket to the script by one non-blocking
+ * step. The socket is blocking for the script, so it's read only when
+ * polled readable */
+static void httpd_conn_relay(struct httpd_conn *conn) {
+	ssize_t len;
+
+	if (conn->in_len) {
+		len = write(conn->relay_fd, conn->inbuf, conn->in_len);
+		if (len > 0) {
+			conn->in_len -= len;
+			conn->relay_left -= len;
+			memmove(conn->inbuf, conn->inbuf + len, conn->in_len);
+		}
+	} else {
+		len = recv(conn->ci.ci_sock, conn->inbuf,
+				conn->relay_left < BUFF_SZ ? conn->relay_left : BUFF_SZ,
+				MSG_DONTWAIT);
+		if (len > 0) {
+			conn->in_len = len;
+		} else if (len == 0) {
+			len = -1;
+			errno = ECONNRESET;
+		}
+	}
+
+	if (len == -1 && (errno == EAGAIN || errno == EINTR)) {
+		return;
+	}
+	if (len == -1 || !conn->relay_left) {
+		/* The script has the socket, so it ends the response */
+		httpd_conn_close(conn);
+		return;
+	}
+
+	conn->last_active = time(NULL);
+}
+
+static void httpd_accept(int host, const char *basedir) {
+	struct httpd_conn *conn;
+	struct sockaddr_storage addr;
+	socklen_t addrlen;
+	int sock, i;
+
+	while (1) {
+		addrlen = sizeof(addr);
+		sock = accept(host, (struct sockaddr *) &addr, &addrlen);
+		if (sock == -1) {
+			if (errno == EINTR) {
+				continue;
+			}
+			if (errno != EAGAIN) {
+				httpd_error("accept() failure: %s", strerror(errno));
+			}
+			return;
+		}
+
+		conn = NULL;
+		pthread_mutex_lock(&httpd_queue_lock);
+		for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+			if (httpd_conns[i].state == HTTPD_CONN_FREE) {
+				conn = &httpd_conns[i];
+				conn->state = HTTPD_CONN_IDLE;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&httpd_queue_lock);
+
+		httpd_set_nonblock(sock, 1);
+
+		if (!conn) {
+			struct httpd_conn busy = { .ci = { .ci_sock = sock } };
+
+			httpd_warning("too many connections");
+			httpd_event_status(&busy, 503, "Service Unavailable", 0);
+			close(sock);
+			continue;
+		}
+
+		memcpy(&conn->ci.ci_addr, &addr, sizeof(conn->ci.ci_addr));
+		conn->ci.ci_addrlen = addrlen;
+		conn->ci.ci_sock = sock;
+		conn->ci.ci_index = conn - httpd_conns;
+		conn->ci.ci_stdin = -1;
+		conn->ci.ci_basedir = basedir;
+		conn->in_len = 0;
+		conn->requests = 0;
+		conn->relay_fd = -1;
+		conn->last_active = time(NULL);
+	}
+}
+
+static int httpd_workers_start(void) {
+	pthread_t thread;
+	int i, err;
+
+	for (i = 0; i < HTTPD_WORKERS; i++) {
+		err = pthread_create(&thread, NULL, httpd_worker, &httpd_worker_bufs[i]);
+		if (err) {
+			httpd_error("pthread_create() failure: %s", strerror(err));
+			/* Serve with fewer workers if some are started */
+			return i ? 0 : -err;
+		}
+		pthread_detach(thread);
+	}
+
+	return 0;
+}
+
+static void httpd_event_loop(int host, const char *basedir) {
+	static struct pollfd pfds[HTTPD_MAX_CLIENTS + 2];
+	static struct httpd_conn *pconns[HTTPD_MAX_CLIENTS];
+	struct httpd_conn *conn;
+	char drain[16];
+	time_t now;
+	int nconns, i;
+
+	pfds[0].fd = host;
+	pfds[0].events = POLLIN;
+	pfds[1].fd = httpd_wakeup[0];
+	pfds[1].events = POLLIN;
+
+	while (1) {
+		now = time(NULL);
+		nconns = 0;
+
+		pthread_mutex_lock(&httpd_queue_lock);
+		for (i = 0; i < HTTPD_MAX_CLIENTS; i++) {
+			conn = &httpd_conns[i];
+			if (conn->state != HTTPD_CONN_IDLE
+					&& conn->state != HTTPD_CONN_RELAY) {
+				continue;
+			}
+			if (now - conn->last_active >= HTTPD_KEEPALIVE_TIMEOUT) {
+				close(conn->ci.ci_sock);
+				if (conn->relay_fd != -1) {
+					close(conn->relay_fd);
+					conn->relay_fd = -1;
+				}
+				conn->state = HTTPD_CONN_FREE;
+				continue;
+			}
+			pconns[nconns] = conn;
+			if (conn->state == HTTPD_CONN_RELAY && conn->in_len) {
+				pfds[nconns + 2].fd = conn->relay_fd;
+				pfds[nconns + 2].events = POLLOUT;
+			} else {
+				pfds[nconns + 2].fd = conn->ci.ci_sock;
+				pfds[nconns + 2].events = POLLIN;
+			}
+			pfds[nconns + 2].revents = 0;
+			nconns++;
+		}
+		pthread_mutex_unlock(&httpd_queue_lock);
+
+		pfds[0].revents = pfds[1].revents = 0;
+
+		/* Idle timeouts are checked once a second */
+		if (-1 == poll(pfds, nconns + 2, nconns ? 1000 : -1)) {
+			if (errno != EINTR) {
+				httpd_error("poll() failure: %s", strerror(errno));
+				usleep(100000);
+			}
+			continue;
+		}
+
+		while (0 < waitpid(-1, NULL, WNOHANG)) {
+			/* reap finished scripts */
+		}
+
+		if (pfds[1].revents & POLLIN) {
+			while (0 < read(httpd_wakeup[0], drain, sizeof(drain))) {
+			}
+		}
+
+		for (i = 0; i < nconns; i++) {
+			if (!pfds[i + 2].revents) {
+				continue;
+			}
+			if (pconns[i]->state == HTTPD_CONN_RELAY) {
+				httpd_conn_relay(pconns[i]);
+			} else {
+				httpd_conn_read(pconns[i]);
+			}
+		}
+
+		if (pfds[0].revents & POLLIN) {
+			httpd_accept(host, basedir);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	int host;
+	const char *basedir;
+#if USE_IP_VER == 4
+	struct sockaddr_in inaddr;
+	const size_t inaddrlen = sizeof(inaddr);
+	const int family = AF_INET;
+
+	inaddr.sin_family = AF_INET;
+	inaddr.sin_port= htons(80);
+	inaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+#elif USE_IP_VER == 6
+	struct sockaddr_in6 inaddr;
+	const size_t inaddrlen = sizeof(inaddr);
+	const int family = AF_INET6;
+
+	inaddr.sin6_family = AF_INET6;
+	inaddr.sin6_port= htons(80);
+	memcpy(&inaddr.sin6_addr, &in6addr_any, sizeof(inaddr.sin6_addr));
+#else
+#error Unknown USE_IP_VER
+#endif
+
+	basedir = argc > 1 ? argv[1] : "/";
+
+	if (-1 == pipe(httpd_wakeup)) {
+		httpd_error("pipe() failure: %s", strerror(errno));
+		return -errno;
+	}
+	httpd_set_nonblock(httpd_wakeup[0], 1);
+	httpd_set_nonblock(httpd_wakeup[1], 1);
+
+	host = socket(family, SOCK_STREAM, IPPROTO_TCP);
+	if (host == -1) {
+		httpd_error("socket() failure: %s", strerror(errno));
+		return -errno;
+	}
+
+	if (-1 == bind(host, (struct sockaddr *) &inaddr, inaddrlen)) {
+		httpd_error("bind() failure: %s", strerror(errno));
+		close(host);
+		return -errno;
+	}
+
+	if (-1 == listen(host, HTTPD_MAX_CLIENTS)) {
+		httpd_error("listen() failure: %s", strerror(errno));
+		close(host);
+		return -errno;
+	}
+
+	httpd_set_nonblock(host, 1);
+
+	if (0 != httpd_workers_start()) {
+		close(host);
+		return -1;
+	}
+
+	httpd_event_loop(host, basedir);
+
+	close(host);
+
+	return 0;
+}
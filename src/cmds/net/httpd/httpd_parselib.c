@@ -19,6 +19,7 @@ static const struct http_header_desc {
 } http_headers[] = {
 	{ .name = "Content-Length: ", .hreq_offset = offsetof(struct http_req, content_len), },
 	{ .name = "Content-Type: ", .hreq_offset = offsetof(struct http_req, content_type), },
+	{ .name = "Connection: ", .hreq_offset = offsetof(struct http_req, connection), },
 };
 
 static char *httpd_parse_uri(char *str, struct http_req_uri *huri) {
@@ -63,11 +64,13 @@ static char *httpd_parse_request_line(char *str, struct http_req *hreq) {
 		return NULL;
 	}
 
+	hreq->version = pb;
 	pb = strstr(pb, "\r\n");
 	if (!pb) {
 		httpd_error("can't find sentinel");
 		return NULL;
 	}
+	*pb = '\0';
 
 	return pb + strlen("\r\n");
 }
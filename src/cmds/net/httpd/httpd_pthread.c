@@ -149,6 +149,7 @@ int main(int argc, char **argv) {
 			continue;
 		}
 		assert(ci->ci_addrlen == inaddrlen);
+		ci->ci_stdin = -1;
 		ci->ci_basedir = basedir;
 
 		pthread_create(&thread, NULL, do_httpd_client_thread, ci);
@@ -10,19 +10,55 @@
 #include <stdio.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <string.h>
+
+static void print_stats(void) {
+	struct dns_cache_stats stats;
+
+	dns_cache_get_stats(&stats);
+
+	printf("Queries: %lu\n", stats.queries);
+	printf("Cache hits: %lu (%lu negative), hosts file: %lu, waited: %lu\n",
+			stats.hits, stats.neg_hits, stats.hosts_hits, stats.coalesced);
+	printf("Sent: %lu, average latency: %lu ms\n",
+			stats.sent, stats.latency_ms);
+}
+
+static void print_answers(const struct dns_result *result) {
+	struct dns_rr *rr;
+	size_t i;
+	char addr[INET6_ADDRSTRLEN];
+
+	for (i = 0, rr = result->an; i < result->ancount; ++i, ++rr) {
+		if (rr->rtype == DNS_RR_TYPE_A) {
+			printf("Name: %s\tAddress: %s\n", &rr->rname[0],
+					inet_ntoa(*(struct in_addr *)&rr->rdata.a.address[0]));
+		} else if (rr->rtype == DNS_RR_TYPE_AAAA) {
+			printf("Name: %s\tAddress: %s\n", &rr->rname[0],
+					inet_ntop(AF_INET6, &rr->rdata.aaaa.address[0],
+						addr, sizeof addr));
+		}
+	}
+}
 
 int main(int argc, char **argv) {
 	int ret;
-	struct dns_result result;
+	struct dns_result result, result6;
 	struct dns_rr *rr;
 	size_t i;
 
+	if (argc == 2 && 0 == strcmp(argv[1], "-s")) {
+		print_stats();
+		return 0;
+	}
+
 	if (argc != 2) {
 		printf("Usage: %s name\n", argv[0]);
+		printf("       %s -s\n", argv[0]);
 		return -EINVAL;
 	}
 
-	ret = dns_query(argv[1], DNS_RR_TYPE_A, DNS_RR_CLASS_IN, &result);
+	ret = dns_query_addr(argv[1], &result, &result6);
 	if (ret != 0) {
 		return ret;
 	}
@@ -34,23 +70,22 @@ int main(int argc, char **argv) {
 	/* answer */
 	printf("\n%s:\n", result.nscount != 0 ? "Authoritative answer"
 			: "Non-authoritative answer");
-	for (i = 0, rr = result.an; i < result.ancount; ++i, ++rr) {
-		if (rr->rtype == DNS_RR_TYPE_A) {
-			printf("Name: %s\tAddress: %s\n", &rr->rname[0],
-					inet_ntoa(*(struct in_addr *)&rr->rdata.a.address[0]));
-		}
-	}
+	print_answers(&result);
+	print_answers(&result6);
 
 	/* authoritive */
 	if (result.nscount != 0) {
 		printf("\nAuthoritative nameservers:\n");
 		for (i = 0, rr = result.ns; i < result.nscount; ++i, ++rr) {
-			printf("Name: %s\tNameserver: %s\n", &rr->rname[0],
-					&rr->rdata.ns.nsdname[0]);
+			if (rr->rtype == DNS_RR_TYPE_NS) {
+				printf("Name: %s\tNameserver: %s\n", &rr->rname[0],
+						&rr->rdata.ns.nsdname[0]);
+			}
 		}
 	}
 
 	dns_result_free(&result);
+	dns_result_free(&result6);
 
 	return 0;
 }
@@ -1,7 +1,9 @@
 /**
  * @file
- * @brief Easy TFTP client
- * @details RFC 1350
+ * @brief Easy TFTP client and server
+ * @details RFC 1350 with RFC 2347 option negotiation of blksize (RFC 2348),
+ *   tsize (RFC 2349) and windowsize (RFC 7440). Data goes between the socket
+ *   and the file block by block, nothing is buffered on the way.
  *
  * @date 12.03.10
  * @author Nikolay Korotky
@@ -10,22 +12,37 @@
 
 #include <unistd.h>
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
-#include <unistd.h>
+#include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
 #include <stddef.h>
 #include <assert.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <arpa/inet.h>
 
+#include <framework/mod/options.h>
+
 /*
  * Trivial File Transfer Protocol (IEN-133)
  */
-#define SEGSIZE 512       /* data segment size */
+#define SEGSIZE 512       /* default data segment size */
 #define PKTSIZE SEGSIZE+4 /* full packet size */
 
 #define TFTP_TRANSFER_PORT 69 /* default well known port */
 
+#define TFTP_BLKSIZE_MIN    8     /* RFC 2348 */
+#define TFTP_BLKSIZE_MAX    OPTION_GET(NUMBER,max_blksize)
+#define TFTP_WINDOWSIZE_MAX OPTION_GET(NUMBER,max_windowsize)
+
+#define TFTP_DEF_BLKSIZE    OPTION_GET(NUMBER,blksize)
+#define TFTP_DEF_WINDOWSIZE OPTION_GET(NUMBER,windowsize)
+#define TFTP_RECV_TIMEOUT   OPTION_GET(NUMBER,timeout)
+#define TFTP_RETRIES        OPTION_GET(NUMBER,retries)
+
 /*
  * Packet types.
  */
@@ -44,7 +61,7 @@ struct tftp_msg {
 		} cmd /*__attribute__ ((packed))*/;
 		struct {
 			uint16_t block_num;
-			char stuff[SEGSIZE];
+			char stuff[SEGSIZE]; /* up to negotiated blksize */
 		} data /*__attribute__ ((packed))*/;
 		struct {
 			uint16_t block_num;
@@ -53,14 +70,19 @@ struct tftp_msg {
 			uint16_t error_code;
 			char error_msg[1];
 		} err /*__attriibute__ ((packed))*/;
+		struct {
+			char opts[2];
+		} oack /*__attribute__ ((packed))*/;
 	} op /*__attribute__ ((packed))*/;
 } __attribute__ ((packed));
 
+#define TFTP_DATA_HDR_SZ offsetof(struct tftp_msg, op.data.stuff)
+
 /*
  * Errors
  */
 
-/* These initial 7 are passed across the net in "ERROR" packets. */
+/* These initial 9 are passed across the net in "ERROR" packets. */
 #define	TFTP_EUNDEF      0	/* not defined */
 #define	TFTP_ENOTFOUND   1	/* file not found */
 #define	TFTP_EACCESS     2	/* access violation */
@@ -69,16 +91,33 @@ struct tftp_msg {
 #define	TFTP_EBADID      5	/* unknown transfer ID */
 #define	TFTP_EEXISTS     6	/* file already exists */
 #define	TFTP_ENOUSER     7	/* no such user */
+#define	TFTP_EBADOPT     8	/* option negotiation failed, RFC 2347 */
 /* These extensions are return codes in our API, *never* passed on the net. */
-#define TFTP_TIMEOUT     8	/* operation timed out */
-#define TFTP_NETERR      9	/* some sort of network error */
-#define TFTP_INVALID    10	/* invalid parameter */
-#define TFTP_PROTOCOL   11	/* protocol violation */
-#define TFTP_TOOLARGE   12	/* file is larger than buffer */
-
-static int open_socket(int *out_sock, struct sockaddr *sa,
-		socklen_t salen) {
+#define TFTP_TIMEOUT     9	/* operation timed out */
+#define TFTP_NETERR     10	/* some sort of network error */
+#define TFTP_INVALID    11	/* invalid parameter */
+#define TFTP_PROTOCOL   12	/* protocol violation */
+#define TFTP_TOOLARGE   13	/* file is larger than buffer */
+
+/* One transfer, the same for client and server */
+struct tftp_conn {
+	int sock;
+	FILE *fp;
+	size_t blksize;
+	unsigned int windowsize;
+	long tsize;               /* -1 if not negotiated */
+	size_t bytes;             /* data transferred so far */
+	long pos;                 /* file position of the sender */
+	struct tftp_msg *in;      /* received packet */
+	size_t in_sz;
+	struct tftp_msg *out;     /* outgoing DATA */
+	char ctl[PKTSIZE];        /* last request, OACK or ACK, resent on timeout */
+	size_t ctl_len;
+};
+
+static int open_socket(int *out_sock) {
 	int ret;
+	struct timeval tv;
 
 	ret = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (ret == -1) {
@@ -86,8 +125,10 @@ static int open_socket(int *out_sock, struct sockaddr *sa,
 		return -errno;
 	}
 
-	if (-1 == connect(ret, sa, salen)) {
-		perror("tftp: connect() failure");
+	tv.tv_sec = TFTP_RECV_TIMEOUT;
+	tv.tv_usec = 0;
+	if (-1 == setsockopt(ret, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv)) {
+		perror("tftp: setsockopt() failure");
 		close(ret);
 		return -errno;
 	}
@@ -161,6 +202,16 @@ static int close_file(FILE *fp) {
 	return 0;
 }
 
+static long file_size(FILE *fp) {
+	struct stat st;
+
+	if (-1 == fstat(fileno(fp), &st)) {
+		return -1;
+	}
+
+	return st.st_size;
+}
+
 static int read_file(FILE *fp, char *buff, size_t buff_sz, size_t *out_bytes) {
 	int ret;
 
@@ -187,11 +238,42 @@ static int write_file(FILE *fp, char *data, size_t data_sz) {
 	return 0;
 }
 
+static int tftp_conn_init(struct tftp_conn *conn, size_t blksize) {
+	memset(conn, 0, sizeof *conn);
+	conn->sock = -1;
+	conn->blksize = SEGSIZE;
+	conn->windowsize = 1;
+	conn->tsize = -1;
+
+	/* a server may ignore the options and send default blocks */
+	conn->in_sz = TFTP_DATA_HDR_SZ + (blksize > SEGSIZE ? blksize : SEGSIZE);
+	conn->in = malloc(conn->in_sz);
+	conn->out = malloc(conn->in_sz);
+	if ((conn->in == NULL) || (conn->out == NULL)) {
+		free(conn->in);
+		free(conn->out);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void tftp_conn_fini(struct tftp_conn *conn) {
+	if (conn->sock >= 0) close(conn->sock);
+	if (conn->fp) fclose(conn->fp);
+	free(conn->in);
+	free(conn->out);
+}
+
 static int tftp_build_msg_cmd(struct tftp_msg *msg, size_t *msg_len,
 		uint16_t type, char *filename, char *mode) {
 	char *ptr;
 	size_t sz;
 
+	if (strlen(filename) + strlen(mode) + 2 > SEGSIZE) {
+		return -ENAMETOOLONG;
+	}
+
 	msg->opcode = htons(type);
 	*msg_len = sizeof msg->opcode;
 
@@ -208,20 +290,53 @@ static int tftp_build_msg_cmd(struct tftp_msg *msg, size_t *msg_len,
 	return 0;
 }
 
-static int tftp_build_msg_data(struct tftp_msg *msg, size_t *msg_len,
-		FILE *fp, uint16_t block_num) {
+/* Appends "name\0value\0" to a request or an OACK */
+static int tftp_msg_add_opt(struct tftp_msg *msg, size_t *msg_len,
+		const char *name, long value) {
+	char *ptr;
+	size_t sz;
+	int ret;
+
+	sz = strlen(name) + 1;
+	if (*msg_len + sz >= PKTSIZE) {
+		return -ENAMETOOLONG;
+	}
+	ptr = (char *)msg + *msg_len;
+	memcpy(ptr, name, sz);
+	ptr += sz;
+
+	ret = snprintf(ptr, PKTSIZE - *msg_len - sz, "%ld", value);
+	if ((ret < 0) || (*msg_len + sz + ret + 1 > PKTSIZE)) {
+		return -ENAMETOOLONG;
+	}
+	*msg_len += sz + ret + 1;
+
+	return 0;
+}
+
+static int tftp_build_msg_data(struct tftp_conn *conn, size_t *msg_len,
+		uint32_t block) {
 	int ret;
 	size_t bytes = 0;
+	struct tftp_msg *msg = conn->out;
+	long pos;
 
 	msg->opcode = htons(DATA);
 	*msg_len = sizeof msg->opcode;
 
-	msg->op.data.block_num = htons(block_num);
+	msg->op.data.block_num = htons((uint16_t)block);
 	*msg_len += sizeof msg->op.data.block_num;
 
-	ret = read_file(fp, &msg->op.data.stuff[0], sizeof msg->op.data.stuff, &bytes);
+	/* a window is resent straight from the file */
+	pos = (long)(block - 1) * conn->blksize;
+	if ((conn->pos != pos) && (-1 == fseek(conn->fp, pos, SEEK_SET))) {
+		return -errno;
+	}
+
+	ret = read_file(conn->fp, &msg->op.data.stuff[0], conn->blksize, &bytes);
 	if (ret != 0) return ret;
 	*msg_len += bytes;
+	conn->pos = pos + bytes;
 
 	return 0;
 }
@@ -236,6 +351,37 @@ static int tftp_build_msg_ack(struct tftp_msg *msg, size_t *msg_len, uint16_t bl
 	return 0;
 }
 
+static int tftp_build_msg_error(struct tftp_msg *msg, size_t *msg_len,
+		uint16_t error_code, const char *error_msg) {
+	size_t sz;
+
+	msg->opcode = htons(ERROR);
+	*msg_len = sizeof msg->opcode;
+
+	msg->op.err.error_code = htons(error_code);
+	*msg_len += sizeof msg->op.err.error_code;
+
+	sz = strlen(error_msg) + 1;
+	memcpy(&msg->op.err.error_msg[0], error_msg, sz);
+	*msg_len += sz;
+
+	return 0;
+}
+
+/* Checks the strings are terminated and come in name/value pairs */
+static int opts_with_correct_len(char *opts, size_t left_sz) {
+	int strings = 0;
+
+	while (left_sz != 0) {
+		do
+			if (left_sz-- == 0) return 0;
+		while (*opts++ != '\0');
+		strings++;
+	}
+
+	return strings % 2 == 0;
+}
+
 static int msg_with_correct_len(struct tftp_msg *msg, size_t msg_len) {
 	size_t field_sz, left_sz;
 	char *tmp;
@@ -259,7 +405,8 @@ static int msg_with_correct_len(struct tftp_msg *msg, size_t msg_len) {
 		do
 			if (left_sz-- == 0) return 0;
 		while (*tmp++ != '\0');
-		break;
+		/* options */
+		return opts_with_correct_len(tmp, left_sz);
 	case DATA:
 		/* block number */
 		field_sz = sizeof msg->op.data.block_num;
@@ -285,6 +432,8 @@ static int msg_with_correct_len(struct tftp_msg *msg, size_t msg_len) {
 			if (left_sz-- == 0) return 0;
 		while (*tmp++ != '\0');
 		break;
+	case OACK:
+		return opts_with_correct_len(&msg->op.oack.opts[0], left_sz);
 	default: /* unknown operation */
 		return 0;
 	}
@@ -304,14 +453,20 @@ static int tftp_msg_send(struct tftp_msg *msg, size_t msg_len,
 	return 0;
 }
 
-static int tftp_msg_recv(struct tftp_msg *msg, size_t *msg_len,
-		int sock) {
+static int tftp_msg_recv(struct tftp_msg *msg, size_t msg_sz, size_t *msg_len,
+		int sock, struct sockaddr_in *from) {
 	ssize_t ret;
+	socklen_t from_len;
 
 	assert(msg_len != NULL);
 
-	ret = recv(sock, (char *)msg, sizeof *msg, 0);
+	from_len = sizeof *from;
+	ret = recvfrom(sock, (char *)msg, msg_sz, 0, (struct sockaddr *)from,
+			from ? &from_len : NULL);
 	if (ret == -1) {
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			return -ETIMEDOUT;
+		}
 		perror("tftp: recv() failure");
 		return -errno;
 	}
@@ -321,189 +476,731 @@ static int tftp_msg_recv(struct tftp_msg *msg, size_t *msg_len,
 	return 0;
 }
 
-static int tftp_send_file(char *filename, char *hostname, char binary_on) {
-	int ret, sock;
-	struct sockaddr_storage remote_addr;
-	socklen_t remote_addr_len;
-	FILE *fp = NULL;
-	struct tftp_msg snd, rcv;
-	size_t snd_len, rcv_len = 0;
-	uint16_t pkg_number;
+static int tftp_ctl_send(struct tftp_conn *conn) {
+	return tftp_msg_send((struct tftp_msg *)conn->ctl, conn->ctl_len, conn->sock);
+}
 
-	ret = make_remote_addr(hostname,
-			(struct sockaddr *)&remote_addr, &remote_addr_len);
-	if (ret != 0) { sock = -1; fp = NULL; goto error; }
+static void tftp_send_error(struct tftp_conn *conn, uint16_t error_code,
+		const char *error_msg) {
+	tftp_build_msg_error((struct tftp_msg *)conn->ctl, &conn->ctl_len,
+			error_code, error_msg);
+	tftp_ctl_send(conn);
+}
 
-	ret = open_socket(&sock, (struct sockaddr *)&remote_addr,
-			remote_addr_len);
-	if (ret != 0) { sock = -1; fp = NULL; goto error; }
+static void tftp_print_error(struct tftp_msg *msg, const char *peer) {
+	fprintf(stderr, "%s: error: code=%d, msg='%s`\n",
+			peer, (int)ntohs(msg->op.err.error_code), &msg->op.err.error_msg[0]);
+}
 
-	ret = open_file(filename, get_file_mode_r(binary_on), &fp);
-	if (ret != 0) { fp = NULL; goto error; }
+/*
+ * Applies options of an OACK. The server may only lower what was requested,
+ * anything else fails the negotiation.
+ */
+static int tftp_parse_oack(struct tftp_conn *conn, size_t msg_len,
+		size_t req_blksize, unsigned int req_windowsize) {
+	char *name, *value, *end;
+	long val;
+
+	name = &conn->in->op.oack.opts[0];
+	end = (char *)conn->in + msg_len;
+	while (name < end) {
+		value = name + strlen(name) + 1;
+		val = strtol(value, NULL, 10);
+
+		if (0 == strcasecmp(name, "blksize")) {
+			if ((val < TFTP_BLKSIZE_MIN) || (val > req_blksize)) {
+				return -EINVAL;
+			}
+			conn->blksize = val;
+		} else if (0 == strcasecmp(name, "windowsize")) {
+			if ((val < 1) || (val > req_windowsize)) {
+				return -EINVAL;
+			}
+			conn->windowsize = val;
+		} else if (0 == strcasecmp(name, "tsize")) {
+			conn->tsize = val;
+		} else {
+			return -EINVAL;
+		}
 
-	pkg_number = 0;
+		name = value + strlen(value) + 1;
+	}
 
-	ret = tftp_build_msg_cmd(&snd, &snd_len, WRQ, filename, get_transfer_mode(binary_on));
-	if (ret != 0) goto error;
+	return 0;
+}
 
-	/* Send Write Request */
-	goto send_msg;
+/*
+ * Sends blocks from the file, windowsize of them before waiting for an ACK.
+ * An ACK of a block inside the window, or a timeout, restarts the window
+ * right after the last acknowledged block.
+ */
+static int tftp_send_blocks(struct tftp_conn *conn, const char *peer) {
+	uint32_t acked, next, last;
+	uint16_t delta;
+	size_t msg_len, rcv_len;
+	int ret, retries;
+
+	acked = last = 0;
+	next = 1;
+	retries = 0;
+	conn->pos = 0;
 
 	while (1) {
-		/* receive reply */
-		ret = tftp_msg_recv(&rcv, &rcv_len, sock);
-		if (ret != 0) goto error;
+		while ((next <= acked + conn->windowsize)
+				&& ((last == 0) || (next <= last))) {
+			ret = tftp_build_msg_data(conn, &msg_len, next);
+			if (ret != 0) {
+				tftp_send_error(conn, TFTP_EUNDEF, "read error");
+				return ret;
+			}
+			if (msg_len - TFTP_DATA_HDR_SZ < conn->blksize) {
+				last = next;
+			}
 
-		/* check message length */
-		if (!msg_with_correct_len(&rcv, rcv_len)) goto send_msg; /* bad packet, send again */
+			ret = tftp_msg_send(conn->out, msg_len, conn->sock);
+			if (ret != 0) return ret;
+			next++;
+		}
 
-		/* handling of the reply msg */
-		switch (ntohs(rcv.opcode)) {
+		ret = tftp_msg_recv(conn->in, conn->in_sz, &rcv_len, conn->sock, NULL);
+		if (ret == -ETIMEDOUT) {
+			if (++retries > TFTP_RETRIES) {
+				fprintf(stderr, "%s: error: timed out\n", peer);
+				return ret;
+			}
+			next = acked + 1;
+			continue;
+		}
+		if (ret != 0) return ret;
+
+		if (!msg_with_correct_len(conn->in, rcv_len)) continue;
+
+		switch (ntohs(conn->in->opcode)) {
 		case ACK:
-			if (ntohs(rcv.op.ack.block_num) != pkg_number) {
-				goto send_msg; /* invalid acknowledgement, send again */
+			delta = ntohs(conn->in->op.ack.block_num) - (uint16_t)acked;
+			if (delta >= next - acked) {
+				continue; /* stale acknowledgement */
+			}
+			if (delta != 0) {
+				retries = 0;
 			}
+			acked += delta;
+			next = acked + 1;
 			break;
 		case ERROR:
-			fprintf(stderr, "%s: error: code=%d, msg='%s`\n",
-					hostname, (int)ntohs(rcv.op.err.error_code), &rcv.op.err.error_msg[0]);
-			goto error;
+			tftp_print_error(conn->in, peer);
+			return -ECONNABORTED;
 		default:
-			goto send_msg;
+			continue;
+		}
+
+		if ((last != 0) && (acked == last)) {
+			conn->bytes = conn->pos;
+			return 0;
+		}
+	}
+}
+
+/*
+ * Waits one timeout after the final ACK and repeats it if the last block comes
+ * again, so a lost final ACK does not make the sender fail on a closed port.
+ */
+static void tftp_recv_dally(struct tftp_conn *conn, uint16_t last_block) {
+	size_t rcv_len;
+
+	while (0 == tftp_msg_recv(conn->in, conn->in_sz, &rcv_len, conn->sock, NULL)) {
+		if (msg_with_correct_len(conn->in, rcv_len)
+				&& (ntohs(conn->in->opcode) == DATA)
+				&& (ntohs(conn->in->op.data.block_num) == last_block)) {
+			tftp_ctl_send(conn);
 		}
+	}
+}
 
-		/* whether we have more data to transfer? */
-		if ((pkg_number != 0) && (snd_len != sizeof snd)) {
-			break; /* no more data */
+/*
+ * Writes in-order blocks to the file and acknowledges every windowsize-th
+ * one. The first block out of order is answered with an ACK of the last good
+ * block, so the sender restarts from there without waiting for a timeout.
+ * A DATA already received (as the reply to RRQ) is passed in rcv_len.
+ */
+static int tftp_recv_blocks(struct tftp_conn *conn, size_t rcv_len,
+		const char *peer, int dally) {
+	uint32_t expected;
+	unsigned int in_window;
+	size_t data_len;
+	int ret, retries, nak_sent;
+
+	expected = 1;
+	in_window = 0;
+	retries = 0;
+	nak_sent = 0;
+
+	while (1) {
+		if (rcv_len == 0) {
+			ret = tftp_msg_recv(conn->in, conn->in_sz, &rcv_len, conn->sock, NULL);
+			if (ret == -ETIMEDOUT) {
+				if (++retries > TFTP_RETRIES) {
+					fprintf(stderr, "%s: error: timed out\n", peer);
+					return ret;
+				}
+				in_window = 0;
+				ret = tftp_ctl_send(conn);
+				if (ret != 0) return ret;
+				continue;
+			}
+			if (ret != 0) return ret;
 		}
 
-		/* get next stuff of data */
-		ret = tftp_build_msg_data(&snd, &snd_len, fp, ++pkg_number);
-		if (ret != 0) goto error; /* TODO send error package */
+		data_len = rcv_len - TFTP_DATA_HDR_SZ;
+		if (!msg_with_correct_len(conn->in, rcv_len)) goto next_msg;
 
-send_msg:
-		/* send request / data */
-		ret = tftp_msg_send(&snd, snd_len, sock);
-		if (ret != 0) goto error;
+		switch (ntohs(conn->in->opcode)) {
+		case DATA:
+			if (data_len > conn->blksize) goto next_msg;
+
+			if (ntohs(conn->in->op.data.block_num) != (uint16_t)expected) {
+				if (!nak_sent) {
+					nak_sent = 1;
+					in_window = 0;
+					tftp_build_msg_ack((struct tftp_msg *)conn->ctl, &conn->ctl_len,
+							(uint16_t)(expected - 1));
+					ret = tftp_ctl_send(conn);
+					if (ret != 0) return ret;
+				}
+				goto next_msg;
+			}
+
+			ret = write_file(conn->fp, &conn->in->op.data.stuff[0], data_len);
+			if (ret != 0) {
+				tftp_send_error(conn, TFTP_ENOSPACE, "write error");
+				return ret;
+			}
+			conn->bytes += data_len;
+			expected++;
+			in_window++;
+			nak_sent = 0;
+			retries = 0;
+
+			if ((data_len < conn->blksize) || (in_window == conn->windowsize)) {
+				in_window = 0;
+				tftp_build_msg_ack((struct tftp_msg *)conn->ctl, &conn->ctl_len,
+						(uint16_t)(expected - 1));
+				ret = tftp_ctl_send(conn);
+				if (ret != 0) return ret;
+			}
+			if (data_len < conn->blksize) {
+				if (dally) {
+					tftp_recv_dally(conn, (uint16_t)(expected - 1));
+				}
+				return 0;
+			}
+			break;
+		case ERROR:
+			tftp_print_error(conn->in, peer);
+			return -ECONNABORTED;
+		default:
+			break;
+		}
+next_msg:
+		rcv_len = 0;
 	}
+}
 
-	ret = close_file(fp);
-	if (ret != 0) { fp = NULL; goto error; }
+/*
+ * Sends the request until a reply comes, then locks the connection on the
+ * transfer ID (port) the server answers from.
+ */
+static int tftp_client_request(struct tftp_conn *conn,
+		struct sockaddr_in *srv, size_t *rcv_len) {
+	struct sockaddr_in from;
+	int ret, retries;
 
-	ret = close_socket(sock);
-	if (ret != 0) { sock = -1; fp = NULL; goto error; }
+	retries = 0;
+	while (1) {
+		if (-1 == sendto(conn->sock, conn->ctl, conn->ctl_len, 0,
+				(struct sockaddr *)srv, sizeof *srv)) {
+			perror("tftp: sendto() failure");
+			return -errno;
+		}
 
-	fprintf(stdout, "File '%s` was transferred\n", filename);
+		ret = tftp_msg_recv(conn->in, conn->in_sz, rcv_len, conn->sock, &from);
+		if (ret == -ETIMEDOUT) {
+			if (++retries > TFTP_RETRIES) return ret;
+			continue;
+		}
+		if (ret != 0) return ret;
+
+		if ((from.sin_addr.s_addr == srv->sin_addr.s_addr)
+				&& msg_with_correct_len(conn->in, *rcv_len)) {
+			break;
+		}
+	}
+
+	if (-1 == connect(conn->sock, (struct sockaddr *)&from, sizeof from)) {
+		perror("tftp: connect() failure");
+		return -errno;
+	}
 
 	return 0;
+}
+
+static int tftp_build_request(struct tftp_conn *conn, uint16_t type,
+		char *filename, char binary_on, size_t blksize,
+		unsigned int windowsize, long tsize) {
+	struct tftp_msg *msg = (struct tftp_msg *)conn->ctl;
+	int ret;
+
+	ret = tftp_build_msg_cmd(msg, &conn->ctl_len, type, filename,
+			get_transfer_mode(binary_on));
+	if (ret != 0) return ret;
+
+	if ((blksize == SEGSIZE) && (windowsize == 1)) {
+		return 0; /* plain RFC 1350 */
+	}
+
+	if (0 != (ret = tftp_msg_add_opt(msg, &conn->ctl_len, "blksize", blksize))
+			|| 0 != (ret = tftp_msg_add_opt(msg, &conn->ctl_len, "windowsize", windowsize))) {
+		return ret;
+	}
+
+	return tsize < 0 ? 0 : tftp_msg_add_opt(msg, &conn->ctl_len, "tsize", tsize);
+}
+
+static int tftp_send_file(char *filename, char *hostname, char binary_on,
+		size_t blksize, unsigned int windowsize) {
+	int ret;
+	struct sockaddr_storage remote_addr;
+	socklen_t remote_addr_len;
+	struct tftp_conn conn;
+	size_t rcv_len;
+
+	ret = tftp_conn_init(&conn, blksize);
+	if (ret != 0) return ret;
+
+	ret = make_remote_addr(hostname,
+			(struct sockaddr *)&remote_addr, &remote_addr_len);
+	if (ret != 0) goto error;
+
+	ret = open_socket(&conn.sock);
+	if (ret != 0) goto error;
+
+	ret = open_file(filename, get_file_mode_r(binary_on), &conn.fp);
+	if (ret != 0) goto error;
+
+	ret = tftp_build_request(&conn, WRQ, filename, binary_on, blksize,
+			windowsize, file_size(conn.fp));
+	if (ret != 0) goto error;
+
+	/* Send Write Request */
+	ret = tftp_client_request(&conn, (struct sockaddr_in *)&remote_addr, &rcv_len);
+	if (ret != 0) goto error;
+
+	switch (ntohs(conn.in->opcode)) {
+	case OACK:
+		ret = tftp_parse_oack(&conn, rcv_len, blksize, windowsize);
+		if (ret != 0) {
+			tftp_send_error(&conn, TFTP_EBADOPT, "bad option");
+			goto error;
+		}
+		break;
+	case ACK:
+		if (ntohs(conn.in->op.ack.block_num) == 0) {
+			break; /* server without options */
+		}
+		/* fallthrough */
+	default:
+		ret = -EINVAL;
+		goto error;
+	case ERROR:
+		tftp_print_error(conn.in, hostname);
+		ret = -ECONNABORTED;
+		goto error;
+	}
+
+	ret = tftp_send_blocks(&conn, hostname);
+	if (ret != 0) goto error;
+
+	ret = close_file(conn.fp);
+	conn.fp = NULL;
+	if (ret != 0) goto error;
+
+	ret = close_socket(conn.sock);
+	conn.sock = -1;
+	if (ret != 0) goto error;
+
+	fprintf(stdout, "File '%s` was transferred (%zu bytes)\n", filename, conn.bytes);
 
 error:
-	if (sock >= 0) close(sock);
-	if (fp) fclose(fp);
+	tftp_conn_fini(&conn);
 	return ret;
 }
 
-static int tftp_recv_file(char *filename, char *hostname, char binary_on) {
-	int ret, sock;
+static int tftp_recv_file(char *filename, char *hostname, char binary_on,
+		size_t blksize, unsigned int windowsize, char *local) {
+	int ret;
 	struct sockaddr_storage remote_addr;
 	socklen_t remote_addr_len;
-	FILE *fp = NULL;
-	struct tftp_msg snd, rcv;
-	size_t snd_len, rcv_len = 0, data_len;
-	uint16_t pkg_number;
+	struct tftp_conn conn;
+	size_t rcv_len;
+
+	ret = tftp_conn_init(&conn, blksize);
+	if (ret != 0) return ret;
 
 	ret = make_remote_addr(hostname,
 			(struct sockaddr *)&remote_addr, &remote_addr_len);
-	if (ret != 0) { sock = -1; fp = NULL; goto error; }
-
-	ret = open_socket(&sock, (struct sockaddr *)&remote_addr,
-			remote_addr_len);
-	if (ret != 0) { sock = -1; fp = NULL; goto error; }
+	if (ret != 0) goto error;
 
-	ret = open_file(filename, get_file_mode_w(binary_on), &fp);
-	if (ret != 0) { fp = NULL; goto error; }
+	ret = open_socket(&conn.sock);
+	if (ret != 0) goto error;
 
-	pkg_number = 0;
+	ret = open_file(local ? local : filename, get_file_mode_w(binary_on), &conn.fp);
+	if (ret != 0) goto error;
 
-	ret = tftp_build_msg_cmd(&snd, &snd_len, RRQ, filename, get_transfer_mode(binary_on));
+	ret = tftp_build_request(&conn, RRQ, filename, binary_on, blksize,
+			windowsize, 0);
 	if (ret != 0) goto error;
 
-	/* Send Write Request */
-	goto send_msg;
+	/* Send Read Request */
+	ret = tftp_client_request(&conn, (struct sockaddr_in *)&remote_addr, &rcv_len);
+	if (ret != 0) goto error;
 
-	do {
-		/* receive reply */
-		ret = tftp_msg_recv(&rcv, &rcv_len, sock);
+	switch (ntohs(conn.in->opcode)) {
+	case OACK:
+		ret = tftp_parse_oack(&conn, rcv_len, blksize, windowsize);
+		if (ret != 0) {
+			tftp_send_error(&conn, TFTP_EBADOPT, "bad option");
+			goto error;
+		}
+		/* ACK 0 confirms the options and starts the transfer */
+		tftp_build_msg_ack((struct tftp_msg *)conn.ctl, &conn.ctl_len, 0);
+		ret = tftp_ctl_send(&conn);
 		if (ret != 0) goto error;
+		rcv_len = 0;
+		break;
+	case DATA:
+		break; /* server without options, the first block is here */
+	case ERROR:
+		tftp_print_error(conn.in, hostname);
+		ret = -ECONNABORTED;
+		goto error;
+	default:
+		ret = -EINVAL;
+		goto error;
+	}
 
-		/* check message length */
-		if (!msg_with_correct_len(&rcv, rcv_len)) goto send_msg; /* bad packet, send again */
+	ret = tftp_recv_blocks(&conn, rcv_len, hostname, 0);
+	if (ret != 0) goto error;
 
-		/* handling of the reply msg */
-		switch (ntohs(rcv.opcode)) {
-		case DATA:
-			if (ntohs(rcv.op.ack.block_num) != pkg_number + 1) {
-				goto send_msg; /* invalid data package, send again */
+	if ((conn.tsize >= 0) && (conn.bytes != (size_t)conn.tsize)) {
+		fprintf(stderr, "%s: warning: got %zu bytes of %ld\n",
+				hostname, conn.bytes, conn.tsize);
+	}
+
+	ret = close_file(conn.fp);
+	conn.fp = NULL;
+	if (ret != 0) goto error;
+
+	ret = close_socket(conn.sock);
+	conn.sock = -1;
+	if (ret != 0) goto error;
+
+	fprintf(stdout, "File '%s` was transferred (%zu bytes)\n", filename, conn.bytes);
+
+error:
+	tftp_conn_fini(&conn);
+	return ret;
+}
+
+/*
+ * Picks the options of a request the server supports and builds the OACK.
+ * Returns 0 if there is nothing to acknowledge.
+ */
+static int tftp_server_opts(struct tftp_conn *conn, char *opts, size_t opts_len,
+		uint16_t type, size_t *blksize) {
+	struct tftp_msg *oack = (struct tftp_msg *)conn->ctl;
+	char *name, *value, *end;
+	long val;
+	int found;
+
+	oack->opcode = htons(OACK);
+	conn->ctl_len = sizeof oack->opcode;
+	found = 0;
+
+	end = opts + opts_len;
+	for (name = opts; name < end; name = value + strlen(value) + 1) {
+		value = name + strlen(name) + 1;
+		val = strtol(value, NULL, 10);
+
+		if (0 == strcasecmp(name, "blksize")) {
+			if (val < TFTP_BLKSIZE_MIN) {
+				continue;
+			}
+			*blksize = val < TFTP_BLKSIZE_MAX ? val : TFTP_BLKSIZE_MAX;
+			val = *blksize;
+		} else if (0 == strcasecmp(name, "windowsize")) {
+			if (val < 1) {
+				continue;
+			}
+			conn->windowsize = val < TFTP_WINDOWSIZE_MAX ? val : TFTP_WINDOWSIZE_MAX;
+			val = conn->windowsize;
+		} else if (0 == strcasecmp(name, "tsize")) {
+			if (type == RRQ) {
+				val = file_size(conn->fp);
+				if (val < 0) {
+					continue;
+				}
+			}
+			conn->tsize = val;
+		} else {
+			continue; /* unknown options are just not acknowledged */
+		}
+
+		if (0 != tftp_msg_add_opt(oack, &conn->ctl_len, name, val)) {
+			return -ENAMETOOLONG;
+		}
+		found = 1;
+	}
+
+	return found;
+}
+
+/* Waits for ACK 0 to the OACK of a read request */
+static int tftp_server_wait_ack0(struct tftp_conn *conn, const char *peer) {
+	size_t rcv_len;
+	int ret, retries;
+
+	for (retries = 0; retries <= TFTP_RETRIES; ) {
+		ret = tftp_ctl_send(conn);
+		if (ret != 0) return ret;
+
+		ret = tftp_msg_recv(conn->in, conn->in_sz, &rcv_len, conn->sock, NULL);
+		if (ret == -ETIMEDOUT) {
+			retries++;
+			continue;
+		}
+		if (ret != 0) return ret;
+
+		if (!msg_with_correct_len(conn->in, rcv_len)) continue;
+
+		switch (ntohs(conn->in->opcode)) {
+		case ACK:
+			if (ntohs(conn->in->op.ack.block_num) == 0) {
+				return 0;
 			}
-			/* save data */
-			data_len = rcv_len - (sizeof rcv - sizeof rcv.op.data.stuff);
-			ret = write_file(fp, &rcv.op.data.stuff[0], data_len);
-			if (ret != 0) goto error;
 			break;
 		case ERROR:
-			fprintf(stderr, "%s: error: code=%d, msg='%s`\n",
-				hostname, (int)ntohs(rcv.op.err.error_code), &rcv.op.err.error_msg[0]);
-			goto error;
+			tftp_print_error(conn->in, peer);
+			return -ECONNABORTED;
 		default:
-			goto send_msg;
+			break;
 		}
+	}
 
-		/* send ack */
-		ret = tftp_build_msg_ack(&snd, &snd_len, ++pkg_number);
-		if (ret != 0) goto error;
+	return -ETIMEDOUT;
+}
 
-send_msg:
-		/* send request / ack */
-		ret = tftp_msg_send(&snd, snd_len, sock);
-		if (ret != 0) goto error;
+/* A relative path without ".." components, so it stays in the server root */
+static int tftp_path_is_safe(const char *name) {
+	const char *comp;
 
-		/* whether we get more data? */
-	} while ((pkg_number == 0) || (rcv_len == sizeof rcv));
+	if ((*name == '\0') || (*name == '/')) {
+		return 0;
+	}
 
-	ret = close_file(fp);
-	if (ret != 0) {
-		fp = NULL;
-		goto error;
+	for (comp = name; comp; comp = strchr(comp, '/')) {
+		if (*comp == '/') {
+			comp++;
+		}
+		if ((comp[0] == '.') && (comp[1] == '.')
+				&& ((comp[2] == '/') || (comp[2] == '\0'))) {
+			return 0;
+		}
 	}
 
-	ret = close_socket(sock);
-	if (ret != 0) {
-		sock = -1;
-		fp = NULL;
-		goto error;
+	return 1;
+}
+
+static int tftp_serve(struct tftp_msg *req, size_t req_len,
+		struct sockaddr_in *client, const char *root, int writable) {
+	struct tftp_conn conn;
+	char path[PATH_MAX];
+	char *filename, *mode, *opts, *peer;
+	uint16_t type;
+	size_t blksize;
+	char binary_on;
+	int ret, has_opts;
+
+	type = ntohs(req->opcode);
+	filename = &req->op.cmd.name_and_mode[0];
+	mode = filename + strlen(filename) + 1;
+	opts = mode + strlen(mode) + 1;
+	peer = inet_ntoa(client->sin_addr);
+	binary_on = 0 != strcasecmp(mode, "netascii");
+
+	ret = tftp_conn_init(&conn, SEGSIZE);
+	if (ret != 0) return ret;
+
+	/* a new port is the transfer ID of the server */
+	ret = open_socket(&conn.sock);
+	if (ret != 0) goto out;
+	if (-1 == connect(conn.sock, (struct sockaddr *)client, sizeof *client)) {
+		ret = -errno;
+		goto out;
 	}
 
-	fprintf(stdout, "File '%s` was transferred\n", filename);
+	if ((type != RRQ) && (type != WRQ)) {
+		tftp_send_error(&conn, TFTP_EBADOP, "illegal operation");
+		ret = -EINVAL;
+		goto out;
+	}
 
-	return 0;
+	if ((type == WRQ) && !writable) {
+		tftp_send_error(&conn, TFTP_EACCESS, "writing is not allowed");
+		ret = -EACCES;
+		goto out;
+	}
 
-error:
-	if (sock >= 0) close(sock);
-	if (fp) fclose(fp);
+	if (!tftp_path_is_safe(filename)
+			|| (snprintf(path, sizeof path, "%s/%s", root, filename)
+				>= sizeof path)) {
+		tftp_send_error(&conn, TFTP_EACCESS, "access violation");
+		ret = -EACCES;
+		goto out;
+	}
+
+	if ((type == RRQ ? open_file(path, get_file_mode_r(binary_on), &conn.fp)
+			: open_file(path, get_file_mode_w(binary_on), &conn.fp)) != 0) {
+		tftp_send_error(&conn, type == RRQ ? TFTP_ENOTFOUND : TFTP_EACCESS,
+				strerror(errno));
+		ret = -ENOENT;
+		goto out;
+	}
+
+	blksize = SEGSIZE;
+	has_opts = tftp_server_opts(&conn, opts, (char *)req + req_len - opts,
+			type, &blksize);
+	if (has_opts < 0) {
+		ret = has_opts;
+		goto out;
+	}
+
+	if (blksize > SEGSIZE) {
+		/* buffers for the negotiated block size */
+		free(conn.in);
+		free(conn.out);
+		conn.in_sz = TFTP_DATA_HDR_SZ + blksize;
+		conn.in = malloc(conn.in_sz);
+		conn.out = malloc(conn.in_sz);
+		if ((conn.in == NULL) || (conn.out == NULL)) {
+			tftp_send_error(&conn, TFTP_ENOSPACE, "no memory");
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+	conn.blksize = blksize;
+
+	if (type == RRQ) {
+		if (has_opts && (0 != (ret = tftp_server_wait_ack0(&conn, peer)))) {
+			goto out;
+		}
+		ret = tftp_send_blocks(&conn, peer);
+	} else {
+		if (!has_opts) {
+			tftp_build_msg_ack((struct tftp_msg *)conn.ctl, &conn.ctl_len, 0);
+		}
+		/* OACK or ACK 0, it is resent until the first block comes */
+		ret = tftp_ctl_send(&conn);
+		if (ret == 0) {
+			ret = tftp_recv_blocks(&conn, 0, peer, 1);
+		}
+	}
+
+	fprintf(stdout, "%s: %s '%s` %s (%zu bytes)\n", peer,
+			type == RRQ ? "get" : "put", filename,
+			ret == 0 ? "done" : "failed", conn.bytes);
+
+out:
+	tftp_conn_fini(&conn);
+	return ret;
+}
+
+static int tftp_server(const char *root, int writable) {
+	int ret, sock;
+	struct sockaddr_in addr, last;
+	socklen_t addr_len;
+	char req_buf[PKTSIZE];
+	struct tftp_msg *req = (struct tftp_msg *)req_buf;
+	ssize_t req_len;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock == -1) {
+		perror("tftp: socket() failure");
+		return -errno;
+	}
+
+	memset(&addr, 0, sizeof addr);
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(TFTP_TRANSFER_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (-1 == bind(sock, (struct sockaddr *)&addr, sizeof addr)) {
+		perror("tftp: bind() failure");
+		close(sock);
+		return -errno;
+	}
+
+	memset(&last, 0, sizeof last);
+
+	/* transfers are served one at a time */
+	while (1) {
+		addr_len = sizeof addr;
+		req_len = recvfrom(sock, req_buf, sizeof req_buf, 0,
+				(struct sockaddr *)&addr, &addr_len);
+		if (req_len == -1) {
+			if ((errno == EAGAIN) || (errno == EINTR)) {
+				continue;
+			}
+			ret = -errno;
+			perror("tftp: recvfrom() failure");
+			break;
+		}
+
+		if (!msg_with_correct_len(req, req_len)) {
+			continue;
+		}
+
+		/* Retransmitted requests queued while the session was served would
+		 * start it again (and truncate the file of a WRQ) */
+		if ((addr.sin_addr.s_addr == last.sin_addr.s_addr)
+				&& (addr.sin_port == last.sin_port)) {
+			continue;
+		}
+		last = addr;
+
+		tftp_serve(req, req_len, &addr, root, writable);
+	}
+
+	close(sock);
 	return ret;
 }
 
 int main(int argc, char **argv) {
 	int ret, i;
-	char param_ascii, param_binary, param_get, param_put;
-	int (*file_hnd)(char *, char *, char);
+	char param_ascii, param_binary, param_get, param_put, param_server;
+	char param_writable;
+	size_t blksize;
+	unsigned int windowsize;
+	char *local;
 
 	/* Initialize objects */
-	param_ascii = param_binary = param_get = param_put = 0;
+	param_ascii = param_binary = param_get = param_put = param_server = 0;
+	param_writable = 0;
+	blksize = TFTP_DEF_BLKSIZE;
+	windowsize = TFTP_DEF_WINDOWSIZE;
+	local = NULL;
 	getopt_init();
 
 	/* Get options */
-	while ((ret = getopt(argc, argv, "habgp")) != -1) {
+	while ((ret = getopt(argc, argv, "habgpswB:W:o:")) != -1) {
 		switch (ret) {
 		default:
 		case '?':
@@ -511,7 +1208,9 @@ int main(int argc, char **argv) {
 			fprintf(stderr, "Try -h for more information\n");
 			return -EINVAL;
 		case 'h':
-			fprintf(stdout, "Usage: %s [-hab] -[g|p] files destination\n", argv[0]);
+			fprintf(stdout, "Usage: %s [-hab] [-B blksize] [-W windowsize] "
+					"-[g|p] files destination\n", argv[0]);
+			fprintf(stdout, "       %s -s [-w] [root]\n", argv[0]);
 			return 0;
 		case 'a':
 		case 'b':
@@ -531,9 +1230,38 @@ int main(int argc, char **argv) {
 			}
 			*(ret == 'g' ? &param_get : &param_put) = 1;
 			break;
+		case 's':
+			param_server = 1;
+			break;
+		case 'w':
+			param_writable = 1;
+			break;
+		case 'B':
+			blksize = strtoul(optarg, NULL, 0);
+			if ((blksize < TFTP_BLKSIZE_MIN) || (blksize > TFTP_BLKSIZE_MAX)) {
+				fprintf(stderr, "%s: error: blksize must be in %d..%d\n",
+						argv[0], TFTP_BLKSIZE_MIN, TFTP_BLKSIZE_MAX);
+				return -EINVAL;
+			}
+			break;
+		case 'W':
+			windowsize = strtoul(optarg, NULL, 0);
+			if ((windowsize < 1) || (windowsize > TFTP_WINDOWSIZE_MAX)) {
+				fprintf(stderr, "%s: error: windowsize must be in 1..%d\n",
+						argv[0], TFTP_WINDOWSIZE_MAX);
+				return -EINVAL;
+			}
+			break;
+		case 'o':
+			local = optarg;
+			break;
 		}
 	}
 
+	if (param_server) {
+		return tftp_server(optind < argc ? argv[optind] : ".", param_writable);
+	}
+
 	/* Check transfering mode options */
 	if (!param_ascii && !param_binary) {
 		param_binary = 1; /* default mode */
@@ -552,10 +1280,20 @@ int main(int argc, char **argv) {
 		return -EINVAL;
 	}
 
+	if (local && (!param_get || (argc - optind != 2))) {
+		fprintf(stderr, "%s: error: -o is for getting a single file\n", argv[0]);
+		return -EINVAL;
+	}
+
 	/* Handling */
-	file_hnd = param_get ? &tftp_recv_file : &tftp_send_file;
 	for (i = optind; i < argc - 1; ++i) {
-		ret = (*file_hnd)(argv[i], argv[argc - 1], param_binary);
+		if (param_get) {
+			ret = tftp_recv_file(argv[i], argv[argc - 1], param_binary,
+					blksize, windowsize, local);
+		} else {
+			ret = tftp_send_file(argv[i], argv[argc - 1], param_binary,
+					blksize, windowsize);
+		}
 		if (ret != 0) {
 			fprintf(stderr, "%s: error: error occured when handled file '%s`\n",
 					argv[0], argv[i]);
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @brief Hardware performance counters control
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <hal/pmu.h>
+#include <kernel/sched.h>
+#include <kernel/task.h>
+#include <kernel/thread.h>
+
+#include <profiler/pmu/pmu_profiler.h>
+
+#define PMU_SAMPLE_PERIOD 100000
+
+static void print_usage(void) {
+	printf("Usage: pmu [-h] [-l] [-c ev[,ev...]] [-s ev -p period] [-t]\n");
+}
+
+static int event_lookup(const char *name, enum pmu_event *ev) {
+	int i;
+
+	for (i = 0; i < PMU_EV_TOTAL; i++) {
+		if (!strcmp(name, pmu_event_name(i))) {
+			*ev = i;
+			return 0;
+		}
+	}
+
+	printf("Unknown event: %s\n", name);
+	return -EINVAL;
+}
+
+static void print_list(void) {
+	int i;
+
+	printf("%d counters\n", pmu_counters_total());
+	for (i = 0; i < PMU_EV_TOTAL; i++) {
+		printf("\t%s\n", pmu_event_name(i));
+	}
+}
+
+static void print_stat(void) {
+	enum pmu_event ev[PMU_EV_TOTAL];
+	struct task *task;
+	struct thread *t;
+	int i, n;
+
+	n = pmu_count_events(ev);
+	if (n == 0) {
+		printf("Counting is not started\n");
+		return;
+	}
+
+	printf(" %4s %4s", "pid", "tid");
+	for (i = 0; i < n; i++) {
+		printf(" %16s", pmu_event_name(ev[i]));
+	}
+	printf("\n");
+
+	sched_lock();
+	{
+		task_foreach(task) {
+			task_foreach_thread(t, task) {
+				printf(" %4d %4d", task_get_id(t->task), t->id);
+				for (i = 0; i < n; i++) {
+					printf(" %16llu", pmu_count_thread(t, i));
+				}
+				printf("\n");
+			}
+		}
+	}
+	sched_unlock();
+}
+
+static int start_count(char *list) {
+	enum pmu_event ev[PMU_EV_TOTAL];
+	char *name;
+	int n = 0;
+
+	for (name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+		if (n == PMU_EV_TOTAL || event_lookup(name, &ev[n])) {
+			return -EINVAL;
+		}
+		n++;
+	}
+
+	return pmu_count_start(ev, n);
+}
+
+int main(int argc, char **argv) {
+	enum pmu_event sample_ev = PMU_EV_CYCLES;
+	unsigned long period = PMU_SAMPLE_PERIOD;
+	int opt, sample = 0, res = 0;
+
+	getopt_init();
+
+	while (-1 != (opt = getopt(argc, argv, "hlc:s:p:t"))) {
+		switch (opt) {
+		case 'h':
+			print_usage();
+			return 0;
+		case 'l':
+			print_list();
+			return 0;
+		case 'c':
+			res = start_count(optarg);
+			if (res) {
+				printf("Can't start counting: %d\n", res);
+				return res;
+			}
+			break;
+		case 's':
+			if (event_lookup(optarg, &sample_ev)) {
+				return -EINVAL;
+			}
+			sample = 1;
+			break;
+		case 'p':
+			period = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			pmu_sample_stop();
+			pmu_count_stop();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	if (sample) {
+		res = pmu_sample_start(sample_ev, period);
+		if (res) {
+			printf("Can't start sampling: %d\n", res);
+		}
+		return res;
+	}
+
+	if (argc == 1) {
+		print_stat();
+	}
+
+	return res;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief Control ring buffer tracing and export its records
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <profiler/tracing/ring_trace.h>
+
+static void print_usage(void) {
+	printf("Usage: rtrace [-e | -d] [-o file | -c addr:port] "
+			"[-n rounds] [-i ms]\n");
+}
+
+static int open_file(const char *name, int *with_header) {
+	int fd;
+
+	fd = open(name, O_WRONLY | O_CREAT | O_APPEND, 0666);
+	if (fd < 0) {
+		return -errno;
+	}
+
+	/* Header goes only at the beginning of the file */
+	*with_header = lseek(fd, 0, SEEK_END) == 0;
+
+	return fd;
+}
+
+static int open_peer(char *peer) {
+	struct sockaddr_in dst;
+	char *port;
+	int sock;
+
+	port = strchr(peer, ':');
+	if (!port) {
+		return -EINVAL;
+	}
+	*port++ = '\0';
+
+	memset(&dst, 0, sizeof(dst));
+	dst.sin_family = AF_INET;
+	dst.sin_port = htons(atoi(port));
+	if (!inet_aton(peer, &dst.sin_addr)) {
+		return -EINVAL;
+	}
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (connect(sock, (struct sockaddr *) &dst, sizeof(dst)) < 0) {
+		close(sock);
+		return -errno;
+	}
+
+	return sock;
+}
+
+int main(int argc, char **argv) {
+	int opt, fd = -1, with_header = 1, rounds = 1, interval = 100;
+	int res, total = 0;
+
+	getopt_init();
+
+	while (-1 != (opt = getopt(argc, argv, "hedo:c:n:i:"))) {
+		switch (opt) {
+		case 'e':
+			ring_trace_enable();
+			break;
+		case 'd':
+			ring_trace_disable();
+			break;
+		case 'o':
+			fd = open_file(optarg, &with_header);
+			break;
+		case 'c':
+			fd = open_peer(optarg);
+			break;
+		case 'n':
+			rounds = atoi(optarg);
+			break;
+		case 'i':
+			interval = atoi(optarg);
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+
+		if ((opt == 'o' || opt == 'c') && fd < 0) {
+			printf("Can't open %s: %s\n", optarg, strerror(-fd));
+			return fd;
+		}
+	}
+
+	if (fd < 0) {
+		return 0;
+	}
+
+	while (rounds-- > 0) {
+		res = ring_trace_stream(fd, with_header);
+		if (res < 0) {
+			printf("Write failed: %s\n", strerror(-res));
+			break;
+		}
+
+		with_header = 0;
+		total += res;
+
+		if (rounds) {
+			usleep(interval * 1000);
+		}
+	}
+
+	close(fd);
+
+	printf("%d records written, %u lost\n", total, ring_trace_lost());
+
+	return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @brief Report raw sampling profiler data in folded-stack format
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <debug/symbol.h>
+#include <profiler/sampling/raw_sample.h>
+
+typedef enum {START_PROFILING, STOP_PROFILING, RESET, SHOW_INFO} action;
+
+static void print_usage(void) {
+	printf(	"Flags:\n"
+			"-h print usage\n"
+			"-s start profiling (restart if already running)\n"
+			"-t stop profiler (do not discard information)\n"
+			"-r discard collected samples\n"
+			"-i set custom timer interval\n"
+			"-o write report to file\n");
+}
+
+static void print_frame(FILE *out, void *pc) {
+	const struct symbol *s;
+
+	s = symbol_lookup(pc);
+	if (s) {
+		fputs(s->name, out);
+	} else {
+		fprintf(out, "%p", pc);
+	}
+}
+
+static void print_folded(void *const *pc, int depth, unsigned int count,
+		void *arg) {
+	FILE *out = arg;
+	int i;
+
+	/* Folded format lists the outermost frame first */
+	for (i = depth - 1; i >= 0; i--) {
+		print_frame(out, pc[i]);
+		fputc(i ? ';' : ' ', out);
+	}
+
+	fprintf(out, "%u\n", count);
+}
+
+int main(int argc, char **argv) {
+	int opt, interval = 0;
+	const char *out_name = NULL;
+	action act = SHOW_INFO;
+	FILE *out;
+
+	getopt_init();
+
+	while ((opt = getopt(argc, argv, "hstri:o:")) != -1) {
+		switch (opt) {
+		case 'i':
+			if (1 != sscanf(optarg, "%d", &interval)) {
+				printf("Wrong argument, integer value for \"-i\" expected.\n");
+				return -EINVAL;
+			}
+			break;
+		case 'o':
+			out_name = optarg;
+			break;
+		case 's':
+			act = START_PROFILING;
+			break;
+		case 't':
+			act = STOP_PROFILING;
+			break;
+		case 'r':
+			act = RESET;
+			break;
+		case 'h':
+			print_usage();
+			return 0;
+		default:
+			print_usage();
+			return -EINVAL;
+		}
+	}
+
+	switch (act) {
+	case START_PROFILING:
+		printf("%s profiler...\n",
+				sample_raw_is_running() ? "Restarting" : "Starting");
+		return sample_raw_start(interval);
+	case STOP_PROFILING:
+		if (!sample_raw_is_running()) {
+			printf("Profiler is not running!\n");
+			return 0;
+		}
+		printf("Stopping profiler...\n");
+		return sample_raw_stop();
+	case RESET:
+		sample_raw_reset();
+		return 0;
+	case SHOW_INFO:
+		break;
+	}
+
+	out = stdout;
+	if (out_name) {
+		out = fopen(out_name, "w");
+		if (!out) {
+			printf("Can't open %s\n", out_name);
+			return -errno;
+		}
+	}
+
+	sample_raw_for_each(print_folded, out);
+
+	if (out != stdout) {
+		fclose(out);
+	}
+
+	/* Not a part of the folded-stack data */
+	if (sample_raw_dropped()) {
+		fprintf(stderr, "%u samples dropped\n", sample_raw_dropped());
+	}
+
+	return 0;
+}
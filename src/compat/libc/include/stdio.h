@@ -168,6 +168,19 @@ extern size_t fwrite(const void *ptr, size_t size, size_t nmemb, FILE *stream);
  */
 extern size_t fread(void *ptr, size_t size, size_t nmemb, FILE *stream);
 
+/* The same without taking the stream lock, see flockfile() */
+extern size_t fwrite_unlocked(const void *ptr, size_t size, size_t nmemb,
+		FILE *stream);
+extern size_t fread_unlocked(void *ptr, size_t size, size_t nmemb,
+		FILE *stream);
+
+/**
+ * Lock the stream for a sequence of operations done by one thread.
+ */
+extern void flockfile(FILE *stream);
+extern int ftrylockfile(FILE *stream);
+extern void funlockfile(FILE *stream);
+
 /**
  * Function will flushes the stream pointed to by fp (writing any buffered
  * output data using fflush(3)) and closes the underlying file descriptor.
@@ -9,6 +9,7 @@
 #include "file_struct.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 int setvbuf(FILE *stream, char *buf, int mode, size_t size) {
 
@@ -17,9 +18,24 @@ int setvbuf(FILE *stream, char *buf, int mode, size_t size) {
 	}
 
 	fflush(stream);
+	stdio_buf_free(stream);
+	stream->buf_adaptive = 0;
+
+	if (mode == _IONBF) {
+		buf = NULL;
+		size = 0;
+	} else if (buf == NULL) {
+		if (size == 0) {
+			size = BUFSIZ;
+		}
+		if (NULL == (buf = stream->mbuf = malloc(size))) {
+			return -1;
+		}
+	}
 
-	stream->obuf = buf;
-	stream->obuf_sz = size;
+	stream->buftype = mode;
+	stream->obuf = stream->ibuf = buf;
+	stream->obuf_sz = stream->ibuf_sz = size;
 	stream->obuf_len = 0;
 
 	return 0;
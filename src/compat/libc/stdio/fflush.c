@@ -6,17 +6,33 @@
  * @date    24.11.2014
  */
 
-#include <fcntl.h>
 #include "file_struct.h"
 
 #include <stdio.h>
 
-extern int libc_ob_forceflush(FILE *file);
+static void stdio_flush_one(FILE *stream) {
+	fflush(stream);
+}
 
 int fflush(FILE *stream) {
+	int locked;
+
+	if (stream == NULL) {
+		/* Standard streams are not in the list of opened ones */
+		fflush(stdout);
+		fflush(stderr);
+		stdio_task_files_foreach(stdio_flush_one);
+		return 0;
+	}
 
-	if (stream->flags & O_WRONLY) {
+	locked = stdio_lock(stream);
+	if (stream->obuf_len) {
 		libc_ob_forceflush(stream);
 	}
+	if (stream->ibuf_len) {
+		stdio_ib_drop(stream);
+	}
+	stdio_unlock(stream, locked);
+
 	return 0;
 }
@@ -10,6 +10,10 @@
 #define STDIO_FILE_STRUCT_H_
 
 #include <stdio.h>
+#include <kernel/thread/sync/mutex.h>
+#include <util/dlist.h>
+
+struct task;
 
 struct file_struct {
 	int fd;
@@ -27,8 +31,33 @@ struct file_struct {
 	void *obuf;
 	int obuf_sz;
 	int obuf_len;
+
+	/* Read buffer, bytes from ibuf_pos to ibuf_len are not consumed yet.
+	 * For buffered files it shares memory with obuf, only one of them
+	 * holds data at a time. */
+	char *ibuf;
+	int ibuf_sz;
+	int ibuf_pos;
+	int ibuf_len;
+
+	void *mbuf;        /* buffer allocated by stdio, freed on fclose() */
+	char buf_adaptive; /* buffer is chosen on the first read or write */
+
+	struct task *owner; /* task which opened the stream, NULL for std ones */
+	struct mutex lock;
+	struct dlist_head lnk; /* in the list of opened streams */
 };
 
 extern int funopen_check(FILE *f);
 
+extern void stdio_task_files_foreach(void (*fn)(FILE *file));
+
+extern void stdio_buf_adapt(FILE *file);
+extern void stdio_buf_free(FILE *file);
+extern void stdio_ib_drop(FILE *file);
+extern int libc_ob_forceflush(FILE *file);
+
+extern int stdio_lock(FILE *file);
+extern void stdio_unlock(FILE *file, int locked);
+
 #endif /* STDIO_FILE_STRUCT_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief Per-FILE locking
+ *
+ * @date 17.10.2026
+ */
+
+#include <kernel/task.h>
+#include <kernel/thread.h>
+#include <util/dlist.h>
+#include "file_struct.h"
+
+#include <stdio.h>
+
+/*
+ * A stream opened by a task with a single thread can't be accessed
+ * concurrently, so the lock is skipped. Standard streams are shared by all
+ * tasks and always locked. The caller gets back whether the lock was taken,
+ * since the task may start a thread before the unlock.
+ */
+int stdio_lock(FILE *file) {
+	struct task *tsk = task_self();
+
+	if ((file->owner == tsk)
+			&& dlist_empty(&task_get_main(tsk)->thread_link)) {
+		return 0;
+	}
+
+	mutex_lock(&file->lock);
+	return 1;
+}
+
+void stdio_unlock(FILE *file, int locked) {
+	if (locked) {
+		mutex_unlock(&file->lock);
+	}
+}
+
+void flockfile(FILE *file) {
+	mutex_lock(&file->lock);
+}
+
+int ftrylockfile(FILE *file) {
+	return mutex_trylock(&file->lock);
+}
+
+void funlockfile(FILE *file) {
+	mutex_unlock(&file->lock);
+}
@@ -92,6 +92,11 @@ FILE *freopen(const char *path, const char *mode, FILE *file) {
 	}
 	old_fd = file->fd;
 
+	libc_ob_forceflush(file);
+	stdio_buf_free(file);
+	file->buf_adaptive = 1;
+	file->has_ungetc = 0;
+
 	dup2(fd, old_fd);
 	file->flags = flags;
 
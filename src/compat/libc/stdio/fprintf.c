@@ -23,6 +23,14 @@ static void file_printchar(struct printchar_handler_data *d, int c) {
 	fputc(c, d->file);
 }
 
+static void file_printstr(struct printchar_handler_data *d,
+		const char *s, size_t n) {
+	assert(d != NULL);
+	assert(d->file != NULL);
+
+	fwrite(s, 1, n, d->file);
+}
+
 int vfprintf(FILE *file, const char *format, va_list args) {
 	struct printchar_handler_data data;
 
@@ -31,7 +39,7 @@ int vfprintf(FILE *file, const char *format, va_list args) {
 
 	data.file = file;
 
-	return __print(file_printchar, &data, format, args);
+	return __print_bulk(file_printchar, file_printstr, &data, format, args);
 }
 
 int fprintf(FILE *file, const char *format, ...) {
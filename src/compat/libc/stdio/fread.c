@@ -7,44 +7,80 @@
 
 #include <errno.h>
 #include <stddef.h>
+#include <string.h>
 #include <unistd.h>
+#include <util/math.h>
 #include "file_struct.h"
 
 #include <stdio.h>
 
-size_t fread(void *buf, size_t size, size_t count, FILE *file) {
-	char *cbuff;
-	size_t cnt;
+static int libc_read(FILE *file, void *buf, size_t len) {
+	int ret;
+
+	if (funopen_check(file)) {
+		if (file->readfn) {
+			ret = file->readfn((void *) file->cookie, buf, len);
+		} else {
+			ret = 0;
+		}
+	} else {
+		ret = read(file->fd, buf, len);
+	}
+
+	return ret;
+}
+
+size_t fread_unlocked(void *buf, size_t size, size_t count, FILE *file) {
+	char *cbuf = buf;
+	size_t len, cnt, n;
+	int ret;
 
 	if (NULL == file) {
 		SET_ERRNO(EBADF);
-		return -1;
+		return 0;
+	}
+
+	len = size * count;
+	if (len == 0) {
+		return 0;
 	}
 
 	cnt = 0;
 	if (file->has_ungetc) {
 		file->has_ungetc = 0;
-		cbuff = buf;
-		cbuff[0] = (char)file->ungetc;
-		count --;
-		buf = &cbuff[1];
-		cnt++;
-	}
-	while (cnt != count * size) {
-		int ret;
-		if (funopen_check(file)) {
-			if (file->readfn) {
-				ret = file->readfn((void *) file->cookie, buf, size * count);
-			} else {
-				ret = 0;
+		cbuf[cnt++] = (char)file->ungetc;
+	}
+
+	stdio_buf_adapt(file);
+	if (file->obuf_len) {
+		libc_ob_forceflush(file);
+	}
+
+	while (cnt != len) {
+		if (file->ibuf_pos != file->ibuf_len) {
+			n = min(file->ibuf_len - file->ibuf_pos, len - cnt);
+			memcpy(cbuf + cnt, file->ibuf + file->ibuf_pos, n);
+			file->ibuf_pos += n;
+			cnt += n;
+			continue;
+		}
+
+		if ((file->ibuf == NULL) || (len - cnt >= file->ibuf_sz)) {
+			/* Large reads go straight to the caller's memory */
+			ret = libc_read(file, cbuf + cnt, len - cnt);
+			if (ret <= 0) {
+				break; /* errors */
 			}
-		} else {
-			ret = read(file->fd,  buf, size * count);
+			cnt += ret;
+			continue;
 		}
+
+		ret = libc_read(file, file->ibuf, file->ibuf_sz);
 		if (ret <= 0) {
 			break; /* errors */
 		}
-		cnt += ret;
+		file->ibuf_pos = 0;
+		file->ibuf_len = ret;
 	}
 	if (cnt % size) {
 		/* try to revert some bytes */
@@ -53,3 +89,19 @@ size_t fread(void *buf, size_t size, size_t count, FILE *file) {
 
 	return cnt / size;
 }
+
+size_t fread(void *buf, size_t size, size_t count, FILE *file) {
+	size_t ret;
+	int locked;
+
+	if (NULL == file) {
+		SET_ERRNO(EBADF);
+		return 0;
+	}
+
+	locked = stdio_lock(file);
+	ret = fread_unlocked(buf, size, count, file);
+	stdio_unlock(file, locked);
+
+	return ret;
+}
@@ -13,8 +13,25 @@
 #include <unistd.h>
 #include "file_struct.h"
 
+/* The position the user sees, counting bytes held in the buffers */
+static off_t stdio_tell(FILE *file) {
+	off_t pos;
+	int locked;
+
+	locked = stdio_lock(file);
+	pos = lseek(file->fd, 0L, SEEK_CUR);
+	if (pos != (off_t)-1) {
+		pos += file->obuf_len - (file->ibuf_len - file->ibuf_pos)
+				- file->has_ungetc;
+	}
+	stdio_unlock(file, locked);
+
+	return pos;
+}
+
 int fseek(FILE *file, long int offset, int origin) {
 	off_t ret;
+	int locked;
 
 	if (origin != SEEK_SET && origin != SEEK_CUR
 			&& origin != SEEK_END) {
@@ -27,7 +44,16 @@ int fseek(FILE *file, long int offset, int origin) {
 		return -1;
 	}
 
+	locked = stdio_lock(file);
+	fflush(file);
+	if (origin == SEEK_CUR) {
+		/* Relative to the position the user sees, before the pushed back byte */
+		offset -= file->has_ungetc;
+	}
+	file->has_ungetc = 0;
 	ret = lseek(file->fd, offset, origin);
+	stdio_unlock(file, locked);
+
 	if (ret == (off_t)-1) {
 		return -1;
 	}
@@ -44,7 +70,7 @@ long int ftell(FILE *file) {
 		SET_ERRNO(EBADF);
 		return -1;
 	}
-	return lseek(file->fd, 0L, SEEK_CUR);
+	return stdio_tell(file);
 }
 
 off_t ftello(FILE *file) {
@@ -59,7 +85,7 @@ int fgetpos(FILE *stream, fpos_t *pos) {
 		return -1;
 	}
 
-	mypos = lseek(stream->fd, 0L, SEEK_CUR);
+	mypos = stdio_tell(stream);
 
 	if (-1 == mypos) {
 		return -1;
@@ -71,19 +97,12 @@ int fgetpos(FILE *stream, fpos_t *pos) {
 }
 
 int fsetpos(FILE *stream, const fpos_t *pos) {
-	off_t ret;
-
 	if (NULL == stream) {
 		SET_ERRNO(EBADF);
 		return -1;
 	}
 
-	ret = lseek(stream->fd, *pos, SEEK_SET);
-	if (ret == (off_t)-1) {
-		return -1;
-	}
-
-	return 0;
+	return fseek(stream, *pos, SEEK_SET);
 }
 
 void rewind(FILE *file) {
@@ -29,19 +29,38 @@ static int libc_write(FILE *file, const void *buf, size_t len) {
 	return ret;
 }
 
+/* Writes until all is written or an error. @return bytes written */
+static size_t libc_write_all(FILE *file, const void *buf, size_t len) {
+	size_t done;
+	int ret;
+
+	for (done = 0; done < len; done += ret) {
+		ret = libc_write(file, buf + done, len - done);
+		if (ret <= 0) {
+			break;
+		}
+	}
+
+	return done;
+}
+
 static int libc_ob_check(FILE *file) {
 	return file->obuf != NULL ? 0 : -1;
 }
 
+/* On a short write the rest stays in the buffer */
 int libc_ob_forceflush(FILE *file) {
-	int err;
+	size_t done;
 
 	if (0 > libc_ob_check(file)) {
 		return 0;
 	}
 
-	if (0 > (err = libc_write(file, file->obuf, file->obuf_len))) {
-		return err;
+	done = libc_write_all(file, file->obuf, file->obuf_len);
+	if (done < file->obuf_len) {
+		file->obuf_len -= done;
+		memmove(file->obuf, file->obuf + done, file->obuf_len);
+		return -1;
 	}
 
 	file->obuf_len = 0;
@@ -49,102 +68,101 @@ int libc_ob_forceflush(FILE *file) {
 	return 0;
 }
 
-static int libc_ob_tryflush(FILE *file) {
-
-	if (file->obuf_len == file->obuf_sz) {
-		return libc_ob_forceflush(file);
-	}
-
-	return 0;
-}
-
-static int libc_ob_add(FILE *file, const void *buf, size_t len) {
-	const void *cbuf = buf;
-	int clen = len;
-	int err;
+/* @return bytes of @a buf written or buffered */
+static size_t libc_ob_add(FILE *file, const void *buf, size_t len) {
+	size_t done = 0;
 
 	if (0 > libc_ob_check(file)) {
-		return libc_write(file, buf, len);
+		return libc_write_all(file, buf, len);
 	}
 
 	/* have in buffer */
 	if (file->obuf_len) {
-		const int appendlen = min(file->obuf_sz - file->obuf_len, len);
-
-		memcpy(file->obuf + file->obuf_len, cbuf, appendlen);
+		done = min(file->obuf_sz - file->obuf_len, len);
 
-		file->obuf_len += appendlen;
-		cbuf += appendlen;
-		clen -= appendlen;
+		memcpy(file->obuf + file->obuf_len, buf, done);
+		file->obuf_len += done;
 
-		if (0 > (err = libc_ob_tryflush(file))) {
-			return err;
+		if ((file->obuf_len == file->obuf_sz)
+				&& (0 > libc_ob_forceflush(file))) {
+			return done;
 		}
 	}
 	/* last unwritten */
-	if (clen > 0) {
-		const int fullob_n = clen / file->obuf_sz;
-		int i_fullob;
-
-		for (i_fullob = 0; i_fullob < fullob_n; ++i_fullob) {
-			libc_write(file, buf + i_fullob * file->obuf_sz, file->obuf_sz);
-		}
-
-		cbuf += fullob_n * file->obuf_sz;
-		clen -= fullob_n * file->obuf_sz;
-
-		file->obuf_len = clen;
-		memcpy(file->obuf, cbuf, clen);
+	if (len - done >= file->obuf_sz) {
+		/* Large writes go straight from the caller's memory */
+		return done + libc_write_all(file, buf + done, len - done);
+	}
+	if (len - done > 0) {
+		file->obuf_len = len - done;
+		memcpy(file->obuf, buf + done, len - done);
 	}
 
-	return 0;
+	return len;
 }
 
-static int libc_ob_line(FILE *file, const void *buf, size_t len) {
-	int err;
+static size_t libc_ob_line(FILE *file, const void *buf, size_t len) {
 	const void *nl = memrchr(buf, '\n', len);
+	size_t done;
 
 	if (nl) {
-		const int writelen = nl - buf + 1;
-		if (0 > (err = libc_ob_add(file, buf, writelen))) {
-			return err;
-		}
-		if (0 > (err = libc_ob_forceflush(file))) {
-			return err;
+		const size_t writelen = nl - buf + 1;
+
+		done = libc_ob_add(file, buf, writelen);
+		if ((done < writelen) || (0 > libc_ob_forceflush(file))) {
+			return done;
 		}
-		err = libc_ob_add(file, buf, len - writelen);
+		done += libc_ob_add(file, buf + writelen, len - writelen);
 	} else {
-		err = libc_ob_add(file, buf, len);
+		done = libc_ob_add(file, buf, len);
 	}
 
-	return err;
+	return done;
 }
 
-size_t fwrite(const void *buf, size_t size, size_t count, FILE *file) {
-	int i_block;
+size_t fwrite_unlocked(const void *buf, size_t size, size_t count,
+		FILE *file) {
+	size_t len, done;
 
 	if (NULL == file) {
 		errno = EBADF;
 		return 0;
 	}
 
-	for (i_block = 0; i_block < count; ++i_block) {
-		const void *block = buf + i_block * size;
-		int err;
+	len = size * count;
+	if (len == 0) {
+		return 0;
+	}
 
-		if (_IOLBF == file->buftype) {
-			err = libc_ob_line(file, block, size);
-		} else if (_IOFBF == file->buftype) {
-			err = libc_ob_add(file, block, size);
-		} else {
-			err = libc_write(file, block, size);
-		}
+	stdio_buf_adapt(file);
+	if (file->ibuf_len) {
+		stdio_ib_drop(file);
+	}
 
-		if (0 > err) {
-			errno = err;
-			return i_block;
-		}
+	if (_IOLBF == file->buftype) {
+		done = libc_ob_line(file, buf, len);
+	} else if (_IOFBF == file->buftype) {
+		done = libc_ob_add(file, buf, len);
+	} else {
+		done = libc_write_all(file, buf, len);
+	}
+
+	/* Only whole items count, errno is set by the failed write */
+	return done / size;
+}
+
+size_t fwrite(const void *buf, size_t size, size_t count, FILE *file) {
+	size_t ret;
+	int locked;
+
+	if (NULL == file) {
+		errno = EBADF;
+		return 0;
 	}
 
-	return count;
+	locked = stdio_lock(file);
+	ret = fwrite_unlocked(buf, size, count, file);
+	stdio_unlock(file, locked);
+
+	return ret;
 }
@@ -9,6 +9,8 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <float.h>
+#include <limits.h>
 #include <stddef.h>
 #include <math.h>
 #include <stdarg.h>
@@ -16,6 +18,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <util/math.h>
+#include <util/array.h>
 #include <framework/mod/options.h>
 
 #include "printf_impl.h"
@@ -56,49 +59,130 @@
 //#define PRINT_F_PREC_SHORTENED 4 /* shortened precision for real numbers */
 #define PRINT_F_PREC_DEFAULT   6 /* default precision for real numbers */
 
-static int print_s(void (*printchar_handler)(struct printchar_handler_data *d, int c),
-		struct printchar_handler_data *printchar_data,
+#define PRINT_ARG (-1) /* width or precision is given by an argument */
+
+#define PRINT_FMT_NEW     0
+#define PRINT_FMT_READY   1
+#define PRINT_FMT_DYNAMIC 2 /* too many conversions to keep them */
+
+struct print_out {
+	printchar_handler_t printchar;
+	printstr_handler_t printstr;
+	struct printchar_handler_data *data;
+};
+
+static void out_str(const struct print_out *out, const char *str, int len) {
+	if (len <= 0) {
+		return;
+	}
+
+	if (out->printstr) {
+		out->printstr(out->data, str, len);
+		return;
+	}
+
+	while (len--) out->printchar(out->data, *str++);
+}
+
+static void out_pad(const struct print_out *out, char ch, int count) {
+	static const char spaces[] = "                ";
+	static const char zeros[] = "0000000000000000";
+	const char *pad = ch == ' ' ? spaces : zeros;
+
+	for (; count > 0; count -= ARRAY_SIZE(spaces) - 1) {
+		out_str(out, pad, min(count, (int) ARRAY_SIZE(spaces) - 1));
+	}
+}
+
+static int print_s(const struct print_out *out,
 		const char *str, int width, int max_len, unsigned int ops) {
-	int pc, len, space_count;
+	int len, space_count;
 
-	assert(printchar_handler != NULL);
 	assert(str != NULL);
 	assert(width >= 0);
 	assert(max_len >= 0);
 
-	pc = 0;
-	len = strlen(str);
-	if (ops & OPS_PREC_IS_GIVEN) {
-		len = min(max_len, len);
-	}
+	len = (ops & OPS_PREC_IS_GIVEN) ? strnlen(str, max_len) : strlen(str);
 	space_count = width > len ? width - len : 0;
 
 	if (!(ops & OPS_FLAG_LEFT_ALIGN)) {
-		pc += space_count;
-		for (; space_count; --space_count) printchar_handler(printchar_data, ' ');
+		out_pad(out, ' ', space_count);
 	}
 
-	pc += len;
-	while (len--) printchar_handler(printchar_data, *str++);
+	out_str(out, str, len);
 
-	pc += space_count;
-	while (space_count--) printchar_handler(printchar_data, ' ');
+	if (ops & OPS_FLAG_LEFT_ALIGN) {
+		out_pad(out, ' ', space_count);
+	}
 
-	return pc;
+	return len + space_count;
+}
+
+static const char print_digit_pairs[200] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/* Writes decimal digits of @a u before @a end, two at a time */
+static char *print_u32_dec(char *end, uint32_t u) {
+	unsigned int r;
+
+	while (u >= 100) {
+		r = (u % 100) * 2;
+		u /= 100;
+		*--end = print_digit_pairs[r + 1];
+		*--end = print_digit_pairs[r];
+	}
+
+	if (u >= 10) {
+		*--end = print_digit_pairs[u * 2 + 1];
+		*--end = print_digit_pairs[u * 2];
+	} else {
+		*--end = '0' + u;
+	}
+
+	return end;
 }
 
-static int print_i(void (*printchar_handler)(struct printchar_handler_data *d, int c),
-		struct printchar_handler_data *printchar_data, unsigned long long int u,
+/* 64-bit division is a library call on 32-bit targets, so the value is
+ * split into parts of 9 digits handled in 32 bits */
+static char *print_ull_dec(char *end, unsigned long long int u) {
+	char *str;
+
+	while (u > UINT32_MAX) {
+		str = print_u32_dec(end, u % 1000000000);
+		end -= 9;
+		while (str > end) *--str = '0';
+		u /= 1000000000;
+	}
+
+	return print_u32_dec(end, u);
+}
+
+static char *print_ull_pow2(char *end, unsigned long long int u,
+		int shift, const char *digits) {
+	unsigned int mask = (1 << shift) - 1;
+
+	do {
+		*--end = digits[u & mask];
+		u >>= shift;
+	} while (u);
+
+	return end;
+}
+
+static int print_i(const struct print_out *out, unsigned long long int u,
 		int is_signed, int width, int min_len, unsigned int ops, int base) {
-	char buff[PRINT_I_BUFF_SZ], *str, *end, *prefix;
-	int pc, ch, len, prefix_len, zero_count, space_count, letter_base;
+	char buff[PRINT_I_BUFF_SZ], *str, *end;
+	const char *prefix;
+	int len, prefix_len, zero_count, space_count;
 
-	assert(printchar_handler != NULL);
 	assert(width >= 0);
 	assert(min_len >= 0);
 
-	str = end = &buff[0] + sizeof buff / sizeof buff[0] - 1;
-	*end = '\0';
+	str = end = &buff[0] + sizeof buff / sizeof buff[0];
 	prefix = is_signed && ((long long int)u < 0) ? (u = -u, "-")
 			: is_signed && (ops & OPS_FLAG_WITH_SIGN) ? "+"
 			: is_signed && (ops & OPS_FLAG_EXTRA_SPACE) ? " "
@@ -106,16 +190,20 @@ static int print_i(void (*printchar_handler)(struct printchar_handler_data *d, i
 			: (base == 16) && (ops & OPS_FLAG_WITH_SPEC)
 				? ops & OPS_SPEC_UPPER_CASE ? "0X" : "0x"
 			: "";
-	pc = 0;
 	prefix_len = strlen(prefix);
-	letter_base = ops & OPS_SPEC_UPPER_CASE ? 'A' : 'a';
 
-	do {
-		ch = u % base;
-		if (ch >= 10) ch += letter_base - 10 - '0';
-		*--str = ch + '0';
-		u /= base;
-	} while (u);
+	switch (base) {
+	case 10:
+		str = print_ull_dec(end, u);
+		break;
+	case 16:
+		str = print_ull_pow2(end, u, 4, ops & OPS_SPEC_UPPER_CASE
+				? "0123456789ABCDEF" : "0123456789abcdef");
+		break;
+	default:
+		str = print_ull_pow2(end, u, 3, "01234567");
+		break;
+	}
 
 	len = end - str;
 	zero_count = (len < min_len ? min_len : (ops & OPS_FLAG_ZERO_PAD)
@@ -125,23 +213,18 @@ static int print_i(void (*printchar_handler)(struct printchar_handler_data *d, i
 	space_count = max(space_count, 0);
 
 	if (!(ops & OPS_FLAG_LEFT_ALIGN)) {
-		pc += space_count;
-		for (; space_count; --space_count) printchar_handler(printchar_data, ' ');
+		out_pad(out, ' ', space_count);
 	}
 
-	pc += prefix_len;
-	while (prefix_len--) printchar_handler(printchar_data, *prefix++);
-
-	pc += zero_count;
-	while (zero_count--) printchar_handler(printchar_data, '0');
+	out_str(out, prefix, prefix_len);
+	out_pad(out, '0', zero_count);
+	out_str(out, str, len);
 
-	pc += len;
-	while (len--) printchar_handler(printchar_data, *str++);
-
-	pc += space_count;
-	while (space_count--) printchar_handler(printchar_data, ' ');
+	if (ops & OPS_FLAG_LEFT_ALIGN) {
+		out_pad(out, ' ', space_count);
+	}
 
-	return pc;
+	return prefix_len + zero_count + len + space_count;
 }
 
 #if OPTION_GET(NUMBER, support_floating)
@@ -161,17 +244,94 @@ static int print_i(void (*printchar_handler)(struct printchar_handler_data *d, i
 #define FABS fabs
 #endif
 
-static int print_f(void (*printchar_handler)(struct printchar_handler_data *d, int c),
-		struct printchar_handler_data *printchar_data, long double r, int width,
+static const uint32_t print_f_pow10[] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+	1000000000,
+};
+
+/* Numbers below 10^18 with %f precision up to 9 are split into integer and
+ * scaled fractional parts, which are converted as integers without long
+ * double arithmetic and libm calls. Scaling may be off by half an ulp, so
+ * returns -1 without output when the scaled part is that close to a rounding
+ * boundary, to let the caller print it exactly */
+static int print_f_fast(const struct print_out *out, double r, int width,
+		int precision, unsigned int ops) {
+	char buff[PRINT_F_BUFF_SZ], *str, *end;
+	const char *prefix;
+	unsigned long long int ip;
+	uint32_t fp;
+	double scaled, rest;
+	int len, prefix_len, pad_count;
+
+	prefix = signbit(r) ? (r = -r, "-")
+			: ops & OPS_FLAG_WITH_SIGN ? "+"
+			: ops & OPS_FLAG_EXTRA_SPACE ? " "
+			: "";
+	prefix_len = strlen(prefix);
+
+	ip = (unsigned long long int) r;
+	scaled = (r - ip) * print_f_pow10[precision];
+	rest = scaled - (uint32_t) scaled;
+	if ((rest - 0.5 <= scaled * DBL_EPSILON)
+			&& (0.5 - rest <= scaled * DBL_EPSILON)) {
+		return -1;
+	}
+
+	fp = (uint32_t) (scaled + 0.5);
+	if (fp >= print_f_pow10[precision]) {
+		fp -= print_f_pow10[precision];
+		ip++;
+	}
+
+	end = &buff[0] + sizeof buff / sizeof buff[0];
+	str = end;
+	if (precision) {
+		str = print_u32_dec(end, fp);
+		while (str > end - precision) *--str = '0';
+	}
+	if (precision || (ops & OPS_FLAG_WITH_SPEC)) {
+		*--str = '.';
+	}
+	str = print_ull_dec(str, ip);
+
+	len = end - str;
+	pad_count = max(width - prefix_len - len, 0);
+
+	if (!(ops & (OPS_FLAG_ZERO_PAD | OPS_FLAG_LEFT_ALIGN))) {
+		out_pad(out, ' ', pad_count);
+	}
+	out_str(out, prefix, prefix_len);
+	if (ops & OPS_FLAG_ZERO_PAD) {
+		out_pad(out, '0', pad_count);
+	}
+	out_str(out, str, len);
+	if (ops & OPS_FLAG_LEFT_ALIGN) {
+		out_pad(out, ' ', pad_count);
+	}
+
+	return prefix_len + len + pad_count;
+}
+
+static int print_f(const struct print_out *out, long double r, int width,
 		int precision, unsigned int ops, int base, int with_exp, int is_shortened) {
 	char buff[PRINT_F_BUFF_SZ], *str, *end, *prefix, *postfix;
 	DOUBLE ip, fp, ep;
 	int pc, i, ch, len, prefix_len, postfix_len, pad_count, sign_count, zero_left, letter_base;
 
-	assert(printchar_handler != NULL);
 	assert(width >= 0);
 	assert(precision >= 0);
 
+	if ((base == 10) && !with_exp && !is_shortened && !(ops & OPS_LEN_LONGFP)
+			&& isfinite(r) && (fabsl(r) < 1e18L)
+			&& ((ops & OPS_PREC_IS_GIVEN ? precision : PRINT_F_PREC_DEFAULT)
+				< (int) ARRAY_SIZE(print_f_pow10))) {
+		len = print_f_fast(out, r, width,
+				ops & OPS_PREC_IS_GIVEN ? precision : PRINT_F_PREC_DEFAULT, ops);
+		if (len >= 0) {
+			return len;
+		}
+	}
+
 	postfix = end = str = &buff[0] + sizeof buff / sizeof buff[0] - 1;
 	*end = '\0';
 	prefix = signbit(r) ? (r = -r, base == 16)
@@ -254,47 +414,106 @@ static int print_f(void (*printchar_handler)(struct printchar_handler_data *d, i
 
 	if (!(ops & (OPS_FLAG_ZERO_PAD | OPS_FLAG_LEFT_ALIGN))) {
 		pc += pad_count;
-		while (pad_count--) printchar_handler(printchar_data, ' ');
+		out_pad(out, ' ', pad_count);
 	}
 
 	pc += prefix_len;
-	while (prefix_len--) printchar_handler(printchar_data, *prefix++);
+	out_str(out, prefix, prefix_len);
 
 	if (ops & OPS_FLAG_ZERO_PAD) {
 		pc += pad_count;
-		while (pad_count--) printchar_handler(printchar_data, '0');
+		out_pad(out, '0', pad_count);
 	}
 
 	pc += len;
-	while (len--) printchar_handler(printchar_data, *str++);
+	out_str(out, str, len);
 
 	pc += zero_left;
-	while (zero_left--) printchar_handler(printchar_data, '0');
+	out_pad(out, '0', zero_left);
 
 	pc += postfix_len;
-	while (postfix_len--) printchar_handler(printchar_data, *postfix++);
+	out_str(out, postfix, postfix_len);
 
 	if (ops & OPS_FLAG_LEFT_ALIGN) {
 		pc += pad_count;
-		while (pad_count--) printchar_handler(printchar_data, ' ');
+		out_pad(out, ' ', pad_count);
 	}
 
 	return pc;
 }
 #else
-static int print_f(void (*printchar_handler)(struct printchar_handler_data *d, int c),
-		struct printchar_handler_data *printchar_data, double r, int width,
+static int print_f(const struct print_out *out, double r, int width,
 		int precision, unsigned int ops, int base, int with_exp, int is_shortened) {
-	return print_s(printchar_handler, printchar_data, "%f", 0, 0, 0);
+	return print_s(out, "%f", 0, 0, 0);
 }
 #endif
 
-int __print(void (*printchar_handler)(struct printchar_handler_data *d, int c),
-		struct printchar_handler_data *printchar_data,
-		const char *format, va_list args) {
-	int pc, width, precision;
+/* Parses a conversion following '%' at @a format, returns the end of it */
+static const char *print_spec_parse(const char *format,
+		struct print_spec *spec) {
+	unsigned int ops;
+	int width, precision;
+
+	ops = 0;
+
+	/* get flags */
+	for (;; ++format) {
+		switch (*format) {
+		default: goto after_flags;
+		case '-': ops |= OPS_FLAG_LEFT_ALIGN; continue;
+		case '+': ops |= OPS_FLAG_WITH_SIGN; continue;
+		case ' ': ops |= OPS_FLAG_EXTRA_SPACE; continue;
+		case '#': ops |= OPS_FLAG_WITH_SPEC; continue;
+		case '0': ops |= OPS_FLAG_ZERO_PAD; continue;
+		}
+	}
+after_flags:
+
+	/* get width */
+	if (*format == '*') { width = PRINT_ARG; ++format; }
+	else {
+		for (width = 0; isdigit(*format); ++format) {
+			width = min(width * 10 + *format - '0', SHRT_MAX);
+		}
+	}
+
+	/* get precision */
+	precision = 0;
+	if (*format == '.') {
+		ops |= OPS_PREC_IS_GIVEN;
+		if (*++format == '*') { precision = PRINT_ARG; ++format; }
+		else {
+			for (; isdigit(*format); ++format) {
+				precision = min(precision * 10 + *format - '0', SHRT_MAX);
+			}
+		}
+	}
+
+	/* get length */
+	switch (*format) {
+	case 'h': ops |= *++format != 'h' ? OPS_LEN_SHORT : (++format, OPS_LEN_MIN); break;
+	case 'l': ops |= *++format != 'l' ? OPS_LEN_LONG : (++format, OPS_LEN_LONGLONG); break;
+	case 'j': ops |= OPS_LEN_MAX; ++format; break;
+	case 'z': ops |= OPS_LEN_SIZE; ++format; break;
+	case 't': ops |= OPS_LEN_PTRDIFF; ++format; break;
+	case 'L': ops |= OPS_LEN_LONGFP; ++format; break;
+	}
+
+	ops |= isupper(*format) ? OPS_SPEC_UPPER_CASE : 0;
+
+	spec->ops = ops;
+	spec->width = width;
+	spec->precision = precision;
+	spec->spec = *format;
+
+	return *format ? format + 1 : format;
+}
+
+/* Prints conversion @a spec, @a begin points to its '%' */
+static int print_conv(const struct print_out *out, const struct print_spec *spec,
+		const char *begin, va_list *args, int pc) {
+	int width, precision;
 	unsigned int ops;
-	const char *begin;
 	union {
 		void *vp;
 		char ca[2];
@@ -303,144 +522,207 @@ int __print(void (*printchar_handler)(struct printchar_handler_data *d, int c),
 		long double ld;
 	} tmp;
 
+	ops = spec->ops;
+
+	width = spec->width != PRINT_ARG ? spec->width : va_arg(*args, int);
+	width = max(width, 0);
+
+	precision = spec->precision != PRINT_ARG ? spec->precision
+			: va_arg(*args, int);
+	precision = precision >= 0 ? precision : (ops &= ~OPS_PREC_IS_GIVEN, 0);
+
+	/* handle specifier */
+	switch (spec->spec) {
+	default:
+		out_str(out, begin, spec->len);
+		return spec->len;
+	case '%':
+		out->printchar(out->data, '%');
+		return 1;
+	case 'd':
+	case 'i':
+		tmp.ulli = ops & OPS_LEN_MIN ? (signed char)va_arg(*args, int)
+				: ops & OPS_LEN_SHORT ? (short int)va_arg(*args, int)
+				: ops & OPS_LEN_LONG ? va_arg(*args, long int)
+				: ops & OPS_LEN_LONGLONG ? va_arg(*args, long long int)
+				: ops & OPS_LEN_MAX ? va_arg(*args, intmax_t)
+				: ops & OPS_LEN_SIZE ? va_arg(*args, ssize_t)
+				: ops & OPS_LEN_PTRDIFF ? va_arg(*args, ptrdiff_t)
+				: va_arg(*args, int);
+		return print_i(out, tmp.ulli, 1, width, precision, ops, 10);
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+		tmp.ulli = ops & OPS_LEN_MIN ? (unsigned char)va_arg(*args, unsigned int)
+				: ops & OPS_LEN_SHORT ? (unsigned short int)va_arg(*args, unsigned int)
+				: ops & OPS_LEN_LONG ? va_arg(*args, unsigned long int)
+				: ops & OPS_LEN_LONGLONG ? va_arg(*args, unsigned long long int)
+				: ops & OPS_LEN_MAX ? va_arg(*args, uintmax_t)
+				: ops & OPS_LEN_SIZE ? va_arg(*args, size_t)
+				: ops & OPS_LEN_PTRDIFF ? va_arg(*args, ptrdiff_t)
+				: va_arg(*args, unsigned int);
+		return print_i(out, tmp.ulli, 0, width, precision, ops,
+				spec->spec == 'u' ? 10 : (spec->spec == 'o' ? 8 : 16));
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		tmp.ld = ops & OPS_LEN_LONGFP ? va_arg(*args, long double)
+				: va_arg(*args, double);
+		return print_f(out, tmp.ld, width, precision, ops,
+				tolower(spec->spec) == 'a' ? 16 : 10,
+				tolower(spec->spec) == 'e' || tolower(spec->spec) == 'a',
+				tolower(spec->spec) == 'g');
+	case 'c':
+		/* TODO handle (ops & OPS_LEN_LONG) for wint_t */
+		tmp.ca[0] = (char)va_arg(*args, int);
+		tmp.ca[1] = '\0';
+		return print_s(out, &tmp.ca[0], width, precision, ops);
+	case 's':
+		/* TODO handle (ops & OPS_LEN_LONG) for wchar_t* */
+		tmp.cp = va_arg(*args, char *);
+		return print_s(out, tmp.cp ? tmp.cp : PRINT_S_NULL_STR,
+				width, precision, ops);
+	case 'p':
+		tmp.vp = va_arg(*args, void *);
+		return print_i(out, (size_t)tmp.vp, 0, width, sizeof tmp.vp * 2 + 2,
+				ops | (OPS_FLAG_WITH_SPEC | OPS_FLAG_ZERO_PAD), 16);
+	case 'n':
+		if (ops & OPS_LEN_MIN) *va_arg(*args, signed char *) = (signed char)pc;
+		else if (ops & OPS_LEN_SHORT) *va_arg(*args, short int *) = (short int)pc;
+		else if (ops & OPS_LEN_LONG) *va_arg(*args, long int *) = (long int)pc;
+		else if (ops & OPS_LEN_LONGLONG) *va_arg(*args, long long int *) = (long long int)pc;
+		else if (ops & OPS_LEN_MAX) *va_arg(*args, intmax_t *) = (intmax_t)pc;
+		else if (ops & OPS_LEN_SIZE) *va_arg(*args, size_t *) = (size_t)pc;
+		else if (ops & OPS_LEN_PTRDIFF) *va_arg(*args, ptrdiff_t *) = (ptrdiff_t)pc;
+		else *va_arg(*args, int *) = pc;
+		return 0;
+	}
+}
+
+int __print_bulk(printchar_handler_t printchar_handler,
+		printstr_handler_t printstr_handler,
+		struct printchar_handler_data *printchar_data,
+		const char *format, va_list args) {
+	struct print_out out = { printchar_handler, printstr_handler, printchar_data };
+	struct print_spec spec;
+	const char *begin;
+	va_list ap;
+	int pc;
+
 	assert(printchar_handler != NULL);
 	assert(format != NULL);
 
 	pc = 0;
+	va_copy(ap, args);
 
-	for (begin = format; *format; begin = ++format) {
+	while (*format) {
 		/**
 		 * %[flags][width][.precision][length]specifier
 		 */
+		begin = format;
+		format = strchrnul(format, '%');
+		out_str(&out, begin, format - begin);
+		pc += format - begin;
 
-		/* check first symbol */
-		if (*format != '%') {
-single_print:
-			++pc;
-			printchar_handler(printchar_data, *format);
-			continue;
+		if (!*format) {
+			break;
 		}
 
-		ops = 0;
-
-		/* get flags */
-		while (*++format) {
-			switch (*format) {
-			default: goto after_flags;
-			case '-': ops |= OPS_FLAG_LEFT_ALIGN; break;
-			case '+': ops |= OPS_FLAG_WITH_SIGN; break;
-			case ' ': ops |= OPS_FLAG_EXTRA_SPACE; break;
-			case '#': ops |= OPS_FLAG_WITH_SPEC; break;
-			case '0': ops |= OPS_FLAG_ZERO_PAD; break;
-			}
-		}
-after_flags:
+		begin = format;
+		format = print_spec_parse(format + 1, &spec);
+		spec.len = min(format - begin, UCHAR_MAX);
+		pc += print_conv(&out, &spec, begin, &ap, pc);
+	}
 
-		/* get width */
-		if (*format == '*') { width = va_arg(args, int); ++format; }
-		else { width = atoi(format); while (isdigit(*format)) ++format; }
-		width = max(width, 0);
+	va_end(ap);
 
-		/* get precision */
-		ops |= *format == '.' ? OPS_PREC_IS_GIVEN : 0;
-		if ((*format == '.') && (*++format == '*')) { precision = va_arg(args, int); ++format; }
-		else { precision = atoi(format); while (isdigit(*format)) ++format; }
-		precision = precision >= 0 ? precision : (ops &= ~OPS_PREC_IS_GIVEN, 0);
+	return pc;
+}
 
-		/* get length */
-		switch (*format) {
-		case 'h': ops |= *++format != 'h' ? OPS_LEN_SHORT : (++format, OPS_LEN_MIN); break;
-		case 'l': ops |= *++format != 'l' ? OPS_LEN_LONG : (++format, OPS_LEN_LONGLONG); break;
-		case 'j': ops |= OPS_LEN_MAX; ++format; break;
-		case 'z': ops |= OPS_LEN_SIZE; ++format; break;
-		case 't': ops |= OPS_LEN_PTRDIFF; ++format; break;
-		case 'L': ops |= OPS_LEN_LONGFP; ++format; break;
-		}
+int __print(void (*printchar_handler)(struct printchar_handler_data *d, int c),
+		struct printchar_handler_data *printchar_data,
+		const char *format, va_list args) {
+	return __print_bulk(printchar_handler, NULL, printchar_data, format, args);
+}
 
-		/* handle specifier */
-		ops |= isupper(*format) ? OPS_SPEC_UPPER_CASE : 0;
-		switch (*format) {
-		default:
-			pc += format - begin + 1;
-			do
-				printchar_handler(printchar_data, *begin);
-			while (++begin <= format);
-			break;
-		case '%': goto single_print;
-		case 'd':
-		case 'i':
-			tmp.ulli = ops & OPS_LEN_MIN ? (signed char)va_arg(args, int)
-					: ops & OPS_LEN_SHORT ? (short int)va_arg(args, int)
-					: ops & OPS_LEN_LONG ? va_arg(args, long int)
-					: ops & OPS_LEN_LONGLONG ? va_arg(args, long long int)
-					: ops & OPS_LEN_MAX ? va_arg(args, intmax_t)
-					: ops & OPS_LEN_SIZE ? va_arg(args, ssize_t)
-					: ops & OPS_LEN_PTRDIFF ? va_arg(args, ptrdiff_t)
-					: va_arg(args, int);
-			pc += print_i(printchar_handler, printchar_data, tmp.ulli, 1, width,
-					precision, ops, 10);
-			break;
-		case 'u':
-		case 'o':
-		case 'x':
-		case 'X':
-			tmp.ulli = ops & OPS_LEN_MIN ? (unsigned char)va_arg(args, unsigned int)
-					: ops & OPS_LEN_SHORT ? (unsigned short int)va_arg(args, unsigned int)
-					: ops & OPS_LEN_LONG ? va_arg(args, unsigned long int)
-					: ops & OPS_LEN_LONGLONG ? va_arg(args, unsigned long long int)
-					: ops & OPS_LEN_MAX ? va_arg(args, uintmax_t)
-					: ops & OPS_LEN_SIZE ? va_arg(args, size_t)
-					: ops & OPS_LEN_PTRDIFF ? va_arg(args, ptrdiff_t)
-					: va_arg(args, unsigned int);
-			pc += print_i(printchar_handler, printchar_data, tmp.ulli, 0, width,
-					precision, ops, *format == 'u' ? 10 : (*format == 'o' ? 8 : 16));
-			break;
-		case 'f':
-		case 'F':
-		case 'e':
-		case 'E':
-		case 'g':
-		case 'G':
-		case 'a':
-		case 'A':
-			tmp.ld = ops & OPS_LEN_LONGFP ? va_arg(args, long double)
-					: va_arg(args, double);
-			pc += print_f(printchar_handler, printchar_data, tmp.ld,
-					width, precision, ops, tolower(*format) == 'a' ? 16 : 10,
-					tolower(*format) == 'e' || tolower(*format) == 'a',
-					tolower(*format) == 'g');
-			break;
-		case 'c':
-			/* TODO handle (ops & OPS_LEN_LONG) for wint_t */
-			tmp.ca[0] = (char)va_arg(args, int);
-			tmp.ca[1] = '\0';
-			pc += print_s(printchar_handler, printchar_data, &tmp.ca[0],
-					width, precision, ops);
-			break;
-		case 's':
-			/* TODO handle (ops & OPS_LEN_LONG) for wchar_t* */
-			tmp.cp = va_arg(args, char *);
-			pc += print_s(printchar_handler, printchar_data,
-					tmp.cp ? tmp.cp : PRINT_S_NULL_STR, width, precision, ops);
+static void print_fmt_parse(struct print_fmt *fmt) {
+	struct print_spec *spec;
+	const char *format, *begin;
+
+	format = fmt->format;
+
+	for (spec = fmt->specs; spec < fmt->specs + PRINT_FMT_MAX_SPECS; spec++) {
+		begin = format;
+		format = strchrnul(format, '%');
+		if (format - begin > USHRT_MAX) {
 			break;
-		case 'p':
-			tmp.vp = va_arg(args, void *);
-			pc += print_i(printchar_handler, printchar_data, (size_t)tmp.vp, 0,
-					width, sizeof tmp.vp * 2 + 2,
-					ops | (OPS_FLAG_WITH_SPEC | OPS_FLAG_ZERO_PAD), 16);
+		}
+		spec->lit_len = format - begin;
+
+		if (!*format) {
+			spec->len = 0;
+			__sync_synchronize();
+			fmt->state = PRINT_FMT_READY;
+			return;
+		}
+
+		begin = format;
+		format = print_spec_parse(format + 1, spec);
+		if (format - begin > UCHAR_MAX) {
 			break;
-		case 'n':
-			if (ops & OPS_LEN_MIN) *va_arg(args, signed char *) = (signed char)pc;
-			else if (ops & OPS_LEN_SHORT) *va_arg(args, short int *) = (short int)pc;
-			else if (ops & OPS_LEN_LONG) *va_arg(args, long int *) = (long int)pc;
-			else if (ops & OPS_LEN_LONGLONG) *va_arg(args, long long int *) = (long long int)pc;
-			else if (ops & OPS_LEN_MAX) *va_arg(args, intmax_t *) = (intmax_t)pc;
-			else if (ops & OPS_LEN_SIZE) *va_arg(args, size_t *) = (size_t)pc;
-			else if (ops & OPS_LEN_PTRDIFF) *va_arg(args, ptrdiff_t *) = (ptrdiff_t)pc;
-			else *va_arg(args, int *) = pc;
+		}
+		spec->len = format - begin;
+	}
+
+	fmt->state = PRINT_FMT_DYNAMIC;
+}
+
+int __print_fmt(printchar_handler_t printchar_handler,
+		printstr_handler_t printstr_handler,
+		struct printchar_handler_data *printchar_data,
+		struct print_fmt *fmt, va_list args) {
+	struct print_out out = { printchar_handler, printstr_handler, printchar_data };
+	const struct print_spec *spec;
+	const char *format;
+	va_list ap;
+	int pc;
+
+	assert(printchar_handler != NULL);
+	assert(fmt != NULL);
+
+	if (fmt->state == PRINT_FMT_NEW) {
+		print_fmt_parse(fmt);
+	}
+
+	if (fmt->state != PRINT_FMT_READY) {
+		return __print_bulk(printchar_handler, printstr_handler,
+				printchar_data, fmt->format, args);
+	}
+
+	pc = 0;
+	va_copy(ap, args);
+
+	format = fmt->format;
+	for (spec = fmt->specs; ; spec++) {
+		out_str(&out, format, spec->lit_len);
+		pc += spec->lit_len;
+		format += spec->lit_len;
+
+		if (!spec->len) {
 			break;
 		}
+
+		pc += print_conv(&out, spec, format, &ap, pc);
+		format += spec->len;
 	}
 
+	va_end(ap);
+
 	return pc;
 }
@@ -10,11 +10,59 @@
 #define PRINTF_IMPL_H_
 
 #include <stdarg.h>
+#include <stddef.h>
 
 struct printchar_handler_data;
 
+typedef void (*printchar_handler_t)(struct printchar_handler_data *d, int c);
+typedef void (*printstr_handler_t)(struct printchar_handler_data *d,
+		const char *s, size_t n);
+
 extern int __print(void (*printchar_handler)(struct printchar_handler_data *d, int c),
 		struct printchar_handler_data *printchar_data,
 		const char *format, va_list args);
 
+/**
+ * Same as __print(), but runs of literal text, converted numbers and
+ * padding are passed to @a printstr_handler at once. Single characters
+ * still go to @a printchar_handler. @a printstr_handler may be NULL.
+ */
+extern int __print_bulk(printchar_handler_t printchar_handler,
+		printstr_handler_t printstr_handler,
+		struct printchar_handler_data *printchar_data,
+		const char *format, va_list args);
+
+/** One conversion of a pre-parsed format */
+struct print_spec {
+	unsigned short lit_len; /* literal text before the conversion */
+	unsigned char len;      /* length of the conversion, 0 for the end */
+	char spec;
+	unsigned short ops;
+	short width;            /* -1 if given by an argument */
+	short precision;        /* -1 if given by an argument */
+};
+
+#define PRINT_FMT_MAX_SPECS 6
+
+/**
+ * Format string parsed on the first use, see __print_fmt(). Formats with
+ * more conversions are parsed on each use.
+ */
+struct print_fmt {
+	const char *format;
+	int state;
+	struct print_spec specs[PRINT_FMT_MAX_SPECS + 1];
+};
+
+#define PRINT_FMT_INIT(_format) { .format = _format, }
+
+/**
+ * Same as __print_bulk() for a format, which is parsed once and kept in
+ * @a fmt for next calls.
+ */
+extern int __print_fmt(printchar_handler_t printchar_handler,
+		printstr_handler_t printstr_handler,
+		struct printchar_handler_data *printchar_data,
+		struct print_fmt *fmt, va_list args);
+
 #endif /* PRINTF_IMPL_H_ */
@@ -9,6 +9,8 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <util/math.h>
 
 #include "printf_impl.h"
 
@@ -27,6 +29,17 @@ static void strn_printchar(struct printchar_handler_data *d, int c) {
 	}
 }
 
+static void strn_printstr(struct printchar_handler_data *d,
+		const char *s, size_t n) {
+	assert(d != NULL);
+	assert((d->str != NULL) || (d->left == 0));
+
+	n = min(n, d->left);
+	memcpy(d->str, s, n);
+	d->str += n;
+	d->left -= n;
+}
+
 int vsnprintf(char *str, size_t size, const char *format, va_list args) {
 	int ret;
 	struct printchar_handler_data data;
@@ -36,7 +49,7 @@ int vsnprintf(char *str, size_t size, const char *format, va_list args) {
 
 	data.str = str;
 	data.left = size ? size - 1 : 0;
-	ret = __print(strn_printchar, &data, format, args);
+	ret = __print_bulk(strn_printchar, strn_printstr, &data, format, args);
 	if (size) *data.str = '\0';
 
 	return ret;
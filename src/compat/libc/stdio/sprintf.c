@@ -20,6 +20,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "printf_impl.h"
 
@@ -34,6 +35,15 @@ static void str_printchar(struct printchar_handler_data *d, int c) {
 	*d->str++ = c;
 }
 
+static void str_printstr(struct printchar_handler_data *d,
+		const char *s, size_t n) {
+	assert(d != NULL);
+	assert(d->str != NULL);
+
+	memcpy(d->str, s, n);
+	d->str += n;
+}
+
 int vsprintf(char *str, const char *format, va_list args) {
 	int ret;
 	struct printchar_handler_data data;
@@ -42,7 +52,7 @@ int vsprintf(char *str, const char *format, va_list args) {
 	assert(format != NULL);
 
 	data.str = str;
-	ret = __print(str_printchar, &data, format, args);
+	ret = __print_bulk(str_printchar, str_printstr, &data, format, args);
 	assert(data.str != NULL);
 	*data.str = '\0';
 
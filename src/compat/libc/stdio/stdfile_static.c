@@ -14,6 +14,7 @@
 /* stdin */
 static FILE stdin_struct = {
 	.fd = STDIN_FILENO,
+	.lock = RMUTEX_INIT_STATIC,
 	.flags = O_RDONLY,
 };
 FILE *stdin = &stdin_struct;
@@ -22,6 +23,7 @@ FILE *stdin = &stdin_struct;
 static char stdout_obuf[16];
 static FILE stdout_struct = {
 	.fd = STDOUT_FILENO,
+	.lock = RMUTEX_INIT_STATIC,
 	.flags = O_WRONLY,
 	.buftype = _IOLBF,
 	.obuf = stdout_obuf,
@@ -32,6 +34,7 @@ FILE *stdout = &stdout_struct;
 /* stderr */
 static FILE stderr_struct = {
 	.fd = STDERR_FILENO,
+	.lock = RMUTEX_INIT_STATIC,
 	.flags = O_WRONLY,
 };
 FILE *stderr = &stderr_struct;
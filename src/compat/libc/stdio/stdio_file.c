@@ -7,15 +7,25 @@
 
 #include <framework/mod/options.h>
 #include <mem/misc/pool.h>
+#include <kernel/task.h>
+#include <util/math.h>
 #include "file_struct.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #define FILE_QUANTITY OPTION_GET(NUMBER,file_quantity)
+#define BUF_SIZE_MIN  OPTION_GET(NUMBER,buf_size_min)
+#define BUF_SIZE_MAX  OPTION_GET(NUMBER,buf_size_max)
 
 POOL_DEF(file_pool, FILE, FILE_QUANTITY);
 
+static DLIST_DEFINE(stdio_files);
+static struct mutex stdio_files_lock = MUTEX_INIT_STATIC;
+
 FILE *stdio_file_alloc(int fd) {
 	FILE *file = pool_alloc(&file_pool);
 
@@ -25,12 +35,101 @@ FILE *stdio_file_alloc(int fd) {
 
 	memset(file, 0, sizeof(FILE));
 	file->fd = fd;
+	file->buftype = _IONBF;
+	file->buf_adaptive = 1;
+	file->owner = task_self();
+	mutex_init(&file->lock);
+
+	mutex_lock(&stdio_files_lock);
+	dlist_add_prev(dlist_head_init(&file->lnk), &stdio_files);
+	mutex_unlock(&stdio_files_lock);
 
 	return file;
 }
 
 void stdio_file_free(FILE *file) {
+	stdio_buf_free(file);
+
 	if ((file != stdin) && (file != stdout)	&& (file != stderr)) {
+		mutex_lock(&stdio_files_lock);
+		dlist_del(&file->lnk);
+		mutex_unlock(&stdio_files_lock);
+
 		pool_free(&file_pool, file);
 	}
 }
+
+/* Streams of other tasks have descriptors of those tasks, so only streams
+ * opened by the current one are visited */
+void stdio_task_files_foreach(void (*fn)(FILE *file)) {
+	struct task *tsk = task_self();
+	FILE *file;
+
+	mutex_lock(&stdio_files_lock);
+	dlist_foreach_entry(file, &stdio_files, lnk) {
+		if (file->owner == tsk) {
+			fn(file);
+		}
+	}
+	mutex_unlock(&stdio_files_lock);
+}
+
+/*
+ * Only regular files are buffered: terminals, sockets and pipes keep writing
+ * through at once, as their users expect. The size is a multiple of the
+ * file system block, so refills and flushes are whole blocks.
+ */
+void stdio_buf_adapt(FILE *file) {
+	struct stat st;
+	size_t sz;
+
+	if (!file->buf_adaptive) {
+		return;
+	}
+	file->buf_adaptive = 0;
+
+	if (funopen_check(file) || (0 != fstat(file->fd, &st))
+			|| !S_ISREG(st.st_mode)) {
+		return;
+	}
+
+	sz = BUF_SIZE_MIN;
+	if (st.st_blksize > 0) {
+		sz = ((sz + st.st_blksize - 1) / st.st_blksize) * st.st_blksize;
+	}
+	sz = min(sz, BUF_SIZE_MAX);
+
+	file->mbuf = malloc(sz);
+	if (file->mbuf == NULL) {
+		return;
+	}
+
+	file->buftype = _IOFBF;
+	file->obuf = file->ibuf = file->mbuf;
+	file->obuf_sz = file->ibuf_sz = sz;
+	file->obuf_len = file->ibuf_pos = file->ibuf_len = 0;
+}
+
+void stdio_buf_free(FILE *file) {
+	if (file->mbuf == NULL) {
+		return;
+	}
+
+	free(file->mbuf);
+	file->mbuf = NULL;
+	file->obuf = file->ibuf = NULL;
+	file->obuf_sz = file->ibuf_sz = 0;
+	file->obuf_len = file->ibuf_pos = file->ibuf_len = 0;
+	file->buftype = _IONBF;
+}
+
+/* Gives back read ahead data, so the file position is where the user is */
+void stdio_ib_drop(FILE *file) {
+	int unread = file->ibuf_len - file->ibuf_pos;
+
+	if ((unread > 0) && !funopen_check(file)) {
+		lseek(file->fd, -unread, SEEK_CUR);
+	}
+
+	file->ibuf_pos = file->ibuf_len = 0;
+}
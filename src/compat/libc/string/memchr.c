@@ -7,10 +7,34 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+
+#define BLOCK_SZ (sizeof(unsigned long))
+
+#define ONES  ((unsigned long) -1 / 0xff)
+#define HIGHS (ONES << 7)
+
+/* Nonzero if X contains a zero byte.  */
+#define has_zero(x) (((x) - ONES) & ~(x) & HIGHS)
 
 void *memchr(const void *s, int c, size_t n) {
 	const unsigned char *src = (const unsigned char *) s;
+	const unsigned long *w;
 	unsigned char d = c;
+	unsigned long mask;
+
+	for (; n && ((uintptr_t) src & (BLOCK_SZ - 1)); n--, src++) {
+		if (*src == d)
+			return (void *) src;
+	}
+
+	/* Skip words without D, XOR turns D bytes into zero bytes.  */
+	mask = ONES * d;
+	for (w = (const unsigned long *) src; n >= BLOCK_SZ; n -= BLOCK_SZ, w++) {
+		if (has_zero(*w ^ mask))
+			break;
+	}
+	src = (const unsigned char *) w;
 
 	while (n--) {
 		if (*src == d)
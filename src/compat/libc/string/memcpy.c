@@ -19,36 +19,77 @@
 #define unaligned(x, y) \
   (((long) x | (long) y) & (sizeof(long) - 1))
 
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define merge(cur, next, sh) \
+  (((cur) >> (sh)) | ((next) << (BLOCK_SZ * 8 - (sh))))
+#else
+# define merge(cur, next, sh) \
+  (((cur) << (sh)) | ((next) >> (BLOCK_SZ * 8 - (sh))))
+#endif
+
+/* Copies @a words long words to aligned DST from unaligned SRC. Only
+ * aligned long words are read from SRC, the last one may contain bytes past
+ * the end of SRC, but it never crosses a page boundary.  */
+static void memcpy_shifted(long *dst, const char *src, size_t words) {
+	unsigned int sh = ((uintptr_t) src & (BLOCK_SZ - 1)) * 8;
+	const unsigned long *s = (const unsigned long *) (src - sh / 8);
+	unsigned long cur, next;
+
+	cur = *s++;
+	for (; words; words--) {
+		next = *s++;
+		*dst++ = merge(cur, next, sh);
+		cur = next;
+	}
+}
+
 void *memcpy(void *dst_, const void *src_, size_t n) {
 	char *dst = dst_;
 	long *aligned_dst;
 	const char *src = src_;
 	const long *aligned_src;
 
-	/* If the size is small, or either SRC or DST is unaligned,
-	 then punt into the byte copy loop.  This should be rare.  */
-	if (n >= BLOCK_SZ * 4 && !unaligned((intptr_t) src, (intptr_t) dst)) {
-		aligned_dst = (long *) dst;
-		aligned_src = (long *) src;
-
-		/* Copy 4X long words at a time if possible.  */
-		for (; n >= BLOCK_SZ * 4; n -= BLOCK_SZ * 4) {
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-			*aligned_dst++ = *aligned_src++;
-		}
-
-		/* Copy one long word at a time if possible.  */
-		for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
-			*aligned_dst++ = *aligned_src++;
-		}
-
-		/* Pick up any residual with a byte copier.  */
-		dst = (char *) aligned_dst;
-		src = (char *) aligned_src;
+	/* If the size is small, punt into the byte copy loop.  */
+	if (n < BLOCK_SZ * 4) {
+		goto bytes;
+	}
+
+	/* Align DST, then copy words either directly or merging two
+	 source words, if SRC is still unaligned.  */
+	while (unaligned((intptr_t) dst, 0)) {
+		*dst++ = *src++;
+		n--;
+	}
+
+	if (unaligned((intptr_t) src, 0)) {
+		memcpy_shifted((long *) dst, src, n / BLOCK_SZ);
+		dst += n & ~(BLOCK_SZ - 1);
+		src += n & ~(BLOCK_SZ - 1);
+		n &= BLOCK_SZ - 1;
+		goto bytes;
+	}
+
+	aligned_dst = (long *) dst;
+	aligned_src = (long *) src;
+
+	/* Copy 4X long words at a time if possible.  */
+	for (; n >= BLOCK_SZ * 4; n -= BLOCK_SZ * 4) {
+		*aligned_dst++ = *aligned_src++;
+		*aligned_dst++ = *aligned_src++;
+		*aligned_dst++ = *aligned_src++;
+		*aligned_dst++ = *aligned_src++;
+	}
+
+	/* Copy one long word at a time if possible.  */
+	for (; n >= BLOCK_SZ; n -= BLOCK_SZ) {
+		*aligned_dst++ = *aligned_src++;
 	}
 
+	/* Pick up any residual with a byte copier.  */
+	dst = (char *) aligned_dst;
+	src = (char *) aligned_src;
+
+bytes:
 	while (n--) {
 		*dst++ = *src++;
 	}
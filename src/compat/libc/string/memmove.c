@@ -10,6 +10,7 @@
  */
 
 #include <string.h>
+#include <stdint.h>
 
 #include "inhibit_libcall.h"
 
@@ -22,6 +23,19 @@ void *memmove(void *_dst, const void *_src, size_t n) {
 		/* Moving from low mem to hi mem; start at end.  */
 		src += n;
 		dst += n;
+
+		/* Copy long words, if both ends are aligned the same way.  */
+		if ((((uintptr_t) src ^ (uintptr_t) dst) & (sizeof(long) - 1)) == 0) {
+			for (; n && ((uintptr_t) dst & (sizeof(long) - 1)); n--) {
+				*--dst = *--src;
+			}
+			for (; n >= sizeof(long); n -= sizeof(long)) {
+				dst -= sizeof(long);
+				src -= sizeof(long);
+				*(long *) dst = *(const long *) src;
+			}
+		}
+
 		while (n--) {
 			*--dst = *--src;
 		}
@@ -7,12 +7,33 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+
+#define BLOCK_SZ (sizeof(unsigned long))
+
+#define ONES  ((unsigned long) -1 / 0xff)
+#define HIGHS (ONES << 7)
+
+/* Nonzero if X contains a zero byte.  */
+#define has_zero(x) (((x) - ONES) & ~(x) & HIGHS)
 
 size_t strlen(const char *str) {
 	const char *s = str;
+	const unsigned long *w;
+
+	/* Aligned words never cross a page boundary, so it's safe to read
+	 * a whole word containing the terminating zero.  */
+	for (; (uintptr_t) s & (BLOCK_SZ - 1); s++) {
+		if (!*s) {
+			return (size_t) (s - str);
+		}
+	}
+
+	for (w = (const unsigned long *) s; !has_zero(*w); w++)
+		;
 
-	while (*s++)
+	for (s = (const char *) w; *s; s++)
 		;
 
-	return (size_t) (s - str - 1);
+	return (size_t) (s - str);
 }
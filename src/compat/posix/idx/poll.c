@@ -106,6 +106,11 @@ int poll(struct pollfd fds[], nfds_t nfds, int timeout) {
 		return -EINVAL;
 	}
 
+	ret = poll_table_init(&pt, nfds);
+	if (ret < 0) {
+		return SET_ERRNO(-ret);
+	}
+
 	table_prepare(&pt, fds, nfds);
 
 	ticks = timeout;
@@ -113,17 +118,20 @@ int poll(struct pollfd fds[], nfds_t nfds, int timeout) {
 
 	if (fd_cnt || ticks == 0) {
 		fds_setup(&pt, fds, nfds);
+		poll_table_fini(&pt);
 		return fd_cnt;
 	}
 
 	ret = poll_table_wait(&pt, ticks);
 	if ((ret != 0) && (ret != -ETIMEDOUT)) {
+		poll_table_fini(&pt);
 		return SET_ERRNO(-ret);
 	}
 
 	poll_table_count(&pt);
 
 	fd_cnt = fds_setup(&pt, fds, nfds);
+	poll_table_fini(&pt);
 
 	return fd_cnt;
 }
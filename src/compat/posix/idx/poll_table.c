@@ -6,6 +6,7 @@
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <poll.h>
 
 #include <kernel/sched/waitq.h>
@@ -17,11 +18,35 @@
 #include <fs/index_descriptor.h>
 
 #include <kernel/thread.h>
+#include <mem/sysmalloc.h>
+#include <util/array.h>
 
 static struct idesc *poll_table_idx2idesc(int idx) {
 	return idx < 0 ? NULL : index_descriptor_get(idx);
 }
 
+int poll_table_init(struct idesc_poll_table *pt, int nr) {
+	pt->size = 0;
+
+	if (nr <= ARRAY_SIZE(pt->idesc_poll_buf)) {
+		pt->idesc_poll = pt->idesc_poll_buf;
+		return 0;
+	}
+
+	pt->idesc_poll = sysmalloc(nr * sizeof(*pt->idesc_poll));
+	if (!pt->idesc_poll) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void poll_table_fini(struct idesc_poll_table *pt) {
+	if (pt->idesc_poll != pt->idesc_poll_buf) {
+		sysfree(pt->idesc_poll);
+	}
+}
+
 int poll_table_count(struct idesc_poll_table *pt) {
 	int cnt = 0;
 	int i;
@@ -8,11 +8,17 @@
 #ifndef POLL_TABLE_H_
 #define POLL_TABLE_H_
 
+#include <config/embox/compat/posix/idx/poll_table.h>
 #include <framework/mod/options.h>
 #include <fs/idesc_event.h>
 #include <fs/poll_table.h>
 #include <kernel/task/resource/idesc_table.h>
 
+/* Descriptors polled without taking the table from heap */
+#define POLL_TABLE_SIZE \
+	OPTION_MODULE_GET(embox__compat__posix__idx__poll_table, \
+			NUMBER, poll_table_size)
+
 struct idesc;
 
 struct idesc_poll {
@@ -24,10 +30,20 @@ struct idesc_poll {
 };
 
 struct idesc_poll_table {
-	struct idesc_poll idesc_poll[MODOPS_IDESC_TABLE_SIZE];
+	struct idesc_poll *idesc_poll;
 	int size;
+	struct idesc_poll idesc_poll_buf[POLL_TABLE_SIZE];
 };
 
+/**
+ * Makes room for @a nr descriptors, the table is allocated if they don't
+ * fit into the embedded buffer.
+ *
+ * @return 0 on success, -ENOMEM otherwise
+ */
+extern int poll_table_init(struct idesc_poll_table *pt, int nr);
+extern void poll_table_fini(struct idesc_poll_table *pt);
+
 extern int poll_table_count(struct idesc_poll_table *pt);
 extern int poll_table_wait(struct idesc_poll_table *pt, clock_t ticks);
 
@@ -25,7 +25,6 @@
 #include <fs/idesc.h>
 #include <fs/idesc_event.h>
 #include <fs/poll_table.h>
-#include <util/array.h>
 
 static int select_fds2pt(struct idesc_poll_table *pt,
 		int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds) {
@@ -59,7 +58,6 @@ static int select_fds2pt(struct idesc_poll_table *pt,
 				return SET_ERRNO(EBADF);
 			}
 
-			assert(cnt < ARRAY_SIZE(pt->idesc_poll));
 			pl = &pt->idesc_poll[cnt++];
 
 			pl->fd = i;
@@ -113,8 +111,14 @@ int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struc
 	struct idesc_poll_table pt;
 	int ret;
 
+	ret = poll_table_init(&pt, nfds);
+	if (0 > ret) {
+		return SET_ERRNO(-ret);
+	}
+
 	ret = select_fds2pt(&pt, nfds, readfds, writefds, exceptfds);
 	if (0 > ret) {
+		poll_table_fini(&pt);
 		return ret;
 	}
 
@@ -123,16 +127,19 @@ int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struc
 
 	if (ret != 0 || ticks == 0) {
 		select_pt2fds(&pt, readfds, writefds, exceptfds);
+		poll_table_fini(&pt);
 		return ret;
 	}
 
 	ret = poll_table_wait(&pt, ticks);
 	if ((ret != 0) && (ret != -ETIMEDOUT)) {
+		poll_table_fini(&pt);
 		return SET_ERRNO(-ret);
 	}
 
 	ret = poll_table_count(&pt);
 	select_pt2fds(&pt, readfds, writefds, exceptfds);
+	poll_table_fini(&pt);
 	return ret;
 }
 
@@ -79,6 +79,12 @@ static struct hostent * get_hostent_from_net(const char *hostname) {
 		h_errno = HOST_NOT_FOUND;
 		return NULL;
 	}
+	if (result.ancount == 0) {
+		/* The name exists, but has no addresses */
+		dns_result_free(&result);
+		h_errno = NO_DATA;
+		return NULL;
+	}
 
 	addr_len = result.an->rdlength;
 
@@ -7,6 +7,7 @@
  * @author Alexander Kalmuk
  */
 
+#include <stdio.h>
 #include <unistd.h>
 
 #include <kernel/sched.h>
@@ -35,5 +36,6 @@ void _exit(int status) {
 
 /* stdlib */
 void exit(int status) {
+	fflush(NULL);
 	_exit(status);
 }
@@ -3,6 +3,71 @@
 
 #include <stdint.h>
 
+/* Generic host control registers */
+#define AHCI_CAP          0x00
+#define AHCI_GHC          0x04
+#define AHCI_IS           0x08
+#define AHCI_PI           0x0c
+#define AHCI_VS           0x10
+
+#define AHCI_CAP_NP       0x0000001f /* Number of ports - 1 */
+#define AHCI_CAP_NCS      0x00001f00 /* Number of command slots - 1 */
+#define AHCI_CAP_NCS_SHIFT 8
+#define AHCI_CAP_SCLO     (1 << 24)  /* Command list override */
+#define AHCI_CAP_SNCQ     (1 << 30)  /* Native Command Queuing */
+#define AHCI_CAP_S64A     (1u << 31) /* 64-bit addressing */
+
+#define AHCI_GHC_HR       (1 << 0)   /* HBA reset */
+#define AHCI_GHC_IE       (1 << 1)   /* Interrupt enable */
+#define AHCI_GHC_AE       (1u << 31) /* AHCI enable */
+
+/* Port registers */
+#define AHCI_PORT(n)      (0x100 + (n) * 0x80)
+#define AHCI_PORT_CLB     0x00
+#define AHCI_PORT_CLBU    0x04
+#define AHCI_PORT_FB      0x08
+#define AHCI_PORT_FBU     0x0c
+#define AHCI_PORT_IS      0x10
+#define AHCI_PORT_IE      0x14
+#define AHCI_PORT_CMD     0x18
+#define AHCI_PORT_TFD     0x20
+#define AHCI_PORT_SIG     0x24
+#define AHCI_PORT_SSTS    0x28
+#define AHCI_PORT_SCTL    0x2c
+#define AHCI_PORT_SERR    0x30
+#define AHCI_PORT_SACT    0x34
+#define AHCI_PORT_CI      0x38
+
+#define AHCI_PORT_CMD_ST  (1 << 0)   /* Start processing the command list */
+#define AHCI_PORT_CMD_SUD (1 << 1)   /* Spin-up device */
+#define AHCI_PORT_CMD_POD (1 << 2)   /* Power on device */
+#define AHCI_PORT_CMD_CLO (1 << 3)   /* Command list override */
+#define AHCI_PORT_CMD_FRE (1 << 4)   /* FIS receive enable */
+#define AHCI_PORT_CMD_FR  (1 << 14)  /* FIS receive running */
+#define AHCI_PORT_CMD_CR  (1 << 15)  /* Command list running */
+
+#define AHCI_PORT_IS_DHRS (1 << 0)   /* Device to host register FIS */
+#define AHCI_PORT_IS_PSS  (1 << 1)   /* PIO setup FIS */
+#define AHCI_PORT_IS_SDBS (1 << 3)   /* Set device bits FIS */
+#define AHCI_PORT_IS_IFS  (1 << 27)  /* Interface fatal error */
+#define AHCI_PORT_IS_HBDS (1 << 28)  /* Host bus data error */
+#define AHCI_PORT_IS_HBFS (1 << 29)  /* Host bus fatal error */
+#define AHCI_PORT_IS_TFES (1 << 30)  /* Task file error */
+#define AHCI_PORT_IS_ERR  (AHCI_PORT_IS_IFS | AHCI_PORT_IS_HBDS \
+		| AHCI_PORT_IS_HBFS | AHCI_PORT_IS_TFES)
+
+#define AHCI_PORT_TFD_ERR 0x01
+#define AHCI_PORT_TFD_DRQ 0x08
+#define AHCI_PORT_TFD_BSY 0x80
+
+#define AHCI_PORT_SSTS_DET      0x0f
+#define AHCI_PORT_SSTS_DET_PHY  0x03 /* Device is present, phy is up */
+
+#define AHCI_PORT_SCTL_DET      0x0f
+#define AHCI_PORT_SCTL_DET_INIT 0x01 /* Interface initialization (COMRESET) */
+
+#define AHCI_SIG_ATA      0x00000101
+
 struct ahci_hba {
 	uintptr_t base_addr;
 	uint32_t  nports;
@@ -0,0 +1,798 @@
+/**
+ * @file
+ * @brief Generic AHCI SATA host controller on PCI
+ *
+ * @details Each port with an ATA disk becomes a block device. A request is
+ *   split into commands of at most AHCI_PRD_N pages which are issued to the
+ *   free command slots at once. If the disk supports NCQ up to 32 commands
+ *   are outstanding, otherwise DMA commands go one by one. Completion is
+ *   signalled by the interrupt which wakes up the requesters of the port.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <drivers/ahci/ahci.h>
+#include <drivers/block_dev.h>
+#include <drivers/block_dev/partition.h>
+#include <drivers/pci/pci.h>
+#include <drivers/pci/pci_driver.h>
+#include <drivers/pci/pci_id.h>
+#include <hal/reg.h>
+#include <kernel/irq.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread/waitq.h>
+#include <kernel/time/ktime.h>
+#include <mem/page.h>
+#include <mem/phymem.h>
+#include <mem/sysmalloc.h>
+#include <util/indexator.h>
+#include <util/log.h>
+
+#include <framework/mod/options.h>
+
+#define AHCI_PRD_N        OPTION_GET(NUMBER, prd_n)
+#define AHCI_TIMEOUT_MS   OPTION_GET(NUMBER, timeout_ms)
+#define AHCI_DISK_N       OPTION_GET(NUMBER, disk_n)
+
+#define AHCI_MAX_PORTS    32
+#define AHCI_MAX_SLOTS    32
+#define AHCI_SECTOR_SIZE  512
+
+/* Bound of busy waiting with the port lock held */
+#define AHCI_SPIN_LOOPS   500000
+
+/* Buffers are split at page boundaries, the first page may be partial */
+#define AHCI_MAX_SECTS    ((AHCI_PRD_N - 1) * PAGE_SIZE() / AHCI_SECTOR_SIZE)
+
+#define ATA_CMD_READ_DMA_EXT     0x25
+#define ATA_CMD_WRITE_DMA_EXT    0x35
+#define ATA_CMD_READ_FPDMA       0x60
+#define ATA_CMD_WRITE_FPDMA      0x61
+#define ATA_CMD_IDENTIFY         0xec
+
+#define ATA_DEV_LBA              0x40
+
+#define FIS_TYPE_REG_H2D         0x27
+#define FIS_H2D_CMD              0x80
+
+#define AHCI_PORT_IE_BITS \
+	(AHCI_PORT_IS_DHRS | AHCI_PORT_IS_SDBS | AHCI_PORT_IS_ERR)
+
+/* Command header, an entry of the command list */
+struct ahci_cmd_hdr {
+	uint32_t flags;
+	uint32_t prdbc;   /* Bytes transferred */
+	uint32_t ctba;    /* Command table, 128 bytes aligned */
+	uint32_t ctbau;
+	uint32_t reserved[4];
+};
+
+#define AHCI_CMD_CFL_H2D   5         /* Length of H2D FIS in dwords */
+#define AHCI_CMD_WRITE     (1 << 6)
+#define AHCI_CMD_PRDTL(n)  ((n) << 16)
+
+struct ahci_prd {
+	uint32_t dba;
+	uint32_t dbau;
+	uint32_t reserved;
+	uint32_t dbc;     /* Byte count - 1 */
+};
+
+struct ahci_cmd_tbl {
+	uint8_t cfis[64];
+	uint8_t acmd[16];
+	uint8_t reserved[48];
+	struct ahci_prd prd[AHCI_PRD_N];
+};
+
+#define AHCI_CMD_LIST_SIZE (AHCI_MAX_SLOTS * sizeof(struct ahci_cmd_hdr))
+#define AHCI_RFIS_SIZE     256
+
+struct ahci_pci_hba;
+
+struct ahci_port {
+	struct ahci_pci_hba *hba;
+	uintptr_t base;
+	int num;
+
+	struct ahci_cmd_hdr *cmd_list;
+	void *rfis;
+	struct ahci_cmd_tbl *cmd_tbl;
+	int cmd_tbl_pages;
+
+	int ncq;
+	int depth;          /* Number of slots in use */
+	uint32_t issued;    /* Slots given to the HBA */
+	uint32_t busy;      /* Slots owned by requesters */
+	uint32_t done;      /* Completed, not yet collected by requesters */
+	uint32_t failed;
+	int recovering;     /* Port IRQs are masked, nothing is issued */
+	int irq_recover;    /* Recovery is left to the IRQ thread */
+	spinlock_t lock;
+	struct waitq wq;
+
+	uint64_t sectors;
+	struct block_dev *bdev;
+};
+
+struct ahci_pci_hba {
+	struct ahci_hba hba;
+	struct pci_slot_dev *pci_dev;
+	unsigned int irq;
+	uint32_t cap;
+	struct ahci_port *ports[AHCI_MAX_PORTS];
+};
+
+static const struct pci_id ahci_pci_id_table[] = {
+	{ PCI_ANY_ID, PCI_ANY_ID, PCI_CLASS_ID(PCI_BASE_CLASS_STORAGE,
+			PCI_CLASS_STORAGE_SATA, PCI_PROG_IF_SATA_AHCI) },
+};
+
+PCI_DRIVER_TABLE("ahci", ahci_pci_init, ahci_pci_id_table);
+
+INDEX_DEF(ahci_disk_idx, 0, AHCI_DISK_N);
+
+static const struct block_dev_driver ahci_bdev_driver;
+
+static inline uint32_t ahci_port_read(struct ahci_port *port, int reg) {
+	return REG32_LOAD(port->base + reg);
+}
+
+static inline void ahci_port_write(struct ahci_port *port, int reg,
+		uint32_t val) {
+	REG32_STORE(port->base + reg, val);
+}
+
+/* Polls until (reg & mask) == val, used only out of the I/O path */
+static int ahci_wait(uintptr_t reg, uint32_t mask, uint32_t val,
+		int timeout_ms) {
+	while ((REG32_LOAD(reg) & mask) != val) {
+		if (timeout_ms-- <= 0) {
+			return -ETIMEDOUT;
+		}
+		usleep(1000);
+	}
+	return 0;
+}
+
+static int ahci_port_stop(struct ahci_port *port) {
+	REG32_CLEAR(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_ST);
+	if (ahci_wait(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_CR, 0, 500)) {
+		return -ETIMEDOUT;
+	}
+
+	REG32_CLEAR(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_FRE);
+	return ahci_wait(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_FR, 0, 500);
+}
+
+static int ahci_port_start(struct ahci_port *port) {
+	ahci_port_write(port, AHCI_PORT_SERR, ~0);
+	ahci_port_write(port, AHCI_PORT_IS, ~0);
+
+	REG32_ORIN(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_FRE);
+	if (ahci_wait(port->base + AHCI_PORT_TFD,
+			AHCI_PORT_TFD_BSY | AHCI_PORT_TFD_DRQ, 0, 1000)) {
+		return -ETIMEDOUT;
+	}
+	REG32_ORIN(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_ST);
+
+	return 0;
+}
+
+/* Same as ahci_wait(), but busy waits */
+static int ahci_spin(uintptr_t reg, uint32_t mask, uint32_t val) {
+	int i;
+
+	for (i = 0; i < AHCI_SPIN_LOOPS; i++) {
+		if ((REG32_LOAD(reg) & mask) == val) {
+			return 0;
+		}
+	}
+	return -ETIMEDOUT;
+}
+
+static inline int ahci_port_busy(struct ahci_port *port) {
+	return ahci_port_read(port, AHCI_PORT_TFD)
+		& (AHCI_PORT_TFD_BSY | AHCI_PORT_TFD_DRQ);
+}
+
+/* Resets the link, the device comes back with a D2H register FIS */
+static void ahci_port_comreset(struct ahci_port *port) {
+	uint32_t sctl;
+	time64_t start;
+	int i;
+
+	sctl = ahci_port_read(port, AHCI_PORT_SCTL) & ~AHCI_PORT_SCTL_DET;
+	ahci_port_write(port, AHCI_PORT_SCTL, sctl | AHCI_PORT_SCTL_DET_INIT);
+
+	/* COMRESET is sent for 1 ms at least */
+	start = ktime_get_ns();
+	for (i = 0; i < AHCI_SPIN_LOOPS && ktime_get_ns() - start < 1000000; i++) {
+	}
+
+	ahci_port_write(port, AHCI_PORT_SCTL, sctl);
+	ahci_spin(port->base + AHCI_PORT_SSTS, AHCI_PORT_SSTS_DET,
+			AHCI_PORT_SSTS_DET_PHY);
+	ahci_port_write(port, AHCI_PORT_SERR, ~0);
+	ahci_spin(port->base + AHCI_PORT_TFD,
+			AHCI_PORT_TFD_BSY | AHCI_PORT_TFD_DRQ, 0);
+}
+
+/* @return 1 if the caller is to recover the port, called with the port
+ * lock held */
+static int ahci_port_recover_claim(struct ahci_port *port) {
+	if (port->recovering) {
+		return 0;
+	}
+
+	port->recovering = 1;
+	ahci_port_write(port, AHCI_PORT_IE, 0);
+
+	return 1;
+}
+
+/* Aborts all issued commands and brings the port back. Runs in thread
+ * context with the port claimed. The steps are polled with busy waiting,
+ * as the IRQ thread must not block. */
+static void ahci_port_recover(struct ahci_port *port) {
+	ipl_t ipl;
+
+	log_error("port %d: error, tfd %08x", port->num,
+			ahci_port_read(port, AHCI_PORT_TFD));
+
+	REG32_CLEAR(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_ST);
+	ahci_spin(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_CR, 0);
+
+	ahci_port_write(port, AHCI_PORT_SERR, ~0);
+	ahci_port_write(port, AHCI_PORT_IS, ~0);
+
+	/* A hung device keeps BSY, the engine can't start then */
+	if (ahci_port_busy(port) && (port->hba->cap & AHCI_CAP_SCLO)) {
+		REG32_ORIN(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_CLO);
+		ahci_spin(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_CLO, 0);
+	}
+	if (ahci_port_busy(port)) {
+		ahci_port_comreset(port);
+		ahci_port_write(port, AHCI_PORT_IS, ~0);
+	}
+
+	ipl = spin_lock_ipl(&port->lock);
+	{
+		port->failed |= port->issued;
+		port->done |= port->issued;
+		port->issued = 0;
+
+		REG32_ORIN(port->base + AHCI_PORT_CMD, AHCI_PORT_CMD_ST);
+		ahci_port_write(port, AHCI_PORT_IE, AHCI_PORT_IE_BITS);
+		port->recovering = 0;
+	}
+	spin_unlock_ipl(&port->lock, ipl);
+
+	waitq_wakeup_all(&port->wq);
+}
+
+static void ahci_fis_h2d(uint8_t *fis, uint8_t cmd, uint64_t lba,
+		uint16_t count, uint16_t features) {
+	memset(fis, 0, 20);
+	fis[0] = FIS_TYPE_REG_H2D;
+	fis[1] = FIS_H2D_CMD;
+	fis[2] = cmd;
+	fis[3] = features & 0xff;
+	fis[4] = lba & 0xff;
+	fis[5] = (lba >> 8) & 0xff;
+	fis[6] = (lba >> 16) & 0xff;
+	fis[7] = cmd == ATA_CMD_IDENTIFY ? 0 : ATA_DEV_LBA;
+	fis[8] = (lba >> 24) & 0xff;
+	fis[9] = (lba >> 32) & 0xff;
+	fis[10] = (lba >> 40) & 0xff;
+	fis[11] = features >> 8;
+	fis[12] = count & 0xff;
+	fis[13] = count >> 8;
+}
+
+/* @return number of PRD entries */
+static int ahci_fill_prds(struct ahci_cmd_tbl *tbl, char *buf, size_t len) {
+	size_t chunk;
+	int i;
+
+	for (i = 0; len > 0; i++) {
+		chunk = PAGE_SIZE() - ((uintptr_t) buf & (PAGE_SIZE() - 1));
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		tbl->prd[i].dba = (uint32_t) (uintptr_t) buf;
+		tbl->prd[i].dbau = 0;
+		tbl->prd[i].reserved = 0;
+		tbl->prd[i].dbc = chunk - 1;
+
+		buf += chunk;
+		len -= chunk;
+	}
+
+	return i;
+}
+
+static void ahci_cmd_prepare(struct ahci_port *port, int slot, uint8_t cmd,
+		uint64_t lba, uint16_t nsect, char *buf, int write) {
+	struct ahci_cmd_tbl *tbl = &port->cmd_tbl[slot];
+	struct ahci_cmd_hdr *hdr = &port->cmd_list[slot];
+	int prdtl;
+
+	if (cmd == ATA_CMD_READ_FPDMA || cmd == ATA_CMD_WRITE_FPDMA) {
+		/* Sector count is in features, tag is in count */
+		ahci_fis_h2d(tbl->cfis, cmd, lba, slot << 3, nsect);
+	} else {
+		ahci_fis_h2d(tbl->cfis, cmd, lba, nsect, 0);
+	}
+
+	prdtl = ahci_fill_prds(tbl, buf, nsect * AHCI_SECTOR_SIZE);
+
+	hdr->flags = AHCI_CMD_CFL_H2D | AHCI_CMD_PRDTL(prdtl)
+		| (write ? AHCI_CMD_WRITE : 0);
+	hdr->prdbc = 0;
+}
+
+/* Called with the port lock held */
+static void ahci_cmd_issue(struct ahci_port *port, int slot) {
+	port->issued |= 1u << slot;
+	if (port->ncq) {
+		ahci_port_write(port, AHCI_PORT_SACT, 1u << slot);
+	}
+	ahci_port_write(port, AHCI_PORT_CI, 1u << slot);
+}
+
+/* @return 1 if the port is to be recovered by the IRQ thread */
+static int ahci_port_irq(struct ahci_port *port) {
+	uint32_t is, active, done;
+	int recover = 0;
+
+	is = ahci_port_read(port, AHCI_PORT_IS);
+	ahci_port_write(port, AHCI_PORT_IS, is);
+
+	spin_lock(&port->lock);
+	{
+		if (port->recovering) {
+			/* Commands are collected by the recovery */
+		} else if (is & AHCI_PORT_IS_ERR) {
+			ahci_port_recover_claim(port);
+			port->irq_recover = 1;
+			recover = 1;
+		} else {
+			/* NCQ command is done when the device clears SACT bit with
+			 * SDB FIS, others are done with CI bit */
+			active = ahci_port_read(port, AHCI_PORT_SACT)
+				| ahci_port_read(port, AHCI_PORT_CI);
+			done = port->issued & ~active;
+
+			port->issued &= ~done;
+			port->done |= done;
+		}
+	}
+	spin_unlock(&port->lock);
+
+	if (!recover) {
+		waitq_wakeup_all(&port->wq);
+	}
+
+	return recover;
+}
+
+static irq_return_t ahci_irq_handler(unsigned int irq_nr, void *data) {
+	struct ahci_pci_hba *hba = data;
+	uint32_t is;
+	int i, recover = 0;
+
+	is = REG32_LOAD(hba->hba.base_addr + AHCI_IS);
+	if (!is) {
+		return IRQ_NONE;
+	}
+
+	for (i = 0; i < AHCI_MAX_PORTS; i++) {
+		if ((is & (1u << i)) && hba->ports[i]) {
+			recover |= ahci_port_irq(hba->ports[i]);
+		}
+	}
+
+	/* Port status is cleared first, otherwise the HBA raises it again */
+	REG32_STORE(hba->hba.base_addr + AHCI_IS, is);
+
+	return recover ? IRQ_WAKE_THREAD : IRQ_HANDLED;
+}
+
+/* Recovery busy waits for the link, so it's out of the hard IRQ */
+static irq_return_t ahci_irq_thread(unsigned int irq_nr, void *data) {
+	struct ahci_pci_hba *hba = data;
+	struct ahci_port *port;
+	int i, recover;
+	ipl_t ipl;
+
+	for (i = 0; i < AHCI_MAX_PORTS; i++) {
+		if (!(port = hba->ports[i])) {
+			continue;
+		}
+
+		ipl = spin_lock_ipl(&port->lock);
+		recover = port->irq_recover;
+		port->irq_recover = 0;
+		spin_unlock_ipl(&port->lock, ipl);
+
+		if (recover) {
+			ahci_port_recover(port);
+		}
+	}
+
+	return IRQ_HANDLED;
+}
+
+static inline uint32_t ahci_slots_free(struct ahci_port *port) {
+	return ~port->busy & (uint32_t) ((1ull << port->depth) - 1);
+}
+
+/* @return free slot or -1, called with the port lock held */
+static int ahci_slot_get(struct ahci_port *port) {
+	uint32_t free = ahci_slots_free(port);
+	int slot;
+
+	if (!free) {
+		return -1;
+	}
+
+	slot = __builtin_ctz(free);
+	port->busy |= 1u << slot;
+
+	return slot;
+}
+
+static int ahci_rw(struct block_dev *bdev, char *buf, size_t count,
+		blkno_t blkno, int write) {
+	struct ahci_port *port = bdev->privdata;
+	uint32_t mine = 0, done;
+	uint64_t lba = blkno;
+	size_t nsect, n;
+	uint8_t cmd;
+	ipl_t ipl;
+	int slot, recover, ret = 0;
+
+	if (count % AHCI_SECTOR_SIZE) {
+		/* DMA transfers whole sectors only */
+		return -EINVAL;
+	}
+
+	nsect = count / AHCI_SECTOR_SIZE;
+	if (nsect == 0) {
+		return 0;
+	}
+	if (lba + nsect > port->sectors) {
+		return -EINVAL;
+	}
+
+	if (port->ncq) {
+		cmd = write ? ATA_CMD_WRITE_FPDMA : ATA_CMD_READ_FPDMA;
+	} else {
+		cmd = write ? ATA_CMD_WRITE_DMA_EXT : ATA_CMD_READ_DMA_EXT;
+	}
+
+	while (nsect > 0 || mine) {
+		ipl = spin_lock_ipl(&port->lock);
+		{
+			/* Take as many slots as possible for the rest of the request */
+			while (nsect > 0 && !port->recovering
+					&& (slot = ahci_slot_get(port)) >= 0) {
+				n = nsect < AHCI_MAX_SECTS ? nsect : AHCI_MAX_SECTS;
+
+				ahci_cmd_prepare(port, slot, cmd, lba, n, buf, write);
+				ahci_cmd_issue(port, slot);
+				mine |= 1u << slot;
+
+				buf += n * AHCI_SECTOR_SIZE;
+				lba += n;
+				nsect -= n;
+			}
+		}
+		spin_unlock_ipl(&port->lock, ipl);
+
+		/* Wait for own commands, or for a free slot if there are none */
+		if (WAITQ_WAIT_TIMEOUT(&port->wq,
+				mine ? (port->done & mine)
+					: (ahci_slots_free(port) && !port->recovering),
+				AHCI_TIMEOUT_MS) && mine) {
+			ipl = spin_lock_ipl(&port->lock);
+			/* Hung commands are aborted and fail */
+			recover = (mine & port->issued) && ahci_port_recover_claim(port);
+			spin_unlock_ipl(&port->lock, ipl);
+
+			if (recover) {
+				ahci_port_recover(port);
+			}
+		}
+
+		ipl = spin_lock_ipl(&port->lock);
+		{
+			done = port->done & mine;
+			if (port->failed & done) {
+				ret = -EIO;
+			}
+			port->done &= ~done;
+			port->failed &= ~done;
+			port->busy &= ~done;
+			mine &= ~done;
+		}
+		spin_unlock_ipl(&port->lock, ipl);
+
+		if (done) {
+			/* Freed slots may be awaited by other requesters */
+			waitq_wakeup_all(&port->wq);
+		}
+
+		if (ret != 0) {
+			/* The rest is not issued, already issued is waited for */
+			nsect = 0;
+		}
+	}
+
+	return ret == 0 ? count : ret;
+}
+
+static int ahci_read(struct block_dev *bdev, char *buf, size_t count,
+		blkno_t blkno) {
+	return ahci_rw(bdev, buf, count, blkno, 0);
+}
+
+static int ahci_write(struct block_dev *bdev, char *buf, size_t count,
+		blkno_t blkno) {
+	return ahci_rw(bdev, buf, count, blkno, 1);
+}
+
+static int ahci_ioctl(struct block_dev *bdev, int cmd, void *args,
+		size_t size) {
+	struct ahci_port *port = bdev->privdata;
+
+	switch (cmd) {
+	case IOCTL_GETDEVSIZE:
+		return port->sectors;
+	case IOCTL_GETBLKSIZE:
+		return AHCI_SECTOR_SIZE;
+	case IOCTL_REVALIDATE:
+		return create_partitions(bdev);
+	}
+
+	return -ENOSYS;
+}
+
+static const struct block_dev_driver ahci_bdev_driver = {
+	.name  = "ahci",
+	.ioctl = ahci_ioctl,
+	.read  = ahci_read,
+	.write = ahci_write,
+};
+
+/* Executes a command in slot 0 by polling, interrupts of the port are off */
+static int ahci_exec_polled(struct ahci_port *port, uint8_t cmd, void *buf,
+		size_t len) {
+	struct ahci_cmd_tbl *tbl = &port->cmd_tbl[0];
+	int ret;
+
+	ahci_fis_h2d(tbl->cfis, cmd, 0, 0, 0);
+	port->cmd_list[0].flags = AHCI_CMD_CFL_H2D
+		| AHCI_CMD_PRDTL(ahci_fill_prds(tbl, buf, len));
+	port->cmd_list[0].prdbc = 0;
+
+	ahci_port_write(port, AHCI_PORT_CI, 1);
+	ret = ahci_wait(port->base + AHCI_PORT_CI, 1, 0, AHCI_TIMEOUT_MS);
+
+	if (ret == 0 && (ahci_port_read(port, AHCI_PORT_TFD) & AHCI_PORT_TFD_ERR)) {
+		ret = -EIO;
+	}
+	ahci_port_write(port, AHCI_PORT_IS, ~0);
+
+	return ret;
+}
+
+static int ahci_port_identify(struct ahci_port *port, uint32_t cap) {
+	uint16_t *id;
+	int ret;
+
+	if (!(id = phymem_alloc(1))) {
+		return -ENOMEM;
+	}
+
+	ret = ahci_exec_polled(port, ATA_CMD_IDENTIFY, id, AHCI_SECTOR_SIZE);
+	if (ret != 0) {
+		goto out;
+	}
+
+	if (id[83] & (1 << 10)) {
+		/* 48-bit addressing */
+		port->sectors = (uint64_t) id[100] | ((uint64_t) id[101] << 16)
+			| ((uint64_t) id[102] << 32) | ((uint64_t) id[103] << 48);
+	} else {
+		port->sectors = (uint64_t) id[60] | ((uint64_t) id[61] << 16);
+	}
+
+	port->depth = ((cap & AHCI_CAP_NCS) >> AHCI_CAP_NCS_SHIFT) + 1;
+	port->ncq = (cap & AHCI_CAP_SNCQ) && (id[76] & (1 << 8));
+	if (port->ncq) {
+		if (port->depth > (id[75] & 0x1f) + 1) {
+			port->depth = (id[75] & 0x1f) + 1;
+		}
+	} else {
+		port->depth = 1;
+	}
+
+out:
+	phymem_free(id, 1);
+	return ret;
+}
+
+static void ahci_port_free(struct ahci_port *port) {
+	if (port->cmd_tbl) {
+		phymem_free(port->cmd_tbl, port->cmd_tbl_pages);
+	}
+	if (port->cmd_list) {
+		phymem_free(port->cmd_list, 1);
+	}
+	sysfree(port);
+}
+
+static struct ahci_port *ahci_port_init(struct ahci_pci_hba *hba, int num) {
+	struct ahci_port *port;
+	uintptr_t base;
+	int i;
+
+	base = hba->hba.base_addr + AHCI_PORT(num);
+	if ((REG32_LOAD(base + AHCI_PORT_SSTS) & AHCI_PORT_SSTS_DET)
+				!= AHCI_PORT_SSTS_DET_PHY
+			|| REG32_LOAD(base + AHCI_PORT_SIG) != AHCI_SIG_ATA) {
+		return NULL;
+	}
+
+	if (!(port = sysmalloc(sizeof(*port)))) {
+		return NULL;
+	}
+	memset(port, 0, sizeof(*port));
+	port->hba = hba;
+	port->base = base;
+	port->num = num;
+	spin_init(&port->lock, __SPIN_UNLOCKED);
+	waitq_init(&port->wq);
+
+	/* Command list and received FIS share a page */
+	port->cmd_tbl_pages = (AHCI_MAX_SLOTS * sizeof(struct ahci_cmd_tbl)
+			+ PAGE_SIZE() - 1) / PAGE_SIZE();
+	port->cmd_list = phymem_alloc(1);
+	port->cmd_tbl = phymem_alloc(port->cmd_tbl_pages);
+	if (!port->cmd_list || !port->cmd_tbl) {
+		goto err;
+	}
+	port->rfis = (char *) port->cmd_list + AHCI_CMD_LIST_SIZE;
+	memset(port->cmd_list, 0, AHCI_CMD_LIST_SIZE + AHCI_RFIS_SIZE);
+
+	for (i = 0; i < AHCI_MAX_SLOTS; i++) {
+		port->cmd_list[i].ctba = (uint32_t) (uintptr_t) &port->cmd_tbl[i];
+	}
+
+	if (ahci_port_stop(port) != 0) {
+		goto err;
+	}
+
+	ahci_port_write(port, AHCI_PORT_CLB, (uint32_t) (uintptr_t) port->cmd_list);
+	ahci_port_write(port, AHCI_PORT_CLBU, 0);
+	ahci_port_write(port, AHCI_PORT_FB, (uint32_t) (uintptr_t) port->rfis);
+	ahci_port_write(port, AHCI_PORT_FBU, 0);
+	ahci_port_write(port, AHCI_PORT_IE, 0);
+
+	if (ahci_port_start(port) != 0
+			|| ahci_port_identify(port, hba->cap) != 0) {
+		ahci_port_stop(port);
+		goto err;
+	}
+
+	ahci_port_write(port, AHCI_PORT_IE, AHCI_PORT_IE_BITS);
+
+	return port;
+err:
+	log_error("port %d: initialization failed", num);
+	ahci_port_free(port);
+	return NULL;
+}
+
+static int ahci_port_bdev_create(struct ahci_port *port) {
+	char path[PATH_MAX];
+
+	strcpy(path, "/dev/sata#");
+	if (0 > block_dev_named(path, &ahci_disk_idx)) {
+		return -ENOMEM;
+	}
+
+	port->bdev = block_dev_create(path, (void *) &ahci_bdev_driver, port);
+	if (!port->bdev) {
+		return -ENOMEM;
+	}
+	port->bdev->block_size = AHCI_SECTOR_SIZE;
+	port->bdev->size = port->sectors * AHCI_SECTOR_SIZE;
+
+	log_info("%s: %llu sectors, %s, %d slots", path,
+			(unsigned long long) port->sectors,
+			port->ncq ? "NCQ" : "no NCQ", port->depth);
+
+	return create_partitions(port->bdev);
+}
+
+static int ahci_pci_init(struct pci_slot_dev *pci_dev) {
+	struct ahci_pci_hba *hba;
+	uintptr_t abar;
+	uint32_t pi;
+	int i, ret;
+
+	if (!(hba = sysmalloc(sizeof(*hba)))) {
+		return -ENOMEM;
+	}
+	memset(hba, 0, sizeof(*hba));
+	hba->pci_dev = pci_dev;
+
+	abar = PCI_BAR_BASE(pci_dev->bar[5]);
+	hba->hba.base_addr = (uintptr_t) mmap_device_memory((void *) abar,
+			AHCI_PORT(AHCI_MAX_PORTS), PROT_READ | PROT_WRITE | PROT_NOCACHE,
+			MAP_FIXED, abar);
+	if (!hba->hba.base_addr) {
+		sysfree(hba);
+		return -ENOMEM;
+	}
+
+	pci_set_master(pci_dev);
+
+	REG32_ORIN(hba->hba.base_addr + AHCI_GHC, AHCI_GHC_AE);
+	hba->cap = REG32_LOAD(hba->hba.base_addr + AHCI_CAP);
+	pi = REG32_LOAD(hba->hba.base_addr + AHCI_PI);
+	hba->hba.nports = (hba->cap & AHCI_CAP_NP) + 1;
+
+	for (i = 0; i < AHCI_MAX_PORTS; i++) {
+		if (pi & (1u << i)) {
+			hba->ports[i] = ahci_port_init(hba, i);
+		}
+	}
+
+	/* Single vector is enough, all ports are checked in the handler */
+	ret = pci_msi_enable(pci_dev, 1);
+	if (ret > 0) {
+		hba->irq = ret;
+		ret = irq_attach_threaded(hba->irq, ahci_irq_handler,
+				ahci_irq_thread, 0, hba, "ahci");
+	} else {
+		hba->irq = pci_dev->irq;
+		ret = irq_attach_threaded(hba->irq, ahci_irq_handler,
+				ahci_irq_thread, IF_SHARESUP, hba, "ahci");
+	}
+	if (ret != 0) {
+		pci_msi_disable(pci_dev);
+		for (i = 0; i < AHCI_MAX_PORTS; i++) {
+			if (hba->ports[i]) {
+				ahci_port_stop(hba->ports[i]);
+				ahci_port_free(hba->ports[i]);
+			}
+		}
+		sysfree(hba);
+		return ret;
+	}
+
+	REG32_STORE(hba->hba.base_addr + AHCI_IS, ~0);
+	REG32_ORIN(hba->hba.base_addr + AHCI_GHC, AHCI_GHC_IE);
+
+	register_ahci_hba(&hba->hba);
+
+	for (i = 0; i < AHCI_MAX_PORTS; i++) {
+		if (hba->ports[i] && ahci_port_bdev_create(hba->ports[i]) != 0) {
+			log_error("port %d: block device is not created", i);
+		}
+	}
+
+	return 0;
+}
@@ -87,7 +87,7 @@ static void aaci_pl041_dev_start(struct audio_dev *dev) {
 	hw_dev = priv->hw_dev;
 	aacirun = &hw_dev->aaci_runtime;
 
-	//log_debug("dev = 0x%X", dev);
+	//log_debug("dev = %p", dev);
 
 	ptr = audio_dev_get_out_cur_ptr(dev);
 	len = hw_dev->fifo_depth;
@@ -131,7 +131,7 @@ static void aaci_pl041_dev_stop(struct audio_dev *dev) {
 	hw_dev = priv->hw_dev;
 	aacirun = &hw_dev->aaci_runtime;
 
-	log_debug("dev = 0x%X", dev);
+	log_debug("dev = %p", dev);
 	ie = REG32_LOAD(aacirun->base + AACI_IE);
 	ie &= ~(AACI_IE_URIE | AACI_IE_TXIE);
 	REG32_STORE(aacirun->base + AACI_IE, ie);
@@ -141,17 +141,17 @@ static void aaci_pl041_dev_stop(struct audio_dev *dev) {
 }
 
 static void aaci_pl041_dev_pause(struct audio_dev *dev) {
-	log_debug("dev = 0x%X", dev);
+	log_debug("dev = %p", dev);
 	aaci_pl041_dev_stop(dev);
 }
 
 static void aaci_pl041_dev_resume(struct audio_dev *dev) {
-	log_debug("dev = 0x%X", dev);
+	log_debug("dev = %p", dev);
 	aaci_pl041_dev_start(dev);
 }
 
 static int aaci_pl041_ioctl(struct audio_dev *dev, int cmd, void *args) {
-	log_debug("dev = 0x%X", dev);
+	log_debug("dev = %p", dev);
 	switch(cmd) {
 	case ADIOCTL_IN_SUPPORT:
 		return 0;
@@ -124,7 +124,7 @@ static void *pa_thread_hnd(void *arg) {
 		out_buf = audio_dev_get_out_cur_ptr(audio_dev);
 		in_buf  = audio_dev_get_in_cur_ptr(audio_dev);
 
-		log_debug("out_buf = 0x%X, buf_len %d", out_buf, audio_dev->buf_len);
+		log_debug("out_buf = %p, buf_len %d", out_buf, audio_dev->buf_len);
 
 		if (out_buf)
 			memset(out_buf, 0, audio_dev->buf_len);
@@ -218,10 +218,15 @@ int block_dev_write_buffered(struct block_dev *bdev, const char *buffer, size_t
 			 * Blocks are stored in the buffer cache in a decrypted state.
 			 * Therefore first we encrypt block, then write it onto disk and then decrypt block.
 			 */
-			buffer_encrypt(bh);
+			if (0 != (res = buffer_encrypt(bh))) {
+				/* Contents differ from the disk, read it again next time */
+				buffer_set_flag(bh, BH_NEW);
+				bcache_buffer_unlock(bh);
+				return res;
+			}
 			if (blksize != (res = bdev->driver->write(bdev, bh->data,
 					blksize, blkno + i))) {
-				buffer_decrypt(bh);
+				buffer_set_flag(bh, BH_NEW);
 				bcache_buffer_unlock(bh);
 				return res;
 			}
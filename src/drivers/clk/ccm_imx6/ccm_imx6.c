@@ -181,7 +181,7 @@ void clk_reg_dump(void) {
 
 	log_debug("");
 	for (int i = 0x20C8000; i <= 0x20C817C; i+=4) {
-		log_debug("%p =0x%08x", i, REG32_LOAD(i));
+		log_debug("0x%08x =0x%08x", i, REG32_LOAD(i));
 	}
 
 
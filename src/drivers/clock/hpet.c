@@ -31,6 +31,8 @@ EMBOX_UNIT_INIT(hpet_init);
 #define HPET_GEN_INT_REG    0x020
 #define HPET_MAIN_CNT_REG   0x0F0
 
+#define COUNT_SIZE_CAP      (1 << 13)
+
 #define ENABLE_CNF          0x1
 
 #define FEMPTOSEC_IN_SEC    1000000000000000ULL /* 10^15 */
@@ -91,6 +93,9 @@ static int hpet_init(void) {
 
 	hpet_base_address = hpet_table->Address.Address;
 	hpet_counter_device.cycle_hz = hpet_get_hz();
+	if (!(hpet_get_register(HPET_GEN_CAP_REG) & COUNT_SIZE_CAP)) {
+		hpet_counter_device.mask = 0xFFFFFFFF;
+	}
 	hpet_start_counter();
 
 #ifdef HPET_DEBUG
@@ -119,6 +119,7 @@ static ssize_t fbcon_idesc_read(struct idesc *idesc, const struct iovec *iov, in
 
 static ssize_t fbcon_idesc_write(struct idesc *idesc, const struct iovec *iov, int cnt) {
 	struct fbcon *fbcon = data2fbcon(idesc);
+	struct fb_info *fb;
 	char *cbuf;
 	size_t nbyte;
 
@@ -127,10 +128,20 @@ static ssize_t fbcon_idesc_write(struct idesc *idesc, const struct iovec *iov, i
 	assert(cnt == 1);
 	nbyte = iov->iov_len;
 
+	fb = fbcon->vc_this.fb;
+	if (fb) {
+		/* Whole output goes to the screen at once */
+		fb_update_begin(fb);
+	}
+
 	while (nbyte--) {
 		vterm_putc(&fbcon->vterm, *cbuf++);
 	}
 
+	if (fb) {
+		fb_update_end(fb);
+	}
+
 	return (ssize_t)((uintptr_t)cbuf - (uintptr_t)iov->iov_base);
 }
 
@@ -46,7 +46,7 @@ int gpio_settings(struct gpio *gpio, gpio_mask_t mask, int mode) {
 
 	gpio_port = (void *)(BASE_CTRL_ADDR + gpio->port_id * sizeof(struct gpio_dwapb_port));
 
-	log_debug("%p mask 0x%X mode %d", gpio_port, mask, mode);
+	log_debug("%p mask 0x%lX mode %d", gpio_port, mask, mode);
 	ctl = REG32_LOAD(&gpio_port->ctl);
 	ctl &= ~mask;
 	REG32_STORE(&gpio_port->ctl, ctl); /* all hardware pins */
@@ -76,7 +76,7 @@ void gpio_set_level(struct gpio *gpio, gpio_mask_t mask, char level) {
 	} else {
 		dr &= ~mask;
 	}
-	log_debug("%p mask 0x%X mode %d", gpio_port, mask, level);
+	log_debug("%p mask 0x%lX mode %d", gpio_port, mask, level);
 	REG32_STORE(&gpio_port->dr, dr);
 }
 
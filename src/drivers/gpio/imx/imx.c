@@ -48,7 +48,7 @@ int gpio_settings(struct gpio *gpio, gpio_mask_t mask, int mode) {
 
 	int num = GPIO_NUM(gpio);
 
-	log_debug("Set GPIO%d;mask=0x%08x;mode=%d", num, mask, mode);
+	log_debug("Set GPIO%d;mask=0x%08lx;mode=%d", num, mask, mode);
 
 	switch (mode) {
 	case GPIO_MODE_INPUT:
@@ -72,7 +72,7 @@ int gpio_settings(struct gpio *gpio, gpio_mask_t mask, int mode) {
 void gpio_set_level(struct gpio *gpio, gpio_mask_t mask, char level) {
 	int num = GPIO_NUM(gpio);
 
-	log_debug("set level %d for GPIO#%d 0x%08x", level, num, mask);
+	log_debug("set level %d for GPIO#%d 0x%08lx", level, num, mask);
 
 	REG32_ORIN(GPIO_DR(num), mask * level);
 }
@@ -81,7 +81,7 @@ gpio_mask_t gpio_get_level(struct gpio *gpio, gpio_mask_t mask) {
 	int num = GPIO_NUM(gpio);
 	int ret = REG32_LOAD(GPIO_DR(num)) & mask;
 
-	log_debug("get level for GPIO#%d 0x%08x=0x%08x", num, mask, ret);
+	log_debug("get level for GPIO#%d 0x%08lx=0x%08x", num, mask, ret);
 
 	return ret;
 }
@@ -8,6 +8,8 @@
 
 #include <embox/unit.h>
 
+#include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 #include <asm/io.h>
@@ -16,6 +18,7 @@
 #include "lapic.h"
 
 #include <drivers/irqctrl.h>
+#include <kernel/spinlock.h>
 
 #include <module/embox/driver/interrupt/lapic.h>
 
@@ -34,8 +37,25 @@
 #define IOAPIC_ICR_TRIGGER        (1 << 15)
 #define IOAPIC_ICR_INT_MASK       (1 << 16)
 
+#define IOAPIC_IRQ_VECTOR(irq)    ((irq) + 0x20)
+#define IOAPIC_IRQ_IS_MSI(irq)    ((irq) >= IOAPIC_PINS)
+
 EMBOX_UNIT_INIT(ioapic_enable);
 
+static spinlock_t ioapic_lock = SPIN_STATIC_UNLOCKED;
+
+/* APIC ID the IRQ is routed to, -1 is for the CPU enabling the IRQ */
+static int irq_dest[__IRQCTRL_IRQS_TOTAL] = {
+	[0 ... __IRQCTRL_IRQS_TOTAL - 1] = -1
+};
+
+/* Allocated MSI have the writer set */
+static struct {
+	irqctrl_msi_write_t write;
+	irqctrl_msi_mask_t mask;
+	void *dev;
+} msi_irqs[IOAPIC_MSI_IRQS];
+
 static inline uint32_t ioapic_read(uint8_t reg) {
 	*((volatile uint32_t *)(IOREGSEL)) = reg;
 	return *((volatile uint32_t *)(IOREGWIN));
@@ -101,11 +121,33 @@ static inline uint32_t irq_redir_low(unsigned int irq) {
 		val |= IOAPIC_ICR_TRIGGER;
 	}
 
-	val |= (irq + 0x20);
+	val |= IOAPIC_IRQ_VECTOR(irq);
 
 	return val;
 }
 
+static inline uint32_t irq_dest_id(unsigned int irq) {
+	return irq_dest[irq] < 0 ? lapic_id() : irq_dest[irq];
+}
+
+void irqctrl_msi_compose(unsigned int irq, struct irqctrl_msi_msg *msg) {
+	msg->address_lo = LAPIC_MSI_ADDR(irq_dest_id(irq));
+	msg->address_hi = 0;
+	/* Fixed delivery mode, edge triggered */
+	msg->data = IOAPIC_IRQ_VECTOR(irq);
+}
+
+static void ioapic_msi_mask(unsigned int irq, int mask) {
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&ioapic_lock);
+	if (msi_irqs[irq - IOAPIC_PINS].mask) {
+		msi_irqs[irq - IOAPIC_PINS].mask(irq, mask,
+				msi_irqs[irq - IOAPIC_PINS].dev);
+	}
+	spin_unlock_ipl(&ioapic_lock, ipl);
+}
+
 void irqctrl_enable(unsigned int irq) {
 	uint32_t low, high;
 
@@ -114,8 +156,14 @@ void irqctrl_enable(unsigned int irq) {
 		return ;
 	}
 
+	if (IOAPIC_IRQ_IS_MSI(irq)) {
+		/* MSI are masked at the device */
+		ioapic_msi_mask(irq, 0);
+		return;
+	}
+
 	low = irq_redir_low(irq);
-	high = lapic_id() << 24;
+	high = irq_dest_id(irq) << 24;
 
 	ioapic_write(IOAPIC_REDIR_TABLE + irq * 2 + 1, high);
 	ioapic_write(IOAPIC_REDIR_TABLE + irq * 2, low);
@@ -129,6 +177,11 @@ void irqctrl_disable(unsigned int irq) {
 		return ;
 	}
 
+	if (IOAPIC_IRQ_IS_MSI(irq)) {
+		ioapic_msi_mask(irq, 1);
+		return;
+	}
+
 	low = ioapic_read(IOAPIC_REDIR_TABLE + irq * 2);
 	low |= IOAPIC_ICR_INT_MASK;
 	ioapic_write(IOAPIC_REDIR_TABLE + irq * 2, low);
@@ -144,6 +197,100 @@ int irqctrl_pending(unsigned int irq) {
 }
 
 void irqctrl_eoi(unsigned int irq) {
-	//TODO: irq >= 16
 	lapic_send_eoi();
 }
+
+int irqctrl_set_affinity(unsigned int irq, unsigned int cpu) {
+	struct irqctrl_msi_msg msg;
+	uint32_t low;
+	ipl_t ipl;
+
+	if (irq == 0) {
+		/* LAPIC timer is per CPU */
+		return -EINVAL;
+	}
+
+	/* CPU number is the APIC ID, see cpu_get_id() */
+	ipl = spin_lock_ipl(&ioapic_lock);
+	irq_dest[irq] = cpu;
+
+	if (IOAPIC_IRQ_IS_MSI(irq)) {
+		if (msi_irqs[irq - IOAPIC_PINS].write) {
+			irqctrl_msi_compose(irq, &msg);
+			msi_irqs[irq - IOAPIC_PINS].write(irq, &msg,
+					msi_irqs[irq - IOAPIC_PINS].dev);
+		}
+	} else {
+		low = ioapic_read(IOAPIC_REDIR_TABLE + irq * 2);
+		if (!(low & IOAPIC_ICR_INT_MASK)) {
+			/* Mask while the entry is inconsistent */
+			ioapic_write(IOAPIC_REDIR_TABLE + irq * 2,
+					low | IOAPIC_ICR_INT_MASK);
+			ioapic_write(IOAPIC_REDIR_TABLE + irq * 2 + 1, cpu << 24);
+			ioapic_write(IOAPIC_REDIR_TABLE + irq * 2, low);
+		}
+	}
+	spin_unlock_ipl(&ioapic_lock, ipl);
+
+	return 0;
+}
+
+int irqctrl_msi_alloc(unsigned int nvec, irqctrl_msi_write_t write,
+		irqctrl_msi_mask_t mask, void *dev) {
+	unsigned int irq, i, align;
+	ipl_t ipl;
+
+	if (nvec == 0 || nvec > IOAPIC_MSI_IRQS || !write) {
+		return -EINVAL;
+	}
+
+	for (align = 1; align < nvec; align <<= 1) {
+	}
+
+	ipl = spin_lock_ipl(&ioapic_lock);
+
+	/* Multiple message MSI set low bits of the vector */
+	irq = IOAPIC_PINS + (align - IOAPIC_IRQ_VECTOR(IOAPIC_PINS) % align) % align;
+	for (; irq + nvec <= __IRQCTRL_IRQS_TOTAL; irq += align) {
+		for (i = 0; i < nvec; i++) {
+			if (msi_irqs[irq + i - IOAPIC_PINS].write) {
+				break;
+			}
+		}
+		if (i == nvec) {
+			break;
+		}
+	}
+
+	if (irq + nvec > __IRQCTRL_IRQS_TOTAL) {
+		spin_unlock_ipl(&ioapic_lock, ipl);
+		return -ENOSPC;
+	}
+
+	for (i = irq; i < irq + nvec; i++) {
+		msi_irqs[i - IOAPIC_PINS].write = write;
+		msi_irqs[i - IOAPIC_PINS].mask = mask;
+		msi_irqs[i - IOAPIC_PINS].dev = dev;
+		irq_dest[i] = lapic_id();
+	}
+
+	spin_unlock_ipl(&ioapic_lock, ipl);
+
+	return irq;
+}
+
+void irqctrl_msi_free(unsigned int irq, unsigned int nvec) {
+	ipl_t ipl;
+
+	assert(IOAPIC_IRQ_IS_MSI(irq));
+	assert(irq + nvec <= __IRQCTRL_IRQS_TOTAL);
+
+	ipl = spin_lock_ipl(&ioapic_lock);
+	for (; nvec > 0; irq++, nvec--) {
+		msi_irqs[irq - IOAPIC_PINS].write = NULL;
+		msi_irqs[irq - IOAPIC_PINS].mask = NULL;
+		msi_irqs[irq - IOAPIC_PINS].dev = NULL;
+		irq_dest[irq] = -1;
+	}
+	spin_unlock_ipl(&ioapic_lock, ipl);
+}
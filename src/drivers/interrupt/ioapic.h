@@ -8,6 +8,13 @@
 #ifndef IRQCTRL_IOAPIC_H_
 #define IRQCTRL_IOAPIC_H_
 
-#define __IRQCTRL_IRQS_TOTAL 16
+/* IRQs of the I/O APIC pins and then IRQs for MSI, vectors 0x20..0x4F */
+#define IOAPIC_PINS          24
+#define IOAPIC_MSI_IRQS      24
+
+#define __IRQCTRL_IRQS_TOTAL (IOAPIC_PINS + IOAPIC_MSI_IRQS)
+
+#define __IRQCTRL_AFFINITY
+#define __IRQCTRL_MSI
 
 #endif /* IRQCTRL_IOAPIC_H_ */
@@ -30,6 +30,10 @@
 #define	LAPIC_LVT_LINT1	(LOCAL_APIC_DEF_ADDR + 0x360)
 #define	LAPIC_TASKPRIOR	(LOCAL_APIC_DEF_ADDR + 0x80)
 
+/* Message address of MSI delivered to the local APIC with the ID */
+#define LAPIC_MSI_ADDR(apic_id) \
+	(LOCAL_APIC_DEF_ADDR | (((apic_id) & 0xFF) << 12))
+
 #define LAPIC_IPI_DEST             0
 #define LAPIC_IPI_SELF             1
 #define LAPIC_IPI_TO_ALL           2
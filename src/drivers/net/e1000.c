@@ -92,6 +92,7 @@ struct e1000_priv {
 	struct sk_buff *rx_skbs[E1000_RXDESC_NR];
 
 	char link_status;
+	int irq_cause; /* accumulated by the hard handler for the thread */
 };
 
 static inline struct e1000_priv *e1000_get_priv(struct net_device *dev) {
@@ -237,20 +238,41 @@ drop_pack:
 	irq_unlock();
 }
 
+#define E1000_IRQ_CAUSES (E1000_REG_ICR_RXO | E1000_REG_ICR_RXT \
+		| E1000_REG_ICR_TXDW | E1000_REG_ICR_TXQE | E1000_REG_ICR_LSC)
+
+/* Reading ICR acknowledges the device, the rest is done by the thread */
 static irq_return_t e1000_interrupt(unsigned int irq_num, void *dev_id) {
 	struct e1000_priv *nic_priv = e1000_get_priv(dev_id);
 	int cause = REG_LOAD(e1000_reg(dev_id, E1000_REG_ICR));
-	irq_return_t ret = IRQ_NONE;
+
+	if (!(cause & E1000_IRQ_CAUSES)) {
+		return IRQ_NONE;
+	}
+
+	nic_priv->irq_cause |= cause;
+
+	return IRQ_WAKE_THREAD;
+}
+
+static irq_return_t e1000_irq_thread(unsigned int irq_num, void *dev_id) {
+	struct e1000_priv *nic_priv = e1000_get_priv(dev_id);
+	int cause;
+
+	irq_lock();
+	{
+		cause = nic_priv->irq_cause;
+		nic_priv->irq_cause = 0;
+	}
+	irq_unlock();
 
 	if (cause & (E1000_REG_ICR_RXO | E1000_REG_ICR_RXT)) {
 		e1000_rx(dev_id);
-		ret = IRQ_HANDLED;
 	}
 
 	if (cause & (E1000_REG_ICR_TXDW | E1000_REG_ICR_TXQE)) {
 		txed_skb_clean(dev_id);
 		e1000_xmit(dev_id);
-		ret = IRQ_HANDLED;
 	}
 
 	if (cause & (E1000_REG_ICR_LSC)) {
@@ -265,10 +287,9 @@ static irq_return_t e1000_interrupt(unsigned int irq_num, void *dev_id) {
 			printk("e1000: Link down. Please check and insert network cable\n");
 			netdev_flag_down(dev, IFF_RUNNING);
 		}
-		ret = IRQ_HANDLED;
 	}
 
-	return ret;
+	return IRQ_HANDLED;
 }
 
 static int e1000_alloc_dma_rx(struct net_device *dev) {
@@ -428,7 +449,8 @@ static int e1000_init(struct pci_slot_dev *pci_dev) {
 	skb_queue_init(&nic_priv->txing_queue);
 	skb_queue_init(&nic_priv->tx_dev_queue);
 
-	res = irq_attach(pci_dev->irq, e1000_interrupt, IF_SHARESUP, nic, "e1000");
+	res = irq_attach_threaded(pci_dev->irq, e1000_interrupt, e1000_irq_thread,
+			IF_SHARESUP, nic, "e1000");
 	if (res < 0) {
 		return res;
 	}
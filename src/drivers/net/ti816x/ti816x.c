@@ -492,7 +492,7 @@ static irq_return_t ti816x_interrupt_macrxint0(unsigned int irq_num,
 		desc = (void*) desc->next;
 		dev_priv->rx_head = desc;
 
-		log_debug("reuse %#x", &hdesc->desc);
+		log_debug("reuse %p", &hdesc->desc);
 		emac_desc_build(hdesc, 0, RX_FRAME_MAX_LEN, 0, EMAC_DESC_F_OWNER);
 		if (!dev_priv->rx_wait_head) {
 			dev_priv->rx_wait_head = &hdesc->desc;
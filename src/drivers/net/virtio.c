@@ -30,11 +30,6 @@ PCI_DRIVER("virtio", virtio_init, PCI_VENDOR_ID_VIRTIO, PCI_DEV_ID_VIRTIO_NET);
 
 #define MODOPS_PREP_BUFF_CNT OPTION_GET(NUMBER, prep_buff_cnt)
 
-struct virtio_priv {
-	struct virtqueue rq;
-	struct virtqueue tq;
-};
-
 static int virtio_xmit(struct net_device *dev, struct sk_buff *skb) {
 	struct sk_buff_extra *skb_extra;
 	struct sk_buff_data *skb_data;
@@ -84,23 +79,12 @@ static int virtio_xmit(struct net_device *dev, struct sk_buff *skb) {
 	return 0;
 }
 
-static irq_return_t virtio_interrupt(unsigned int irq_num,
-		void *dev_id) {
-	struct net_device *dev;
+/* release outgoing packets */
+static void virtio_tx_done(struct net_device *dev) {
 	struct virtqueue *vq;
 	struct vring_used_elem *used_elem;
-	struct sk_buff *skb;
-	struct sk_buff_data *new_data;
 	struct vring_desc *desc, *next;
 
-	dev = dev_id;
-
-	/* it is really? */
-	if (~virtio_net_get_isr_status(dev) & 1) {
-		return IRQ_NONE;
-	}
-
-	/* release outgoing packets */
 	vq = &netdev_priv(dev, struct virtio_priv)->tq;
 	while (vq->last_seen_used != vq->ring.used->idx) {
 		used_elem = &vq->ring.used->ring[vq->last_seen_used % vq->ring.num];
@@ -117,8 +101,16 @@ static irq_return_t virtio_interrupt(unsigned int irq_num,
 
 		++vq->last_seen_used;
 	}
+}
+
+/* receive incoming packets */
+static void virtio_rx(struct net_device *dev) {
+	struct virtqueue *vq;
+	struct vring_used_elem *used_elem;
+	struct sk_buff *skb;
+	struct sk_buff_data *new_data;
+	struct vring_desc *desc, *next;
 
-	/* receive incoming packets */
 	vq = &netdev_priv(dev, struct virtio_priv)->rq;
 	while (vq->last_seen_used != vq->ring.used->idx) {
 		used_elem = &vq->ring.used->ring[vq->last_seen_used % vq->ring.num];
@@ -154,7 +146,36 @@ static irq_return_t virtio_interrupt(unsigned int irq_num,
 		vring_push_desc(used_elem->id, &vq->ring);
 		virtio_net_notify_queue(VIRTIO_NET_QUEUE_RX, dev);
 	}
+}
+
+/* Transmitted buffers are released right in the hard handler:
+ * virtio_xmit waits for free descriptors with the scheduler locked */
+static irq_return_t virtio_interrupt(unsigned int irq_num,
+		void *dev_id) {
+	struct net_device *dev;
+
+	dev = dev_id;
+
+	/* it is really? Reading the status acknowledges the interrupt */
+	if (~virtio_net_get_isr_status(dev) & 1) {
+		return IRQ_NONE;
+	}
 
+	virtio_tx_done(dev);
+
+	return IRQ_WAKE_THREAD;
+}
+
+static irq_return_t virtio_rx_thread(unsigned int irq_num,
+		void *dev_id) {
+	virtio_rx(dev_id);
+	return IRQ_HANDLED;
+}
+
+/* MSI-X vectors are not shared and have no ISR status */
+static irq_return_t virtio_tx_interrupt(unsigned int irq_num,
+		void *dev_id) {
+	virtio_tx_done(dev_id);
 	return IRQ_HANDLED;
 }
 
@@ -327,6 +348,44 @@ out_nomem:
 	return -ENOMEM;
 }
 
+/* Vectors are assigned after the reset, which drops them */
+static int virtio_msix_setup(struct net_device *dev) {
+	virtio_set_config_vector(VIRTIO_MSI_NO_VECTOR, dev->base_addr);
+
+	if (virtio_set_queue_vector(VIRTIO_NET_QUEUE_RX, 0, dev->base_addr) != 0
+			|| virtio_set_queue_vector(VIRTIO_NET_QUEUE_TX, 1,
+				dev->base_addr) != 1) {
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+static int virtio_irq_attach(struct virtio_priv *dev_priv,
+		struct net_device *dev) {
+	int ret;
+
+	if (!dev_priv->msi_irq) {
+		return irq_attach_threaded(dev->irq, virtio_interrupt,
+				virtio_rx_thread, IF_SHARESUP, dev, "virtio");
+	}
+
+	/* RX vector is masked at the device until the thread has run */
+	ret = irq_attach(dev_priv->msi_irq, virtio_rx_thread, IF_THREADED, dev,
+			"virtio-rx");
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = irq_attach(dev_priv->msi_irq + 1, virtio_tx_interrupt, 0, dev,
+			"virtio-tx");
+	if (ret != 0) {
+		irq_detach(dev_priv->msi_irq, dev);
+	}
+
+	return ret;
+}
+
 static int virtio_init(struct pci_slot_dev *pci_dev) {
 	int ret;
 	struct net_device *nic;
@@ -341,6 +400,18 @@ static int virtio_init(struct pci_slot_dev *pci_dev) {
 	nic->base_addr = pci_dev->bar[0] & PCI_BASE_ADDR_IO_MASK;
 	nic_priv = netdev_priv(nic, struct virtio_priv);
 
+	/* Separate vectors for RX and TX queues, legacy INTx otherwise */
+	nic_priv->msi_irq = 0;
+	ret = pci_msi_enable(pci_dev, 2);
+	if (ret > 0) {
+		if (pci_dev->msix_cap) {
+			nic_priv->msi_irq = ret;
+		} else {
+			/* VirtIO works only with MSI-X */
+			pci_msi_disable(pci_dev);
+		}
+	}
+
 	virtio_config(nic);
 
 	ret = virtio_priv_init(nic_priv, nic);
@@ -348,7 +419,16 @@ static int virtio_init(struct pci_slot_dev *pci_dev) {
 		return ret;
 	}
 
-	ret = irq_attach(nic->irq, virtio_interrupt, IF_SHARESUP, nic, "virtio");
+	if (nic_priv->msi_irq && virtio_msix_setup(nic) != 0) {
+		log_info("virtio: MSI-X vectors are not accepted, using INTx");
+		pci_msi_disable(pci_dev);
+		nic_priv->msi_irq = 0;
+	}
+	if (nic_priv->msi_irq) {
+		nic->irq = nic_priv->msi_irq;
+	}
+
+	ret = virtio_irq_attach(nic_priv, nic);
 	if (ret != 0) {
 		virtio_priv_fini(nic_priv, nic);
 		return ret;
@@ -19,8 +19,10 @@
 /**
  * VirtIO Network Device Registers
  */
-#define VIRTIO_REG_NET_MAC(i) (0x14 + i) /* MAC address (i:0..5) */
-#define VIRTIO_REG_NET_STATUS 0x1A       /* Status (2 bytes) */
+#define VIRTIO_REG_NET_MAC(i, msix) \
+	(VIRTIO_REG_DEVICE_CFG(msix) + i)              /* MAC address (i:0..5) */
+#define VIRTIO_REG_NET_STATUS(msix) \
+	(VIRTIO_REG_DEVICE_CFG(msix) + 0x6)            /* Status (2 bytes) */
 
 /**
  * VirtIO Network Device Queues
@@ -87,6 +89,18 @@ struct virtio_net_hdr {
 	uint16_t csum_offset; /* Size of this place */
 };
 
+/**
+ * VirtIO Network Device Private Data
+ */
+struct virtio_priv {
+	struct virtqueue rq;
+	struct virtqueue tq;
+	unsigned int msi_irq; /* RX queue vector IRQ, TX one follows, 0 with INTx */
+};
+
+#define virtio_net_msix(dev) \
+	(netdev_priv(dev, struct virtio_priv)->msi_irq != 0)
+
 /**
  * VirtIO Operation Definitions For Network Module
  */
@@ -124,12 +138,14 @@ struct virtio_net_hdr {
  */
 static inline uint8_t virtio_net_get_mac(int i,
 		struct net_device *dev) {
-	return virtio_load8(VIRTIO_REG_NET_MAC(i), dev->base_addr);
+	return virtio_load8(VIRTIO_REG_NET_MAC(i, virtio_net_msix(dev)),
+			dev->base_addr);
 }
 
 static inline void virtio_net_set_mac(uint8_t mac_i, int i,
 		struct net_device *dev) {
-	virtio_store8(mac_i, VIRTIO_REG_NET_MAC(i), dev->base_addr);
+	virtio_store8(mac_i, VIRTIO_REG_NET_MAC(i, virtio_net_msix(dev)),
+			dev->base_addr);
 }
 
 /**
@@ -137,7 +153,8 @@ static inline void virtio_net_set_mac(uint8_t mac_i, int i,
  */
 static inline uint16_t virtio_net_get_status(
 		struct net_device *dev) {
-	return virtio_load16(VIRTIO_REG_NET_STATUS, dev->base_addr);
+	return virtio_load16(VIRTIO_REG_NET_STATUS(virtio_net_msix(dev)),
+			dev->base_addr);
 }
 
 #endif /* DRIVERS_ETHERNET_VIRTIO_NET_H_ */
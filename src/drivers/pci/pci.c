@@ -59,8 +59,6 @@ static int pci_get_slot_info(struct pci_slot_dev *dev) {
 	int bar_num;
 	uint32_t devfn = dev->func;
 
-	pci_read_config8(dev->busn, devfn, PCI_BASECLASS_CODE, &dev->baseclass);
-	pci_read_config8(dev->busn, devfn, PCI_SUBCLASS_CODE, &dev->subclass);
 	pci_read_config8(dev->busn, devfn, PCI_REVISION_ID, &dev->rev);
 	pci_read_config8(dev->busn, devfn, PCI_INTERRUPT_LINE, &dev->irq);
 
@@ -101,6 +99,10 @@ struct pci_slot_dev *pci_insert_dev(char configured,
 
 	new_dev->vendor = (uint16_t) vendor_reg & 0xffff;
 	new_dev->device = (uint16_t) (vendor_reg >> 16) & 0xffff;
+	/* Drivers may match the class, it is known for all devices */
+	pci_read_config8(bus, devfn, PCI_BASECLASS_CODE, &new_dev->baseclass);
+	pci_read_config8(bus, devfn, PCI_SUBCLASS_CODE, &new_dev->subclass);
+	pci_read_config8(bus, devfn, PCI_PROG_IFACE, &new_dev->prog_if);
 	if (configured) {
 		pci_get_slot_info(new_dev);
 	}
@@ -187,3 +189,27 @@ void pci_set_master(struct pci_slot_dev * slot_dev) {
 		pci_write_config8(slot_dev->busn, devfn, PCI_LATENCY_TIMER, 64);
 	}
 }
+
+uint8_t pci_find_capability(struct pci_slot_dev *slot_dev, uint8_t cap_id) {
+	uint16_t status;
+	uint8_t pos, id;
+	int ttl = 48; /* Each capability takes at least 4 bytes */
+	uint16_t devfn = PCI_DEVFN(slot_dev->slot, slot_dev->func);
+
+	pci_read_config16(slot_dev->busn, devfn, PCI_STATUS, &status);
+	if (!(status & PCI_STATUS_CAP_LIST)) {
+		return 0;
+	}
+
+	pci_read_config8(slot_dev->busn, devfn, PCI_CAPAB_POINTER, &pos);
+	while (pos >= 0x40 && ttl--) {
+		pos &= ~3;
+		pci_read_config8(slot_dev->busn, devfn, pos + PCI_CAP_ID, &id);
+		if (id == cap_id) {
+			return pos;
+		}
+		pci_read_config8(slot_dev->busn, devfn, pos + PCI_CAP_NEXT, &pos);
+	}
+
+	return 0;
+}
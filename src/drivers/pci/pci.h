@@ -46,7 +46,9 @@
 #define   PCI_COMMAND_MEMORY     0x002   /* Enable response in Memory space */
 #define   PCI_COMMAND_MASTER     0x004   /* Enable bus mastering */
 #define   PCI_COMMAND_SERR       0x100   /* Enable bus mastering */
+#define   PCI_COMMAND_INTX_DISABLE 0x400 /* INTx emulation disable */
 #define PCI_STATUS              0x06   /* 16 bits */
+#define   PCI_STATUS_CAP_LIST    0x010   /* Capabilities list is present */
 #define PCI_REVISION_ID         0x08   /* 8 bits  */
 #define PCI_PROG_IFACE          0x09   /* 8 bits  */
 #define PCI_SUBCLASS_CODE       0x0a   /* 8 bits  */
@@ -96,6 +98,42 @@
 #define PCI_MIN_GNT             0x3E   /* 8 bits  */
 #define PCI_MAX_LAT             0x3F   /* 8 bits  */
 
+/**
+ * Capabilities list: each item starts with the capability ID and the
+ * offset of the next item
+ */
+#define PCI_CAP_ID              0x00   /* 8 bits  */
+#define PCI_CAP_NEXT            0x01   /* 8 bits  */
+#define   PCI_CAP_ID_MSI         0x05
+#define   PCI_CAP_ID_MSIX        0x11
+
+/** MSI capability */
+#define PCI_MSI_FLAGS           0x02   /* 16 bits */
+#define   PCI_MSI_FLAGS_ENABLE   0x0001
+#define   PCI_MSI_FLAGS_QMASK    0x000e  /* Log2 of vectors supported */
+#define   PCI_MSI_FLAGS_QSIZE    0x0070  /* Log2 of vectors enabled */
+#define   PCI_MSI_FLAGS_64BIT    0x0080
+#define PCI_MSI_ADDRESS_LO      0x04   /* 32 bits */
+#define PCI_MSI_ADDRESS_HI      0x08   /* 32 bits, 64-bit devices only */
+#define PCI_MSI_DATA_32         0x08   /* 16 bits */
+#define PCI_MSI_DATA_64         0x0C   /* 16 bits */
+
+/** MSI-X capability */
+#define PCI_MSIX_FLAGS          0x02   /* 16 bits */
+#define   PCI_MSIX_FLAGS_QSIZE   0x07ff  /* Table size - 1 */
+#define   PCI_MSIX_FLAGS_MASKALL 0x4000
+#define   PCI_MSIX_FLAGS_ENABLE  0x8000
+#define PCI_MSIX_TABLE          0x04   /* 32 bits, BAR index and offset */
+#define   PCI_MSIX_TABLE_BIR     0x00000007
+
+/** MSI-X table entry */
+#define PCI_MSIX_ENTRY_SIZE         16
+#define PCI_MSIX_ENTRY_ADDR_LO      0x0
+#define PCI_MSIX_ENTRY_ADDR_HI      0x4
+#define PCI_MSIX_ENTRY_DATA         0x8
+#define PCI_MSIX_ENTRY_VECTOR_CTRL  0xC
+#define   PCI_MSIX_ENTRY_CTRL_MASKBIT 0x1
+
 #define PCI_PRIMARY_BUS         0x18
 #define PCI_SECONDARY_BUS       0x19
 #define PCI_SUBORDINATE_BUS     0x1a
@@ -109,6 +147,8 @@
 #define PCI_CLASS_STORAGE_SCSI          0x0000
 #define PCI_CLASS_STORAGE_IDE           0x0001
 #define PCI_CLASS_STORAGE_FLOPPY        0x0002
+#define PCI_CLASS_STORAGE_SATA          0x0006
+#define   PCI_PROG_IF_SATA_AHCI          0x01
 #define PCI_CLASS_STORAGE_OTHER         0x0080
 
 #define PCI_BASE_CLASS_NETWORK          0x02
@@ -171,12 +211,20 @@ struct pci_slot_dev {
 	uint16_t device;
 	uint8_t baseclass;
 	uint8_t subclass;
+	uint8_t prog_if;
 	uint8_t irq;
 	uint32_t bar[6];
 	uint8_t primary;
 	uint8_t secondary;
 	uint8_t subordinate;
 	uint32_t membaselimit;
+
+	/* Message signalled interrupts, see pci_msi_enable() */
+	uint8_t msi_cap;
+	uint8_t msix_cap;
+	uint16_t msi_nvec;
+	unsigned int msi_irq;
+	volatile uint32_t *msix_table;
 };
 
 #define PCI_BAR_BASE(bar)   (bar & 0xFFFFFFF0)
@@ -191,4 +239,25 @@ struct pci_slot_dev *pci_insert_dev(char configured, uint32_t bus,
 
 extern void pci_set_master(struct pci_slot_dev * slot_dev);
 
+/**
+ * @return offset of the capability in the configuration space or 0 if the
+ *         device has no such capability
+ */
+extern uint8_t pci_find_capability(struct pci_slot_dev *slot_dev,
+		uint8_t cap_id);
+
+/**
+ * Switches the device from INTx to @a nvec message signalled interrupts,
+ * they are delivered to the CPU enabling them, see irq_set_affinity().
+ * MSI-X is preferred to MSI, as it has separate message for each vector.
+ *
+ * @return the IRQ of the first vector, others follow it, or
+ *         -ENOTSUP if the device or the interrupt controller has no MSI,
+ *         -ENOSPC if there are not enough vectors
+ */
+extern int pci_msi_enable(struct pci_slot_dev *slot_dev, unsigned int nvec);
+
+/** Switches the device back to INTx */
+extern void pci_msi_disable(struct pci_slot_dev *slot_dev);
+
 #endif /* PCI_H_ */
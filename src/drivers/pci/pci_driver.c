@@ -16,13 +16,18 @@
 
 #define PCI_INFO_LABEL "\tpci: "
 
+static int pci_id_match(const struct pci_id *id, struct pci_slot_dev *dev) {
+	return (id->ven_id == PCI_ANY_ID || id->ven_id == dev->vendor)
+		&& (id->dev_id == PCI_ANY_ID || id->dev_id == dev->device)
+		&& (!id->class_id || id->class_id == PCI_CLASS_ID(dev->baseclass,
+				dev->subclass, dev->prog_if));
+}
+
 static int pci_drv_probe(const struct pci_driver *drv, struct pci_slot_dev *dev) {
 	int i;
 
 	for (i = 0; i < drv->id_table_n; i++) {
-		if (dev->vendor == drv->id_table[i].ven_id &&
-				dev->device == drv->id_table[i].dev_id &&
-				!drv->init(dev)) {
+		if (pci_id_match(&drv->id_table[i], dev) && !drv->init(dev)) {
 			return 0;
 		}
 	}
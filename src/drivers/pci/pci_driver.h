@@ -15,9 +15,16 @@
 
 struct pci_slot_dev;
 
+/* Vendor or device ID matching any device */
+#define PCI_ANY_ID 0xffff
+
+#define PCI_CLASS_ID(base, sub, prog_if) \
+	(((base) << 16) | ((sub) << 8) | (prog_if))
+
 struct pci_id {
 	uint16_t ven_id;
 	uint16_t dev_id;
+	uint32_t class_id; /* PCI_CLASS_ID() of the device, 0 matches any */
 };
 
 struct pci_driver {
@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Message signalled interrupts (MSI and MSI-X) of PCI devices
+ *
+ * @details Vectors are allocated at the interrupt controller as
+ *   consecutive IRQs. MSI has single message for all vectors of the device,
+ *   the device puts vector number into the low bits of the data. MSI-X has
+ *   a table in the device memory with a message and a mask bit per vector.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include <drivers/irqctrl.h>
+#include <drivers/pci/pci.h>
+#include <util/log.h>
+
+#define PCI_DEV_FN(dev) PCI_DEVFN((dev)->slot, (dev)->func)
+
+#ifdef __IRQCTRL_MSI
+
+static void pci_msi_write(unsigned int irq, const struct irqctrl_msi_msg *msg,
+		void *data) {
+	struct pci_slot_dev *dev = data;
+	uint16_t flags;
+
+	/* The message is common for all vectors */
+	if (irq != dev->msi_irq) {
+		return;
+	}
+
+	pci_read_config16(dev->busn, PCI_DEV_FN(dev),
+			dev->msi_cap + PCI_MSI_FLAGS, &flags);
+	pci_write_config32(dev->busn, PCI_DEV_FN(dev),
+			dev->msi_cap + PCI_MSI_ADDRESS_LO, msg->address_lo);
+	if (flags & PCI_MSI_FLAGS_64BIT) {
+		pci_write_config32(dev->busn, PCI_DEV_FN(dev),
+				dev->msi_cap + PCI_MSI_ADDRESS_HI, msg->address_hi);
+		pci_write_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msi_cap + PCI_MSI_DATA_64, msg->data);
+	} else {
+		pci_write_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msi_cap + PCI_MSI_DATA_32, msg->data);
+	}
+}
+
+static void pci_msix_write(unsigned int irq, const struct irqctrl_msi_msg *msg,
+		void *data) {
+	struct pci_slot_dev *dev = data;
+	volatile uint32_t *entry;
+	uint32_t ctrl;
+
+	entry = dev->msix_table + (irq - dev->msi_irq) * PCI_MSIX_ENTRY_SIZE / 4;
+
+	/* Mask the vector while the message is inconsistent */
+	ctrl = entry[PCI_MSIX_ENTRY_VECTOR_CTRL / 4];
+	entry[PCI_MSIX_ENTRY_VECTOR_CTRL / 4] = ctrl | PCI_MSIX_ENTRY_CTRL_MASKBIT;
+
+	entry[PCI_MSIX_ENTRY_ADDR_LO / 4] = msg->address_lo;
+	entry[PCI_MSIX_ENTRY_ADDR_HI / 4] = msg->address_hi;
+	entry[PCI_MSIX_ENTRY_DATA / 4] = msg->data;
+
+	entry[PCI_MSIX_ENTRY_VECTOR_CTRL / 4] = ctrl;
+}
+
+static void pci_msix_mask(unsigned int irq, int mask, void *data) {
+	struct pci_slot_dev *dev = data;
+	volatile uint32_t *ctrl;
+
+	ctrl = dev->msix_table + (irq - dev->msi_irq) * PCI_MSIX_ENTRY_SIZE / 4
+		+ PCI_MSIX_ENTRY_VECTOR_CTRL / 4;
+	if (mask) {
+		*ctrl |= PCI_MSIX_ENTRY_CTRL_MASKBIT;
+	} else {
+		*ctrl &= ~PCI_MSIX_ENTRY_CTRL_MASKBIT;
+	}
+}
+
+static void pci_intx_disable(struct pci_slot_dev *dev, int disable) {
+	uint16_t cmd;
+
+	pci_read_config16(dev->busn, PCI_DEV_FN(dev), PCI_COMMAND, &cmd);
+	if (disable) {
+		cmd |= PCI_COMMAND_INTX_DISABLE;
+	} else {
+		cmd &= ~PCI_COMMAND_INTX_DISABLE;
+	}
+	pci_write_config16(dev->busn, PCI_DEV_FN(dev), PCI_COMMAND, cmd);
+}
+
+static size_t pci_msix_table_size(uint16_t flags) {
+	return ((flags & PCI_MSIX_FLAGS_QSIZE) + 1) * PCI_MSIX_ENTRY_SIZE;
+}
+
+static void pci_msix_unmap(struct pci_slot_dev *dev, uint16_t flags) {
+	munmap((void *) dev->msix_table, pci_msix_table_size(flags));
+	dev->msix_table = NULL;
+}
+
+static int pci_msix_enable(struct pci_slot_dev *dev, uint8_t cap,
+		unsigned int nvec) {
+	struct irqctrl_msi_msg msg;
+	uint16_t flags;
+	uint32_t table, base;
+	size_t size;
+	int irq, i;
+
+	pci_read_config16(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSIX_FLAGS, &flags);
+	if (nvec > (flags & PCI_MSIX_FLAGS_QSIZE) + 1) {
+		return -ENOSPC;
+	}
+
+	pci_read_config32(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSIX_TABLE, &table);
+	base = PCI_BAR_BASE(dev->bar[table & PCI_MSIX_TABLE_BIR])
+		+ (table & ~PCI_MSIX_TABLE_BIR);
+	size = pci_msix_table_size(flags);
+
+	dev->msix_table = mmap_device_memory((void *) base, size,
+			PROT_READ | PROT_WRITE | PROT_NOCACHE, MAP_FIXED, base);
+	if (!dev->msix_table) {
+		return -ENOMEM;
+	}
+
+	irq = irqctrl_msi_alloc(nvec, pci_msix_write, pci_msix_mask, dev);
+	if (irq < 0) {
+		pci_msix_unmap(dev, flags);
+		return irq;
+	}
+
+	dev->msix_cap = cap;
+	dev->msi_irq = irq;
+	dev->msi_nvec = nvec;
+
+	/* Table is accessible only with MSI-X enabled */
+	pci_write_config16(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSIX_FLAGS,
+			flags | PCI_MSIX_FLAGS_ENABLE | PCI_MSIX_FLAGS_MASKALL);
+
+	for (i = 0; i < nvec; i++) {
+		irqctrl_msi_compose(irq + i, &msg);
+		pci_msix_write(irq + i, &msg, dev);
+		dev->msix_table[i * PCI_MSIX_ENTRY_SIZE / 4
+			+ PCI_MSIX_ENTRY_VECTOR_CTRL / 4] &= ~PCI_MSIX_ENTRY_CTRL_MASKBIT;
+	}
+
+	pci_intx_disable(dev, 1);
+	pci_write_config16(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSIX_FLAGS,
+			(flags | PCI_MSIX_FLAGS_ENABLE) & ~PCI_MSIX_FLAGS_MASKALL);
+
+	return irq;
+}
+
+static int pci_msi_cap_enable(struct pci_slot_dev *dev, uint8_t cap,
+		unsigned int nvec) {
+	struct irqctrl_msi_msg msg;
+	uint16_t flags;
+	unsigned int log2;
+	int irq;
+
+	for (log2 = 0; (1 << log2) < nvec; log2++) {
+	}
+
+	pci_read_config16(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSI_FLAGS, &flags);
+	if (log2 > (flags & PCI_MSI_FLAGS_QMASK) >> 1) {
+		return -ENOSPC;
+	}
+
+	/* Device may use all 2^log2 vectors */
+	/* Per-vector masking of MSI is optional and not used */
+	irq = irqctrl_msi_alloc(1 << log2, pci_msi_write, NULL, dev);
+	if (irq < 0) {
+		return irq;
+	}
+
+	dev->msi_cap = cap;
+	dev->msi_irq = irq;
+	dev->msi_nvec = 1 << log2;
+
+	irqctrl_msi_compose(irq, &msg);
+	pci_msi_write(irq, &msg, dev);
+
+	pci_intx_disable(dev, 1);
+	flags &= ~PCI_MSI_FLAGS_QSIZE;
+	flags |= (log2 << 4) | PCI_MSI_FLAGS_ENABLE;
+	pci_write_config16(dev->busn, PCI_DEV_FN(dev), cap + PCI_MSI_FLAGS, flags);
+
+	return irq;
+}
+
+int pci_msi_enable(struct pci_slot_dev *dev, unsigned int nvec) {
+	uint8_t cap;
+	int ret;
+
+	if (nvec == 0 || dev->msi_nvec) {
+		return -EINVAL;
+	}
+
+	if ((cap = pci_find_capability(dev, PCI_CAP_ID_MSIX))) {
+		ret = pci_msix_enable(dev, cap, nvec);
+	} else if ((cap = pci_find_capability(dev, PCI_CAP_ID_MSI))) {
+		ret = pci_msi_cap_enable(dev, cap, nvec);
+	} else {
+		ret = -ENOTSUP;
+	}
+
+	if (ret < 0) {
+		log_debug("%02x:%02x MSI are not enabled (%d)",
+				dev->busn, PCI_DEV_FN(dev), ret);
+	}
+	return ret;
+}
+
+void pci_msi_disable(struct pci_slot_dev *dev) {
+	uint16_t flags;
+
+	if (!dev->msi_nvec) {
+		return;
+	}
+
+	if (dev->msix_cap) {
+		pci_read_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msix_cap + PCI_MSIX_FLAGS, &flags);
+		pci_write_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msix_cap + PCI_MSIX_FLAGS, flags & ~PCI_MSIX_FLAGS_ENABLE);
+	} else {
+		pci_read_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msi_cap + PCI_MSI_FLAGS, &flags);
+		pci_write_config16(dev->busn, PCI_DEV_FN(dev),
+				dev->msi_cap + PCI_MSI_FLAGS, flags & ~PCI_MSI_FLAGS_ENABLE);
+	}
+	pci_intx_disable(dev, 0);
+
+	irqctrl_msi_free(dev->msi_irq, dev->msi_nvec);
+	if (dev->msix_cap) {
+		/* Not used by the interrupt controller anymore */
+		pci_msix_unmap(dev, flags);
+	}
+
+	dev->msi_cap = dev->msix_cap = 0;
+	dev->msi_nvec = 0;
+}
+
+#else /* !__IRQCTRL_MSI */
+
+int pci_msi_enable(struct pci_slot_dev *dev, unsigned int nvec) {
+	return -ENOTSUP;
+}
+
+void pci_msi_disable(struct pci_slot_dev *dev) {
+}
+
+#endif /* __IRQCTRL_MSI */
@@ -13,6 +13,8 @@
 #include <drivers/serial/uart_device.h>
 #include <drivers/serial/diag_serial.h>
 #include <embox/unit.h>
+#include <kernel/spinlock.h>
+#include <util/math.h>
 
 EMBOX_UNIT_INIT(uart_init);
 
@@ -22,6 +24,10 @@ EMBOX_UNIT_INIT(uart_init);
  */
 #define COM0_PORT_BASE      OPTION_GET(NUMBER,base_addr)
 #define COM0_IRQ_NUM        OPTION_GET(NUMBER,irq_num)
+#define TX_FIFO_SIZE        OPTION_GET(NUMBER,tx_fifo_size)
+
+/* Diag output may come in the middle of the FIFO fill from the interrupt */
+static spinlock_t i8250_tx_lock = SPIN_STATIC_UNLOCKED;
 
 static uint8_t calc_line_stat(const struct uart_params *params) {
 	uint8_t line_stat;
@@ -70,8 +76,47 @@ static int i8250_setup(struct uart *dev, const struct uart_params *params) {
 }
 
 static int i8250_putc(struct uart *dev, int ch) {
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&i8250_tx_lock);
 	while (!(in8(dev->base_addr + UART_LSR) & UART_EMPTY_TX));
 	out8((uint8_t) ch, dev->base_addr + UART_TX);
+	spin_unlock_ipl(&i8250_tx_lock, ipl);
+
+	return 0;
+}
+
+static int i8250_write(struct uart *dev, const char *buf, size_t len) {
+	size_t i;
+	ipl_t ipl;
+
+	ipl = spin_lock_ipl(&i8250_tx_lock);
+
+	/* Empty holding register means the whole FIFO is empty */
+	if (!(in8(dev->base_addr + UART_LSR) & UART_EMPTY_TX)) {
+		len = 0;
+	}
+
+	len = min(len, TX_FIFO_SIZE);
+	for (i = 0; i < len; i++) {
+		out8((uint8_t) buf[i], dev->base_addr + UART_TX);
+	}
+
+	spin_unlock_ipl(&i8250_tx_lock, ipl);
+
+	return len;
+}
+
+static int i8250_irq_tx(struct uart *dev, int enable) {
+	uint8_t ier = in8(dev->base_addr + UART_IER);
+
+	if (enable) {
+		ier |= UART_IER_TX_ENABLE;
+	} else {
+		ier &= ~UART_IER_TX_ENABLE;
+	}
+	out8(ier, dev->base_addr + UART_IER);
+
 	return 0;
 }
 
@@ -88,6 +133,8 @@ static const struct uart_ops i8250_uart_ops = {
 		.uart_putc = i8250_putc,
 		.uart_hasrx = i8250_has_symbol,
 		.uart_setup = i8250_setup,
+		.uart_write = i8250_write,
+		.uart_irq_tx = i8250_irq_tx,
 };
 
 static struct uart uart0 = {
@@ -83,5 +83,6 @@
 #define DIVISOR(baud) (115200 / baud)
 
 #define UART_IER_RX_ENABLE  0x1
+#define UART_IER_TX_ENABLE  0x2
 
 #endif /* SERIAL_8250_H_ */
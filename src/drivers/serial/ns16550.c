@@ -16,7 +16,9 @@
 
 #define UART_LSR_DR     0x01            /* Data ready */
 #define UART_LSR_THRE   0x20            /* Xmit holding register empty */
+#define UART_FCR_ENABLE 0x07            /* Enable and clear FIFOs */
 #define COM_BASE (OPTION_GET(NUMBER, base_addr))
+#define TX_FIFO_SIZE (OPTION_GET(NUMBER, tx_fifo_size))
 
 #define UART_REG(x)                                                     \
         unsigned char x;                                                \
@@ -48,9 +50,14 @@ struct com {
 #define COM3 ((volatile struct com *)COM_BASE)
 #define COM3_RBR (COM3->rbr)
 #define COM3_LSR (COM3->lsr)
+#define COM3_FCR (COM3->fcr)
 
 EMBOX_UNIT_INIT(ns16550_init);
 
+/* Free FIFO entries known without polling LSR, 1 until FIFO is enabled */
+static int tx_fifo_depth = 1;
+static int tx_room;
+
 static int ns16550_init(void) {
 	/* Map one vmem page to handle this device if mmu is used */
 	mmap_device_memory(
@@ -60,13 +67,26 @@ static int ns16550_init(void) {
 			MAP_FIXED,
 			COM_BASE & ~MMU_PAGE_MASK
 			);
+
+	if (TX_FIFO_SIZE > 1) {
+		while ((COM3_LSR & UART_LSR_THRE) == 0);
+		COM3_FCR = UART_FCR_ENABLE;
+		tx_fifo_depth = TX_FIFO_SIZE;
+		tx_room = 0;
+	}
+
 	return 0;
 }
 
 static void ns16550_diag_putc(const struct diag *diag, char ch) {
-	while ((COM3_LSR & UART_LSR_THRE) == 0);
+	/* Empty holding register means the whole FIFO is empty */
+	if (tx_room == 0) {
+		while ((COM3_LSR & UART_LSR_THRE) == 0);
+		tx_room = tx_fifo_depth;
+	}
 
 	COM3_RBR = ch;
+	tx_room--;
 }
 
 static char ns16550_diag_getc(const struct diag *diag) {
@@ -139,6 +139,10 @@ int uart_close(struct uart *uart) {
 
 	uart_state_clear(uart, UART_STATE_OPEN);
 
+	if (uart->params.irq && uart->uart_ops->uart_irq_tx) {
+		uart->uart_ops->uart_irq_tx(uart, 0);
+	}
+
 	return uart_detach_irq(uart);
 }
 
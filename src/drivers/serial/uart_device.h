@@ -8,6 +8,7 @@
 #ifndef UART_DEVICE_H_
 #define UART_DEVICE_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <util/dlist.h>
@@ -34,6 +35,13 @@ struct uart_ops {
 	int (*uart_putc)(struct uart *dev, int symbol);
 	int (*uart_hasrx)(struct uart *dev);
 	int (*uart_setup)(struct uart *dev, const struct uart_params *params);
+
+	/* Optional bulk output: puts as much of @a buf as the transmitter (FIFO)
+	 * takes without waiting, returns the number of sent bytes */
+	int (*uart_write)(struct uart *dev, const char *buf, size_t len);
+	/* Optional: (dis)ables the interrupt on transmitter getting ready for
+	 * more data. Used only with uart_write */
+	int (*uart_irq_tx)(struct uart *dev, int enable);
 };
 
 struct uart {
@@ -136,4 +144,17 @@ static inline int uart_hasrx(struct uart *uart) {
 	return uart->uart_ops->uart_hasrx(uart);
 }
 
+/**
+ * @brief Send output queued in the tty of the uart. Called with IRQs locked.
+ *
+ * @param uart
+ */
+extern void uart_tx_do(struct uart *uart);
+
+/* Whether queued output is sent from the TX ready interrupt */
+static inline int uart_irq_tx_used(struct uart *uart) {
+	return uart->params.irq && uart->uart_ops->uart_write
+		&& uart->uart_ops->uart_irq_tx;
+}
+
 #endif /* UART_DEVICE_H_ */
@@ -88,7 +88,6 @@ static ssize_t serial_read(struct idesc *idesc, const struct iovec *iov, int cnt
 static ssize_t serial_write(struct idesc *idesc, const struct iovec *iov, int cnt) {
 	void *buf;
 	size_t nbyte;
-	int ch;
 	struct uart *uart;
 	size_t written, left;
 
@@ -106,13 +105,10 @@ static ssize_t serial_write(struct idesc *idesc, const struct iovec *iov, int cn
 	assert(uart);
 	assert(uart->tty);
 
+	/* tty_write() wakes the transmitter itself */
 	do {
 		written = tty_write(uart->tty, buf, left);
 
-		while (-1 != (ch = tty_out_getc(uart->tty))) {
-			uart_putc(uart, ch);
-		}
-
 		left -= written;
 		buf = (void *)((char *)buf + written);
 	} while (left != 0);
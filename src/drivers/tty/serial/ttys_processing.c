@@ -99,10 +99,17 @@ irq_return_t uart_irq_handler(unsigned int irq_nr, void *data) {
 	struct uart *dev = data;
 
 	if (dev->tty) {
-		while (uart_hasrx(dev)) {
-			uart_rx_buff_put(dev, uart_getc(dev));
+		if (uart_hasrx(dev)) {
+			while (uart_hasrx(dev)) {
+				uart_rx_buff_put(dev, uart_getc(dev));
+			}
+			lthread_launch(&uart_rx_irq_handler);
+		}
+
+		if (uart_irq_tx_used(dev)) {
+			/* Transmitter may be ready for the queued output */
+			uart_tx_do(dev);
 		}
-		lthread_launch(&uart_rx_irq_handler);
 	}
 
 	return IRQ_HANDLED;
@@ -16,14 +16,41 @@ static inline struct uart *tty2uart(struct tty *tty) {
 	return tu->uart;
 }
 
+/* Sends queued output, called with IRQs locked */
+void uart_tx_do(struct uart *uart) {
+	const struct uart_ops *uops = uart->uart_ops;
+	int irq_tx = uart_irq_tx_used(uart);
+	const char *buf;
+	size_t len, n;
+
+	while ((len = tty_out_peek(uart->tty, &buf))) {
+		if (uops->uart_write) {
+			n = uops->uart_write(uart, buf, len);
+		} else {
+			for (n = 0; n < len; n++) {
+				uart_putc(uart, buf[n]);
+			}
+		}
+
+		if (n) {
+			tty_out_done(uart->tty, n);
+		} else if (irq_tx) {
+			/* Transmitter is full, the rest is sent from its interrupt */
+			break;
+		}
+	}
+
+	if (irq_tx) {
+		uops->uart_irq_tx(uart, len != 0);
+	}
+}
+
 static void uart_out_wake(struct tty *t) {
 	struct uart *uart_dev = tty2uart(t);
-	int ich;
 
 	irq_lock();
 
-	while ((ich = tty_out_getc(t)) != -1)
-		uart_putc(uart_dev, (char) ich);
+	uart_tx_do(uart_dev);
 
 	irq_unlock();
 }
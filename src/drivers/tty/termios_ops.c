@@ -39,6 +39,37 @@ int termios_putc(const struct termios *t, char ch, struct ring *ring,
 	return res + tio_putc(ch, ring, buf, buflen);
 }
 
+int termios_write(const struct termios *t, const char *from, size_t len,
+		struct ring *ring, char *buf, size_t buflen) {
+	const char *curr = from, *end = from + len, *nl;
+	size_t run, written;
+
+	while (curr < end) {
+		run = end - curr;
+
+		/* Runs between newlines are copied as is */
+		if (TIO_L(t, ICANON) && TIO_O(t, ONLCR)
+				&& (nl = memchr(curr, '\n', run))) {
+			run = nl - curr;
+		}
+
+		written = ring_write_all_from(ring, buf, buflen, curr, run);
+		curr += written;
+		if (written < run) {
+			break;
+		}
+
+		if (curr < end) {
+			if (!termios_putc(t, *curr, ring, buf, buflen)) {
+				break;
+			}
+			curr++;
+		}
+	}
+
+	return curr - from;
+}
+
 int termios_gotc(const struct termios *t, char ch, struct ring *ring,
 		char *buf, size_t buflen) {
 	
@@ -59,6 +59,15 @@ typedef struct termios_i_buff {
 extern int termios_putc(const struct termios *t, char ch,
 		struct ring *ring, char *buf, size_t buflen);
 
+/**
+ * @brief Does the same as termios_putc() for a string, processing it by runs
+ * of characters which need no mapping.
+ *
+ * @return Number of consumed characters of @a from
+ */
+extern int termios_write(const struct termios *t, const char *from,
+		size_t len, struct ring *ring, char *buf, size_t buflen);
+
 /**
  * @brief Does associated with termios mapping of symbol to it's visual
  * representation string.
@@ -40,17 +40,17 @@ static inline void tty_out_wake(struct tty *t) {
 	t->ops->out_wake(t);
 }
 
-/* called from mutex locked context */
-static int tty_output(struct tty *t, char ch) {
-	// TODO locks? context? -- Eldar
-	int len = termios_putc(&t->termios, ch, &t->o_ring, t->o_buff, TTY_IO_BUFF_SZ);
-	
+/* called from mutex locked context, returns number of consumed chars */
+static int tty_output(struct tty *t, const char *buff, size_t size) {
+	int len = termios_write(&t->termios, buff, size,
+			&t->o_ring, t->o_buff, TTY_IO_BUFF_SZ);
+
+	/* Device is woken up once per queued batch */
 	if (len > 0) {
 		MUTEX_UNLOCKED_DO(tty_out_wake(t), &t->lock);
 	}
 
 	return len;
-	// t->ops->tx_char(t, ch);
 }
 
 static void tty_rx_do(struct tty *t) {
@@ -129,15 +129,16 @@ size_t tty_read(struct tty *t, char *buff, size_t size) {
 	return rc;
 }
 
-static int tty_blockin_output(struct tty *t, char ch) {
+/* @return Number of consumed chars or negative error */
+static int tty_blockin_output(struct tty *t, const char *buff, size_t size) {
 	struct idesc_wait_link iwl;
 	int ret;
 
 	idesc_wait_init(&iwl, POLLOUT | POLLERR);
 
 	do {
-		if (tty_output(t, ch)) {
-			return 0;
+		if ((ret = tty_output(t, buff, size))) {
+			return ret;
 		}
 
 		if (!t->idesc) {
@@ -167,8 +168,8 @@ size_t tty_write(struct tty *t, const char *buff, size_t size) {
 	threadsig_lock();
 	mutex_lock(&t->lock);
 
-	for (count = size; count > 0; count--, buff++) {
-		if ((ret = tty_blockin_output(t, *buff))) {
+	for (count = size; count > 0; count -= ret, buff += ret) {
+		if ((ret = tty_blockin_output(t, buff, count)) < 0) {
 			break;
 		}
 	}
@@ -305,6 +306,18 @@ int tty_out_getc(struct tty *t) {
 	return (int) ch;
 }
 
+size_t tty_out_peek(struct tty *t, const char **buf) {
+	*buf = t->o_buff + t->o_ring.tail;
+
+	return ring_can_read(&t->o_ring, TTY_IO_BUFF_SZ, TTY_IO_BUFF_SZ);
+}
+
+void tty_out_done(struct tty *t, size_t len) {
+	ring_just_read(&t->o_ring, TTY_IO_BUFF_SZ, len);
+
+	tty_notify(t, POLLOUT);
+}
+
 int tty_out_buf(struct tty *t, void *buf, size_t len) {
 	int ret;
 
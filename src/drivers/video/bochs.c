@@ -83,5 +83,13 @@ static int bochs_init(struct pci_slot_dev *pci_dev) {
 		return -ENOMEM;
 	}
 
+	/* The mode may still be 0x0, then the back buffer waits for a mode */
+	if (OPTION_GET(BOOLEAN, double_buffer)
+			&& fb_double_buffer(info, 1) != 0) {
+		fb_delete(info);
+		munmap(mmap_base, mmap_len);
+		return -ENOMEM;
+	}
+
 	return 0;
 }
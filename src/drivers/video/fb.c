@@ -13,6 +13,7 @@
 #include <limits.h>
 #include <errno.h>
 
+#include <kernel/spinlock.h>
 #include <kernel/thread/sync/mutex.h>
 #include <kernel/printk.h>
 #include <util/dlist.h>
@@ -24,12 +25,24 @@
 
 #include <framework/mod/options.h>
 #include <mem/misc/pool.h>
+#include <mem/page.h>
+#include <mem/phymem.h>
 
 #define MODOPS_FB_AMOUNT OPTION_GET(NUMBER, fb_amount)
+#define MODOPS_DAMAGE_RECTS OPTION_GET(NUMBER, damage_rects)
 
 struct fb_dev {
 	struct dlist_head link;
 	struct fb_info info;
+
+	/* Double buffering */
+	int double_buffer; /**< Requested, the back buffer exists once a mode is set */
+	struct fb_ops drv_ops; /**< Driver's drawing operations, replaced */
+	size_t back_pages;
+	int update_depth; /**< Nesting of fb_update_begin() */
+	spinlock_t damage_lock;
+	int damage_n;
+	struct fb_rect damage[MODOPS_DAMAGE_RECTS];
 };
 
 static int fb_update_current_var(struct fb_info *info);
@@ -79,6 +92,12 @@ struct fb_info *fb_create(const struct fb_ops *ops, char *map_base, size_t map_s
 		if (dev) {
 			info = &dev->info;
 			info->id = fb_count++;
+			info->device_base = NULL;
+			dev->double_buffer = 0;
+			dev->back_pages = 0;
+			dev->update_depth = 0;
+			dev->damage_n = 0;
+			spin_init(&dev->damage_lock, __SPIN_UNLOCKED);
 			dlist_init(&dev->link);
 			dlist_add_next(&dev->link, &fb_list);
 		} else{
@@ -104,9 +123,12 @@ struct fb_info *fb_create(const struct fb_ops *ops, char *map_base, size_t map_s
 }
 
 void fb_delete(struct fb_info *info) {
-	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+	struct fb_dev *dev;
 
 	if (info) {
+		dev = member_cast_out(info, struct fb_dev, info);
+		fb_double_buffer(info, 0);
+
 		mutex_lock(&fb_static);
 		{
 			dlist_del(&dev->link);
@@ -134,18 +156,30 @@ struct fb_info *fb_lookup(int id) {
 	return ret;
 }
 
+static void fb_back_free(struct fb_info *info);
+static int fb_back_alloc(struct fb_info *info);
+
 int fb_set_var(struct fb_info *info, const struct fb_var_screeninfo *var) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
 	int ret;
 
 	assert(info != NULL);
 	assert(var != NULL);
 
 	if (info->ops.fb_set_var != NULL) {
+		/* Back buffer is flushed in the old mode and reallocated for the
+		 * new one */
+		fb_back_free(info);
+
 		ret = info->ops.fb_set_var(info, var);
-		if (ret < 0) {
-			return ret;
+		if (ret == 0) {
+			memcpy(&info->var, var, sizeof(struct fb_var_screeninfo));
+		}
+
+		if (dev->double_buffer && fb_back_alloc(info) != 0 && ret == 0) {
+			ret = -ENOMEM;
 		}
-		memcpy(&info->var, var, sizeof(struct fb_var_screeninfo));
+		return ret < 0 ? ret : 0;
 	}
 
 	return 0;
@@ -156,16 +190,56 @@ int fb_get_var(struct fb_info *info, struct fb_var_screeninfo *var) {
 	return 0;
 }
 
+/* Flushes after a drawing operation unless an update is in progress */
+static void fb_flush_auto(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+
+	if (!__atomic_load_n(&dev->update_depth, __ATOMIC_RELAXED)) {
+		fb_flush(info);
+	}
+}
+
+void fb_update_begin(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+
+	__atomic_add_fetch(&dev->update_depth, 1, __ATOMIC_RELAXED);
+}
+
+void fb_update_end(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+
+	if (!__atomic_sub_fetch(&dev->update_depth, 1, __ATOMIC_RELAXED)) {
+		fb_flush(info);
+	}
+}
+
 void fb_copyarea(struct fb_info *info, const struct fb_copyarea *area) {
 	info->ops.fb_copyarea(info, area);
+
+	if (info->device_base) {
+		fb_damage(info, area->dx, area->dy, area->width, area->height);
+		fb_flush_auto(info);
+	}
 }
 
 void fb_cursor(struct fb_info *info, const struct fb_cursor *cursor) {
 	info->ops.fb_cursor(info, cursor);
+
+	if (info->device_base) {
+		fb_damage(info, cursor->hot.x * cursor->image.width,
+				cursor->hot.y * cursor->image.height,
+				cursor->image.width, cursor->image.height);
+		fb_flush_auto(info);
+	}
 }
 
 void fb_imageblit(struct fb_info *info, const struct fb_image *image) {
 	info->ops.fb_imageblit(info, image);
+
+	if (info->device_base) {
+		fb_damage(info, image->dx, image->dy, image->width, image->height);
+		fb_flush_auto(info);
+	}
 }
 
 #define _val_fixup(x, low, high) (min((high), max((low), (x))))
@@ -181,6 +255,185 @@ void fb_fillrect(struct fb_info *info, const struct fb_fillrect *rect) {
 	r.height = _val_fixup(rect->height, 0, info->var.yres - r.dy);
 
 	info->ops.fb_fillrect(info, &r);
+
+	if (info->device_base) {
+		fb_damage(info, r.dx, r.dy, r.width, r.height);
+		fb_flush_auto(info);
+	}
+}
+
+static size_t fb_screen_bytes(struct fb_info *info) {
+	return (info->var.xres * info->var.yres * info->var.bits_per_pixel
+			+ CHAR_BIT - 1) / CHAR_BIT;
+}
+
+static void fb_back_free(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+
+	if (info->device_base) {
+		fb_flush(info);
+
+		phymem_free(info->screen_base, dev->back_pages);
+		info->screen_base = info->device_base;
+		info->device_base = NULL;
+
+		info->ops.fb_copyarea = dev->drv_ops.fb_copyarea;
+		info->ops.fb_imageblit = dev->drv_ops.fb_imageblit;
+		info->ops.fb_fillrect = dev->drv_ops.fb_fillrect;
+		info->ops.fb_cursor = dev->drv_ops.fb_cursor;
+	}
+}
+
+/* Nothing is allocated until a mode is set */
+static int fb_back_alloc(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+	size_t pages;
+	char *back;
+
+	if (info->device_base || !fb_screen_bytes(info)) {
+		return 0;
+	}
+
+	pages = (fb_screen_bytes(info) + PAGE_SIZE() - 1) / PAGE_SIZE();
+	if (!(back = phymem_alloc(pages))) {
+		return -ENOMEM;
+	}
+	memcpy(back, info->screen_base, fb_screen_bytes(info));
+
+	dev->back_pages = pages;
+	dev->damage_n = 0;
+	info->device_base = info->screen_base;
+	info->screen_base = back;
+
+	/* Driver's drawing would bypass the back buffer */
+	memcpy(&dev->drv_ops, &info->ops, sizeof(struct fb_ops));
+	info->ops.fb_copyarea = NULL;
+	info->ops.fb_imageblit = NULL;
+	info->ops.fb_fillrect = NULL;
+	info->ops.fb_cursor = NULL;
+	fb_ops_fixup(&info->ops);
+
+	return 0;
+}
+
+int fb_double_buffer(struct fb_info *info, int enable) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+
+	assert(info);
+
+	dev->double_buffer = enable;
+	if (!enable) {
+		fb_back_free(info);
+		return 0;
+	}
+
+	return fb_back_alloc(info);
+}
+
+static inline int fb_rect_touch(const struct fb_rect *a,
+		const struct fb_rect *b) {
+	return a->x1 <= b->x2 && b->x1 <= a->x2
+		&& a->y1 <= b->y2 && b->y1 <= a->y2;
+}
+
+static inline void fb_rect_union(struct fb_rect *a, const struct fb_rect *b) {
+	a->x1 = min(a->x1, b->x1);
+	a->y1 = min(a->y1, b->y1);
+	a->x2 = max(a->x2, b->x2);
+	a->y2 = max(a->y2, b->y2);
+}
+
+static inline uint32_t fb_rect_union_area(const struct fb_rect *a,
+		const struct fb_rect *b) {
+	return (max(a->x2, b->x2) - min(a->x1, b->x1))
+		* (max(a->y2, b->y2) - min(a->y1, b->y1));
+}
+
+void fb_damage(struct fb_info *info, uint32_t x, uint32_t y,
+		uint32_t width, uint32_t height) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+	struct fb_rect r;
+	int i, best;
+	ipl_t ipl;
+
+	if (!info->device_base || x >= info->var.xres || y >= info->var.yres) {
+		return;
+	}
+
+	r.x1 = x;
+	r.y1 = y;
+	r.x2 = x + min(width, info->var.xres - x);
+	r.y2 = y + min(height, info->var.yres - y);
+	if (r.x1 == r.x2 || r.y1 == r.y2) {
+		return;
+	}
+
+	ipl = spin_lock_ipl(&dev->damage_lock);
+	{
+		for (i = 0; i < dev->damage_n; i++) {
+			if (fb_rect_touch(&dev->damage[i], &r)) {
+				fb_rect_union(&dev->damage[i], &r);
+				goto out_unlock;
+			}
+		}
+
+		if (dev->damage_n < MODOPS_DAMAGE_RECTS) {
+			dev->damage[dev->damage_n++] = r;
+			goto out_unlock;
+		}
+
+		/* No room, extend the rectangle which grows least */
+		best = 0;
+		for (i = 1; i < dev->damage_n; i++) {
+			if (fb_rect_union_area(&dev->damage[i], &r)
+					< fb_rect_union_area(&dev->damage[best], &r)) {
+				best = i;
+			}
+		}
+		fb_rect_union(&dev->damage[best], &r);
+	}
+out_unlock:
+	spin_unlock_ipl(&dev->damage_lock, ipl);
+}
+
+static void fb_flush_rect(struct fb_info *info, const struct fb_rect *r) {
+	uint32_t bpp = info->var.bits_per_pixel;
+	uint32_t line = info->var.xres * bpp;
+	uint32_t y, start, end;
+
+	for (y = r->y1; y < r->y2; y++) {
+		start = (y * line + r->x1 * bpp) / CHAR_BIT;
+		end = (y * line + r->x2 * bpp + CHAR_BIT - 1) / CHAR_BIT;
+		fb_memcpy_tofb(info->device_base + start, info->screen_base + start,
+				end - start);
+	}
+}
+
+void fb_flush(struct fb_info *info) {
+	struct fb_dev *dev = member_cast_out(info, struct fb_dev, info);
+	struct fb_rect damage[MODOPS_DAMAGE_RECTS];
+	int i, n;
+	ipl_t ipl;
+
+	if (!info->device_base) {
+		return;
+	}
+
+	ipl = spin_lock_ipl(&dev->damage_lock);
+	{
+		n = dev->damage_n;
+		memcpy(damage, dev->damage, n * sizeof(damage[0]));
+		dev->damage_n = 0;
+	}
+	spin_unlock_ipl(&dev->damage_lock, ipl);
+
+	for (i = 0; i < n; i++) {
+		if (info->ops.fb_flush) {
+			info->ops.fb_flush(info, &damage[i]);
+		} else {
+			fb_flush_rect(info, &damage[i]);
+		}
+	}
 }
 
 static int fb_update_current_var(struct fb_info *info) {
@@ -382,6 +635,36 @@ static void bitcpy_rev(uint32_t *dst, uint32_t dstn, uint32_t *src,
 	}
 }
 
+/* Whole-byte pixels: rows are moved by memmove, which copies words itself */
+static void fb_copyarea_bytes(struct fb_info *info,
+		const struct fb_copyarea *area, uint32_t width, uint32_t height) {
+	uint32_t pitch = info->var.xres * info->var.bits_per_pixel / CHAR_BIT;
+	uint32_t len = width * info->var.bits_per_pixel / CHAR_BIT;
+	char *dst, *src;
+
+	dst = info->screen_base + area->dy * pitch
+		+ area->dx * info->var.bits_per_pixel / CHAR_BIT;
+	src = info->screen_base + area->sy * pitch
+		+ area->sx * info->var.bits_per_pixel / CHAR_BIT;
+
+	if (area->dy > area->sy) {
+		/* Overlapped rows must be moved from the bottom */
+		dst += (height - 1) * pitch;
+		src += (height - 1) * pitch;
+		while (height-- != 0) {
+			memmove(dst, src, len);
+			dst -= pitch;
+			src -= pitch;
+		}
+	} else {
+		while (height-- != 0) {
+			memmove(dst, src, len);
+			dst += pitch;
+			src += pitch;
+		}
+	}
+}
+
 static void fb_default_copyarea(struct fb_info *info, const struct fb_copyarea *area) {
 	uint32_t width, height, *dst, dstn, *src, srcn;
 
@@ -395,6 +678,11 @@ static void fb_default_copyarea(struct fb_info *info, const struct fb_copyarea *
 	height = min(area->height, info->var.yres - max(area->sy, area->dy));
 
 	assert(info->screen_base != NULL);
+	if (info->var.bits_per_pixel % CHAR_BIT == 0) {
+		fb_copyarea_bytes(info, area, width, height);
+		return;
+	}
+
 	dstn = srcn = (uint32_t)info->screen_base % sizeof(*dst);
 	dst = src = (uint32_t *)((uint32_t)info->screen_base - dstn);
 	dstn = dstn * CHAR_BIT + (area->dy * info->var.xres
@@ -516,6 +804,7 @@ static void bitfill_rev(uint32_t *dst, uint32_t dstn, uint32_t pat,
 		}
 		while (len-- != 0) {
 			fb_writel(fb_readl(dst) ^ pat, dst);
+			++dst;
 			pat = (pat << loff) | (pat >> roff);
 		}
 
@@ -523,6 +812,79 @@ static void bitfill_rev(uint32_t *dst, uint32_t dstn, uint32_t pat,
 	}
 }
 
+static inline void fb_write_pixel(void *p, uint32_t bpp, uint32_t pixel,
+		int xor) {
+	switch (bpp) {
+	case 8:
+		fb_writeb(xor ? fb_readb(p) ^ pixel : pixel, p);
+		break;
+	case 16:
+		fb_writew(xor ? fb_readw(p) ^ pixel : pixel, p);
+		break;
+	case 32:
+		fb_writel(xor ? fb_readl(p) ^ pixel : pixel, p);
+		break;
+	}
+}
+
+/**
+ * Fills @a n pixels of 8, 16 or 32 bpp from @a dst, which is aligned to the
+ * pixel size. Middle of the span is filled by 32-bit words.
+ */
+static void fb_fill_span(char *dst, uint32_t bpp, uint32_t pixel,
+		uint32_t n, int xor) {
+	uint32_t pat, words, *p;
+
+	if (bpp == 8 && !xor) {
+		fb_memset(dst, pixel, n);
+		return;
+	}
+
+	for (; n != 0 && (uintptr_t) dst % sizeof(*p) != 0; n--) {
+		fb_write_pixel(dst, bpp, pixel, xor);
+		dst += bpp / CHAR_BIT;
+	}
+
+	pat = pixel_to_pat(bpp, pixel);
+	p = (uint32_t *) dst;
+	words = n * bpp / (sizeof(*p) * CHAR_BIT);
+	n -= words * (sizeof(*p) * CHAR_BIT) / bpp;
+
+	if (xor) {
+		for (; words >= 4; words -= 4, p += 4) {
+			fb_writel(fb_readl(p) ^ pat, p);
+			fb_writel(fb_readl(p + 1) ^ pat, p + 1);
+			fb_writel(fb_readl(p + 2) ^ pat, p + 2);
+			fb_writel(fb_readl(p + 3) ^ pat, p + 3);
+		}
+		for (; words != 0; words--, p++) {
+			fb_writel(fb_readl(p) ^ pat, p);
+		}
+	} else {
+		for (; words >= 4; words -= 4, p += 4) {
+			fb_writel(pat, p);
+			fb_writel(pat, p + 1);
+			fb_writel(pat, p + 2);
+			fb_writel(pat, p + 3);
+		}
+		for (; words != 0; words--, p++) {
+			fb_writel(pat, p);
+		}
+	}
+
+	for (dst = (char *) p; n != 0; n--) {
+		fb_write_pixel(dst, bpp, pixel, xor);
+		dst += bpp / CHAR_BIT;
+	}
+}
+
+static inline int fb_bpp_is_fast(struct fb_info *info) {
+	uint32_t bpp = info->var.bits_per_pixel;
+
+	return (bpp == 8 || bpp == 16 || bpp == 32)
+		&& (uintptr_t) info->screen_base % sizeof(uint32_t) == 0;
+}
+
 static void fb_default_fillrect(struct fb_info *info, const struct fb_fillrect *rect) {
 	uint32_t width, height, pat_orig, pat, *dst, dstn, loff, roff;
 	void (*fill_op)(uint32_t *dst, uint32_t dstn, uint32_t pat,
@@ -536,9 +898,21 @@ static void fb_default_fillrect(struct fb_info *info, const struct fb_fillrect *
 	width = min(rect->width, info->var.xres - rect->dx);
 	height = min(rect->height, info->var.yres - rect->dy);
 
+	assert(info->screen_base != NULL);
+	if (fb_bpp_is_fast(info)) {
+		uint32_t bypp = info->var.bits_per_pixel / CHAR_BIT;
+		char *line = info->screen_base
+			+ (rect->dy * info->var.xres + rect->dx) * bypp;
+
+		for (; height != 0; height--, line += info->var.xres * bypp) {
+			fb_fill_span(line, info->var.bits_per_pixel, rect->color,
+					width, rect->rop != ROP_COPY);
+		}
+		return;
+	}
+
 	pat_orig = pixel_to_pat(info->var.bits_per_pixel, rect->color);
 
-	assert(info->screen_base != NULL);
 	dstn = (uint32_t)info->screen_base % sizeof(*dst);
 	dst = (uint32_t *)((uint32_t)info->screen_base - dstn);
 	dstn = dstn * CHAR_BIT + (rect->dy * info->var.xres
@@ -560,6 +934,34 @@ static void fb_default_fillrect(struct fb_info *info, const struct fb_fillrect *
 	}
 }
 
+/* Monochrome image, rows are (width + 7) / 8 bytes, MSB is the left pixel */
+static void fb_imageblit_mono(struct fb_info *info,
+		const struct fb_image *image) {
+	uint32_t bpp = info->var.bits_per_pixel;
+	uint32_t pitch = (image->width + CHAR_BIT - 1) / CHAR_BIT;
+	uint32_t width, height, i, j;
+	const uint8_t *src;
+	char *line, *dst;
+
+	if ((image->dx >= info->var.xres) || (image->dy >= info->var.yres)) return;
+
+	width = min(image->width, info->var.xres - image->dx);
+	height = min(image->height, info->var.yres - image->dy);
+
+	line = info->screen_base
+		+ (image->dy * info->var.xres + image->dx) * bpp / CHAR_BIT;
+	for (j = 0; j < height; ++j) {
+		src = (const uint8_t *) image->data + j * pitch;
+		dst = line;
+		for (i = 0; i < width; ++i) {
+			fb_write_pixel(dst, bpp, src[i / CHAR_BIT] & (0x80 >> (i % CHAR_BIT))
+					? image->fg_color : image->bg_color, 0);
+			dst += bpp / CHAR_BIT;
+		}
+		line += info->var.xres * bpp / CHAR_BIT;
+	}
+}
+
 static void fb_default_imageblit(struct fb_info *info, const struct fb_image *image) {
 	/* TODO it's slow version:) */
 	uint32_t i, j;
@@ -568,6 +970,12 @@ static void fb_default_imageblit(struct fb_info *info, const struct fb_image *im
 	assert(info != NULL);
 	assert(image != NULL);
 	assert(image->depth == 1);
+
+	if (fb_bpp_is_fast(info)) {
+		fb_imageblit_mono(info, image);
+		return;
+	}
+
 	assert(image->width == 8);
 
 	rect.width = rect.height = 1;
@@ -802,7 +1210,7 @@ void pix_fmt_chan_set_val(enum pix_fmt fmt, enum pix_chan chan, void *data, int
 		switch (chan) {
 		case ALPHA_CHAN:
 			return;
-		case BLUE_CHAN:
+		case RED_CHAN:
 			tmp &= ~0xFF0000;
 			tmp |= val << 16;
 			break;
@@ -810,7 +1218,7 @@ void pix_fmt_chan_set_val(enum pix_fmt fmt, enum pix_chan chan, void *data, int
 			tmp &= ~0x00FF00;
 			tmp |= val << 8;
 			break;
-		case RED_CHAN:
+		case BLUE_CHAN:
 			tmp &= ~0x0000FF;
 			tmp |= val;
 			break;
@@ -922,42 +1330,112 @@ void pix_fmt_chan_set_val(enum pix_fmt fmt, enum pix_chan chan, void *data, int
 	}
 }
 
+/* Bit position of the channel in the pixel, see pix_fmt_chan_get_val() */
+static int pix_fmt_chan_shift(enum pix_fmt fmt, enum pix_chan chan) {
+	switch (chan) {
+	case ALPHA_CHAN:
+		return 24;
+	case GREEN_CHAN:
+		return fmt == RGB565 || fmt == BGR565 ? 5 : 8;
+	case RED_CHAN:
+		if (fmt == BGR565) {
+			return 11;
+		}
+		return fmt == BGR888 || fmt == BGRA8888 ? 16 : 0;
+	case BLUE_CHAN:
+		if (fmt == RGB565) {
+			return 11;
+		}
+		return fmt == RGB888 || fmt == RGBA8888 ? 16 : 0;
+	}
+
+	return 0;
+}
+
+/* Shorter conversions scale channels directly, building tables costs more */
+#define PIX_FMT_TABLE_MIN 64
+
+/* RGB(A)8888 <-> BGR(A)8888, the only difference is R and B placement */
+static void pix_fmt_convert_swap32(uint32_t *src, uint32_t *dst, int n,
+		enum pix_fmt in, enum pix_fmt out) {
+	uint32_t alpha_or, alpha_and, px;
+	int swap;
+
+	swap = pix_fmt_chan_shift(in, RED_CHAN) != pix_fmt_chan_shift(out, RED_CHAN);
+	alpha_and = pix_fmt_has_alpha(out) ? 0xffffffff : 0x00ffffff;
+	alpha_or = pix_fmt_has_alpha(out) && !pix_fmt_has_alpha(in) ? 0xff000000 : 0;
+
+	for (int i = 0; i < n; i++) {
+		px = src[i];
+		if (swap) {
+			px = (px & 0xff00ff00) | ((px >> 16) & 0xff) | ((px & 0xff) << 16);
+		}
+		dst[i] = (px & alpha_and) | alpha_or;
+	}
+}
+
 int pix_fmt_convert(void *src, void *dst, int n,
 		enum pix_fmt in, enum pix_fmt out) {
-	int src_step = pix_fmt_bpp(in);
-	int dst_step = pix_fmt_bpp(out);
-	int alpha, red, green, blue;
-	int in_bits[] = {
-		pix_fmt_chan_bits(in, ALPHA_CHAN),
-		pix_fmt_chan_bits(in, RED_CHAN),
-		pix_fmt_chan_bits(in, GREEN_CHAN),
-		pix_fmt_chan_bits(in, BLUE_CHAN)
-	};
-
-	int out_bits[] = {
-		pix_fmt_chan_bits(out, ALPHA_CHAN),
-		pix_fmt_chan_bits(out, RED_CHAN),
-		pix_fmt_chan_bits(out, GREEN_CHAN),
-		pix_fmt_chan_bits(out, BLUE_CHAN)
-	};
-
-	memset(dst, 0, n * pix_fmt_bpp(out) / 8);
+	int src_step = pix_fmt_bpp(in) / CHAR_BIT;
+	int dst_step = pix_fmt_bpp(out) / CHAR_BIT;
+	uint8_t scale[4][256];
+	int shift_in[4], shift_out[4], bits_in[4], bits_out[4];
+	uint32_t px, res;
+	int chan, val, use_table;
+
+	if (in == UNKNOWN || out == UNKNOWN) {
+		return -EINVAL;
+	}
+
+	if (src_step == 4 && dst_step == 4) {
+		pix_fmt_convert_swap32(src, dst, n, in, out);
+		return 0;
+	}
+
+	if (in == out) {
+		memcpy(dst, src, n * src_step);
+		return 0;
+	}
+
+	use_table = n >= PIX_FMT_TABLE_MIN;
+	for (chan = ALPHA_CHAN; chan <= BLUE_CHAN; chan++) {
+		bits_in[chan] = pix_fmt_chan_bits(in, chan);
+		bits_out[chan] = pix_fmt_chan_bits(out, chan);
+		shift_in[chan] = pix_fmt_chan_shift(in, chan);
+		shift_out[chan] = pix_fmt_chan_shift(out, chan);
+
+		if (!use_table) {
+			continue;
+		}
+		for (val = 0; val < (1 << bits_in[chan]); val++) {
+			scale[chan][val] = pix_color_scale(val, bits_in[chan], bits_out[chan]);
+		}
+	}
 
 	for (int i = 0; i < n; i++) {
-		alpha = pix_fmt_chan_get_val(in, ALPHA_CHAN, src);
-		red   = pix_fmt_chan_get_val(in, RED_CHAN, src);
-		green = pix_fmt_chan_get_val(in, GREEN_CHAN, src);
-		blue  = pix_fmt_chan_get_val(in, BLUE_CHAN, src);
-
-		alpha = pix_color_scale(alpha, in_bits[0], out_bits[0]);
-		red   = pix_color_scale(red,   in_bits[1], out_bits[1]);
-		green = pix_color_scale(green, in_bits[2], out_bits[2]);
-		blue  = pix_color_scale(blue,  in_bits[3], out_bits[3]);
-
-		pix_fmt_chan_set_val(out, ALPHA_CHAN, dst, alpha);
-		pix_fmt_chan_set_val(out, RED_CHAN,   dst, red);
-		pix_fmt_chan_set_val(out, GREEN_CHAN, dst, green);
-		pix_fmt_chan_set_val(out, BLUE_CHAN,  dst, blue);
+		px = src_step == 4 ? *(uint32_t *) src : *(uint16_t *) src;
+		res = 0;
+
+		for (chan = ALPHA_CHAN; chan <= BLUE_CHAN; chan++) {
+			if (bits_out[chan] == 0) {
+				continue;
+			}
+			if (bits_in[chan] == 0) {
+				/* Opaque */
+				val = (1 << bits_out[chan]) - 1;
+			} else {
+				val = (px >> shift_in[chan]) & ((1 << bits_in[chan]) - 1);
+				val = use_table ? scale[chan][val]
+					: pix_color_scale(val, bits_in[chan], bits_out[chan]);
+			}
+			res |= (uint32_t) val << shift_out[chan];
+		}
+
+		if (dst_step == 4) {
+			*(uint32_t *) dst = res;
+		} else {
+			*(uint16_t *) dst = res;
+		}
 
 		src += src_step;
 		dst += dst_step;
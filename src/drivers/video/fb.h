@@ -144,6 +144,14 @@ struct fbcurpos {
 	uint16_t y;
 };
 
+/* Rectangle of the screen, x2 and y2 are excluded */
+struct fb_rect {
+	uint32_t x1;
+	uint32_t y1;
+	uint32_t x2;
+	uint32_t y2;
+};
+
 struct fb_cursor {
 	uint16_t enable;
 	uint16_t rop;
@@ -163,14 +171,18 @@ struct fb_ops {
 	void (*fb_fillrect)(struct fb_info *info, const struct fb_fillrect *rect);
 	void (*fb_imageblit)(struct fb_info *info, const struct fb_image *image);
 	void (*fb_cursor)(struct fb_info *info, const struct fb_cursor *cursor);
+	/* Copies a damaged rectangle of the back buffer to the device memory in
+	 * double buffered mode, the CPU copies it if it's not set */
+	void (*fb_flush)(struct fb_info *info, const struct fb_rect *rect);
 };
 
 struct fb_info {
 	int id; /**< ID, monothonically incremented for each fb */
 
 	struct fb_ops ops; /**< Operations on fb, allowed to be modified by driver */
-	char *screen_base; /**< Start of frame buffer */
+	char *screen_base; /**< Start of frame buffer, back one if double buffered */
 	size_t screen_size; /**< Maximum lenght of frame buffer */
+	char *device_base; /**< Device memory if double buffered, NULL otherwise */
 
 	struct fb_var_screeninfo var; /**< Current variable settins */
 };
@@ -179,6 +191,14 @@ extern struct fb_info *fb_create(const struct fb_ops *ops, char *map_base,
 		size_t map_size);
 extern void fb_delete(struct fb_info *info);
 
+/**
+ * Switches to drawing in the back buffer in RAM, only damaged parts of it are
+ * copied to the device on fb_flush(). Drawing operations of the driver are
+ * replaced with the default ones, as they work with the device memory.
+ * If no mode is set yet, the back buffer is allocated when it is.
+ */
+extern int fb_double_buffer(struct fb_info *info, int enable);
+
 /**
  * Solely application's part
  */
@@ -192,6 +212,23 @@ extern void fb_fillrect(struct fb_info *info, const struct fb_fillrect *rect);
 extern void fb_imageblit(struct fb_info *info, const struct fb_image *image);
 extern void fb_cursor(struct fb_info *info, const struct fb_cursor *cursor);
 
+/**
+ * Marks the rectangle of screen_base as changed. Drawing functions above do
+ * it themselves and flush immediately (see fb_update_begin()), those who
+ * write to screen_base directly should call fb_damage() and fb_flush(). Both
+ * do nothing if the frame buffer is not double buffered.
+ */
+extern void fb_damage(struct fb_info *info, uint32_t x, uint32_t y,
+		uint32_t width, uint32_t height);
+extern void fb_flush(struct fb_info *info);
+
+/**
+ * Drawing functions between these calls don't flush, the damage is flushed
+ * at once by the outermost fb_update_end(). Calls may be nested.
+ */
+extern void fb_update_begin(struct fb_info *info);
+extern void fb_update_end(struct fb_info *info);
+
 
 extern int fb_devfs_create(const struct fb_ops *ops, char *map_base, size_t map_size);
 
@@ -99,7 +99,8 @@ static struct fb_ops pl110_lcd_ops = {
 
 static int pl110_lcd_init(void) {
 	char *mmap_base = (void *) pl110_fb;
-	size_t mmap_len = 0;
+	size_t mmap_len = sizeof(pl110_fb);
+	struct fb_info *info;
 	uint32_t tmp;
 
 	tmp = pl110_fb_width = 640;
@@ -117,7 +118,10 @@ static int pl110_lcd_init(void) {
 	REG32_CLEAR(PL110_CONTROL, PL110_BPP_MASK);
 	REG32_ORIN(PL110_CONTROL, 5 << PL110_BPP_OFFT);
 
-	fb_create(&pl110_lcd_ops, mmap_base, mmap_len);
+	info = fb_create(&pl110_lcd_ops, mmap_base, mmap_len);
+	if (info == NULL) {
+		return -ENOMEM;
+	}
 
 	pl110_fb_width  = PL110_MAX_WIDTH;
 	pl110_fb_height = PL110_MAX_HEIGHT;
@@ -125,6 +129,10 @@ static int pl110_lcd_init(void) {
 	for (int i = 0; i < 640 * 480; i++)
 		pl110_fb[i] = 0xff000000;
 
+	if (OPTION_GET(BOOLEAN, double_buffer)) {
+		return fb_double_buffer(info, 1);
+	}
+
 	return 0;
 }
 
@@ -12,6 +12,7 @@
 #include <sys/mman.h>
 
 #include <drivers/video/fb.h>
+#include <framework/mod/options.h>
 #include <mem/page.h>
 #include <util/binalign.h>
 #include <util/log.h>
@@ -86,7 +87,8 @@ static struct fb_ops stm32f7_lcd_ops = {
 
 static int stm32f7_lcd_init(void) {
 	char *mmap_base = (void*) LCD_FRAMEBUFFER;
-	size_t mmap_len = 0;
+	size_t mmap_len;
+	struct fb_info *info;
 
 	if (BSP_LCD_Init() != LCD_OK) {
 		log_error("Failed to init LCD!");
@@ -97,7 +99,17 @@ static int stm32f7_lcd_init(void) {
 	BSP_LCD_SelectLayer(LTDC_ACTIVE_LAYER);
 	BSP_LCD_Clear(LCD_COLOR_BLACK);
 
-	fb_create(&stm32f7_lcd_ops, mmap_base, mmap_len);
+	/* 24 bpp, see stm32f7_lcd_get_var() */
+	mmap_len = BSP_LCD_GetXSize() * BSP_LCD_GetYSize() * 3;
+
+	info = fb_create(&stm32f7_lcd_ops, mmap_base, mmap_len);
+	if (info == NULL) {
+		return -ENOMEM;
+	}
+
+	if (OPTION_GET(BOOLEAN, double_buffer)) {
+		return fb_double_buffer(info, 1);
+	}
 
 	return 0;
 }
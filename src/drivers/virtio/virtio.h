@@ -25,6 +25,16 @@
 #define VIRTIO_REG_QUEUE_N  0x10 /* Queue notify */
 #define VIRTIO_REG_DEVICE_S 0x12 /* Device status */
 #define VIRTIO_REG_ISR_S    0x13 /* ISR status */
+#define VIRTIO_REG_MSI_CFG  0x14 /* Configuration change vector (MSI-X) */
+#define VIRTIO_REG_MSI_Q    0x16 /* Selected queue vector (MSI-X) */
+
+/**
+ * Device specific configuration follows the registers, which are longer
+ * with MSI-X enabled
+ */
+#define VIRTIO_REG_DEVICE_CFG(msix) ((msix) ? 0x18 : 0x14)
+
+#define VIRTIO_MSI_NO_VECTOR 0xFFFF
 
 /**
  * VirtIO Device Status
@@ -83,6 +93,23 @@ static inline void virtio_set_queue_addr(void *q_addr,
 			VIRTIO_REG_QUEUE_A, base_addr);
 }
 
+/**
+ * VirtIO MSI-X Vector Operations
+ * @return the vector set or VIRTIO_MSI_NO_VECTOR if the device failed
+ */
+static inline uint16_t virtio_set_config_vector(uint16_t vec,
+		unsigned long base_addr) {
+	virtio_store16(vec, VIRTIO_REG_MSI_CFG, base_addr);
+	return virtio_load16(VIRTIO_REG_MSI_CFG, base_addr);
+}
+
+static inline uint16_t virtio_set_queue_vector(uint16_t q_id, uint16_t vec,
+		unsigned long base_addr) {
+	virtio_select_queue(q_id, base_addr);
+	virtio_store16(vec, VIRTIO_REG_MSI_Q, base_addr);
+	return virtio_load16(VIRTIO_REG_MSI_Q, base_addr);
+}
+
 /**
  * VirtIO Status Operations
  */
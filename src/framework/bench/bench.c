@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @brief Benchmark invocation and statistics.
+ *
+ * Every iteration is timed separately with the clock source that counts
+ * without interrupts (TSC, cycle counter, ...). Cost of reading the counter
+ * itself is measured once per run and subtracted from each sample.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kernel/time/clock_source.h>
+#include <kernel/time/time_device.h>
+#include <util/array.h>
+
+#include <framework/bench/api.h>
+#include <framework/mod/options.h>
+
+#define BENCH_MAX_SAMPLES  OPTION_GET(NUMBER, max_samples)
+#define BENCH_WARMUP       OPTION_GET(NUMBER, warmup)
+#define BENCH_ITERATIONS   OPTION_GET(NUMBER, iterations)
+
+ARRAY_SPREAD_DEF(const struct bench * const, __bench_registry);
+
+static int bench_sample_cmp(const void *a, const void *b) {
+	uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+static uint64_t bench_isqrt(uint64_t v) {
+	uint64_t res = 0, bit = (uint64_t) 1 << 62;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= res + bit) {
+			v -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+static unsigned int bench_bits(uint64_t v) {
+	unsigned int bits = 0;
+
+	while (v) {
+		v >>= 1;
+		bits++;
+	}
+
+	return bits;
+}
+
+/* Narrow counters without event device (32-bit HPET) may wrap between reads */
+static inline uint64_t bench_delta(struct clock_source *cs,
+		uint64_t t0, uint64_t t1) {
+	if (!cs->event_device && cs->counter_device->mask) {
+		return (t1 - t0) & cs->counter_device->mask;
+	}
+	return t1 - t0;
+}
+
+/* Minimal cost of two consequent counter reads */
+static uint64_t bench_overhead(struct clock_source *cs) {
+	uint64_t t0, t1, min = UINT64_MAX;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		t0 = clock_source_get_hwcycles(cs);
+		t1 = clock_source_get_hwcycles(cs);
+		if (bench_delta(cs, t0, t1) < min) {
+			min = bench_delta(cs, t0, t1);
+		}
+	}
+
+	return min;
+}
+
+static void bench_stats(uint64_t *samples, unsigned int n,
+		struct bench_result *res) {
+	uint64_t sum = 0, var = 0, d;
+	unsigned int i, limit, shift;
+
+	qsort(samples, n, sizeof(*samples), bench_sample_cmp);
+
+	for (i = 0; i < n; i++) {
+		sum += samples[i];
+	}
+	res->mean = sum / n;
+
+	/* Scale deltas down so that the sum of n squares fits 64 bits */
+	d = samples[n - 1] - res->mean > res->mean - samples[0] ?
+			samples[n - 1] - res->mean : res->mean - samples[0];
+	limit = (64 - bench_bits(n)) / 2;
+	shift = bench_bits(d) > limit ? bench_bits(d) - limit : 0;
+
+	for (i = 0; i < n; i++) {
+		d = samples[i] > res->mean ?
+				samples[i] - res->mean : res->mean - samples[i];
+		d >>= shift;
+		var += d * d;
+	}
+
+	res->iterations = n;
+	res->min = samples[0];
+	res->max = samples[n - 1];
+	res->median = (n % 2) ? samples[n / 2] :
+			(samples[n / 2 - 1] + samples[n / 2]) / 2;
+	res->p99 = samples[(n * 99 + 99) / 100 - 1];
+	res->stddev = bench_isqrt(var / n) << shift;
+}
+
+int bench_run(const struct bench *bench, const struct bench_opts *opts,
+		struct bench_result *result) {
+	struct clock_source *cs;
+	unsigned int warmup, iters, i;
+	uint64_t *samples;
+	uint64_t t0, t1, overhead;
+	int ret;
+
+	cs = clock_source_get_best(CS_WITHOUT_IRQ);
+	if (!cs || !cs->counter_device) {
+		return -ENOTSUP;
+	}
+
+	warmup = opts ? opts->warmup : BENCH_WARMUP;
+	iters = opts ? opts->iterations : BENCH_ITERATIONS;
+	if (iters == 0 || iters > BENCH_MAX_SAMPLES) {
+		return -EINVAL;
+	}
+
+	samples = malloc(iters * sizeof(*samples));
+	if (!samples) {
+		return -ENOMEM;
+	}
+
+	if (bench->setup && (ret = bench->setup()) != 0) {
+		free(samples);
+		return ret;
+	}
+
+	for (i = 0; i < warmup; i++) {
+		bench->run();
+	}
+
+	overhead = bench_overhead(cs);
+
+	for (i = 0; i < iters; i++) {
+		t0 = clock_source_get_hwcycles(cs);
+		bench->run();
+		t1 = clock_source_get_hwcycles(cs);
+
+		t1 = bench_delta(cs, t0, t1);
+		samples[i] = t1 > overhead ? t1 - overhead : 0;
+	}
+
+	if (bench->teardown) {
+		bench->teardown();
+	}
+
+	bench_stats(samples, iters, result);
+	result->cycle_hz = cs->counter_device->cycle_hz;
+
+	free(samples);
+
+	return 0;
+}
+
+void bench_report(const struct bench *bench,
+		const struct bench_result *res) {
+	printf("bench=%s iterations=%u min=%llu median=%llu mean=%llu p99=%llu "
+			"max=%llu stddev=%llu unit=cycles hz=%u\n",
+			bench->name, res->iterations,
+			(unsigned long long) res->min,
+			(unsigned long long) res->median,
+			(unsigned long long) res->mean,
+			(unsigned long long) res->p99,
+			(unsigned long long) res->max,
+			(unsigned long long) res->stddev,
+			(unsigned int) res->cycle_hz);
+}
+
+const struct bench *bench_lookup(const char *name) {
+	const struct bench *bench;
+
+	bench_foreach(bench) {
+		if (strcmp(bench->name, name) == 0) {
+			return bench;
+		}
+	}
+
+	return NULL;
+}
@@ -10,6 +10,7 @@
 #include <kernel/printk.h>
 
 #include <embox/runlevel.h>
+#include <embox/unit.h>
 
 #include <framework/mod/api.h>
 
@@ -74,16 +75,20 @@ int runlevel_set(runlevel_nr_t level) {
 
 	while (init_level != level) {
 		const struct mod *const volatile*mod;
-		int ret;
+		int ret, async_ret;
 
 		ret = 0;
 		for (mod = start_mods[init_level + d];
 				mod != end_mods[init_level + d]; mod += d) {
 			if (*mod && (ret = mod_op(*mod))) {
-				goto mod_fail;
+				break;
 			}
 		}
-mod_fail:
+		/* Level is reached (or failed) only when async units are done */
+		async_ret = __unit_init_wait_all();
+		if (!ret) {
+			ret = async_ret;
+		}
 		if (runlevel_change_hook(init_level + d, ret)) {
 			return ret;
 		}
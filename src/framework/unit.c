@@ -6,8 +6,10 @@
  * @author Eldar Abusalimov
  */
 
+#include <stdint.h>
 #include <string.h>
 #include <kernel/printk.h>
+#include <kernel/time/clock_source.h>
 
 #include <framework/mod/ops.h>
 #include <framework/mod/api.h>
@@ -23,28 +25,22 @@ const struct mod_ops __unit_mod_ops = {
 };
 
 static int unit_mod_enable(const struct mod *mod) {
-	int ret = 0;
 	struct unit *unit = (struct unit *) mod;
 
 	if (NULL == unit->init) {
 		return 0;
 	}
 
-	printk("\tunit: initializing %s.%s: ",
-		mod_pkg_name(mod), mod_name(mod));
-	if (0 == (ret = unit->init())) {
-		printk("done\n");
-	} else {
-		printk("error: %s\n", strerror(-ret));
-	}
-
-	return ret;
+	return __unit_init(unit);
 }
 
 static int unit_mod_disable(const struct mod *mod) {
 	int ret = 0;
 	struct unit *unit = (struct unit *) mod;
 
+	/* Next enable runs init again */
+	unit->priv->state = 0;
+
 	if (NULL == unit->fini) {
 		return 0;
 	}
@@ -59,3 +55,18 @@ static int unit_mod_disable(const struct mod *mod) {
 
 	return ret;
 }
+
+uint64_t __unit_init_time_us(void) {
+	static struct clock_source *cs;
+	struct timespec ts;
+
+	if (!cs) {
+		cs = clock_source_get_best(CS_WITHOUT_IRQ);
+		if (!cs) {
+			return 0;
+		}
+	}
+
+	ts = clock_source_read(cs);
+	return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file
+ * @brief Units are initialized by a pool of boot threads.
+ *
+ * Runlevel code enables modules in topological order. An async unit is put
+ * into the FIFO queue and the boot thread goes on with the next module. A
+ * worker takes the unit, waits until units it depends on are done and runs
+ * its init. Since the queue follows the topological order, dependencies of
+ * a unit are always taken by workers before the unit itself, so workers
+ * can't wait for each other in a cycle.
+ *
+ * Until the pool is started (threads are not available at early runlevels)
+ * all units are initialized synchronously.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <kernel/printk.h>
+#include <kernel/thread.h>
+#include <kernel/thread/sync/cond.h>
+#include <kernel/thread/sync/mutex.h>
+#include <util/err.h>
+
+#include <framework/mod/api.h>
+#include <framework/mod/options.h>
+
+#include <embox/unit.h>
+
+#define UNIT_INIT_WORKERS   OPTION_GET(NUMBER, workers)
+#define UNIT_INIT_ASYNC_ALL OPTION_GET(BOOLEAN, async_all)
+
+#define UNIT_STATE_NONE     0
+#define UNIT_STATE_PENDING  1 /* queued or init is running */
+#define UNIT_STATE_DONE     2
+#define UNIT_STATE_LAZY     3
+
+EMBOX_UNIT_INIT(unit_init_pool_start);
+
+static struct mutex unit_init_lock = MUTEX_INIT_STATIC;
+static cond_t unit_init_cond = COND_INIT_STATIC;
+
+static const struct unit *unit_queue_head;
+static const struct unit **unit_queue_tail = &unit_queue_head;
+static int unit_pending;
+static int unit_async_error;
+
+static int unit_pool_ready;
+
+static int unit_is_async(const struct unit *unit) {
+	return unit_pool_ready
+		&& (UNIT_INIT_ASYNC_ALL || (unit->flags & UNIT_FLAG_ASYNC));
+}
+
+static void unit_state_set(const struct unit *unit, int state) {
+	if (!unit_pool_ready) {
+		unit->priv->state = state;
+		return;
+	}
+
+	mutex_lock(&unit_init_lock);
+	unit->priv->state = state;
+	cond_broadcast(&unit_init_cond);
+	mutex_unlock(&unit_init_lock);
+}
+
+static int unit_init_run(const struct unit *unit) {
+	const struct mod *mod = &unit->mod;
+	uint64_t start;
+	int ret;
+
+	start = __unit_init_time_us();
+	ret = unit->init();
+
+	if (ret == 0 && start) {
+		printk("\tunit: initialized %s.%s in %u us\n",
+			mod_pkg_name(mod), mod_name(mod),
+			(unsigned int) (__unit_init_time_us() - start));
+	} else if (ret == 0) {
+		printk("\tunit: initialized %s.%s\n",
+			mod_pkg_name(mod), mod_name(mod));
+	} else {
+		printk("\tunit: initializing %s.%s: error: %s\n",
+			mod_pkg_name(mod), mod_name(mod), strerror(-ret));
+	}
+
+	unit->priv->result = ret;
+	unit_state_set(unit, UNIT_STATE_DONE);
+
+	return ret;
+}
+
+/* Blocks until all units @a mod depends on (directly or through modules
+ * without init) are initialized. */
+static void unit_deps_wait(const struct mod *mod) {
+	const struct mod *dep;
+	const struct unit *unit;
+
+	mod_foreach_requires(dep, mod) {
+		if (dep->ops != &__unit_mod_ops) {
+			if (unit_pending) {
+				unit_deps_wait(dep);
+			}
+			continue;
+		}
+
+		unit = (const struct unit *) dep;
+		if (unit->init == NULL) {
+			continue;
+		}
+
+		if (unit->priv->state == UNIT_STATE_LAZY) {
+			/* Used at boot, so there is no point to defer it */
+			unit_ensure(unit);
+			continue;
+		}
+
+		if (!unit_pool_ready) {
+			continue;
+		}
+
+		mutex_lock(&unit_init_lock);
+		while (unit->priv->state == UNIT_STATE_PENDING) {
+			cond_wait(&unit_init_cond, &unit_init_lock);
+		}
+		mutex_unlock(&unit_init_lock);
+	}
+}
+
+static void *unit_init_worker(void *arg) {
+	const struct unit *unit;
+	int ret;
+
+	mutex_lock(&unit_init_lock);
+	while (1) {
+		while (!unit_queue_head) {
+			cond_wait(&unit_init_cond, &unit_init_lock);
+		}
+
+		unit = unit_queue_head;
+		unit_queue_head = unit->priv->next;
+		if (!unit_queue_head) {
+			unit_queue_tail = &unit_queue_head;
+		}
+		mutex_unlock(&unit_init_lock);
+
+		unit_deps_wait(&unit->mod);
+		ret = unit_init_run(unit);
+
+		mutex_lock(&unit_init_lock);
+		if (ret && !unit_async_error) {
+			unit_async_error = ret;
+		}
+		unit_pending--;
+		cond_broadcast(&unit_init_cond);
+	}
+
+	return NULL;
+}
+
+int __unit_init(const struct unit *unit) {
+	const struct mod *mod = &unit->mod;
+
+	switch (unit->priv->state) {
+	case UNIT_STATE_DONE:
+		/* Already done by unit_ensure() */
+		return unit->priv->result;
+	case UNIT_STATE_PENDING:
+		return 0;
+	default:
+		break;
+	}
+
+	if (unit->flags & UNIT_FLAG_LAZY) {
+		unit->priv->state = UNIT_STATE_LAZY;
+		printk("\tunit: %s.%s is deferred until first use\n",
+			mod_pkg_name(mod), mod_name(mod));
+		return 0;
+	}
+
+	if (!unit_is_async(unit)) {
+		unit->priv->state = UNIT_STATE_PENDING;
+		unit_deps_wait(mod);
+		return unit_init_run(unit);
+	}
+
+	mutex_lock(&unit_init_lock);
+	unit->priv->state = UNIT_STATE_PENDING;
+	unit->priv->next = NULL;
+	*unit_queue_tail = unit;
+	unit_queue_tail = &unit->priv->next;
+	unit_pending++;
+	cond_broadcast(&unit_init_cond);
+	mutex_unlock(&unit_init_lock);
+
+	return 0;
+}
+
+int __unit_init_wait_all(void) {
+	int ret;
+
+	if (!unit_pool_ready) {
+		return 0;
+	}
+
+	mutex_lock(&unit_init_lock);
+	while (unit_pending) {
+		cond_wait(&unit_init_cond, &unit_init_lock);
+	}
+	ret = unit_async_error;
+	unit_async_error = 0;
+	mutex_unlock(&unit_init_lock);
+
+	return ret;
+}
+
+int unit_ensure(const struct unit *unit) {
+	if (unit->init == NULL) {
+		return 0;
+	}
+
+	if (unit->priv->state == UNIT_STATE_DONE) {
+		return unit->priv->result;
+	}
+
+	mutex_lock(&unit_init_lock);
+	while (unit->priv->state == UNIT_STATE_PENDING) {
+		cond_wait(&unit_init_cond, &unit_init_lock);
+	}
+	if (unit->priv->state == UNIT_STATE_DONE) {
+		mutex_unlock(&unit_init_lock);
+		return unit->priv->result;
+	}
+	/* Not initialized yet: lazy or its runlevel is not reached */
+	unit->priv->state = UNIT_STATE_PENDING;
+	mutex_unlock(&unit_init_lock);
+
+	unit_deps_wait(&unit->mod);
+	return unit_init_run(unit);
+}
+
+static int unit_init_pool_start(void) {
+	struct thread *t;
+	int i;
+
+	for (i = 0; i < UNIT_INIT_WORKERS; i++) {
+		t = thread_create(THREAD_FLAG_DETACHED, unit_init_worker, NULL);
+		if (err(t)) {
+			/* Units are still initialized synchronously */
+			return i ? 0 : err(t);
+		}
+	}
+
+	unit_pool_ready = 1;
+
+	return 0;
+}
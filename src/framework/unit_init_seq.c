@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief Units are initialized one by one in the boot context.
+ *
+ * Async and lazy flags are ignored, every unit is ready when its runlevel
+ * is reached.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <kernel/printk.h>
+#include <framework/mod/api.h>
+
+#include <embox/unit.h>
+
+#define UNIT_STATE_DONE 1
+
+int __unit_init(const struct unit *unit) {
+	const struct mod *mod = &unit->mod;
+	uint64_t start;
+	int ret;
+
+	if (unit->priv->state == UNIT_STATE_DONE) {
+		return unit->priv->result;
+	}
+
+	printk("\tunit: initializing %s.%s: ",
+		mod_pkg_name(mod), mod_name(mod));
+	start = __unit_init_time_us();
+	if (0 == (ret = unit->init()) && start) {
+		printk("done in %u us\n",
+			(unsigned int) (__unit_init_time_us() - start));
+	} else if (ret == 0) {
+		printk("done\n");
+	} else {
+		printk("error: %s\n", strerror(-ret));
+	}
+
+	unit->priv->result = ret;
+	unit->priv->state = UNIT_STATE_DONE;
+
+	return ret;
+}
+
+int __unit_init_wait_all(void) {
+	return 0;
+}
+
+int unit_ensure(const struct unit *unit) {
+	if (unit->init == NULL) {
+		return 0;
+	}
+
+	return __unit_init(unit);
+}
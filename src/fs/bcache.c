@@ -10,7 +10,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
-#include <util/hashtable.h>
+#include <util/hashmap.h>
 
 #include <mem/misc/pool.h>
 #include <mem/sysmalloc.h>
@@ -29,10 +29,10 @@ static DLIST_DEFINE(bh_list);
 
 static size_t bh_hash(void *key);
 static int bh_cmp(void *key1, void *key2);
-HASHTABLE_DEF(bcache_ht, BCACHE_SIZE / 10, bh_hash, bh_cmp);
-POOL_DEF(bcach_ht_item_pool, struct hashtable_item, BCACHE_SIZE);
+/* Grows on demand, the initial size must be a power of two */
+HASHMAP_DEF(bcache_ht, 32, bh_hash, bh_cmp);
 
-static struct hashtable *bcache = &bcache_ht;
+static struct hashmap *bcache = &bcache_ht;
 static struct mutex bcache_mutex;
 static int graw_buffers(struct block_dev *bdev, int block, size_t size);
 static void free_more_memory(size_t size);
@@ -45,7 +45,7 @@ struct buffer_head *bcache_getblk_locked(struct block_dev *bdev, int block, size
 
 	mutex_lock(&bcache_mutex);
 	while (1) {
-		bh = (struct buffer_head *)hashtable_get(bcache, &key);
+		bh = (struct buffer_head *)hashmap_get(bcache, &key);
 
 		if (bh) {
 			assert(size == bh->blocksize);
@@ -66,7 +66,6 @@ struct buffer_head *bcache_getblk_locked(struct block_dev *bdev, int block, size
 
 static void free_more_memory(size_t size) {
 	struct buffer_head *bh;
-	struct hashtable_item *ht_item;
 
 	/* Free everything that we can free */
 	dlist_foreach_entry(bh, &bh_list, bh_next) {
@@ -89,19 +88,17 @@ static void free_more_memory(size_t size) {
 			}
 
 			dlist_del(&bh->bh_next);
-			ht_item = hashtable_del(bcache, bh);
+			hashmap_del(bcache, bh);
 		}
 		bcache_buffer_unlock(bh);
 
 		sysfree(bh->data);
-		pool_free(&bcach_ht_item_pool, ht_item);
 		pool_free(&buffer_head_pool, bh);
 	}
 }
 
 static int graw_buffers(struct block_dev *bdev, int block, size_t size) {
 	struct buffer_head *bh;
-	struct hashtable_item *ht_item;
 
 	bh = pool_alloc(&buffer_head_pool);
 
@@ -123,14 +120,11 @@ static int graw_buffers(struct block_dev *bdev, int block, size_t size) {
 		pool_free(&buffer_head_pool, bh);
 		return -1;
 	}
-	ht_item = pool_alloc(&bcach_ht_item_pool);
-	if (!ht_item) {
+	if (0 != hashmap_put(bcache, bh, bh)) {
 		sysfree(bh->data);
 		pool_free(&buffer_head_pool, bh);
 		return -1;
 	}
-	ht_item = hashtable_item_init(ht_item, bh, bh);
-	hashtable_put(bcache, ht_item);
 
 	dlist_add_next(&bh->bh_next, &bh_list);
 
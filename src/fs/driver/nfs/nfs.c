@@ -12,7 +12,9 @@
 #include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <time.h>
 #include <sys/time.h>
+#include <arpa/inet.h>
 
 #include <fs/vfs.h>
 #include <fs/nfs.h>
@@ -31,6 +33,19 @@
 #include <net/lib/rpc/xdr.h>
 #include <util/math.h>
 #include <util/err.h>
+#include <kernel/time/time.h>
+
+#define NFS_RSIZE        OPTION_GET(NUMBER,rsize)
+#define NFS_WSIZE        OPTION_GET(NUMBER,wsize)
+#define NFS_MAX_REQUESTS OPTION_GET(NUMBER,max_requests)
+#define NFS_ATTR_TIMEOUT OPTION_GET(NUMBER,attr_timeout)
+
+/* read-ahead window and write-behind buffer are filled by one batch */
+#define NFS_RA_SIZE      (NFS_RSIZE * NFS_MAX_REQUESTS)
+#define NFS_WB_SIZE      (NFS_WSIZE * NFS_MAX_REQUESTS)
+
+/* RPC and NFS headers around the data of READ/WRITE */
+#define NFS_RPC_HDR_SZ   512
 
 
 static int nfs_create_dir_entry(node_t *parent);
@@ -39,6 +54,7 @@ static int nfs_mount(struct nas *nas);
 static int nfs_lookup(struct nas *nas);
 static int nfs_call_proc_nfs(struct nas *nas,
 		__u32 procnum, char *req, char *reply);
+static int nfs_call_many(struct nas *nas, struct rpc_call *calls, int count);
 
 /* nfs filesystem description pool */
 POOL_DEF (nfs_fs_pool, struct nfs_fs_info, OPTION_GET(NUMBER,nfs_descriptor_quantity));
@@ -64,6 +80,184 @@ static void unaligned_set_hyper(uint64_t *dst, void *src) {
 	memcpy(dst, src, sizeof *dst);
 }
 
+static __u32 nfs_time_ms(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * MSEC_PER_SEC + ts.tv_nsec / NSEC_PER_MSEC;
+}
+
+static int nfs_attr_is_fresh(nfs_file_info_t *fi) {
+	return (0 != fi->fh.name_fh.len) && (0 != fi->attr_time)
+			&& (nfs_time_ms() - fi->attr_time < NFS_ATTR_TIMEOUT);
+}
+
+static void nfs_file_free_buffers(nfs_file_info_t *fi) {
+	if (NULL != fi->ra_buf) {
+		sysfree(fi->ra_buf);
+		fi->ra_buf = NULL;
+	}
+	fi->ra_len = 0;
+
+	if (NULL != fi->wb_buf) {
+		sysfree(fi->wb_buf);
+		fi->wb_buf = NULL;
+	}
+	fi->wb_len = 0;
+}
+
+/*
+ * Reads [offset, offset + size) with READs of rsize bytes, keeping up to
+ * max_requests of them outstanding. Returns the amount of data that was read
+ * contiguously from offset, which is less than size at the end of file.
+ */
+static int nfs_read_pipelined(struct nas *nas, nfs_file_info_t *fi,
+		__u64 offset, char *buf, size_t size) {
+	struct rpc_call calls[NFS_MAX_REQUESTS];
+	read_req_t req[NFS_MAX_REQUESTS];
+	read_reply_t reply[NFS_MAX_REQUESTS];
+	size_t datalen, sent;
+	int i, n;
+
+	datalen = 0;
+	while (datalen < size) {
+		sent = datalen;
+		for (n = 0; (n < NFS_MAX_REQUESTS) && (sent < size); n++) {
+			req[n].count = min(size - sent, NFS_RSIZE);
+			req[n].offset = offset + sent;
+			req[n].fh = &fi->fh.name_fh;
+			reply[n].datalen = 0;
+			reply[n].data = buf + sent;
+
+			calls[n].procnum = NFSPROC3_READ;
+			calls[n].inproc = (xdrproc_t)xdr_nfs_read_file;
+			calls[n].in = (char *) &req[n];
+			calls[n].outproc = (xdrproc_t)xdr_nfs_read_file;
+			calls[n].out = (char *) &reply[n];
+
+			sent += req[n].count;
+		}
+
+		if (0 > nfs_call_many(nas, calls, n)) {
+			return datalen ? datalen : -EIO;
+		}
+
+		/* replies may come in any order, but only a gapless prefix counts */
+		for (i = 0; i < n; i++) {
+			if (RPC_SUCCESS != calls[i].status) {
+				return datalen ? datalen : -EIO;
+			}
+			datalen += reply[i].datalen;
+			memcpy(&fi->attr, &reply[i].attr, sizeof(fi->attr));
+			if (reply[i].eof || (reply[i].datalen < req[i].count)) {
+				return datalen;
+			}
+		}
+		fi->attr_time = nfs_time_ms();
+	}
+
+	return datalen;
+}
+
+/*
+ * Sends UNSTABLE WRITEs of wsize bytes, up to max_requests at once. The data
+ * becomes durable only after nfs_commit() confirms the write verifier.
+ */
+static int nfs_write_pipelined(struct nas *nas, nfs_file_info_t *fi,
+		__u64 offset, char *buf, size_t size) {
+	struct rpc_call calls[NFS_MAX_REQUESTS];
+	write_req_t req[NFS_MAX_REQUESTS];
+	write_reply_t reply[NFS_MAX_REQUESTS];
+	size_t sent;
+	int i, n;
+
+	sent = 0;
+	while (sent < size) {
+		for (n = 0; (n < NFS_MAX_REQUESTS) && (sent < size); n++) {
+			req[n].count = req[n].datalen = min(size - sent, NFS_WSIZE);
+			req[n].data = buf + sent;
+			req[n].offset = offset + sent;
+			req[n].fh = &fi->fh.name_fh;
+			req[n].stable = UNSTABLE;
+			reply[n].attr = &fi->attr;
+
+			calls[n].procnum = NFSPROC3_WRITE;
+			calls[n].inproc = (xdrproc_t)xdr_nfs_write_file;
+			calls[n].in = (char *) &req[n];
+			calls[n].outproc = (xdrproc_t)xdr_nfs_write_file;
+			calls[n].out = (char *) &reply[n];
+
+			sent += req[n].count;
+		}
+
+		if (0 > nfs_call_many(nas, calls, n)) {
+			return -EIO;
+		}
+
+		for (i = 0; i < n; i++) {
+			if ((RPC_SUCCESS != calls[i].status)
+					|| (reply[i].count != req[i].count)) {
+				return -EIO;
+			}
+			if (FILE_SYNC == reply[i].comitted) {
+				continue;
+			}
+			if (!fi->wb_unstable) {
+				fi->wb_unstable = 1;
+				fi->wb_verf = reply[i].cookie_vrf;
+			} else if (fi->wb_verf != reply[i].cookie_vrf) {
+				/* server has restarted and may have lost earlier writes */
+				return -EIO;
+			}
+		}
+		fi->attr_time = nfs_time_ms();
+	}
+
+	return 0;
+}
+
+static int nfs_commit(struct nas *nas, nfs_file_info_t *fi) {
+	commit_req_t req;
+	commit_reply_t reply;
+
+	if (!fi->wb_unstable) {
+		return 0;
+	}
+	fi->wb_unstable = 0;
+
+	/* one COMMIT covers all unstable writes to the file */
+	req.fh = &fi->fh.name_fh;
+	req.offset = 0;
+	req.count = 0;
+	reply.attr = &fi->attr;
+
+	if (0 > nfs_call_proc_nfs(nas, NFSPROC3_COMMIT,
+			(char *) &req, (char *) &reply)) {
+		return -EIO;
+	}
+	if (reply.cookie_vrf != fi->wb_verf) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int nfs_flush(struct nas *nas, nfs_file_info_t *fi) {
+	int rc;
+
+	if (0 == fi->wb_len) {
+		return 0;
+	}
+
+	rc = nfs_write_pipelined(nas, fi, fi->wb_offset, fi->wb_buf, fi->wb_len);
+	fi->wb_len = 0;
+	if ((0 > rc) && (0 == fi->wb_error)) {
+		fi->wb_error = rc;
+	}
+
+	return rc;
+}
+
 /*
  * file_operation
  */
@@ -76,105 +270,141 @@ static struct idesc *nfsfs_open(struct node *node, struct file_desc *desc, int f
 
 	fi->mode = flags;
 	fi->offset = desc->cursor;
+	fi->ra_next = desc->cursor;
+
+	/* fh and attributes got less than attr_timeout ago are trusted */
+	if (!nfs_attr_is_fresh(fi) && (0 != nfs_lookup(nas))) {
+		return err_ptr(ENOENT);
+	}
 
-	if(0 == nfs_lookup(nas)) {
+	if (0 == fi->wb_len) {
 		nas->fi->ni.size = fi->attr.size;
-		return &desc->idesc;
 	}
-	return err_ptr(ENOENT);
+	return &desc->idesc;
 }
 
 static int nfsfs_close(struct file_desc *desc) {
 	nfs_file_info_t *fi;
 	struct nas *nas;
+	int rc;
 
 	nas = desc->node->nas;
 	fi = (nfs_file_info_t *)nas->fi->privdata;
 	fi->offset = desc->cursor = 0;
 
-	return 0;
+	nfs_flush(nas, fi);
+	rc = nfs_commit(nas, fi);
+	if (0 != fi->wb_error) {
+		rc = fi->wb_error;
+		fi->wb_error = 0;
+	}
+
+	nfs_file_free_buffers(fi);
+
+	return rc;
 }
 
 static size_t nfsfs_read(struct file_desc *desc, void *buf, size_t size) {
-	size_t size_to_read;
 	nfs_file_info_t *fi;
-	read_req_t req;
-	read_reply_t reply;
-	size_t datalen;
 	struct nas *nas;
+	__u64 offset;
+	size_t datalen, len, window;
+	int res;
 
 	nas = desc->node->nas;
 	fi = (nfs_file_info_t *) nas->fi->privdata;
+	offset = desc->cursor;
 	datalen = 0;
-	fi->offset = desc->cursor;
-
-	while(1) {
-		size_to_read = min(size, DIRCOUNT);
 
-		/* set read structure */
-		req.count = size_to_read;
-		req.offset = fi->offset;
-		req.fh = &fi->fh.name_fh;
-		reply.datalen = 0;
-		reply.data = (char *) buf + datalen;
-
-		/* send read command */
-		if (0 > nfs_call_proc_nfs(nas, NFSPROC3_READ,
-				(char *) &req, (char *) &reply)) {
-			return 0;
-		}
+	/* the server has to see our own writes first */
+	if (0 > nfs_flush(nas, fi)) {
+		return 0;
+	}
 
-		if (reply.datalen == 0) {
-			break;
+	while (size > 0) {
+		if ((offset >= fi->ra_offset)
+				&& (offset < fi->ra_offset + fi->ra_len)) {
+			len = min(size, fi->ra_offset + fi->ra_len - offset);
+			memcpy((char *) buf + datalen,
+					fi->ra_buf + (offset - fi->ra_offset), len);
+		} else if ((size >= NFS_RA_SIZE) || ((NULL == fi->ra_buf)
+				&& (NULL == (fi->ra_buf = sysmalloc(NFS_RA_SIZE))))) {
+			/* large requests are read straight into the caller's buffer */
+			res = nfs_read_pipelined(nas, fi, offset,
+					(char *) buf + datalen, size);
+			if (0 >= res) {
+				break;
+			}
+			len = res;
+			if (len < size) {
+				offset += len;
+				datalen += len;
+				break;
+			}
+		} else {
+			/* sequential readers get a whole window ahead, others only
+			 * what they have asked for */
+			window = (offset == fi->ra_next) ? NFS_RA_SIZE : size;
+			fi->ra_len = 0;
+			res = nfs_read_pipelined(nas, fi, offset, fi->ra_buf, window);
+			if (0 >= res) {
+				break;
+			}
+			fi->ra_offset = offset;
+			fi->ra_len = res;
+			continue;
 		}
 
-		size -= reply.datalen;
-		fi->offset += reply.datalen;
-		datalen += reply.datalen;
-
-		if (reply.eof || (0 >= size )) {
-			break;
-		}
+		size -= len;
+		offset += len;
+		datalen += len;
 	}
-	desc->cursor = fi->offset;
+
+	fi->ra_next = offset;
+	fi->offset = desc->cursor = offset;
 	return datalen;
 }
 
 static size_t nfsfs_write(struct file_desc *desc, void *buf, size_t size) {
-
-	size_t size_to_write;
 	nfs_file_info_t *fi;
-	write_req_t req;
-	write_reply_t reply;
 	struct nas *nas;
+	__u64 offset;
 
-	size_to_write = size;
 	nas = desc->node->nas;
 	fi = (nfs_file_info_t *) nas->fi->privdata;
-	fi->offset = desc->cursor;
+	offset = desc->cursor;
 
-	/* set read structure */
-	req.count = req.datalen = size_to_write;
-	req.data = (char *) buf;
-	req.offset = fi->offset;
-	req.fh = &fi->fh.name_fh;
-	req.stable = FILE_SYNC;
+	/* the read-ahead window may hold overwritten data */
+	fi->ra_len = 0;
 
-	reply.attr = &fi->attr;
+	/* only contiguous writes are gathered */
+	if ((0 != fi->wb_len) && ((offset != fi->wb_offset + fi->wb_len)
+			|| (fi->wb_len + size > NFS_WB_SIZE))) {
+		if (0 > nfs_flush(nas, fi)) {
+			return 0;
+		}
+	}
 
-	/* send read command */
-	if (0 > nfs_call_proc_nfs(nas, NFSPROC3_WRITE,
-			(char *) &req, (char *) &reply)) {
+	if ((size < NFS_WB_SIZE) && ((NULL != fi->wb_buf)
+			|| (NULL != (fi->wb_buf = sysmalloc(NFS_WB_SIZE))))) {
+		if (0 == fi->wb_len) {
+			fi->wb_offset = offset;
+		}
+		memcpy(fi->wb_buf + fi->wb_len, buf, size);
+		fi->wb_len += size;
+		if ((NFS_WB_SIZE == fi->wb_len) && (0 > nfs_flush(nas, fi))) {
+			return 0;
+		}
+	} else if (0 > nfs_write_pipelined(nas, fi, offset, buf, size)) {
 		return 0;
 	}
 
-	fi->offset += reply.count;
-	desc->cursor = fi->offset;
+	fi->offset = desc->cursor = offset + size;
 	if (nas->fi->ni.size < desc->cursor) {
 		nas->fi->ni.size = desc->cursor;
 	}
 
-	return reply.count;
+	return size;
 }
 
 
@@ -254,8 +484,12 @@ static int nfsfs_format(void *path) {
 
 static int nfsfs_truncate (struct node *node, off_t length) {
 	struct nas *nas = node->nas;
+	nfs_file_info_t *fi = nas->fi->privdata;
 
 	nas->fi->ni.size = length;
+	if (NULL != fi) {
+		fi->ra_len = 0;
+	}
 
 	return 0;
 }
@@ -311,6 +545,21 @@ static int nfs_prepare(struct nfs_fs_info *fsi, char *dev) {
 	return 0;
 }
 
+static struct client *nfs_clnt_create(struct nfs_fs_info *fsi) {
+	struct sockaddr_in raddr;
+	int sock;
+
+	sock = RPC_ANYSOCK;
+	memset(&raddr, 0, sizeof(raddr));
+	raddr.sin_family = AF_INET;
+	inet_aton(fsi->srv_name, &raddr.sin_addr);
+	raddr.sin_port = 0;
+
+	/* a whole READ reply or WRITE call of rsize/wsize fits in the buffers */
+	return clnttcp_create(&raddr, NFS_PROGNUM, NFS_VER, &sock,
+			NFS_WSIZE + NFS_RPC_HDR_SZ, NFS_RSIZE + NFS_RPC_HDR_SZ);
+}
+
 static int nfs_client_init(struct nfs_fs_info *fsi) {
 
 	nfs_clnt_destroy(fsi);
@@ -325,7 +574,7 @@ static int nfs_client_init(struct nfs_fs_info *fsi) {
 		return -1;
 	}
 
-	fsi->nfs = clnt_create(fsi->srv_name, NFS_PROGNUM, NFS_VER, "tcp");
+	fsi->nfs = nfs_clnt_create(fsi);
 	if (fsi->nfs == NULL) {
 		clnt_pcreateerror(fsi->srv_name);
 		return -1;
@@ -349,6 +598,7 @@ static void nfs_free_fs(struct nas *nas) {
 	}
 
 	if(NULL != (fi = nas->fi->privdata)) {
+		nfs_file_free_buffers(fi);
 		pool_free(&nfs_file_pool, fi);
 	}
 }
@@ -411,6 +661,7 @@ static int nfs_umount_entry(struct nas *nas) {
 				nfs_umount_entry(child->nas);
 			}
 
+			nfs_file_free_buffers(child->nas->fi->privdata);
 			pool_free(&nfs_file_pool, child->nas->fi->privdata);
 			vfs_del_leaf(child);
 		}
@@ -455,7 +706,7 @@ static node_t *nfs_create_file(struct nas *parent_nas, readdir_desc_t *predesc)
 		if (!fi) {
 			return NULL;
 		}
-
+		memset(fi, 0, sizeof(*fi));
 	}
 
 	/* copy read the description in the created file*/
@@ -472,6 +723,10 @@ static node_t *nfs_create_file(struct nas *parent_nas, readdir_desc_t *predesc)
 		fi->fh.count = fi->fh.maxcount = DIRCOUNT;
 		fi->fh.cookie = 0;
 	}
+	if ((VALUE_FOLLOWS_YES == predesc->vf_attr)
+			&& (VALUE_FOLLOWS_YES == predesc->vf_fh)) {
+		fi->attr_time = nfs_time_ms();
+	}
 
 	if (!node) {
 		mode = fi->attr.mode;
@@ -625,6 +880,7 @@ static int nfsfs_create(struct node *parent_node, struct node *node) {
 	if(NULL == (fi = pool_alloc(&nfs_file_pool))) {
 		return -1;
 	}
+	memset(fi, 0, sizeof(*fi));
 	nas->fi->privdata = (void *) fi;
 
 	return nfs_create_dir_entry(parent_node); // XXX parent_node? or node?
@@ -666,6 +922,7 @@ static int nfsfs_delete(struct node *node) {
 		return -1;
 	}
 
+	nfs_file_free_buffers(fi);
 	pool_free(&nfs_file_pool, fi);
 	vfs_del_leaf(node);
 	return 0;
@@ -762,24 +1019,14 @@ static int nfs_call_proc_nfs(struct nas *nas,
 			return -1;
 		}
 		break;
-	case NFSPROC3_READ:
-		if (clnt_call(fsi->nfs, NFSPROC3_READ,
-			(xdrproc_t)xdr_nfs_read_file, req,
-			(xdrproc_t)xdr_nfs_read_file, reply,
-			timeout) != RPC_SUCCESS) {
-			clnt_perror(fsi->nfs, fsi->srv_name);
-			printf("read file failed. errno=%d\n", errno);
-			return 0;
-		}
-		break;
-	case NFSPROC3_WRITE:
-		if (clnt_call(fsi->nfs, NFSPROC3_WRITE,
-			(xdrproc_t)xdr_nfs_write_file, req,
-			(xdrproc_t)xdr_nfs_write_file, reply,
+	case NFSPROC3_COMMIT:
+		if (clnt_call(fsi->nfs, NFSPROC3_COMMIT,
+			(xdrproc_t)xdr_nfs_commit, req,
+			(xdrproc_t)xdr_nfs_commit, reply,
 			timeout) != RPC_SUCCESS) {
 			clnt_perror(fsi->nfs, fsi->srv_name);
-			printf("write file failed. errno=%d\n", errno);
-			return 0;
+			printf("nfs commit failed. errno=%d\n", errno);
+			return -1;
 		}
 		break;
 	case NFSPROC3_CREATE:
@@ -840,6 +1087,31 @@ static int nfs_call_proc_nfs(struct nas *nas,
 	return 0;
 }
 
+/*
+ * READ and WRITE go only this way. Returns -1 if the calls are not sent,
+ * otherwise callers check the status of each call, some of them may succeed.
+ */
+static int nfs_call_many(struct nas *nas, struct rpc_call *calls, int count) {
+	struct timeval timeout = { 25, 0 };
+	struct nfs_fs_info *fsi;
+	int i;
+
+	fsi = nas->fs->fsi;
+	if(NULL == fsi->nfs){
+		if(0 >  nfs_client_init(fsi)) {
+			for (i = 0; i < count; i++) {
+				calls[i].status = RPC_SYSTEMERROR;
+			}
+			return -1;
+		}
+	}
+
+	if (clnt_call_many(fsi->nfs, calls, count, timeout) != RPC_SUCCESS) {
+		clnt_perror(fsi->nfs, fsi->srv_name);
+	}
+	return 0;
+}
+
 static int nfs_lookup(struct nas *nas) {
 	node_t *dir_node;
 	struct nas *dir_nas;
@@ -860,9 +1132,22 @@ static int nfs_lookup(struct nas *nas) {
 
 	reply.fh = &fi->fh.name_fh;
 
-	/* send read command */
-	return nfs_call_proc_nfs(nas, NFSPROC3_LOOKUP,
-			(char *) &req, (char *) &reply);
+	/* send lookup command */
+	if (0 > nfs_call_proc_nfs(nas, NFSPROC3_LOOKUP,
+			(char *) &req, (char *) &reply)) {
+		return -1;
+	}
+
+	/* the file has changed on the server */
+	if ((fi->attr.size != reply.attr.size)
+			|| (0 != memcmp(&fi->attr.mtime, &reply.attr.mtime,
+					sizeof(fi->attr.mtime)))) {
+		fi->ra_len = 0;
+	}
+	memcpy(&fi->attr, &reply.attr, sizeof(fi->attr));
+	fi->attr_time = nfs_time_ms();
+
+	return 0;
 }
 
 static int nfs_mount(struct nas *nas) {
@@ -93,6 +93,8 @@
 #define NFSPROC3_PATHCONF       20
 #define NFSPROC3_COMMIT         21
 
+#define UNSTABLE       0
+#define DATA_SYNC      1
 #define FILE_SYNC      2
 
 #define UNCHECKED_MODE  0
@@ -302,7 +304,7 @@ typedef struct write_req {
 typedef struct write_reply {
 	__u32 status;
 	__u32 before_vf;
-	file_attribute_rep_t before_attr;
+	file_del_attribute_rep_t before_attr;
 	__u32 vf;
 	file_attribute_rep_t *attr;
 	__u32 count;
@@ -310,6 +312,23 @@ typedef struct write_reply {
 	__u64 cookie_vrf;
 } write_reply_t;
 
+/* COMMIT file request*/
+typedef struct commit_req {
+	rpc_fh_string_t *fh;
+	__u64 offset;
+	__u32 count;
+} commit_req_t;
+
+/* COMMIT file reply*/
+typedef struct commit_reply {
+	__u32 status;
+	__u32 before_vf;
+	file_del_attribute_rep_t before_attr;
+	__u32 vf;
+	file_attribute_rep_t *attr;
+	__u64 cookie_vrf;
+} commit_reply_t;
+
 typedef struct nfs_fs_info {
 	char srv_name[PATH_MAX];
 	char srv_dir[PATH_MAX];
@@ -324,6 +343,21 @@ typedef struct nfs_file_info {
 	nfs_filehandle_t fh;
 	int mode;				/* mode in which this file was opened */
 	__u64 offset;			/* current (BYTE) pointer */
+	__u32 attr_time;		/* when fh and attr were got from server, ms */
+
+	/* read-ahead window */
+	char *ra_buf;
+	__u64 ra_offset;
+	size_t ra_len;
+	__u64 ra_next;			/* where a sequential read would continue */
+
+	/* write-behind buffer */
+	char *wb_buf;
+	__u64 wb_offset;
+	size_t wb_len;
+	int wb_unstable;		/* server holds data not yet committed */
+	__u64 wb_verf;			/* write verifier of the uncommitted data */
+	int wb_error;			/* deferred error to report on close */
 } nfs_file_info_t;
 
 #endif /* NFS_H_ */
@@ -281,7 +281,7 @@ int xdr_nfs_write_file(struct xdr *xs, char *point) {
 				&& xdr_u_int(xs, &reply->before_vf)) {
 
 				if (VALUE_FOLLOWS_YES == reply->before_vf) {
-					if (XDR_SUCCESS != xdr_nfs_get_attr(xs,
+					if (XDR_SUCCESS != xdr_nfs_get_del_attr(xs,
 						(char *) &reply->before_attr)) {
 							break;
 						}
@@ -314,6 +314,55 @@ int xdr_nfs_write_file(struct xdr *xs, char *point) {
 		return XDR_FAILURE;
 }
 
+int xdr_nfs_commit(struct xdr *xs, char *point) {
+
+	commit_req_t *req;
+	commit_reply_t *reply;
+
+	assert(point != NULL);
+
+	switch (xs->oper) {
+		case XDR_DECODE:
+			reply = (commit_reply_t *)point;
+			if (xdr_u_int(xs, &reply->status) && (STATUS_OK == reply->status)
+				&& xdr_u_int(xs, &reply->before_vf)) {
+
+				if (VALUE_FOLLOWS_YES == reply->before_vf) {
+					if (XDR_SUCCESS != xdr_nfs_get_del_attr(xs,
+						(char *) &reply->before_attr)) {
+							break;
+						}
+					}
+
+				if (xdr_u_int(xs, &reply->vf)) {
+					if (VALUE_FOLLOWS_YES == reply->vf) {
+						if (XDR_SUCCESS != xdr_nfs_get_attr(xs,
+							(char *) reply->attr)) {
+							break;
+						}
+					}
+					if (unaligned_xdr_u_hyper(xs, &reply->cookie_vrf)) {
+						return XDR_SUCCESS;
+					}
+				}
+			}
+			break;
+		case XDR_ENCODE:
+			req = (commit_req_t *)point;
+
+			if (xdr_nfs_name_fh(xs, req->fh)
+				&& unaligned_xdr_u_hyper(xs, &req->offset)
+				&& xdr_u_int(xs, &req->count)) {
+				return XDR_SUCCESS;
+			}
+			break;
+		case XDR_FREE:
+			return XDR_SUCCESS;
+		}
+
+		return XDR_FAILURE;
+}
+
 int xdr_nfs_readdirplus(struct xdr *xs, nfs_filehandle_t *fh) {
 	char *point;
 	size_t size;
@@ -36,6 +36,8 @@ extern int xdr_nfs_lookup(struct xdr *xs, char *point);
 
 extern int xdr_nfs_write_file(struct xdr *xs, char *point);
 
+extern int xdr_nfs_commit(struct xdr *xs, char *point);
+
 extern int xdr_nfs_create(struct xdr *xs, char *point);
 
 extern int xdr_nfs_delete(struct xdr *xs, char *point);
@@ -54,9 +54,102 @@ enum {
 	FLOCK_RANGE_NOT_INTERSECT
 };
 
+/*
+ * Locks are kept in an interval tree: ordered by l_start and augmented with
+ * the maximum end of locks in each subtree. Lock ranges are closed here,
+ * locks which only touch each other are still found.
+ */
+#define kflock_lock_of(node) rb_entry(node, kflock_lock_t, kflock_node)
+
+static inline off_t kflock_lock_end(kflock_lock_t *lock) {
+	return lock->flock.l_start + lock->flock.l_len;
+}
+
+static void kflock_augment(struct rb_node *node) {
+	kflock_lock_t *lock = kflock_lock_of(node);
+	kflock_lock_t *child;
+
+	lock->max_end = kflock_lock_end(lock);
+	if ((child = kflock_lock_of(node->left)) && child->max_end > lock->max_end) {
+		lock->max_end = child->max_end;
+	}
+	if ((child = kflock_lock_of(node->right)) && child->max_end > lock->max_end) {
+		lock->max_end = child->max_end;
+	}
+}
+
+static int kflock_cmp(struct rb_node *node1, struct rb_node *node2) {
+	off_t start1 = kflock_lock_of(node1)->flock.l_start;
+	off_t start2 = kflock_lock_of(node2)->flock.l_start;
+
+	return start1 < start2 ? -1 : start1 > start2;
+}
+
+/* Leftmost lock of the subtree intersecting [start, end] */
+static kflock_lock_t *kflock_subtree_search(struct rb_node *node,
+		off_t start, off_t end) {
+	kflock_lock_t *lock;
+
+	while (node) {
+		if (node->left && kflock_lock_of(node->left)->max_end >= start) {
+			node = node->left;
+			continue;
+		}
+		lock = kflock_lock_of(node);
+		if (lock->flock.l_start > end) {
+			break;
+		}
+		if (kflock_lock_end(lock) >= start) {
+			return lock;
+		}
+		node = node->right;
+		if (!node || kflock_lock_of(node)->max_end < start) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static kflock_lock_t *kflock_first_intersect(kflock_t *kflock,
+		off_t start, off_t end) {
+	return kflock_subtree_search(kflock->locks.root, start, end);
+}
+
+/* Next lock in l_start order after @a lock intersecting [start, end] */
+static kflock_lock_t *kflock_next_intersect(kflock_lock_t *lock,
+		off_t start, off_t end) {
+	struct rb_node *node = &lock->kflock_node;
+	struct rb_node *right = node->right, *prev;
+
+	while (1) {
+		if (right && kflock_lock_of(right)->max_end >= start) {
+			return kflock_subtree_search(right, start, end);
+		}
+
+		/* Go up until we come from the left */
+		do {
+			prev = node;
+			node = node->parent;
+			if (!node) {
+				return NULL;
+			}
+			right = node->right;
+		} while (prev == right);
+
+		lock = kflock_lock_of(node);
+		if (lock->flock.l_start > end) {
+			return NULL;
+		}
+		if (kflock_lock_end(lock) >= start) {
+			return lock;
+		}
+	}
+}
+
 static inline int kflock_init(node_t *node) {
 	/* kflock initialization */
-	dlist_init(&node->kflock.locks);
+	rb_tree_init(&node->kflock.locks, kflock_augment);
 	node->kflock.kflock_guard = SPIN_UNLOCKED;
 
 	return ENOERR;
@@ -70,13 +163,13 @@ static int kflock_lock_get(kflock_t *kflock, struct flock *flock) {
 	if (NULL == lock) {
 		return -ENOMEM;
 	}
-	dlist_add_next(dlist_head_init(&lock->kflock_link), &kflock->locks);
 	lock->flock.l_len = flock->l_len;
 	lock->flock.l_pid = (pid_t) current->task->tid;
 	lock->flock.l_start = flock->l_start;
 	lock->flock.l_type = flock->l_type;
 	lock->flock.l_whence = flock->l_whence;
 	wait_queue_init(&lock->wq);
+	rb_insert(&kflock->locks, &lock->kflock_node, kflock_cmp);
 
 	return -ENOERR;
 }
@@ -85,13 +178,16 @@ static int kflock_lock_get(kflock_t *kflock, struct flock *flock) {
  * all shared locks of current thread if NULL */
 static int kflock_lock_put(kflock_t *kflock, struct flock *flock) {
 	kflock_lock_t *lock;
+	struct rb_node *node, *next;
 	struct thread *current = thread_self();
 
-	dlist_foreach_entry(lock, &kflock->locks, kflock_link) {
+	for (node = rb_first(&kflock->locks); node != NULL; node = next) {
+		next = rb_next(node);
+		lock = kflock_lock_of(node);
 		if (current->task->tid == lock->flock.l_pid) {
 			if (NULL == flock || (lock->flock.l_start == flock->l_start &&
 					lock->flock.l_len == flock->l_len)) {
-				dlist_del(&lock->kflock_link);
+				rb_erase(&kflock->locks, node);
 				wait_queue_notify_all(&lock->wq);
 				pool_free(&kflock_lock_pool, lock);
 				/* Returning success if we are searching for one lock
@@ -120,7 +216,10 @@ static int kflock_get_disposition(int *intersection, kflock_t *kflock,
 
 	*intersection = -1;
 
-	dlist_foreach_entry(lock, &kflock->locks, kflock_link) {
+	/* Only locks intersecting the flock or touching it are visited */
+	for (lock = kflock_first_intersect(kflock, flock->l_start, flock_end);
+			lock != NULL;
+			lock = kflock_next_intersect(lock, flock->l_start, flock_end)) {
 		lock_end = lock->flock.l_start + lock->flock.l_len;
 		delta_start = lock->flock.l_start - flock->l_start;
 		delta_end = lock_end - flock_end;
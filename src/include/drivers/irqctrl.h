@@ -9,6 +9,8 @@
 #ifndef DRIVER_IRQCTRL_H_
 #define DRIVER_IRQCTRL_H_
 
+#include <stdint.h>
+
 #include <module/embox/driver/interrupt/irqctrl_api.h>
 
 /**
@@ -60,4 +62,54 @@ extern int irqctrl_pending(unsigned int irq);
  */
 extern void irqctrl_eoi(unsigned int irq);
 
+/**
+ * Routes the IRQ to the specified CPU.
+ *
+ * @note Implementation defines @c __IRQCTRL_AFFINITY if it provides this.
+ *
+ * @return 0 on success or negative error code
+ */
+extern int irqctrl_set_affinity(unsigned int irq, unsigned int cpu);
+
+/**
+ * Message signalled interrupt: a device raises the IRQ by writing @a data
+ * to @a address_hi:address_lo.
+ */
+struct irqctrl_msi_msg {
+	uint32_t address_lo;
+	uint32_t address_hi;
+	uint32_t data;
+};
+
+/**
+ * Writes the message of the IRQ to the device. It is called each time the
+ * message changes after allocation (e.g. on affinity change).
+ */
+typedef void (*irqctrl_msi_write_t)(unsigned int irq,
+		const struct irqctrl_msi_msg *msg, void *dev);
+
+/**
+ * Masks or unmasks the IRQ at the device, it backs irqctrl_disable() and
+ * irqctrl_enable() of the IRQ.
+ */
+typedef void (*irqctrl_msi_mask_t)(unsigned int irq, int mask, void *dev);
+
+/**
+ * Allocates @a nvec consecutive IRQs for message signalled interrupts.
+ * The first one is aligned to @a nvec, as multiple message MSI requires.
+ * @a mask may be NULL if the device can't mask the vectors, such IRQs are
+ * never disabled.
+ *
+ * @note Implementation defines @c __IRQCTRL_MSI if it provides this.
+ *
+ * @return the first IRQ number or negative error code
+ */
+extern int irqctrl_msi_alloc(unsigned int nvec, irqctrl_msi_write_t write,
+		irqctrl_msi_mask_t mask, void *dev);
+
+extern void irqctrl_msi_free(unsigned int irq, unsigned int nvec);
+
+/** Gets the message the device has to write to raise the allocated IRQ */
+extern void irqctrl_msi_compose(unsigned int irq, struct irqctrl_msi_msg *msg);
+
 #endif /* DRIVER_IRQCTRL_H_ */
@@ -78,4 +78,11 @@ static inline int tty_rx_putc(struct tty *t, char ch, unsigned char flag) {
 extern int tty_out_getc(struct tty *t);
 extern int tty_out_buf(struct tty *t, void *buf, size_t len);
 
+/* Zero-copy output for drivers which may take less than is queued */
+
+/** @return Length of contiguous queued output at @a buf, it stays queued */
+extern size_t tty_out_peek(struct tty *t, const char **buf);
+/** Removes @a len chars returned by tty_out_peek() from the output queue */
+extern void tty_out_done(struct tty *t, size_t len);
+
 #endif /* DRIVERS_TTY_H_ */
@@ -0,0 +1,20 @@
+/**
+ * @file
+ * @brief Main Embox include file for benchmarks.
+ * @details
+ *   A benchmark is a function measured many times in a row with a cycle
+ * counting clock source. The framework collects every sample and reports
+ * minimum, maximum, mean, median, 99th percentile and standard deviation.
+ *
+ * @see EMBOX_BENCH()
+ * @see EMBOX_BENCH_FIXTURE()
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef EMBOX_BENCH_H_
+#define EMBOX_BENCH_H_
+
+#include <framework/bench/self.h>
+
+#endif /* EMBOX_BENCH_H_ */
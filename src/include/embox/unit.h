@@ -13,6 +13,7 @@
 #define EMBOX_UNIT_H_
 
 #include <stddef.h>
+#include <stdint.h>
 #include <framework/mod/self.h>
 
 /**
@@ -24,34 +25,86 @@
  */
 typedef int (*unit_op_t)(void);
 
+/** Init may run in a boot worker thread concurrently with other units. */
+#define UNIT_FLAG_ASYNC  (0x1 << 0)
+/** Init is deferred until the first unit_ensure() call. */
+#define UNIT_FLAG_LAZY   (0x1 << 1)
+
+struct __unit_private {
+	volatile int state; /**< 0 until init is run or after the unit is disabled. */
+	int result;
+	const struct unit *next; /**< Link in the queue of async units. */
+};
+
 struct unit {
 	struct mod mod;
 	unit_op_t init;
 	unit_op_t fini;
+	unsigned int flags;
+	struct __unit_private *priv;
 };
 
 extern const struct mod_ops __unit_mod_ops;
 
-#define __EMBOX_UNIT(_init, _fini) \
+/**
+ * Makes sure init of the unit has been run, running it in the caller context
+ * if needed. It is required for lazy units before the first use of the
+ * module and harmless for other ones. Must not be called from the init of
+ * the same unit.
+ *
+ * @return result of the unit init
+ */
+extern int unit_ensure(const struct unit *unit);
+
+/** unit_ensure() for the unit of the current module */
+#define EMBOX_UNIT_ENSURE() \
+	unit_ensure(&mod_self)
+
+/* Implemented by embox.framework.unit_init */
+extern int __unit_init(const struct unit *unit);
+extern int __unit_init_wait_all(void);
+
+/* Boot time in microseconds for init timing, 0 if there is no clock yet */
+extern uint64_t __unit_init_time_us(void);
+
+#define __EMBOX_UNIT(_init, _fini, _flags) \
 	MOD_SELF_INIT_DECLS(__EMBUILD_MOD__); \
+	static struct __unit_private __unit_priv; \
 	const struct unit mod_self = { \
 		.mod = MOD_SELF_INIT(__EMBUILD_MOD__, &__unit_mod_ops), \
 		.init = _init,   \
 		.fini = _fini,   \
+		.flags = _flags, \
+		.priv = &__unit_priv, \
 	}
 
 #define EMBOX_UNIT(_init, _fini) \
 	static int _init(void); \
 	static int _fini(void); \
-	__EMBOX_UNIT(_init, _fini)
+	__EMBOX_UNIT(_init, _fini, 0)
 
 #define EMBOX_UNIT_INIT(_init) \
 	static int _init(void); \
-	__EMBOX_UNIT(_init, NULL)
+	__EMBOX_UNIT(_init, NULL, 0)
+
+/**
+ * Init is run after all dependencies have been initialized, possibly in
+ * parallel with unrelated units. Units depending on this one still see
+ * it initialized. Modules that are not units (PCI drivers, ...) are enabled
+ * without waiting, so units they depend on must not be async.
+ */
+#define EMBOX_UNIT_INIT_ASYNC(_init) \
+	static int _init(void); \
+	__EMBOX_UNIT(_init, NULL, UNIT_FLAG_ASYNC)
+
+/** Init is run on the first EMBOX_UNIT_ENSURE() or unit_ensure() call. */
+#define EMBOX_UNIT_INIT_LAZY(_init) \
+	static int _init(void); \
+	__EMBOX_UNIT(_init, NULL, UNIT_FLAG_LAZY)
 
 #define EMBOX_UNIT_FINI(_fini) \
 	static int _fini(void); \
-	__EMBOX_UNIT(NULL, _fini)
+	__EMBOX_UNIT(NULL, _fini, 0)
 
 #ifdef __CDT_PARSER__
 
@@ -65,6 +118,14 @@ extern const struct mod_ops __unit_mod_ops;
 	typedef typeof(init) __unit_placeholder; \
 	static int init(void)
 
+# undef  EMBOX_UNIT_INIT_ASYNC
+# define EMBOX_UNIT_INIT_ASYNC(init) \
+	EMBOX_UNIT_INIT(init)
+
+# undef  EMBOX_UNIT_INIT_LAZY
+# define EMBOX_UNIT_INIT_LAZY(init) \
+	EMBOX_UNIT_INIT(init)
+
 # undef  EMBOX_UNIT_FINI
 # define EMBOX_UNIT_FINI(exit) \
 	static int exit(void); \
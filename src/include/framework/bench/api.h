@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Embox benchmark framework.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef FRAMEWORK_BENCH_API_H_
+#define FRAMEWORK_BENCH_API_H_
+
+#include <util/array.h>
+
+#include <framework/bench/types.h>
+
+#define bench_foreach(bench_ptr) \
+	array_spread_foreach(bench_ptr, __bench_registry)
+
+ARRAY_SPREAD_DECLARE(const struct bench * const, __bench_registry);
+
+#define BENCH_ADD(_bench_ptr) \
+	ARRAY_SPREAD_DECLARE(const struct bench * const, __bench_registry); \
+	ARRAY_SPREAD_ADD(__bench_registry, _bench_ptr)
+
+/**
+ * Runs setup, warmup and measured iterations of @a bench.
+ *
+ * @param opts may be @c NULL for default iteration counts
+ *
+ * @return 0 on success, setup result if it failed, -ENOTSUP if there is
+ *   no cycle counting clock source, -EINVAL if number of iterations is 0
+ *   or exceeds max_samples option, -ENOMEM if samples can't be allocated
+ */
+extern int bench_run(const struct bench *bench, const struct bench_opts *opts,
+		struct bench_result *result);
+
+/**
+ * Prints a result as a single line of space separated @c key=value pairs,
+ * so outputs of different builds can be compared by scripts.
+ */
+extern void bench_report(const struct bench *bench,
+		const struct bench_result *result);
+
+extern const struct bench *bench_lookup(const char *name);
+
+#endif /* FRAMEWORK_BENCH_API_H_ */
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief API for registering benchmarks in Embox benchmark framework.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef FRAMEWORK_BENCH_SELF_H_
+#define FRAMEWORK_BENCH_SELF_H_
+
+#include <stddef.h>
+
+#include <util/macro.h>
+#include <util/location.h>
+
+#include <framework/bench/api.h>
+#include <framework/bench/types.h>
+
+/**
+ * Defines a benchmark, the following block is one measured iteration.
+ *
+ * @param name identifier of the benchmark
+ * @param description one-line human readable description
+ */
+#define EMBOX_BENCH(name, description) \
+	EMBOX_BENCH_FIXTURE(name, description, NULL, NULL)
+
+/**
+ * Same as EMBOX_BENCH() with functions run once before warmup and once
+ * after the last iteration.
+ */
+#define EMBOX_BENCH_FIXTURE(name, description, setup, teardown) \
+	__EMBOX_BENCH_NM(name, "" description, setup, teardown,  \
+			MACRO_CONCAT(__bench_, name), MACRO_CONCAT(__bench_run_, name))
+
+#define __EMBOX_BENCH_NM(_name, _description, _setup, _teardown, \
+		bench_nm, run_nm)                                        \
+	static void run_nm(void);                                    \
+	static const struct bench bench_nm = {                       \
+		/* .name        = */ MACRO_STRING(_name),                 \
+		/* .description = */ _description,                       \
+		/* .run         = */ run_nm,                             \
+		/* .setup       = */ _setup,                             \
+		/* .teardown    = */ _teardown,                          \
+		/* .location    = */ LOCATION_INIT,                      \
+	};                                                           \
+	BENCH_ADD(&bench_nm);                                        \
+	static void run_nm(void)
+
+#endif /* FRAMEWORK_BENCH_SELF_H_ */
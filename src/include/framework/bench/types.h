@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief Type declarations shared between benchmark framework and benchmarks.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef FRAMEWORK_BENCH_TYPES_H_
+#define FRAMEWORK_BENCH_TYPES_H_
+
+#include <stdint.h>
+
+#include <util/location.h>
+
+/** One iteration of a benchmark, the framework measures each call. */
+typedef void (*bench_run_t)(void);
+
+typedef int (*bench_setup_t)(void);
+typedef void (*bench_teardown_t)(void);
+
+struct bench {
+	/** Short identifier, used in reports and to select a benchmark. */
+	const char *name;
+	/** One-line human readable description. */
+	const char *description;
+	bench_run_t run;
+	/** Called once before warmup, may be @c NULL. */
+	bench_setup_t setup;
+	/** Called once after the last iteration, may be @c NULL. */
+	bench_teardown_t teardown;
+	struct location location;
+};
+
+struct bench_opts {
+	unsigned int warmup;     /**< Iterations run before measuring. */
+	unsigned int iterations; /**< Measured iterations. */
+};
+
+/** Summary of a run, all values are in clock source cycles. */
+struct bench_result {
+	unsigned int iterations;
+	uint64_t min;
+	uint64_t max;
+	uint64_t mean;
+	uint64_t median;
+	uint64_t p99;
+	uint64_t stddev;
+	/** Frequency of cycles, 0 if unknown. */
+	uint32_t cycle_hz;
+};
+
+#endif /* FRAMEWORK_BENCH_TYPES_H_ */
@@ -44,7 +44,8 @@ struct buffer_head {
 	journal_block_t *journal_block; /* pointer to corresponding up-to-date block from journal (if any) */
 };
 
-extern void buffer_encrypt(struct buffer_head *bh);
+/* Encrypt or decrypt the whole block in place, return 0 or -errno */
+extern int buffer_encrypt(struct buffer_head *bh);
 extern int buffer_decrypt(struct buffer_head *bh);
 
 #endif /* FS_BUFFER_HEAD_H_ */
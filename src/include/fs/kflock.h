@@ -13,6 +13,7 @@
 #include <fcntl.h>
 
 #include <util/dlist.h>
+#include <util/rbtree.h>
 #include <kernel/thread/sync/mutex.h>
 #include <sched.h>
 /*
@@ -54,12 +55,13 @@ typedef struct kflock_lock {
 	off_t             len;
 	pid_t             pid;*/
 	struct flock      flock;
-	struct dlist_head kflock_link;
+	struct rb_node    kflock_node;
+	off_t             max_end; /* of locks in the subtree */
 	//struct wait_queue wq;
 } kflock_lock_t;
 
 typedef struct kflock {
-	struct dlist_head locks;
+	struct rb_tree    locks; /* ordered by l_start */
 	spinlock_t        kflock_guard;
 } kflock_t;
 
@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @brief Hardware performance monitoring unit interface.
+ *
+ * Counters are numbered from 0 to pmu_counters_total() - 1 and belong to
+ * the CPU the caller is running on.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef HAL_PMU_H_
+#define HAL_PMU_H_
+
+#include <stdint.h>
+
+#include <module/embox/arch/pmu.h>
+
+enum pmu_event {
+	PMU_EV_CYCLES = 0,
+	PMU_EV_INSTRUCTIONS,
+	PMU_EV_CACHE_MISSES,
+	PMU_EV_BRANCH_MISSES,
+	PMU_EV_TOTAL
+};
+
+/** Number of general purpose counters available on this CPU. */
+extern int pmu_counters_total(void);
+
+/**
+ * Binds @a cnt to @a ev. Counter is left disabled.
+ *
+ * @param irq_on_overflow If non-zero, overflow of the counter raises
+ *   interrupt #pmu_irq_nr()
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if @a cnt is out of range
+ * @retval -ENOTSUP if the event can't be counted on this CPU
+ */
+extern int pmu_counter_setup(int cnt, enum pmu_event ev, int irq_on_overflow);
+
+extern void pmu_counter_enable(int cnt);
+extern void pmu_counter_disable(int cnt);
+
+extern uint64_t pmu_counter_read(int cnt);
+extern void pmu_counter_write(int cnt, uint64_t val);
+
+/** @return Bit mask of counters which have overflowed. */
+extern unsigned int pmu_overflow_status(void);
+
+/** Clears overflow flags and rearms overflow interrupt. */
+extern void pmu_overflow_clear(unsigned int mask);
+
+/** @return IRQ number of overflow interrupt, or negative if unavailable. */
+extern int pmu_irq_nr(void);
+
+#endif /* HAL_PMU_H_ */
@@ -14,6 +14,8 @@
 #ifndef KERNEL_IRQ_H_
 #define KERNEL_IRQ_H_
 
+#include <stdint.h>
+
 #include <kernel/irq_lock.h>
 #include <drivers/irqctrl.h>
 #include <module/embox/kernel/irq_api.h>
@@ -33,6 +35,8 @@
  */
 /* Sharing supported flag */
 #define IF_SHARESUP	(0x1 << 0)
+/* Handler runs in the IRQ thread, the IRQ is masked meanwhile */
+#define IF_THREADED	(0x1 << 1)
 
 /**
  * IRQ handler return type.
@@ -40,8 +44,19 @@
 typedef enum {
 	IRQ_NONE    = 0, /**< Interrupt has not been handled. */
 	IRQ_HANDLED = 1, /**< Interrupt has been processed by the handler*/
+	IRQ_WAKE_THREAD = 2, /**< Rest of processing is for the IRQ thread */
 } irq_return_t;
 
+/**
+ * Per IRQ statistics, time is in nanoseconds.
+ */
+struct irq_stat {
+	unsigned long count;        /**< Interrupts dispatched */
+	unsigned long thread_count; /**< IRQ thread runs */
+	uint64_t max_time;          /**< Longest run of hard handlers */
+	uint64_t max_thread_time;   /**< Longest run of the IRQ thread */
+};
+
 /**
  * Interrupt Service Routine type.
  *
@@ -90,6 +105,23 @@ typedef irq_return_t (*irq_handler_t)(unsigned int irq_nr, void *data);
 extern int irq_attach(unsigned int irq_nr, irq_handler_t handler,
 		unsigned int flags, void *data, const char *dev_name);
 
+/**
+ * Attaches an ISR split into two parts. The @a handler runs in the interrupt
+ * context, it should only acknowledge the device and return
+ * #IRQ_WAKE_THREAD. Then @a thread_fn runs in the IRQ thread, which is a
+ * light thread scheduled with the priority set by the module option, so
+ * interrupts are enabled meanwhile. @a thread_fn must not block.
+ *
+ * If @a handler is @c NULL, the IRQ is masked until @a thread_fn is done.
+ * irq_attach() with #IF_THREADED is the same as this with @c NULL @a handler.
+ *
+ * @return
+ *   The same as irq_attach().
+ */
+extern int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, void *data,
+		const char *dev_name);
+
 /**
  * Detaches ISR from the specified IRQ.
  *
@@ -111,6 +143,44 @@ extern int irq_attach(unsigned int irq_nr, irq_handler_t handler,
  */
 extern int irq_detach(unsigned int irq_nr, void *data);
 
+/**
+ * Routes the specified IRQ to the CPU, so that its ISR runs there.
+ *
+ * @param irq_nr
+ *   The IRQ number to route.
+ * @param cpu
+ *   The CPU number.
+ *
+ * @return
+ *   Result of routing.
+ * @retval 0
+ *   If all is OK.
+ * @retval -EINVAL
+ *   If @a irq_nr is not @link #irq_nr_valid() valid @endlink, or if there
+ *   is no such CPU.
+ * @retval -ENOSYS
+ *   If the interrupt controller can't route IRQs.
+ */
+extern int irq_set_affinity(unsigned int irq_nr, unsigned int cpu);
+
+/**
+ * Gets statistics of the specified IRQ, it is kept since the boot.
+ *
+ * @retval 0
+ *   If all is OK.
+ * @retval -EINVAL
+ *   If @a irq_nr is not @link #irq_nr_valid() valid @endlink.
+ * @retval -ENOSYS
+ *   If kernel is compiled without IRQ statistics.
+ */
+extern int irq_get_stat(unsigned int irq_nr, struct irq_stat *stat);
+
+/**
+ * Gets name of the device given to irq_attach(), or NULL if the IRQ has no
+ * handlers.
+ */
+extern const char *irq_get_dev_name(unsigned int irq_nr);
+
 /**
  * Called by interrupt handler code.
  * @param interrupt_nr the number of interrupt to dispatch
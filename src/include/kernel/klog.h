@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @brief Asynchronous kernel log
+ *
+ * Producers only pack the format pointer and raw arguments into a per-CPU
+ * record. Formatting and output to sinks (diag console, file, ...) are done
+ * later by the klog thread, so logging never spins on a slow console in
+ * the caller context.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef KERNEL_KLOG_H_
+#define KERNEL_KLOG_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#include <compiler.h>
+#include <util/array.h>
+
+/**
+ * Destination for formatted messages. Called from the klog thread only,
+ * one call per message.
+ */
+struct klog_sink {
+	const char *name;
+	void (*write)(int level, const char *buf, size_t len);
+};
+
+#define KLOG_SINK_DEF(sink_) \
+	ARRAY_SPREAD_DECLARE(const struct klog_sink *const, \
+			__klog_sinks_registry);                \
+	ARRAY_SPREAD_ADD(__klog_sinks_registry, &sink_)
+
+/**
+ * Queues a message. Format string must stay valid until the message is
+ * written out, that is always true for string literals. String arguments
+ * are copied.
+ *
+ * @return 0 if queued, -EAGAIN if dropped by rate limit or full buffer
+ */
+extern int klog(int level, const char *fmt, ...) _PRINTF_FORMAT(2, 3);
+extern int vklog(int level, const char *fmt, va_list args);
+
+/** Formats and writes out all queued messages in the caller context. */
+extern void klog_flush(void);
+
+/**
+ * Copies formatted history starting at @a *pos into @a buf.
+ * @a pos is advanced, so consequent calls continue reading.
+ *
+ * @return Number of bytes copied
+ */
+extern size_t klog_history_read(char *buf, size_t size, size_t *pos);
+
+/** Number of messages lost due to rate limiting or full buffers */
+extern unsigned int klog_dropped(void);
+
+#endif /* KERNEL_KLOG_H_ */
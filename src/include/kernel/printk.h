@@ -15,4 +15,8 @@
 extern int printk(const char *format, ...) _PRINTF_FORMAT(1, 2);
 extern int vprintk(const char *format, va_list args) _PRINTF_FORMAT(1, 0);
 
+struct print_fmt;
+/** Same as vprintk() for a format parsed once, see PRINT_FMT_INIT() */
+extern int vprintk_fmt(struct print_fmt *fmt, va_list args);
+
 #endif /* KERNEL_PRINTK_H_ */
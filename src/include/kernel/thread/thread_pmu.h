@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @brief Per-thread hardware performance counters
+ *
+ * Implementation header defines 'struct thread_pmu' and provides
+ *   void thread_pmu_init(struct thread_pmu *tp);
+ *   void thread_pmu_switch(struct thread_pmu *prev, struct thread_pmu *next);
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef THREAD_PMU_H_
+#define THREAD_PMU_H_
+
+struct thread_pmu;
+
+#include <module/embox/kernel/thread/thread_pmu.h>
+
+#endif /* THREAD_PMU_H_ */
@@ -21,6 +21,7 @@
 #include <kernel/thread/thread_cancel.h>
 #include <kernel/sched.h>
 #include <kernel/thread/thread_wait.h>
+#include <kernel/thread/thread_pmu.h>
 
 #include <util/dlist.h>
 
@@ -67,6 +68,8 @@ struct thread {
 
 	struct thread_wait thread_wait;
 
+	struct thread_pmu  pmu;          /**< Per-thread hardware counters */
+
 	int                policy;
 };
 
@@ -68,6 +68,10 @@ extern struct timespec clock_source_read(struct clock_source *cs);
 extern int clock_source_register(struct clock_source *cs);
 extern int clock_source_unregister(struct clock_source *cs);
 
+/**
+ * Cycles of the counter since the clock source started, counted with
+ * jiffies if the source has an event device. The source must have a counter.
+ */
 extern time64_t clock_source_get_hwcycles(struct clock_source *cs);
 
 static inline uint32_t clock_sourcehz2mult(uint32_t hz, uint32_t shift) {
@@ -52,10 +52,13 @@ struct time_event_device {
  * @param init - init function.
  * @param resolution - number of cycles per second.
  * @param read - return current number of cycles.
+ * @param mask - mask of counter bits for counters narrower than cycle_t,
+ *   0 if the counter doesn't wrap.
  */
 struct time_counter_device {
 	uint32_t cycle_hz;
 	cycle_t (*read)(void);
+	cycle_t mask;
 };
 
 #endif /* KERNEL_TIME_TIME_DEVICE_H_ */
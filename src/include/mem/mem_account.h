@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief Accounting of statically reserved memory
+ *
+ * Every static pool, hash table and heap registers a descriptor with its
+ * owning module, so reserved size and high-water usage can be inspected at
+ * runtime. Reserved sizes are compile-time constants.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef MEM_MEM_ACCOUNT_H_
+#define MEM_MEM_ACCOUNT_H_
+
+#include <stddef.h>
+
+#include <util/array.h>
+#include <util/macro.h>
+
+struct mem_account_stat {
+	size_t reserved; /**< Bytes reserved for the region */
+	size_t obj_size; /**< Size of an object (or a page), 0 if not applicable */
+	size_t total;    /**< Objects which fit into the region */
+	size_t used;     /**< Objects in use now */
+	size_t max_used; /**< High-water mark of @a used */
+	unsigned int failed; /**< Allocations failed because region was full */
+};
+
+struct mem_account {
+	const char *name;
+	/** Mangled module name, e.g. embox__net__skbuff */
+	const char *owner;
+	const char *type;
+	const void *obj;
+	void (*stat)(const void *obj, struct mem_account_stat *st);
+};
+
+#ifdef __EMBUILD_MOD__
+# define __MEM_ACCOUNT_OWNER MACRO_STRING(__EMBUILD_MOD__)
+#else
+# define __MEM_ACCOUNT_OWNER "unknown"
+#endif
+
+#define MEM_ACCOUNT_DEF(_name, _type, _obj, _stat) \
+	static const struct mem_account MACRO_CONCAT(__mem_account_, _name) = { \
+		.name  = MACRO_STRING(_name),                 \
+		.owner = __MEM_ACCOUNT_OWNER,                 \
+		.type  = _type,                               \
+		.obj   = _obj,                                \
+		.stat  = _stat,                               \
+	};                                                \
+	ARRAY_SPREAD_DECLARE(const struct mem_account *const, \
+			__mem_account_registry);                  \
+	ARRAY_SPREAD_ADD(__mem_account_registry,          \
+			&MACRO_CONCAT(__mem_account_, _name))
+
+#define mem_account_foreach(acc) \
+	array_spread_foreach(acc, __mem_account_registry)
+
+ARRAY_SPREAD_DECLARE(const struct mem_account *const, __mem_account_registry);
+
+#endif /* MEM_MEM_ACCOUNT_H_ */
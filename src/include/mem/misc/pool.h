@@ -12,12 +12,39 @@
 
 
 #include <stddef.h>
+#include <util/array.h>
 #include <util/macro.h>
 #include <util/slist.h>
 #include <util/bitmap.h>
 
+#include <mem/mem_account.h>
+
 #include <module/embox/mem/pool.h>
 
+struct pool;
+struct pool_chunk;
+
+/** Operations of elastic pools, implemented by embox.mem.pool_elastic */
+struct pool_elastic_ops {
+	void *(*alloc)(struct pool *pl);
+	void (*free)(struct pool *pl, void *obj);
+	int (*belong)(const struct pool *pl, const void *obj);
+};
+
+/** Growth state of a pool defined with POOL_DEF_ELASTIC() */
+struct pool_elastic {
+	const struct pool_elastic_ops *ops;
+	/* Maximum number of objects, statically reserved ones included */
+	size_t max_objects;
+	size_t obj_align;
+	/* Objects and bytes taken from the page allocator */
+	size_t objects;
+	size_t chunk_bytes;
+	/* Power of 2, set on the first growth. Chunks are aligned to their size */
+	size_t chunk_pages;
+	struct pool_chunk *chunks;
+};
+
 /** Representation of the pool*/
 struct pool {
 	/* Place in memory for allocation */
@@ -32,6 +59,13 @@ struct pool {
 	size_t pool_size;
 	/* Boundary, after which begin non-allocated memory */
 	void *bound_free;
+	/* Objects allocated now and the maximum ever allocated */
+	size_t used;
+	size_t max_used;
+	/* Allocations failed because the pool was full */
+	unsigned int exhausted;
+	/* NULL for fixed size pools */
+	struct pool_elastic *elastic;
 #ifdef POOL_DEBUG
 	BITMAP_DECL(blocks, POOL_MAX_OBJECTS);
 #endif
@@ -65,7 +99,8 @@ struct pool {
 			.obj_size = sizeof(__pool_storage ## name[0]), \
 			.pool_size = sizeof(__pool_storage ## name), \
 			POOL_BLOCKS_INIT \
-	};
+	}; \
+	MEM_ACCOUNT_DEF(name, "pool", &name, pool_account_stat)
 
 
 /**
@@ -79,6 +114,44 @@ struct pool {
  #define POOL_DEF(name, object_type, size) POOL_DEF_ATTR(name, object_type, size, )
 
 
+/**
+ * Create pool descriptor for a pool, which has @a size objects reserved
+ * statically and grows by chunks of pages from the physical page allocator
+ * up to @a max_size objects. Chunks which have no allocated objects are
+ * returned to the page allocator when it runs out of memory. Requires
+ * embox.mem.pool_elastic module. Unlike fixed pools, alloc and free are
+ * safe against interrupts.
+ *
+ * @param name of cache
+ * @param type of objects in cache
+ * @param count of objects reserved statically
+ * @param maximum count of objects
+ */
+#define POOL_DEF_ELASTIC(name, object_type, size, max_size) \
+	extern const struct pool_elastic_ops __pool_elastic_ops; \
+	static union { \
+		object_type object; \
+		struct slist_link free_link; \
+	} __pool_storage ## name[size] \
+		__attribute__((section(".bss..reserve.pool,\"aw\",%nobits;#")));  \
+	static struct pool_elastic __pool_elastic ## name = { \
+			.ops = &__pool_elastic_ops, \
+			.max_objects = max_size, \
+			.obj_align = __alignof__(__pool_storage ## name[0]), \
+	}; \
+	static struct pool name = { \
+			.memory = __pool_storage ## name, \
+			.bound_free = __pool_storage ## name, \
+			.free_blocks = SLIST_INIT(&name.free_blocks),\
+			.obj_size = sizeof(__pool_storage ## name[0]), \
+			.pool_size = sizeof(__pool_storage ## name), \
+			.elastic = &__pool_elastic ## name, \
+			POOL_BLOCKS_INIT \
+	}; \
+	ARRAY_SPREAD_DECLARE(struct pool *const, __pool_elastic_registry); \
+	ARRAY_SPREAD_ADD(__pool_elastic_registry, &name); \
+	MEM_ACCOUNT_DEF(name, "pool", &name, pool_account_stat)
+
 /**
  * allocate single object from the cache and return it to the caller
  * @param cache corresponding to allocating object
@@ -95,4 +168,15 @@ extern void pool_free(struct pool *pl, void *obj);
 
 extern int pool_belong(const struct pool *pl, const void *obj);
 
+/**
+ * Returns chunks of an elastic pool having no allocated objects to the page
+ * allocator. Does nothing for fixed size pools.
+ *
+ * @return number of bytes released
+ */
+extern size_t pool_shrink(struct pool *pl);
+
+/** mem_account statistics callback for pools */
+extern void pool_account_stat(const void *pool, struct mem_account_stat *st);
+
 #endif /* MEM_MISC_UTIL_POOL_H_ */
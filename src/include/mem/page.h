@@ -23,6 +23,7 @@ struct page_allocator {
 	size_t page_size;
 
 	size_t free;
+	size_t min_free; /**< Low-water mark of @a free */
 
 	size_t bitmap_len;
 	unsigned long *bitmap;
@@ -38,6 +39,14 @@ extern void page_free(struct page_allocator *allocator, void *page, size_t page_
 
 extern int page_belong(struct page_allocator *allocator, void *page);
 
+struct mem_account_stat;
+/**
+ * mem_account statistics callback, @a allocator_ptr points to a variable
+ * holding the allocator, since allocators are created at runtime.
+ */
+extern void page_allocator_account_stat(const void *allocator_ptr,
+		struct mem_account_stat *st);
+
 #define PAGE_ALLOCATOR_DEF(name, space, page_number, page_size) \
 	static unsigned long ctrl_space_##name[ page_number/32 ]; \
 	static struct page_allocator name = { \
@@ -45,6 +54,7 @@ extern int page_belong(struct page_allocator *allocator, void *page);
 			page_number, \
 			page_size, \
 			page_size * page_number, \
+			page_size * page_number, \
 			(sizeof(unsigned long) * page_number/32), \
 			ctrl_space_##name \
 	}
@@ -9,6 +9,7 @@
 #define MEM_PHYMEM_H_
 
 #include <mem/page.h>
+#include <util/array.h>
 
 extern struct page_allocator *__phymem_allocator;
 
@@ -18,4 +19,15 @@ extern struct page_allocator *__phymem_allocator;
 extern void *phymem_alloc(size_t page_number);
 extern void phymem_free(void *page, size_t page_number);
 
+/**
+ * Called when phymem_alloc() runs out of pages, before the single retry.
+ * Handler should return unused memory with phymem_free() and must not
+ * sleep, since allocation may happen with interrupts disabled.
+ */
+typedef void (*phymem_reclaim_ft)(void);
+
+#define PHYMEM_RECLAIM_HANDLER(handler) \
+	ARRAY_SPREAD_DECLARE(const phymem_reclaim_ft, __phymem_reclaim_handlers); \
+	ARRAY_SPREAD_ADD(__phymem_reclaim_handlers, handler)
+
 #endif /* MEM_PHYMEM_H_ */
@@ -214,6 +214,13 @@ struct dns_result {
 extern int dns_query(const char *query, enum dns_type qtype, enum dns_class qclass,
 		struct dns_result *out_result);
 
+/**
+ * dns_query_addr - query A and AAAA records of the name at once
+ * Returns 0 if any of queries succeeded, a failed result has no records
+ */
+extern int dns_query_addr(const char *qname, struct dns_result *out_a,
+		struct dns_result *out_aaaa);
+
 /**
  * dns_result_free - free resource from dns_result structure
  */
@@ -228,4 +235,32 @@ extern char *dns_set_nameserver(char *nameserver);
 
 extern char *dns_init_nameserver(char *nameserver);
 
+/**
+ * dns_hosts_lookup - answer A or AAAA query from the hosts file
+ * Returns -ENOENT if there is no such name, the query is sent to the
+ * nameserver then
+ */
+extern int dns_hosts_lookup(const struct dns_q *query,
+		struct dns_result *out_result);
+
+/**
+ * Resolver statistics
+ */
+struct dns_cache_stats {
+	unsigned long queries;    /* all queries */
+	unsigned long hits;       /* answered from the cache */
+	unsigned long neg_hits;   /* failed lookups answered from the cache */
+	unsigned long hosts_hits; /* answered from the hosts file */
+	unsigned long coalesced;  /* waited for the same query in flight */
+	unsigned long sent;       /* queries sent to the nameserver */
+	unsigned long latency_ms; /* average reply time of the nameserver */
+};
+
+extern void dns_cache_get_stats(struct dns_cache_stats *stats);
+
+/**
+ * dns_cache_flush - drop all cached replies
+ */
+extern void dns_cache_flush(void);
+
 #endif /* NET_LIB_DNS_H_ */
@@ -61,9 +61,23 @@ struct rpc_err {
 };
 
 
+/* One call of a batch issued with clnt_call_many() */
+struct rpc_call {
+	uint32_t procnum;
+	xdrproc_t inproc;
+	char *in;
+	xdrproc_t outproc;
+	char *out;
+	enum clnt_stat status; /* result of this particular call */
+	uint32_t xid;          /* used by the transport to match the reply */
+};
+
 struct clnt_ops {
 	enum clnt_stat (*call)(struct client *clnt, uint32_t procnum, xdrproc_t inproc,
 			char *in, xdrproc_t outproc, char *out, struct timeval wait);
+	/* optional: keep all calls outstanding at once, replies in any order */
+	enum clnt_stat (*call_many)(struct client *clnt, struct rpc_call *calls,
+			int count, struct timeval wait);
 	void (*geterr)(struct client *clnt, struct rpc_err *perr);
 	void (*destroy)(struct client *clnt);
 };
@@ -110,6 +124,11 @@ extern struct client * clnttcp_create(struct sockaddr_in *addr, uint32_t prognum
 extern enum clnt_stat clnt_call(struct client *clnt, uint32_t procnum, xdrproc_t inproc,
 		char *in, xdrproc_t outproc, char *out, struct timeval wait);
 
+/* Sends all calls before waiting for the replies when the transport allows
+ * that, otherwise calls them one by one. Returns the first failed status */
+extern enum clnt_stat clnt_call_many(struct client *clnt, struct rpc_call *calls,
+		int count, struct timeval wait);
+
 extern void clnt_geterr(struct client * clnt, struct rpc_err *perr);
 
 extern void clnt_destroy(struct client *clnt);
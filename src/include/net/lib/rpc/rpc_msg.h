@@ -103,5 +103,7 @@ extern int xdr_rejected_reply(struct xdr *xs, struct rejected_reply *rr);
 extern int xdr_call_body(struct xdr *xs, struct call_body *cb);
 extern int xdr_reply_body(struct xdr *xs, struct reply_body *rb);
 extern int xdr_rpc_msg(struct xdr *xs, struct rpc_msg *msg);
+/* Everything after the xid, so a reply can be matched before decoding */
+extern int xdr_rpc_msg_body(struct xdr *xs, struct rpc_msg *msg);
 
 #endif /* NET_LIB_RPC_RPC_MSG_H_ */
@@ -97,6 +97,7 @@ extern void xdrrec_create(struct xdr *xs, size_t sendsz, size_t recvsz,
 		char *handle, xdrrec_hnd_t readit, xdrrec_hnd_t writeit);
 
 extern int xdrrec_endofrecord(struct xdr *xs, int sendnow);
+extern int xdrrec_skiprecord(struct xdr *xs);
 extern size_t xdr_getpos(struct xdr *xs);
 extern int xdr_setpos(struct xdr *xs, size_t pos);
 extern void xdr_destroy(struct xdr *xs);
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Open addressing hash map with inline entries
+ *
+ * @details Robin Hood probing over a power-of-two array of
+ *   {hash, key, value} slots, so neither lookup nor insertion allocates or
+ *   follows item pointers. When the load factor exceeds 7/8 the map
+ *   allocates a table twice as large and moves the old entries a few
+ *   slots per update, so no single put pays for the whole rehash.
+ *   The interface follows util/hashtable.h with (key, value) pairs instead
+ *   of caller allocated items.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef UTIL_HASHMAP_H_
+#define UTIL_HASHMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <util/hashtable.h>
+#include <mem/mem_account.h>
+
+struct hashmap_slot {
+	uint32_t hash; /**< mixed hash of the key, 0 for an empty slot */
+	void *key;
+	void *value;
+};
+
+struct hashmap_table {
+	struct hashmap_slot *slots;
+	unsigned int mask; /**< number of slots - 1 */
+	unsigned int cnt;
+};
+
+struct hashmap {
+	struct hashmap_table cur;
+	struct hashmap_table old; /**< being moved to @a cur, no slots if not */
+	unsigned int move_pos; /**< next slot of @a old to move */
+	struct hashmap_slot *static_slots; /**< initial slots, never freed */
+	unsigned int static_mask;
+	ht_hash_ft get_hash_key;
+	ht_cmp_ft cmp;
+	unsigned int max_cnt; /**< maximum number of entries */
+	unsigned int failed; /**< puts failed because the map was full */
+};
+
+/**
+ * Initializes a map with an initial array of @a size slots, @a size must be
+ * a power of two. The map grows on heap when it fills up.
+ */
+extern struct hashmap *hashmap_init(struct hashmap *map,
+		struct hashmap_slot *slots, unsigned int size,
+		ht_hash_ft get_hash, ht_cmp_ft cmp);
+
+/** Deletes all entries and frees memory allocated by the map */
+extern void hashmap_destroy(struct hashmap *map);
+
+/**
+ * Inserts @a value with @a key. The key must not be in the map already.
+ *
+ * @return 0 or -ENOMEM if the map is full and can't grow
+ */
+extern int hashmap_put(struct hashmap *map, void *key, void *value);
+
+/** @return value of @a key or NULL if there is no such key */
+extern void *hashmap_get(struct hashmap *map, void *key);
+
+/** Deletes @a key, @return its value or NULL if there is no such key */
+extern void *hashmap_del(struct hashmap *map, void *key);
+
+/**
+ * Iterates over keys like hashtable_get_key_first/next. The map must not be
+ * changed during iteration.
+ *
+ * @return pointer to the key or NULL if there are no more entries
+ */
+extern void *hashmap_get_key_first(struct hashmap *map);
+extern void *hashmap_get_key_next(struct hashmap *map, void *prev_key);
+
+/** @return number of entries */
+static inline unsigned int hashmap_count(struct hashmap *map) {
+	return map->cur.cnt + map->old.cnt;
+}
+
+/** mem_account statistics callback for maps defined by HASHMAP_DEF */
+extern void hashmap_account_stat(const void *map,
+		struct mem_account_stat *st);
+
+#define HASHMAP_DEF(name, size, hash_fn, cmp_fn) \
+		static struct hashmap_slot name##_slots[size];  \
+		static struct hashmap name = {                  \
+				.cur = { name##_slots, (size) - 1, 0 }, \
+				.static_slots = name##_slots,           \
+				.static_mask = (size) - 1,              \
+				.get_hash_key = hash_fn,                \
+				.cmp = cmp_fn,                          \
+		};                                              \
+		MEM_ACCOUNT_DEF(name, "hashmap", &name, hashmap_account_stat)
+
+#endif /* UTIL_HASHMAP_H_ */
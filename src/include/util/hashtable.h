@@ -110,6 +110,11 @@ extern void *hashtable_get_key_next(struct hashtable *ht, void *prev_key);
 
 
 #include <util/dlist.h>
+#include <mem/mem_account.h>
+
+/** mem_account statistics callback for tables defined by HASHTABLE_DEF */
+extern void hashtable_account_stat(const void *ht,
+		struct mem_account_stat *st);
 
 struct hashtable_item {
 	struct dlist_head lnk;
@@ -135,6 +140,8 @@ struct hashtable {
 	ht_cmp_ft cmp; /** < handler of the compare elements function */
 	unsigned int table_size; /** size of the array of the table entry */
 	struct dlist_head all;
+	unsigned int cnt; /**< items in the table */
+	unsigned int max_cnt; /**< maximum of @a cnt */
 };
 
 #define HASHTABLE_BUFFER_SIZE(size) \
@@ -151,7 +158,8 @@ struct hashtable {
 				cmp_fn,                                 \
 				size, \
 				DLIST_INIT(name.all),                    \
-		}
+		};                                              \
+		MEM_ACCOUNT_DEF(name, "hashtable", &name, hashtable_account_stat)
 
 
 #define HASHTABLE_SIZE(size) \
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Intrusive red-black tree
+ *
+ * @details Nodes are embedded into user structures and ordered by the user:
+ *   either with rb_insert() and a compare function, or by descending from
+ *   rb_tree::root and calling rb_link() and rb_insert_fixup(), like in
+ *   Linux. Lookups are written by the user the same way.
+ *
+ *   An augmented tree keeps in every node a value computed from the node and
+ *   its children (e.g. the maximum end of intervals in the subtree). Set
+ *   rb_tree::augment to a function recomputing it for one node, and the tree
+ *   calls it for every node whose subtree changes.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef UTIL_RBTREE_H_
+#define UTIL_RBTREE_H_
+
+#include <stddef.h>
+
+#include <util/member.h>
+
+#define RB_RED   0
+#define RB_BLACK 1
+
+struct rb_node {
+	struct rb_node *parent;
+	struct rb_node *left;
+	struct rb_node *right;
+	int color;
+};
+
+/** Recomputes augmented data of @a node from itself and its children */
+typedef void (*rb_augment_ft)(struct rb_node *node);
+
+/** Compares nodes, equal nodes are inserted after existing ones */
+typedef int (*rb_cmp_ft)(struct rb_node *node1, struct rb_node *node2);
+
+struct rb_tree {
+	struct rb_node *root;
+	rb_augment_ft augment; /**< NULL for plain trees */
+};
+
+#define RB_TREE_INIT(augment_fn) { NULL, augment_fn }
+
+#define rb_entry(node, type, member) \
+	((node) == NULL ? NULL : member_cast_out(node, type, member))
+
+static inline void rb_tree_init(struct rb_tree *tree, rb_augment_ft augment) {
+	tree->root = NULL;
+	tree->augment = augment;
+}
+
+static inline int rb_empty(struct rb_tree *tree) {
+	return tree->root == NULL;
+}
+
+/**
+ * Puts @a node into the empty @a link (&parent->left, &parent->right or
+ * &tree->root) found by descent. rb_insert_fixup() must follow.
+ */
+static inline void rb_link(struct rb_node *node, struct rb_node *parent,
+		struct rb_node **link) {
+	node->parent = parent;
+	node->left = node->right = NULL;
+	node->color = RB_RED;
+	*link = node;
+}
+
+/** Rebalances the tree after rb_link() */
+extern void rb_insert_fixup(struct rb_tree *tree, struct rb_node *node);
+
+/** Inserts @a node in order given by @a cmp */
+extern void rb_insert(struct rb_tree *tree, struct rb_node *node,
+		rb_cmp_ft cmp);
+
+extern void rb_erase(struct rb_tree *tree, struct rb_node *node);
+
+/** In-order traversal, @return NULL past the end */
+extern struct rb_node *rb_first(struct rb_tree *tree);
+extern struct rb_node *rb_last(struct rb_tree *tree);
+extern struct rb_node *rb_next(struct rb_node *node);
+extern struct rb_node *rb_prev(struct rb_node *node);
+
+/** Iterates in order, @a node must not be erased inside the loop */
+#define rb_foreach(node, tree) \
+	for (node = rb_first(tree); node != NULL; node = rb_next(node))
+
+#endif /* UTIL_RBTREE_H_ */
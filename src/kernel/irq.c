@@ -22,19 +22,27 @@
 #include <stdbool.h>
 
 #include <util/dlist.h>
+#include <util/member.h>
 
 #include <kernel/irq.h>
 #include <kernel/irq_lock.h>
 #include <kernel/irq_stack.h>
 #include <kernel/critical.h>
 #include <drivers/irqctrl.h>
+#include <hal/cpu.h>
 #include <hal/ipl.h>
 #include <mem/objalloc.h>
+#include <kernel/lthread/lthread.h>
+#include <kernel/sched/schedee_priority.h>
+#include <kernel/time/ktime.h>
 
 
 struct irq_entry {
 	irq_handler_t handler;
+	irq_handler_t thread_fn;
 	void *dev_id;
+	const char *dev_name;
+	int thread_pending;
 	struct dlist_head action_link;
 };
 
@@ -42,6 +50,12 @@ struct irq_action {
 	struct irq_entry *entry;
 	struct dlist_head entry_list;
 	int sharing_supported;
+
+	unsigned int irq_nr;
+	int threaded;
+	int masked; /* until the thread is done */
+	struct irq_entry *volatile thread_entry; /* its thread_fn is running */
+	struct lthread thread;
 };
 
 #if OPTION_GET(NUMBER, action_n) <= 0
@@ -56,17 +70,103 @@ struct irq_action {
 #define IRQ_ENTRY_N OPTION_GET(NUMBER, entry_n)
 #endif
 
+#define IRQ_THREAD_PRIORITY OPTION_GET(NUMBER, thread_priority)
+#define IRQ_STAT_TIME       OPTION_GET(BOOLEAN, stat_time)
+
 OBJALLOC_DEF(irq_actions, struct irq_action, IRQ_ACTION_N);
 OBJALLOC_DEF(irq_entries, struct irq_entry, IRQ_ENTRY_N);
 
 static struct irq_action *irq_table[IRQ_NRS_TOTAL];
 
-int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
-		void *dev_id, const char *dev_name) {
+static struct irq_stat irq_stats[IRQ_NRS_TOTAL];
+
+#if IRQ_STAT_TIME
+extern struct clock_source *kernel_clock_source;
+#endif
+
+static inline uint64_t irq_stat_time(void) {
+#if IRQ_STAT_TIME
+	/* IRQs may come before kernel time is initialized */
+	return kernel_clock_source ? ktime_get_ns() : 0;
+#else
+	return 0;
+#endif
+}
+
+static inline void irq_stat_max(uint64_t *max, uint64_t start) {
+	uint64_t time = irq_stat_time() - start;
+
+	if (time > *max) {
+		*max = time;
+	}
+}
+
+/* Takes a pending entry under the lock and runs it without the lock, as
+ * entries may be detached meanwhile. */
+static int irq_thread_run(struct lthread *self) {
 	struct irq_action *action;
+	struct irq_entry *entry;
+	irq_handler_t thread_fn;
+	void *dev_id = NULL;
+	uint64_t start;
+
+	action = member_cast_out(self, struct irq_action, thread);
+	start = irq_stat_time();
+
+	do {
+		thread_fn = NULL;
+
+		irq_lock();
+		action->thread_entry = NULL;
+		dlist_foreach_entry(entry, &action->entry_list, action_link) {
+			if (entry->thread_pending) {
+				entry->thread_pending = 0;
+				thread_fn = entry->thread_fn;
+				dev_id = entry->dev_id;
+				action->thread_entry = entry;
+				break;
+			}
+		}
+		irq_unlock();
+
+		if (thread_fn) {
+			thread_fn(action->irq_nr, dev_id);
+		}
+	} while (thread_fn);
+
+	irq_lock();
+	{
+		if (action->masked) {
+			action->masked = 0;
+			irqctrl_enable(action->irq_nr);
+		}
+
+		irq_stats[action->irq_nr].thread_count++;
+		irq_stat_max(&irq_stats[action->irq_nr].max_thread_time, start);
+	}
+	irq_unlock();
+
+	return 0;
+}
+
+static void irq_action_thread_init(struct irq_action *action) {
+	if (action->threaded) {
+		return;
+	}
+
+	lthread_init(&action->thread, irq_thread_run);
+	schedee_priority_set(&action->thread.schedee, IRQ_THREAD_PRIORITY);
+	action->threaded = 1;
+}
+
+int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, void *dev_id,
+		const char *dev_name) {
+	struct irq_action *action;
+	struct irq_entry *entry;
 	int ret = ENOERR;
 
-	if (!irq_nr_valid(irq_nr) || !handler) {
+	if (!irq_nr_valid(irq_nr) || !(handler || thread_fn)) {
 		return -EINVAL;
 	}
 
@@ -85,31 +185,42 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
 	} else if (! (action = objalloc(&irq_actions))) {
 		ret = -ENOMEM;
 		goto out_unlock;
+	} else {
+		dlist_init(&action->entry_list);
+		action->irq_nr = irq_nr;
+		action->threaded = 0;
+		action->masked = 0;
+		action->thread_entry = NULL;
 	}
 
 	/* Action entry allocation */
-	if (! (action->entry = objalloc(&irq_entries))) {
-		if (dlist_empty(&(irq_table[irq_nr]->entry_list))) {
+	if (! (entry = objalloc(&irq_entries))) {
+		if (!irq_table[irq_nr]) {
 			objfree(&irq_actions, action);
 		}
 		ret = -ENOMEM;
 		goto out_unlock;
 	}
 
-	action->entry->handler = handler;
+	entry->handler = handler;
+	entry->thread_fn = thread_fn;
+	entry->dev_id = dev_id;
+	entry->dev_name = dev_name;
+	entry->thread_pending = 0;
+	action->entry = entry;
 	action->sharing_supported = (flags & IF_SHARESUP) ? 1 : 0;
-	action->entry->dev_id = dev_id;
 
-	if (irq_table[irq_nr]) {
-		/* Add new device to list */
-		dlist_add_next(dlist_head_init(&(action->entry->action_link)),
-				&(irq_table[irq_nr]->entry_list));
-	} else {
-		/* Initialize list if it is first device on this IRQ line */
+	if (thread_fn) {
+		irq_action_thread_init(action);
+	}
+
+	/* Add new device to list */
+	dlist_add_next(dlist_head_init(&entry->action_link),
+			&action->entry_list);
+
+	if (!irq_table[irq_nr]) {
+		/* It is the first device on this IRQ line */
 		irq_table[irq_nr] = action;
-		dlist_init(&action->entry_list);
-		dlist_add_next(dlist_head_init(&(action->entry->action_link)),
-				&(irq_table[irq_nr]->entry_list));
 		irqctrl_enable(irq_nr);
 	}
 
@@ -117,10 +228,25 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
 	return ret;
 }
 
+int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
+		void *dev_id, const char *dev_name) {
+	if (!handler) {
+		return -EINVAL;
+	}
+
+	if (flags & IF_THREADED) {
+		return irq_attach_threaded(irq_nr, NULL, handler, flags, dev_id,
+				dev_name);
+	}
+
+	return irq_attach_threaded(irq_nr, handler, NULL, flags, dev_id,
+			dev_name);
+}
+
 int irq_detach(unsigned int irq_nr, void *dev_id) {
-	struct irq_action *action;
-	struct irq_entry *entry;
-	int ret = ENOERR;
+	struct irq_action *action, *unused_action;
+	struct irq_entry *entry, *detached = NULL;
+	int ret = -ENOENT;
 
 	if (!irq_nr_valid(irq_nr)) {
 		return -EINVAL;
@@ -130,32 +256,97 @@ int irq_detach(unsigned int irq_nr, void *dev_id) {
 
 	/* Go thru list to determine which IRQ/DEV pair should be detached */
 	if (!(action = irq_table[irq_nr])) {
-		ret = -ENOENT;
-		goto out_unlock;
+		irq_unlock();
+		return -ENOENT;
 	}
 
-	dlist_foreach_entry(entry, &(irq_table[irq_nr]->entry_list), action_link) {
+	dlist_foreach_entry(entry, &action->entry_list, action_link) {
 		if (entry->dev_id == dev_id) {
 			dlist_del(&(entry->action_link));
-			objfree(&irq_entries, entry);
+			detached = entry;
+			ret = ENOERR;
+			break;
+		}
+	}
 
-			if (dlist_empty(&(irq_table[irq_nr]->entry_list))) {
-				objfree(&irq_actions, action);
-				irq_table[irq_nr] = NULL;
-				irqctrl_disable(irq_nr);
-				break;
-			}
+	if (!dlist_empty(&action->entry_list)) {
+		unused_action = NULL;
+	} else {
+		unused_action = action;
+		irq_table[irq_nr] = NULL;
+		irqctrl_disable(irq_nr);
+		/* The thread must not enable the line back */
+		action->masked = 0;
+	}
+
+	irq_unlock();
+
+	if (detached) {
+		/* The thread may be running its thread_fn on another CPU. It runs
+		 * to the end without being preempted by threads, so it's never
+		 * waited for on the same CPU. */
+		while (action->thread_entry == detached) {
 		}
+		objfree(&irq_entries, detached);
+	}
+
+	if (unused_action) {
+		if (unused_action->threaded) {
+			/* The thread may still run */
+			lthread_join(&unused_action->thread);
+		}
+		objfree(&irq_actions, unused_action);
 	}
 
-	out_unlock: irq_unlock();
 	return ret;
 }
 
+int irq_set_affinity(unsigned int irq_nr, unsigned int cpu) {
+	if (!irq_nr_valid(irq_nr) || cpu >= NCPU) {
+		return -EINVAL;
+	}
+
+#ifdef __IRQCTRL_AFFINITY
+	return irqctrl_set_affinity(irq_nr, cpu);
+#else
+	return -ENOSYS;
+#endif
+}
+
+int irq_get_stat(unsigned int irq_nr, struct irq_stat *stat) {
+	if (!irq_nr_valid(irq_nr)) {
+		return -EINVAL;
+	}
+
+	irq_lock();
+	*stat = irq_stats[irq_nr];
+	irq_unlock();
+
+	return 0;
+}
+
+const char *irq_get_dev_name(unsigned int irq_nr) {
+	struct irq_action *action;
+
+	assert(irq_nr_valid(irq_nr));
+
+	action = irq_table[irq_nr];
+	if (!action) {
+		return NULL;
+	}
+
+	return dlist_first_entry(&action->entry_list, struct irq_entry,
+			action_link)->dev_name;
+}
+
 void irq_dispatch(unsigned int irq_nr) {
+	struct irq_action *action;
 	struct irq_entry *entry = NULL;
 	irq_handler_t handler = NULL;
+	irq_return_t ret;
 	void *dev_id = NULL;
+	int wake_thread = 0;
+	uint64_t start;
 	ipl_t ipl;
 
 	assert(irq_nr_valid(irq_nr));
@@ -163,21 +354,45 @@ void irq_dispatch(unsigned int irq_nr) {
 	assertf(irq_stack_protection() == 0,
 			"Stack overflow detected on irq dispatch");
 
-	if (irq_table[irq_nr]) {
+	irq_stats[irq_nr].count++;
+
+	if ((action = irq_table[irq_nr])) {
+		start = irq_stat_time();
+
 		ipl = ipl_save();
-		dlist_foreach_entry(entry, &(irq_table[irq_nr]->entry_list),
-				action_link) {
+		dlist_foreach_entry(entry, &action->entry_list, action_link) {
 			assert(NULL != entry);
 
 			handler = entry->handler;
-			assert(NULL != handler);
-
 			dev_id = entry->dev_id;
 
+			if (!handler) {
+				/* Whole processing is in the thread */
+				entry->thread_pending = 1;
+				action->masked = 1;
+				wake_thread = 1;
+				continue;
+			}
+
 			ipl_restore(ipl);
-			handler(irq_nr, dev_id);
+			ret = handler(irq_nr, dev_id);
 			ipl = ipl_save();
+
+			if (ret == IRQ_WAKE_THREAD && entry->thread_fn) {
+				entry->thread_pending = 1;
+				wake_thread = 1;
+			}
+		}
+
+		if (action->masked) {
+			irqctrl_disable(irq_nr);
 		}
 		ipl_restore(ipl);
+
+		if (wake_thread) {
+			lthread_launch(&action->thread);
+		}
+
+		irq_stat_max(&irq_stats[irq_nr].max_time, start);
 	}
 }
@@ -6,6 +6,9 @@
  * @author: Anton Bondarev
  */
 
+#include <errno.h>
+#include <stddef.h>
+
 #include <kernel/irq.h>
 
 int irq_attach(unsigned int irq_nr, irq_handler_t handler, unsigned int flags,
@@ -19,6 +22,25 @@ int irq_detach(unsigned int irq_nr, void *dev_id) {
 	return 0;
 }
 
+int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, void *data,
+		const char *dev_name) {
+	irqctrl_enable(irq_nr);
+	return 0;
+}
+
+int irq_set_affinity(unsigned int irq_nr, unsigned int cpu) {
+	return -ENOSYS;
+}
+
+int irq_get_stat(unsigned int irq_nr, struct irq_stat *stat) {
+	return -ENOSYS;
+}
+
+const char *irq_get_dev_name(unsigned int irq_nr) {
+	return NULL;
+}
+
 void irq_dispatch(unsigned int irq_nr) {
 
 }
@@ -0,0 +1,633 @@
+/**
+ * @file
+ * @brief Asynchronous kernel log
+ *
+ * Message is stored as a fixed size record in the ring of the current CPU:
+ * the format pointer and arguments in their binary form, strings are copied
+ * inline. Records of all CPUs are merged by the global sequence number and
+ * formatted by the klog thread (or by klog_flush() caller).
+ *
+ * @date 17.10.2026
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <hal/clock.h>
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/klog.h>
+#include <kernel/sched/schedee_priority.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/thread/sync/mutex.h>
+#include <kernel/thread/waitq.h>
+#include <kernel/time/time.h>
+#include <util/array.h>
+#include <util/err.h>
+#include <util/logging.h>
+#include <util/math.h>
+
+#include <drivers/diag.h>
+
+#include <embox/unit.h>
+#include <framework/mod/options.h>
+
+#define KLOG_REC_SIZE      OPTION_GET(NUMBER, rec_size)
+#define KLOG_RECORDS       OPTION_GET(NUMBER, records)
+#define KLOG_HISTORY_SIZE  OPTION_GET(NUMBER, history_size)
+#define KLOG_RATE_LIMIT    OPTION_GET(NUMBER, rate_limit)
+#define KLOG_PRIORITY      OPTION_GET(NUMBER, priority)
+#define KLOG_DIAG_SINK     OPTION_GET(BOOLEAN, diag_sink)
+#define KLOG_CONSOLE_LEVEL OPTION_GET(NUMBER, console_level)
+
+#define KLOG_LINE_SIZE     256
+
+ARRAY_SPREAD_DEF(const struct klog_sink *const, __klog_sinks_registry);
+
+EMBOX_UNIT_INIT(klog_init);
+
+struct klog_rec {
+	unsigned int seq;
+	clock_t time;
+	const char *fmt;
+	short level;
+	unsigned char truncated;
+	unsigned short len;
+	char payload[KLOG_REC_SIZE];
+};
+
+struct klog_ring {
+	unsigned int head; /* written by the owner CPU with IRQs disabled */
+	unsigned int tail; /* written by the consumer under klog_mutex */
+	struct klog_rec rec[KLOG_RECORDS];
+};
+
+enum klog_arg {
+	KLOG_ARG_NONE,
+	KLOG_ARG_INT,
+	KLOG_ARG_LONG,
+	KLOG_ARG_LLONG,
+	KLOG_ARG_PTR,
+	KLOG_ARG_STR,
+	KLOG_ARG_DOUBLE,
+	KLOG_ARG_LDOUBLE,
+};
+
+struct klog_spec {
+	const char *end;    /* next char after the conversion */
+	int stars;          /* number of '*' (each takes int argument) */
+	enum klog_arg arg;
+};
+
+static struct klog_ring klog_ring __cpudata__;
+
+static unsigned int klog_seq;
+static unsigned int klog_lost;
+static unsigned int klog_lost_reported;
+
+static clock_t klog_rl_start;
+static unsigned int klog_rl_count;
+static spinlock_t klog_rl_lock = SPIN_STATIC_UNLOCKED;
+
+/* Set by producers, the klog thread sleeps until it's raised */
+static int klog_wake;
+static struct waitq klog_wq = WAITQ_INIT(klog_wq);
+
+static char klog_history[KLOG_HISTORY_SIZE];
+static size_t klog_history_total;
+
+static struct mutex klog_mutex = MUTEX_INIT_STATIC;
+
+/* Same conversions as __print() understands */
+static const char *klog_spec_parse(const char *p, struct klog_spec *spec) {
+	int len = 0;
+
+	spec->stars = 0;
+	spec->arg = KLOG_ARG_NONE;
+
+	assert(*p == '%');
+	for (p++; *p != '\0' && strchr("-+ #0", *p); p++);
+	for (; *p == '*' || (*p >= '0' && *p <= '9') || *p == '.'; p++) {
+		if (*p == '*') {
+			spec->stars++;
+		}
+	}
+	for (; *p != '\0' && strchr("hlLjzt", *p); p++) {
+		switch (*p) {
+		case 'l':
+			len = len ? 2 : 1;
+			break;
+		case 'j':
+			len = 2;
+			break;
+		case 'z':
+		case 't':
+			len = 1;
+			break;
+		case 'L':
+			len = 3;
+			break;
+		}
+	}
+
+	switch (*p) {
+	case 'd': case 'i': case 'u': case 'o':
+	case 'x': case 'X': case 'c':
+		spec->arg = (len == 2) ? KLOG_ARG_LLONG :
+				(len == 1) ? KLOG_ARG_LONG : KLOG_ARG_INT;
+		break;
+	case 'p':
+		spec->arg = KLOG_ARG_PTR;
+		break;
+	case 's':
+		spec->arg = KLOG_ARG_STR;
+		break;
+	case 'f': case 'F': case 'e': case 'E':
+	case 'g': case 'G': case 'a': case 'A':
+		spec->arg = (len == 3) ? KLOG_ARG_LDOUBLE : KLOG_ARG_DOUBLE;
+		break;
+	case 'n':
+		/* not supported, but the argument must be skipped */
+		spec->arg = KLOG_ARG_PTR;
+		break;
+	default:
+		break;
+	}
+
+	spec->end = (*p != '\0') ? p + 1 : p;
+	return spec->end;
+}
+
+static int klog_put(struct klog_rec *rec, const void *val, size_t size) {
+	if (rec->len + size > KLOG_REC_SIZE) {
+		rec->truncated = 1;
+		return -1;
+	}
+	memcpy(rec->payload + rec->len, val, size);
+	rec->len += size;
+	return 0;
+}
+
+static void klog_pack(struct klog_rec *rec, const char *fmt, va_list args) {
+	struct klog_spec spec;
+	const char *p;
+	int i;
+
+	for (p = fmt; *p != '\0'; ) {
+		if (*p != '%') {
+			p++;
+			continue;
+		}
+		p = klog_spec_parse(p, &spec);
+
+		for (i = 0; i < spec.stars; i++) {
+			int star = va_arg(args, int);
+			if (klog_put(rec, &star, sizeof(star))) {
+				return;
+			}
+		}
+
+		switch (spec.arg) {
+		case KLOG_ARG_INT: {
+			int v = va_arg(args, int);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_LONG: {
+			long v = va_arg(args, long);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_LLONG: {
+			long long v = va_arg(args, long long);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_PTR: {
+			void *v = va_arg(args, void *);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_DOUBLE: {
+			double v = va_arg(args, double);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_LDOUBLE: {
+			long double v = va_arg(args, long double);
+			if (klog_put(rec, &v, sizeof(v))) {
+				return;
+			}
+			break;
+		}
+		case KLOG_ARG_STR: {
+			const char *s = va_arg(args, const char *);
+			size_t n;
+
+			if (s == NULL) {
+				s = "(null)";
+			}
+			if (rec->len >= KLOG_REC_SIZE) {
+				rec->truncated = 1;
+				return;
+			}
+			n = strlen(s);
+			/* Strings are cut to the space left, terminator is kept */
+			if (rec->len + n + 1 > KLOG_REC_SIZE) {
+				n = KLOG_REC_SIZE - rec->len - 1;
+				rec->truncated = 1;
+			}
+			memcpy(rec->payload + rec->len, s, n);
+			rec->payload[rec->len + n] = '\0';
+			rec->len += n + 1;
+			if (rec->truncated) {
+				return;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+/* Called with IRQs disabled, the window is shared by all CPUs */
+static int klog_rate_limited(clock_t now) {
+	int limited;
+
+	if (!KLOG_RATE_LIMIT) {
+		return 0;
+	}
+
+	spin_lock(&klog_rl_lock);
+	{
+		if (now - klog_rl_start >= ms2jiffies(1000)) {
+			klog_rl_start = now;
+			klog_rl_count = 0;
+		}
+
+		limited = ++klog_rl_count > KLOG_RATE_LIMIT;
+	}
+	spin_unlock(&klog_rl_lock);
+
+	return limited;
+}
+
+static void klog_kick(void) {
+	if (!__sync_lock_test_and_set(&klog_wake, 1)) {
+		waitq_wakeup_all(&klog_wq);
+	}
+}
+
+int vklog(int level, const char *fmt, va_list args) {
+	struct klog_ring *ring;
+	struct klog_rec *rec;
+	clock_t now;
+	ipl_t ipl;
+
+	now = clock_sys_ticks();
+
+	ipl = ipl_save();
+	{
+		ring = cpudata_ptr(&klog_ring);
+
+		if (klog_rate_limited(now)
+				|| ring->head - ring->tail >= KLOG_RECORDS) {
+			__sync_fetch_and_add(&klog_lost, 1);
+			ipl_restore(ipl);
+			klog_kick();
+			return -EAGAIN;
+		}
+
+		rec = &ring->rec[ring->head % KLOG_RECORDS];
+		rec->seq = __sync_fetch_and_add(&klog_seq, 1);
+		rec->time = now;
+		rec->fmt = fmt;
+		rec->level = level;
+		rec->truncated = 0;
+		rec->len = 0;
+		klog_pack(rec, fmt, args);
+
+		__sync_synchronize();
+		ring->head++;
+	}
+	ipl_restore(ipl);
+
+	klog_kick();
+
+	return 0;
+}
+
+int klog(int level, const char *fmt, ...) {
+	va_list args;
+	int ret;
+
+	va_start(args, fmt);
+	ret = vklog(level, fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+static int klog_get(const struct klog_rec *rec, size_t *off,
+		void *val, size_t size) {
+	if (*off + size > rec->len) {
+		return -1;
+	}
+	memcpy(val, rec->payload + *off, size);
+	*off += size;
+	return 0;
+}
+
+/* Builds printf spec from [begin, end) with '*' replaced by the values */
+static int klog_spec_build(char *buf, size_t size, const char *begin,
+		const char *end, const struct klog_rec *rec, size_t *off) {
+	size_t n = 0;
+	int star;
+
+	for (; begin < end && n < size - 1; begin++) {
+		if (*begin != '*') {
+			buf[n++] = *begin;
+			continue;
+		}
+		if (klog_get(rec, off, &star, sizeof(star))) {
+			return -1;
+		}
+		n += snprintf(buf + n, size - n, "%d", star);
+		n = min(n, size - 1);
+	}
+	buf[n] = '\0';
+	return 0;
+}
+
+static size_t klog_format(const struct klog_rec *rec, char *buf, size_t size) {
+	struct klog_spec spec;
+	char spec_buf[32];
+	const char *p, *begin;
+	size_t n, off = 0;
+	time64_t ms;
+	int ret;
+
+	ms = jiffies2ms(rec->time);
+	n = snprintf(buf, size, "[%5u.%03u] ",
+			(unsigned int) (ms / 1000), (unsigned int) (ms % 1000));
+
+	for (p = rec->fmt; *p != '\0' && n < size - 1; ) {
+		if (*p != '%') {
+			buf[n++] = *p++;
+			continue;
+		}
+
+		begin = p;
+		p = klog_spec_parse(p, &spec);
+
+		if (*(p - 1) == '%' && p - begin == 2) {
+			buf[n++] = '%';
+			continue;
+		}
+
+		if (klog_spec_build(spec_buf, sizeof(spec_buf), begin, p, rec, &off)) {
+			goto truncated;
+		}
+
+		ret = 0;
+		switch (spec.arg) {
+		case KLOG_ARG_INT: {
+			int v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			ret = snprintf(buf + n, size - n, spec_buf, v);
+			break;
+		}
+		case KLOG_ARG_LONG: {
+			long v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			ret = snprintf(buf + n, size - n, spec_buf, v);
+			break;
+		}
+		case KLOG_ARG_LLONG: {
+			long long v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			ret = snprintf(buf + n, size - n, spec_buf, v);
+			break;
+		}
+		case KLOG_ARG_PTR: {
+			void *v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			if (*(p - 1) != 'n') {
+				ret = snprintf(buf + n, size - n, spec_buf, v);
+			}
+			break;
+		}
+		case KLOG_ARG_DOUBLE: {
+			double v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			ret = snprintf(buf + n, size - n, spec_buf, v);
+			break;
+		}
+		case KLOG_ARG_LDOUBLE: {
+			long double v;
+			if (klog_get(rec, &off, &v, sizeof(v))) {
+				goto truncated;
+			}
+			ret = snprintf(buf + n, size - n, spec_buf, v);
+			break;
+		}
+		case KLOG_ARG_STR: {
+			const char *s = rec->payload + off;
+			if (off >= rec->len) {
+				goto truncated;
+			}
+			off += strlen(s) + 1;
+			ret = snprintf(buf + n, size - n, spec_buf, s);
+			if (off >= rec->len && rec->truncated) {
+				n = min(n + max(ret, 0), size - 1);
+				goto truncated;
+			}
+			break;
+		}
+		default:
+			/* Unknown conversion is printed as is */
+			ret = snprintf(buf + n, size - n, "%s", spec_buf);
+			break;
+		}
+
+		n = min(n + max(ret, 0), size - 1);
+	}
+
+	buf[n] = '\0';
+	return n;
+
+truncated:
+	n += snprintf(buf + n, size - n, "...\n");
+	return min(n, size - 1);
+}
+
+static void klog_history_write(const char *buf, size_t len) {
+	size_t pos;
+
+	while (len) {
+		size_t n;
+
+		pos = klog_history_total % KLOG_HISTORY_SIZE;
+		n = min(len, KLOG_HISTORY_SIZE - pos);
+		memcpy(klog_history + pos, buf, n);
+		klog_history_total += n;
+		buf += n;
+		len -= n;
+	}
+}
+
+static void klog_emit(int level, const char *buf, size_t len) {
+	const struct klog_sink *sink;
+
+	klog_history_write(buf, len);
+
+	array_spread_foreach(sink, __klog_sinks_registry) {
+		sink->write(level, buf, len);
+	}
+}
+
+/* Ring of the CPU holding the oldest queued record */
+static struct klog_ring *klog_oldest(void) {
+	struct klog_ring *ring, *oldest = NULL;
+	unsigned int seq = 0;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &klog_ring);
+		if (ring->head == ring->tail) {
+			continue;
+		}
+		if (!oldest || (int) (ring->rec[ring->tail % KLOG_RECORDS].seq - seq) < 0) {
+			oldest = ring;
+			seq = ring->rec[ring->tail % KLOG_RECORDS].seq;
+		}
+	}
+
+	return oldest;
+}
+
+void klog_flush(void) {
+	static char line[KLOG_LINE_SIZE];
+	struct klog_ring *ring;
+	struct klog_rec *rec;
+	unsigned int lost;
+	size_t len;
+
+	mutex_lock(&klog_mutex);
+
+	while ((ring = klog_oldest())) {
+		__sync_synchronize();
+		rec = &ring->rec[ring->tail % KLOG_RECORDS];
+		len = klog_format(rec, line, sizeof(line));
+		klog_emit(rec->level, line, len);
+		__sync_synchronize();
+		ring->tail++;
+	}
+
+	lost = klog_lost;
+	if (lost != klog_lost_reported) {
+		len = snprintf(line, sizeof(line), "klog: %u messages suppressed\n",
+				lost - klog_lost_reported);
+		klog_emit(LOG_WARNING, line, min(len, sizeof(line) - 1));
+		klog_lost_reported = lost;
+	}
+
+	mutex_unlock(&klog_mutex);
+}
+
+size_t klog_history_read(char *buf, size_t size, size_t *pos) {
+	size_t n, total, copied = 0;
+
+	mutex_lock(&klog_mutex);
+
+	total = klog_history_total;
+	if (total > KLOG_HISTORY_SIZE && *pos < total - KLOG_HISTORY_SIZE) {
+		/* Skip overwritten part */
+		*pos = total - KLOG_HISTORY_SIZE;
+	}
+
+	while (copied < size && *pos < total) {
+		n = min(size - copied, total - *pos);
+		n = min(n, KLOG_HISTORY_SIZE - *pos % KLOG_HISTORY_SIZE);
+		memcpy(buf + copied, klog_history + *pos % KLOG_HISTORY_SIZE, n);
+		copied += n;
+		*pos += n;
+	}
+
+	mutex_unlock(&klog_mutex);
+
+	return copied;
+}
+
+unsigned int klog_dropped(void) {
+	return klog_lost;
+}
+
+#if KLOG_DIAG_SINK
+static void klog_diag_write(int level, const char *buf, size_t len) {
+	if (level > KLOG_CONSOLE_LEVEL) {
+		return;
+	}
+	while (len--) {
+		diag_putc(*buf++);
+	}
+}
+
+static const struct klog_sink klog_diag_sink = {
+	.name  = "diag",
+	.write = klog_diag_write,
+};
+KLOG_SINK_DEF(klog_diag_sink);
+#endif
+
+static void *klog_thread_run(void *arg) {
+	while (1) {
+		WAITQ_WAIT(&klog_wq, klog_wake);
+		/* Cleared before draining, so records put meanwhile wake us again */
+		__sync_lock_release(&klog_wake);
+		klog_flush();
+	}
+
+	return NULL;
+}
+
+static int klog_init(void) {
+	struct thread *t;
+
+	t = thread_create(0, klog_thread_run, NULL);
+	if (err(t)) {
+		return err(t);
+	}
+
+	schedee_priority_set(&t->schedee, KLOG_PRIORITY);
+
+	return 0;
+}
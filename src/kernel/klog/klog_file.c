@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Kernel log sink appending messages to a file
+ *
+ * @date 17.10.2026
+ */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include <kernel/klog.h>
+
+#include <framework/mod/options.h>
+
+#define KLOG_FILE_PATH OPTION_STRING_GET(path)
+
+static int klog_file_fd = -1;
+
+static void klog_file_write(int level, const char *buf, size_t len) {
+	if (klog_file_fd < 0) {
+		/* File system may be mounted later than the first message */
+		klog_file_fd = open(KLOG_FILE_PATH, O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (klog_file_fd < 0) {
+			return;
+		}
+	}
+
+	if (write(klog_file_fd, buf, len) < 0) {
+		close(klog_file_fd);
+		klog_file_fd = -1;
+	}
+}
+
+static const struct klog_sink klog_file_sink = {
+	.name  = "file",
+	.write = klog_file_write,
+};
+KLOG_SINK_DEF(klog_file_sink);
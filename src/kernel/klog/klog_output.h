@@ -0,0 +1,22 @@
+/**
+ * @file
+ * @brief Logging through the asynchronous kernel log
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef KERNEL_KLOG_OUTPUT_H_
+#define KERNEL_KLOG_OUTPUT_H_
+
+#include <kernel/klog.h>
+
+#include <module/embox/compat/libc/stdio/print.h>
+
+#define __logging_vprint(level, fmt, args) \
+	vklog(level, fmt, args)
+
+/* Records keep the format, it is parsed only when printed */
+#define __logging_vprint_fmt(level, pfmt, args) \
+	vklog(level, (pfmt)->format, args)
+
+#endif /* KERNEL_KLOG_OUTPUT_H_ */
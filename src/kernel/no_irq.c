@@ -5,6 +5,9 @@
  * @author Anton Bondarev
  */
 
+#include <errno.h>
+#include <stddef.h>
+
 #include <kernel/irq.h>
 
 int irq_attach(unsigned int irq_nr, irq_handler_t handler,
@@ -15,3 +18,21 @@ int irq_attach(unsigned int irq_nr, irq_handler_t handler,
 int irq_detach(unsigned int irq_nr, void *data) {
 	return 0;
 }
+
+int irq_attach_threaded(unsigned int irq_nr, irq_handler_t handler,
+		irq_handler_t thread_fn, unsigned int flags, void *data,
+		const char *dev_name) {
+	return 0;
+}
+
+int irq_set_affinity(unsigned int irq_nr, unsigned int cpu) {
+	return -ENOSYS;
+}
+
+int irq_get_stat(unsigned int irq_nr, struct irq_stat *stat) {
+	return -ENOSYS;
+}
+
+const char *irq_get_dev_name(unsigned int irq_nr) {
+	return NULL;
+}
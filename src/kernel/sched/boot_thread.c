@@ -32,7 +32,7 @@ struct schedee *boot_thread_create(void) {
 	task_set_main(task_kernel_task(), bootstrap);
 	thread_set_current(bootstrap);
 
-	log_debug("boot_schedee = %#x", &bootstrap->schedee);
+	log_debug("boot_schedee = %p", &bootstrap->schedee);
 
 	return &bootstrap->schedee;
 }
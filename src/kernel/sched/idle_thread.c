@@ -33,7 +33,7 @@ int idle_thread_create(void) {
 
 	task_thread_register(task_kernel_task(), t);
 	schedee_priority_set(&t->schedee, SCHED_PRIORITY_MIN);
-	log_debug("idle_schedee = %#x", &t->schedee);
+	log_debug("idle_schedee = %p", &t->schedee);
 
 	cpu_init(cpu_get_id(), t);
 	thread_launch(t);
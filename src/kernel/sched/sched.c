@@ -321,7 +321,7 @@ static inline void __sched_wakeup_smp_inactive(struct schedee *s) {
 int __sched_wakeup(struct schedee *s) {
 	int was_waiting = (s->waiting && s->waiting != TW_SMP_WAKING);
 
-	log_debug("schedee #%x", s);
+	log_debug("schedee %p", s);
 
 	if (was_waiting)
 		/* Check if t->ready state is still set, and we can do
@@ -396,7 +396,7 @@ static void __schedule(int preempt) {
 		spin_unlock(&rq.lock);
 
 		schedee_set_current(next);
-		log_debug("prev: %#x, next: %#x", prev, next);
+		log_debug("prev: %p, next: %p", prev, next);
 
 		/* next->process has to enable ipl. */
 		next = next->process(prev, next);
@@ -14,10 +14,148 @@
 
 #include <fs/idesc.h>
 #include <kernel/task.h>
+#include <mem/sysmalloc.h>
 
 #include <kernel/task/resource/idesc_table.h>
-#include <util/array.h>
-#include <util/indexator.h>
+#include <util/bitmap.h>
+
+/* Descriptors in the chunk, the last one may be cut by the table size */
+static inline unsigned int idesc_chunk_bits(int n) {
+	unsigned int rest = MODOPS_IDESC_TABLE_SIZE - n * IDESC_CHUNK_SIZE;
+
+	return rest < IDESC_CHUNK_SIZE ? rest : IDESC_CHUNK_SIZE;
+}
+
+/* Directory of the chunks or NULL if not allocated yet */
+static inline struct idesc_table_dir *idesc_table_dir(struct idesc_table *t) {
+#if IDESC_TABLE_TWO_LEVEL
+	return t->dir;
+#else
+	return NULL;
+#endif
+}
+
+static inline int idesc_chunk_full(struct idesc_table_chunk *chunk, int n) {
+	unsigned int bits = idesc_chunk_bits(n);
+
+	return bitmap_find_zero_bit(chunk->used, bits, 0) == bits;
+}
+
+static inline struct idesc_table_chunk *idesc_table_chunk(
+		struct idesc_table *t, int n) {
+	if (n == 0) {
+		return &t->first;
+	}
+	return idesc_table_dir(t) ? idesc_table_dir(t)->chunk[n] : NULL;
+}
+
+/* Allocates the chunk if needed, called with the mutex held */
+static struct idesc_table_chunk *idesc_table_chunk_get(
+		struct idesc_table *t, int n) {
+#if IDESC_TABLE_TWO_LEVEL
+	struct idesc_table_dir *dir;
+	struct idesc_table_chunk *chunk;
+#endif
+
+	if (n == 0) {
+		return &t->first;
+	}
+
+#if IDESC_TABLE_TWO_LEVEL
+	dir = t->dir;
+	if (!dir) {
+		if (!(dir = sysmalloc(sizeof(*dir)))) {
+			return NULL;
+		}
+		memset(dir, 0, sizeof(*dir));
+		dir->chunk[0] = &t->first;
+		if (idesc_chunk_full(&t->first, 0)) {
+			bitmap_set_bit(dir->full, 0);
+		}
+		__atomic_store_n(&t->dir, dir, __ATOMIC_RELEASE);
+	}
+
+	chunk = dir->chunk[n];
+	if (!chunk) {
+		if (!(chunk = sysmalloc(sizeof(*chunk)))) {
+			return NULL;
+		}
+		memset(chunk, 0, sizeof(*chunk));
+		/* Lookups see the chunk only after it is zeroed */
+		__atomic_store_n(&dir->chunk[n], chunk, __ATOMIC_RELEASE);
+	}
+
+	return chunk;
+#else
+	return NULL;
+#endif
+}
+
+/* Lowest free index, called with the mutex held */
+static int idesc_table_find_free(struct idesc_table *t) {
+	struct idesc_table_chunk *chunk;
+	unsigned int n, bit;
+
+	n = 0;
+	if (idesc_chunk_full(&t->first, 0)) {
+		n = idesc_table_dir(t) ?
+			bitmap_find_zero_bit(idesc_table_dir(t)->full, IDESC_CHUNK_NUM, 1) : 1;
+		if (n >= IDESC_CHUNK_NUM) {
+			return -EMFILE;
+		}
+	}
+
+	if (!(chunk = idesc_table_chunk_get(t, n))) {
+		return -ENOMEM;
+	}
+
+	bit = bitmap_find_zero_bit(chunk->used, idesc_chunk_bits(n), 0);
+	assert(bit < idesc_chunk_bits(n));
+
+	return n * IDESC_CHUNK_SIZE + bit;
+}
+
+/* @a raw may carry the cloexec flag. Called with the mutex held */
+static void idesc_table_fill(struct idesc_table *t, int idx,
+		struct idesc *raw) {
+	struct idesc_table_chunk *chunk;
+	int n = idx / IDESC_CHUNK_SIZE;
+
+	chunk = idesc_table_chunk(t, n);
+	assert(chunk);
+	assert(!bitmap_test_bit(chunk->used, idx % IDESC_CHUNK_SIZE));
+
+	bitmap_set_bit(chunk->used, idx % IDESC_CHUNK_SIZE);
+	if (idesc_table_dir(t) && idesc_chunk_full(chunk, n)) {
+		bitmap_set_bit(idesc_table_dir(t)->full, n);
+	}
+
+	__atomic_store_n(&chunk->idesc[idx % IDESC_CHUNK_SIZE], raw,
+			__ATOMIC_RELEASE);
+}
+
+/* Next used index not less than @a idx or -1 */
+static int idesc_table_next(struct idesc_table *t, int idx) {
+	struct idesc_table_chunk *chunk;
+	unsigned int n, bit, start;
+
+	start = idx % IDESC_CHUNK_SIZE;
+	for (n = idx / IDESC_CHUNK_SIZE; n < IDESC_CHUNK_NUM; n++, start = 0) {
+		if (!(chunk = idesc_table_chunk(t, n))) {
+			if (!idesc_table_dir(t)) {
+				break;
+			}
+			continue;
+		}
+
+		bit = bitmap_find_bit(chunk->used, idesc_chunk_bits(n), start);
+		if (bit < idesc_chunk_bits(n)) {
+			return n * IDESC_CHUNK_SIZE + bit;
+		}
+	}
+
+	return -1;
+}
 
 int idesc_index_valid(int idx) {
 	return (idx >=0) && (idx < MODOPS_IDESC_TABLE_SIZE);
@@ -29,18 +167,20 @@ int idesc_table_add(struct idesc_table *t, struct idesc *idesc, int cloexec) {
 	assert(t);
 	assert(idesc);
 
-	idx = index_alloc(&t->indexator, INDEX_MIN);
-	if (idx == INDEX_NONE) {
-		return -EMFILE;
-	}
+	mutex_lock(&t->mutex);
 
-	idesc->idesc_count++;
+	idx = idesc_table_find_free(t);
+	if (idx >= 0) {
+		idesc->idesc_count++;
 
-	if (cloexec) {
-		idesc_cloexec_set(idesc);
+		if (cloexec) {
+			idesc_cloexec_set(idesc);
+		}
+
+		idesc_table_fill(t, idx, idesc);
 	}
 
-	t->idesc_table[idx] = idesc;
+	mutex_unlock(&t->mutex);
 
 	return idx;
 }
@@ -49,9 +189,13 @@ int idesc_table_lock(struct idesc_table *t, struct idesc *idesc, int idx, int cl
 	assert(t);
 	assert(idesc);
 	assert(idesc_index_valid(idx));
-	assert(!index_locked(&t->indexator, idx));
 
-	index_lock(&t->indexator, idx);
+	mutex_lock(&t->mutex);
+
+	if (!idesc_table_chunk_get(t, idx / IDESC_CHUNK_SIZE)) {
+		mutex_unlock(&t->mutex);
+		return -ENOMEM;
+	}
 
 	idesc->idesc_count++;
 
@@ -59,91 +203,155 @@ int idesc_table_lock(struct idesc_table *t, struct idesc *idesc, int idx, int cl
 		idesc_cloexec_set(idesc);
 	}
 
-	t->idesc_table[idx] = idesc;
+	idesc_table_fill(t, idx, idesc);
+
+	mutex_unlock(&t->mutex);
 
 	return idx;
 }
 
 int idesc_table_locked(struct idesc_table *t, int idx) {
+	struct idesc_table_chunk *chunk;
+
 	assert(t);
 	assert(idesc_index_valid(idx));
 
-	return index_locked(&t->indexator, idx);
+	chunk = idesc_table_chunk(t, idx / IDESC_CHUNK_SIZE);
+
+	return chunk && bitmap_test_bit(chunk->used, idx % IDESC_CHUNK_SIZE);
 }
 
 void idesc_table_del(struct idesc_table *t, int idx) {
+	struct idesc_table_chunk *chunk;
 	struct idesc *idesc;
+	int n = idx / IDESC_CHUNK_SIZE;
 
 	assert(t);
 	assert(idesc_index_valid(idx));
 
-	idesc = idesc_table_get(t, idx);
+	mutex_lock(&t->mutex);
+
+	chunk = idesc_table_chunk(t, n);
+	assert(chunk);
+
+	idesc = chunk->idesc[idx % IDESC_CHUNK_SIZE];
+	idesc_cloexec_clear(idesc);
 	assert(idesc);
 	assert(idesc->idesc_ops && idesc->idesc_ops->close);
 
+	__atomic_store_n(&chunk->idesc[idx % IDESC_CHUNK_SIZE], NULL,
+			__ATOMIC_RELEASE);
+	bitmap_clear_bit(chunk->used, idx % IDESC_CHUNK_SIZE);
+	if (idesc_table_dir(t)) {
+		bitmap_clear_bit(idesc_table_dir(t)->full, n);
+	}
+
+	mutex_unlock(&t->mutex);
+
+	/* Closing may block, the table is not held meanwhile */
 	if (!(--idesc->idesc_count)) {
 		idesc->idesc_ops->close(idesc);
 	}
+}
+
+int idesc_table_cloexec_get(struct idesc_table *t, int idx) {
+	struct idesc **slot;
+
+	assert(t);
+	assert(idesc_index_valid(idx));
 
-	index_free(&t->indexator, idx);
+	slot = idesc_table_slot(t, idx);
 
-	t->idesc_table[idx] = NULL;
+	return slot && idesc_is_cloexeced(*slot);
 }
 
-struct idesc *idesc_table_get(struct idesc_table *t, int idx) {
+void idesc_table_cloexec_set(struct idesc_table *t, int idx, int cloexec) {
+	struct idesc **slot;
 	struct idesc *idesc;
 
 	assert(t);
 	assert(idesc_index_valid(idx));
 
-	idesc = t->idesc_table[idx];
+	mutex_lock(&t->mutex);
 
-	return idesc_cloexec_clear(idesc);
-}
+	slot = idesc_table_slot(t, idx);
+	if (slot && *slot) {
+		idesc = *slot;
+		if (cloexec) {
+			idesc_cloexec_set(idesc);
+		} else {
+			idesc_cloexec_clear(idesc);
+		}
+		__atomic_store_n(slot, idesc, __ATOMIC_RELEASE);
+	}
 
+	mutex_unlock(&t->mutex);
+}
 
 void idesc_table_init(struct idesc_table *t) {
 	assert(t);
-	memset(t->idesc_table, 0, sizeof t->idesc_table);
-	index_init(&t->indexator, 0, ARRAY_SIZE(t->idesc_table),
-			t->index_buffer);
+	memset(&t->first, 0, sizeof t->first);
+#if IDESC_TABLE_TWO_LEVEL
+	t->dir = NULL;
+#endif
+	mutex_init(&t->mutex);
 }
 
 void idesc_table_finit(struct idesc_table *t) {
+#if IDESC_TABLE_TWO_LEVEL
+	struct idesc_table_dir *dir;
+	int n;
+#endif
 	int i;
-	struct idesc *idesc;
 
 	assert(t);
 
-	for(i = 0; i < ARRAY_SIZE(t->idesc_table); i++) {
-		if (t->idesc_table[i]) {
-			idesc = idesc_table_get(t, i);
-			assert(idesc);
-			idesc_table_del(t, i);
+	for (i = idesc_table_next(t, 0); i >= 0; i = idesc_table_next(t, i + 1)) {
+		idesc_table_del(t, i);
+	}
+
+#if IDESC_TABLE_TWO_LEVEL
+	dir = t->dir;
+	if (dir) {
+		t->dir = NULL;
+		for (n = 1; n < IDESC_CHUNK_NUM; n++) {
+			if (dir->chunk[n]) {
+				sysfree(dir->chunk[n]);
+			}
 		}
+		sysfree(dir);
 	}
+#endif
 }
 
 int idesc_table_fork(struct idesc_table *t, struct idesc_table *parent_table) {
+	struct idesc *raw, *idesc;
 	int i, ret;
-	struct idesc *idesc;
 
 	assert(t);
 	assert(parent_table);
 
 	/* idesc_table_init(t); -- not required (called after idesc_table_init) */
 
-	for (i = 0; i < ARRAY_SIZE(t->idesc_table); i++) {
-		if (parent_table->idesc_table[i]) {
-			idesc = idesc_table_get(parent_table, i);
-			assert(idesc);
-			if (!idesc_is_cloexeced(t->idesc_table[i])) {
-				ret = idesc_table_add(t, idesc, 0);
-				assert(ret >= 0); /* FIXME */
-			}
+	mutex_lock(&parent_table->mutex);
+
+	/* Descriptors keep their numbers and FD_CLOEXEC */
+	for (i = idesc_table_next(parent_table, 0); i >= 0;
+			i = idesc_table_next(parent_table, i + 1)) {
+		raw = *idesc_table_slot(parent_table, i);
+		idesc = raw;
+		idesc_cloexec_clear(idesc);
+		assert(idesc);
+
+		ret = idesc_table_lock(t, idesc, i, idesc_is_cloexeced(raw));
+		if (ret < 0) {
+			mutex_unlock(&parent_table->mutex);
+			return ret;
 		}
 	}
 
+	mutex_unlock(&parent_table->mutex);
+
 	return 0;
 }
 
@@ -34,29 +34,16 @@ struct idesc *index_descriptor_get(int idx) {
 }
 
 int index_descritor_cloexec_get(int fd) {
-	struct idesc_table *it;
 	int fd_flags = 0;
 
-	it = task_self_idesc_table();
-	assert(it);
-
-	if (idesc_is_cloexeced(it->idesc_table[fd])) {
+	if (idesc_table_cloexec_get(task_self_idesc_table(), fd)) {
 		fd_flags |= FD_CLOEXEC;
 	}
 	return fd_flags;
 }
 
 int index_descriptor_cloexec_set(int fd, int cloexec) {
-	struct idesc_table *it;
-
-	it = task_resource_idesc_table(task_self());
-	assert(it);
-
-	if (cloexec | FD_CLOEXEC) {
-		idesc_cloexec_set(it->idesc_table[fd]);
-	} else {
-		idesc_cloexec_clear(it->idesc_table[fd]);
-	}
+	idesc_table_cloexec_set(task_self_idesc_table(), fd, cloexec & FD_CLOEXEC);
 	return 0;
 }
 
@@ -11,26 +11,58 @@
 #define KERNEL_TASK_RESOURCE_IDESC_TABLE_H_
 
 #include <sys/cdefs.h>
+#include <assert.h>
 #include <stdint.h>
 
 #include <config/embox/kernel/task/resource/idesc_table.h>
 #include <framework/mod/options.h>
 #include <kernel/task.h>
-#include <util/indexator.h>
+#include <kernel/thread/sync/mutex.h>
+#include <util/bitmap.h>
 
+/* Maximum number of descriptors of a task */
 #define MODOPS_IDESC_TABLE_SIZE \
 	OPTION_MODULE_GET(embox__kernel__task__resource__idesc_table, \
 			NUMBER, idesc_table_size)
-struct idesc;
 
-struct idesc_table {
-	struct idesc *idesc_table[MODOPS_IDESC_TABLE_SIZE];
+/* A small table is a single chunk cut to its size */
+#define IDESC_CHUNK_MAX    64
+#define IDESC_CHUNK_SIZE \
+	(MODOPS_IDESC_TABLE_SIZE < IDESC_CHUNK_MAX ? \
+			MODOPS_IDESC_TABLE_SIZE : IDESC_CHUNK_MAX)
+#define IDESC_CHUNK_NUM \
+	((MODOPS_IDESC_TABLE_SIZE + IDESC_CHUNK_SIZE - 1) / IDESC_CHUNK_SIZE)
+
+/* Whether the table needs the second level at all */
+#define IDESC_TABLE_TWO_LEVEL (IDESC_CHUNK_NUM > 1)
 
-	struct indexator indexator;
-	index_data_t index_buffer[INDEX_DATA_LEN(MODOPS_IDESC_TABLE_SIZE)];
+struct idesc;
+
+struct idesc_table_chunk {
+	struct idesc *idesc[IDESC_CHUNK_SIZE];
+	unsigned long used[BITMAP_SIZE(IDESC_CHUNK_SIZE)];
 };
 
+/* Allocated when the first chunk is exhausted */
+struct idesc_table_dir {
+	unsigned long full[BITMAP_SIZE(IDESC_CHUNK_NUM)]; /* bit per chunk */
+	struct idesc_table_chunk *chunk[IDESC_CHUNK_NUM];
+};
 
+/**
+ * Two-level table: descriptors below IDESC_CHUNK_SIZE are kept right here,
+ * others in chunks allocated on demand. A table not larger than
+ * IDESC_CHUNK_MAX has no second level. Chunks are freed only with the
+ * table, so lookups read it without locking. Changes are serialized by
+ * the mutex.
+ */
+struct idesc_table {
+	struct idesc_table_chunk first;
+#if IDESC_TABLE_TWO_LEVEL
+	struct idesc_table_dir *dir;
+#endif
+	struct mutex mutex;
+};
 
 #define idesc_cloexec_set(desc) \
 	(desc = (struct idesc *)(((uintptr_t)desc) | 0x1))
@@ -60,7 +92,55 @@ extern void idesc_table_finit(struct idesc_table *t);
 
 extern int idesc_table_fork(struct idesc_table *t, struct idesc_table *par_tab);
 
-extern struct idesc *idesc_table_get(struct idesc_table *t, int idx);
+/* @return slot of the descriptor or NULL if its chunk is not allocated */
+static inline struct idesc **idesc_table_slot(struct idesc_table *t, int idx) {
+#if IDESC_TABLE_TWO_LEVEL
+	struct idesc_table_dir *dir;
+	struct idesc_table_chunk *chunk;
+#endif
+
+	if (idx < IDESC_CHUNK_SIZE) {
+		return &t->first.idesc[idx];
+	}
+
+#if IDESC_TABLE_TWO_LEVEL
+
+	dir = __atomic_load_n(&t->dir, __ATOMIC_ACQUIRE);
+	if (!dir) {
+		return NULL;
+	}
+	chunk = __atomic_load_n(&dir->chunk[idx / IDESC_CHUNK_SIZE],
+			__ATOMIC_ACQUIRE);
+	if (!chunk) {
+		return NULL;
+	}
+
+	return &chunk->idesc[idx % IDESC_CHUNK_SIZE];
+#else
+	return NULL;
+#endif
+}
+
+static inline struct idesc *idesc_table_get(struct idesc_table *t, int idx) {
+	struct idesc **slot;
+	struct idesc *idesc;
+
+	assert(t);
+	assert(idesc_index_valid(idx));
+
+	slot = idesc_table_slot(t, idx);
+	if (!slot) {
+		return NULL;
+	}
+	idesc = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+
+	return idesc_cloexec_clear(idesc);
+}
+
+extern int idesc_table_cloexec_get(struct idesc_table *t, int idx);
+
+extern void idesc_table_cloexec_set(struct idesc_table *t, int idx,
+		int cloexec);
 
 extern struct idesc_table * task_resource_idesc_table(
 		const struct task *task);
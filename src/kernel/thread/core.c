@@ -232,6 +232,8 @@ void thread_init(struct thread *t, int priority,
 
 	/* initialize everthing else */
 	thread_wait_init(&t->thread_wait);
+
+	thread_pmu_init(&t->pmu);
 }
 
 struct thread *thread_init_stack(void *stack, size_t stack_sz,
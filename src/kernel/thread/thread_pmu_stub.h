@@ -0,0 +1,24 @@
+/**
+ * @file
+ * @brief
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef THREAD_PMU_STUB_H_
+#define THREAD_PMU_STUB_H_
+
+struct thread_pmu {
+
+};
+
+static inline void thread_pmu_init(struct thread_pmu *tp) {
+	(void) tp;
+}
+
+static inline void thread_pmu_switch(struct thread_pmu *prev,
+		struct thread_pmu *next) {
+	(void) prev; (void) next;
+}
+
+#endif /* THREAD_PMU_STUB_H_ */
@@ -30,6 +30,7 @@ static void thread_prepare_switch(struct thread *prev, struct thread *next) {
 	sched_ticker_switch(prev->policy, next->policy);
 	prev->critical_count = critical_count();
 	critical_count() = next->critical_count;
+	thread_pmu_switch(&prev->pmu, &next->pmu);
 	sched_start_switch(&next->schedee);
 }
 
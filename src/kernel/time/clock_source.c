@@ -226,8 +226,13 @@ struct dlist_head *clock_source_get_list(void) {
 time64_t clock_source_get_hwcycles(struct clock_source *cs) {
 	int load;
 
-	/* TODO: support for counter-less and event-less clock sources */
-	assert(cs->event_device && cs->counter_device);
+	/* TODO: support for counter-less clock sources */
+	assert(cs->counter_device);
+
+	if (!cs->event_device) {
+		/* Counter-only sources (TSC, HPET) have no jiffies to add */
+		return cs->counter_device->read();
+	}
 
 	load = cs->counter_device->cycle_hz / cs->event_device->event_hz;
 	return ((uint64_t) cs->jiffies) * load + cs->counter_device->read();
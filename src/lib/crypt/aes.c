@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @brief AES block cipher (FIPS 197)
+ *
+ * @details Table-driven implementation: a round is 16 lookups into one
+ *   1 Kb table per direction, the other three tables of the classic 32-bit
+ *   implementation are its rotations. Tables are built on first key setup.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/crypt/aes.h>
+
+static uint8_t aes_sbox[256];
+static uint8_t aes_isbox[256];
+static uint32_t aes_te[256]; /* {2, 1, 1, 3} * S[x] */
+static uint32_t aes_td[256]; /* {14, 9, 13, 11} * S^-1[x] */
+static volatile int aes_tab_ready;
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTL8(x, n)  ((uint8_t) (((x) << (n)) | ((x) >> (8 - (n)))))
+
+#define TE0(x) aes_te[x]
+#define TE1(x) ROTR32(aes_te[x], 8)
+#define TE2(x) ROTR32(aes_te[x], 16)
+#define TE3(x) ROTR32(aes_te[x], 24)
+
+#define TD0(x) aes_td[x]
+#define TD1(x) ROTR32(aes_td[x], 8)
+#define TD2(x) ROTR32(aes_td[x], 16)
+#define TD3(x) ROTR32(aes_td[x], 24)
+
+#define B0(x) ((x) >> 24)
+#define B1(x) (((x) >> 16) & 0xff)
+#define B2(x) (((x) >> 8) & 0xff)
+#define B3(x) ((x) & 0xff)
+
+#define LOAD_BE32(p) \
+	(((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) \
+		| ((uint32_t) (p)[2] << 8) | (uint32_t) (p)[3])
+
+#define STORE_BE32(p, v) \
+	do { \
+		(p)[0] = (uint8_t) ((v) >> 24); \
+		(p)[1] = (uint8_t) ((v) >> 16); \
+		(p)[2] = (uint8_t) ((v) >> 8); \
+		(p)[3] = (uint8_t) (v); \
+	} while (0)
+
+/* Building the tables twice from two threads writes the same values */
+static void aes_tab_init(void) {
+	uint8_t pow[256], log[256];
+	uint8_t x, s;
+	int i;
+
+#define GF_MUL(a, b) \
+	((a) && (b) ? pow[(log[a] + log[b]) % 255] : 0)
+
+	/* 3 generates the multiplicative group of GF(2^8) */
+	x = 1;
+	for (i = 0; i < 256; i++) {
+		pow[i] = x;
+		log[x] = i;
+		x ^= (x << 1) ^ ((x & 0x80) ? 0x1b : 0);
+	}
+
+	for (i = 0; i < 256; i++) {
+		x = i ? pow[255 - log[i]] : 0;
+		s = x ^ ROTL8(x, 1) ^ ROTL8(x, 2) ^ ROTL8(x, 3) ^ ROTL8(x, 4) ^ 0x63;
+		aes_sbox[i] = s;
+		aes_isbox[s] = i;
+	}
+
+	for (i = 0; i < 256; i++) {
+		s = aes_sbox[i];
+		aes_te[i] = ((uint32_t) GF_MUL(s, 2) << 24) | ((uint32_t) s << 16)
+			| ((uint32_t) s << 8) | GF_MUL(s, 3);
+
+		s = aes_isbox[i];
+		aes_td[i] = ((uint32_t) GF_MUL(s, 14) << 24)
+			| ((uint32_t) GF_MUL(s, 9) << 16)
+			| ((uint32_t) GF_MUL(s, 13) << 8) | GF_MUL(s, 11);
+	}
+#undef GF_MUL
+
+	__sync_synchronize();
+	aes_tab_ready = 1;
+}
+
+static uint32_t aes_sub_word(uint32_t w) {
+	return ((uint32_t) aes_sbox[B0(w)] << 24)
+		| ((uint32_t) aes_sbox[B1(w)] << 16)
+		| ((uint32_t) aes_sbox[B2(w)] << 8) | aes_sbox[B3(w)];
+}
+
+int aes_set_encrypt_key(struct aes_ctx *ctx, const uint8_t *key,
+		size_t key_len) {
+	uint32_t *rk = ctx->rk;
+	uint32_t t, rcon;
+	int nk, i;
+
+	if ((key_len != 16) && (key_len != 24) && (key_len != 32)) {
+		return -EINVAL;
+	}
+	if (!aes_tab_ready) {
+		aes_tab_init();
+	}
+
+	nk = key_len / 4;
+	ctx->rounds = nk + 6;
+
+	for (i = 0; i < nk; i++) {
+		rk[i] = LOAD_BE32(key + 4 * i);
+	}
+
+	rcon = 0x01;
+	for (i = nk; i < 4 * (ctx->rounds + 1); i++) {
+		t = rk[i - 1];
+		if (i % nk == 0) {
+			t = aes_sub_word(ROTR32(t, 24)) ^ (rcon << 24);
+			rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x1b : 0);
+		} else if ((nk > 6) && (i % nk == 4)) {
+			t = aes_sub_word(t);
+		}
+		rk[i] = rk[i - nk] ^ t;
+	}
+
+	return 0;
+}
+
+/* The equivalent inverse cipher: round keys in reverse order, with
+ * InvMixColumns applied to all but the first and the last one */
+int aes_set_decrypt_key(struct aes_ctx *ctx, const uint8_t *key,
+		size_t key_len) {
+	struct aes_ctx enc;
+	uint32_t w;
+	int ret, r, i;
+
+	ret = aes_set_encrypt_key(&enc, key, key_len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ctx->rounds = enc.rounds;
+	for (r = 0; r <= enc.rounds; r++) {
+		for (i = 0; i < 4; i++) {
+			w = enc.rk[4 * (enc.rounds - r) + i];
+			if ((r != 0) && (r != enc.rounds)) {
+				w = TD0(aes_sbox[B0(w)]) ^ TD1(aes_sbox[B1(w)])
+					^ TD2(aes_sbox[B2(w)]) ^ TD3(aes_sbox[B3(w)]);
+			}
+			ctx->rk[4 * r + i] = w;
+		}
+	}
+
+	memset(&enc, 0, sizeof(enc));
+
+	return 0;
+}
+
+void aes_encrypt(const struct aes_ctx *ctx, const uint8_t in[16],
+		uint8_t out[16]) {
+	const uint32_t *rk = ctx->rk;
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	int r;
+
+	s0 = LOAD_BE32(in) ^ rk[0];
+	s1 = LOAD_BE32(in + 4) ^ rk[1];
+	s2 = LOAD_BE32(in + 8) ^ rk[2];
+	s3 = LOAD_BE32(in + 12) ^ rk[3];
+
+	for (r = 1; r < ctx->rounds; r++) {
+		rk += 4;
+		t0 = TE0(B0(s0)) ^ TE1(B1(s1)) ^ TE2(B2(s2)) ^ TE3(B3(s3)) ^ rk[0];
+		t1 = TE0(B0(s1)) ^ TE1(B1(s2)) ^ TE2(B2(s3)) ^ TE3(B3(s0)) ^ rk[1];
+		t2 = TE0(B0(s2)) ^ TE1(B1(s3)) ^ TE2(B2(s0)) ^ TE3(B3(s1)) ^ rk[2];
+		t3 = TE0(B0(s3)) ^ TE1(B1(s0)) ^ TE2(B2(s1)) ^ TE3(B3(s2)) ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+	rk += 4;
+
+#define FINAL(a, b, c, d, k) \
+	(((uint32_t) aes_sbox[B0(a)] << 24) ^ ((uint32_t) aes_sbox[B1(b)] << 16) \
+		^ ((uint32_t) aes_sbox[B2(c)] << 8) ^ aes_sbox[B3(d)] ^ (k))
+	t0 = FINAL(s0, s1, s2, s3, rk[0]);
+	t1 = FINAL(s1, s2, s3, s0, rk[1]);
+	t2 = FINAL(s2, s3, s0, s1, rk[2]);
+	t3 = FINAL(s3, s0, s1, s2, rk[3]);
+#undef FINAL
+
+	STORE_BE32(out, t0);
+	STORE_BE32(out + 4, t1);
+	STORE_BE32(out + 8, t2);
+	STORE_BE32(out + 12, t3);
+}
+
+void aes_decrypt(const struct aes_ctx *ctx, const uint8_t in[16],
+		uint8_t out[16]) {
+	const uint32_t *rk = ctx->rk;
+	uint32_t s0, s1, s2, s3, t0, t1, t2, t3;
+	int r;
+
+	s0 = LOAD_BE32(in) ^ rk[0];
+	s1 = LOAD_BE32(in + 4) ^ rk[1];
+	s2 = LOAD_BE32(in + 8) ^ rk[2];
+	s3 = LOAD_BE32(in + 12) ^ rk[3];
+
+	for (r = 1; r < ctx->rounds; r++) {
+		rk += 4;
+		t0 = TD0(B0(s0)) ^ TD1(B1(s3)) ^ TD2(B2(s2)) ^ TD3(B3(s1)) ^ rk[0];
+		t1 = TD0(B0(s1)) ^ TD1(B1(s0)) ^ TD2(B2(s3)) ^ TD3(B3(s2)) ^ rk[1];
+		t2 = TD0(B0(s2)) ^ TD1(B1(s1)) ^ TD2(B2(s0)) ^ TD3(B3(s3)) ^ rk[2];
+		t3 = TD0(B0(s3)) ^ TD1(B1(s2)) ^ TD2(B2(s1)) ^ TD3(B3(s0)) ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+	rk += 4;
+
+#define FINAL(a, b, c, d, k) \
+	(((uint32_t) aes_isbox[B0(a)] << 24) ^ ((uint32_t) aes_isbox[B1(b)] << 16) \
+		^ ((uint32_t) aes_isbox[B2(c)] << 8) ^ aes_isbox[B3(d)] ^ (k))
+	t0 = FINAL(s0, s3, s2, s1, rk[0]);
+	t1 = FINAL(s1, s0, s3, s2, rk[1]);
+	t2 = FINAL(s2, s1, s0, s3, rk[2]);
+	t3 = FINAL(s3, s2, s1, s0, rk[3]);
+#undef FINAL
+
+	STORE_BE32(out, t0);
+	STORE_BE32(out + 4, t1);
+	STORE_BE32(out + 8, t2);
+	STORE_BE32(out + 12, t3);
+}
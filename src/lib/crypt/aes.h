@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @brief AES block cipher (FIPS 197) and XTS mode (IEEE 1619)
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef LIB_AES_H_
+#define LIB_AES_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AES_BLOCK_SIZE 16
+#define AES_MAX_ROUNDS 14
+
+struct aes_ctx {
+	uint32_t rk[4 * (AES_MAX_ROUNDS + 1)]; /* expanded round keys */
+	int rounds;
+};
+
+/**
+ * Expands a 16, 24 or 32 bytes long key for encryption or decryption.
+ * @return 0 or -EINVAL on wrong key length
+ */
+extern int aes_set_encrypt_key(struct aes_ctx *ctx, const uint8_t *key,
+		size_t key_len);
+extern int aes_set_decrypt_key(struct aes_ctx *ctx, const uint8_t *key,
+		size_t key_len);
+
+extern void aes_encrypt(const struct aes_ctx *ctx, const uint8_t in[16],
+		uint8_t out[16]);
+extern void aes_decrypt(const struct aes_ctx *ctx, const uint8_t in[16],
+		uint8_t out[16]);
+
+struct xts_ctx {
+	struct aes_ctx enc;   /* data key, encryption schedule */
+	struct aes_ctx dec;   /* data key, decryption schedule */
+	struct aes_ctx tweak; /* tweak key */
+};
+
+/**
+ * Sets the XTS key: the data key followed by the tweak key of the same size,
+ * 32 bytes for AES-128 or 64 bytes for AES-256.
+ * @return 0 or -EINVAL on wrong key length
+ */
+extern int xts_set_key(struct xts_ctx *ctx, const uint8_t *key, size_t key_len);
+
+/**
+ * Encrypts or decrypts len bytes of consecutive data units of unit_size
+ * bytes, the first of them numbered unit. Data may be processed in place.
+ * @return 0 or -EINVAL if len is not a multiple of unit_size or unit_size
+ *   is not a multiple of AES_BLOCK_SIZE
+ */
+extern int xts_encrypt(const struct xts_ctx *ctx, uint64_t unit,
+		size_t unit_size, const uint8_t *in, uint8_t *out, size_t len);
+extern int xts_decrypt(const struct xts_ctx *ctx, uint64_t unit,
+		size_t unit_size, const uint8_t *in, uint8_t *out, size_t len);
+
+#endif /* LIB_AES_H_ */
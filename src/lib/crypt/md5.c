@@ -51,6 +51,7 @@
   1999-05-03 lpd Original version.
  */
 
+#include <stdint.h>
 #include <string.h>
 #include <endian.h>
 
@@ -139,9 +140,12 @@ md5_byte_t *md5_count(const md5_byte_t *ptr, size_t n, md5_byte_t digest[16]) {
 	return digest;
 }
 
-static void md5_process(md5_state_t *pms, const md5_byte_t *data /*[64]*/) {
+/* Processes nblocks 64-byte blocks keeping the digest in registers */
+static void md5_process(md5_state_t *pms, const md5_byte_t *data,
+		size_t nblocks) {
 	md5_word_t a = pms->abcd[0], b = pms->abcd[1], c = pms->abcd[2], d =
 			pms->abcd[3];
+	md5_word_t aa, bb, cc, dd;
 	md5_word_t t;
 #if MD5_BYTE_ORDER > 0
 	/* Define storage only for big-endian CPUs. */
@@ -152,6 +156,12 @@ static void md5_process(md5_state_t *pms, const md5_byte_t *data /*[64]*/) {
 	const md5_word_t *X;
 #endif
 
+next_block:
+	aa = a;
+	bb = b;
+	cc = c;
+	dd = d;
+
 	{
 #if MD5_BYTE_ORDER == 0
 		/*
@@ -207,7 +217,7 @@ static void md5_process(md5_state_t *pms, const md5_byte_t *data /*[64]*/) {
 	/* Round 1. */
 	/* Let [abcd k s i] denote the operation
 	 * a = b + ((a + F(b,c,d) + X[k] + T[i]) <<< s). */
-#define F(x, y, z) (((x) & (y)) | (~(x) & (z)))
+#define F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
 #define SET(a, b, c, d, k, s, Ti)\
 	t = a + F(b,c,d) + X[k] + Ti;\
 	a = ROTATE_LEFT(t, s) + b
@@ -233,7 +243,7 @@ static void md5_process(md5_state_t *pms, const md5_byte_t *data /*[64]*/) {
 	/* Round 2. */
 	/* Let [abcd k s i] denote the operation
 	 * a = b + ((a + G(b,c,d) + X[k] + T[i]) <<< s). */
-#define G(x, y, z) (((x) & (z)) | ((y) & ~(z)))
+#define G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
 #define SET(a, b, c, d, k, s, Ti)\
 	t = a + G(b,c,d) + X[k] + Ti;\
 	a = ROTATE_LEFT(t, s) + b
@@ -311,10 +321,20 @@ static void md5_process(md5_state_t *pms, const md5_byte_t *data /*[64]*/) {
 	/* Then perform the following additions. (That is increment each
 	 * of the four registers by the value it had before this block
 	 * was started.) */
-	pms->abcd[0] += a;
-	pms->abcd[1] += b;
-	pms->abcd[2] += c;
-	pms->abcd[3] += d;
+	a += aa;
+	b += bb;
+	c += cc;
+	d += dd;
+
+	if (--nblocks) {
+		data += 64;
+		goto next_block;
+	}
+
+	pms->abcd[0] = a;
+	pms->abcd[1] = b;
+	pms->abcd[2] = c;
+	pms->abcd[3] = d;
 }
 
 void md5_init(md5_state_t *pms) {
@@ -325,18 +345,18 @@ void md5_init(md5_state_t *pms) {
 	pms->abcd[3] = 0x10325476;
 }
 
-void md5_append(md5_state_t *pms, const md5_byte_t *data, int nbytes) {
+void md5_append(md5_state_t *pms, const md5_byte_t *data, size_t nbytes) {
 	const md5_byte_t *p = data;
-	int left = nbytes;
-	int offset = (pms->count[0] >> 3) & 63;
+	size_t left = nbytes;
+	size_t offset = (pms->count[0] >> 3) & 63;
 	md5_word_t nbits = (md5_word_t) (nbytes << 3);
 
-	if (nbytes <= 0) {
+	if (nbytes == 0) {
 		return;
 	}
 
 	/* Update the message length. */
-	pms->count[1] += nbytes >> 29;
+	pms->count[1] += (md5_word_t) ((uint64_t) nbytes >> 29);
 	pms->count[0] += nbits;
 	if (pms->count[0] < nbits) {
 		pms->count[1]++;
@@ -344,19 +364,21 @@ void md5_append(md5_state_t *pms, const md5_byte_t *data, int nbytes) {
 
 	/* Process an initial partial block. */
 	if (offset) {
-		int copy = (offset + nbytes > 64 ? 64 - offset : nbytes);
+		size_t copy = (offset + nbytes > 64 ? 64 - offset : nbytes);
 
 		memcpy(pms->buf + offset, p, copy);
 		if (offset + copy < 64)
 			return;
 		p += copy;
 		left -= copy;
-		md5_process(pms, pms->buf);
+		md5_process(pms, pms->buf, 1);
 	}
 
 	/* Process full blocks. */
-	for (; left >= 64; p += 64, left -= 64) {
-		md5_process(pms, p);
+	if (left >= 64) {
+		md5_process(pms, p, left / 64);
+		p += left & ~(size_t) 63;
+		left &= 63;
 	}
 
 	/* Process a final partial block. */
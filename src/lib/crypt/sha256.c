@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief SHA-256 (FIPS 180-4)
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/crypt/sha256.h>
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR(x, n)  (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define CH(x, y, z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define S0(x) (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define S1(x) (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define s0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define s1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+#define LOAD_BE32(p) \
+	(((uint32_t) (p)[0] << 24) | ((uint32_t) (p)[1] << 16) \
+		| ((uint32_t) (p)[2] << 8) | (uint32_t) (p)[3])
+
+/* The message schedule is kept as a 16 word ring instead of 64 words */
+#define W(i) w[(i) & 15]
+#define SCHED(i) \
+	(W(i) += s1(W((i) - 2)) + W((i) - 7) + s0(W((i) - 15)))
+
+/* Rounds rename the variables instead of shifting them */
+#define ROUND(a, b, c, d, e, f, g, h, i, wi) \
+	t = h + S1(e) + CH(e, f, g) + sha256_k[i] + (wi); \
+	d += t; \
+	h = t + S0(a) + MAJ(a, b, c)
+
+#define ROUNDS8(i, wfn) \
+	ROUND(a, b, c, d, e, f, g, h, (i) + 0, wfn((i) + 0)); \
+	ROUND(h, a, b, c, d, e, f, g, (i) + 1, wfn((i) + 1)); \
+	ROUND(g, h, a, b, c, d, e, f, (i) + 2, wfn((i) + 2)); \
+	ROUND(f, g, h, a, b, c, d, e, (i) + 3, wfn((i) + 3)); \
+	ROUND(e, f, g, h, a, b, c, d, (i) + 4, wfn((i) + 4)); \
+	ROUND(d, e, f, g, h, a, b, c, (i) + 5, wfn((i) + 5)); \
+	ROUND(c, d, e, f, g, h, a, b, (i) + 6, wfn((i) + 6)); \
+	ROUND(b, c, d, e, f, g, h, a, (i) + 7, wfn((i) + 7))
+
+static void sha256_process(sha256_state_t *st, const uint8_t *data,
+		size_t nblocks) {
+	uint32_t a, b, c, d, e, f, g, h, t;
+	uint32_t w[16];
+	int i;
+
+	a = st->h[0]; b = st->h[1]; c = st->h[2]; d = st->h[3];
+	e = st->h[4]; f = st->h[5]; g = st->h[6]; h = st->h[7];
+
+	while (nblocks--) {
+		for (i = 0; i < 16; i++) {
+			w[i] = LOAD_BE32(data + 4 * i);
+		}
+
+		ROUNDS8(0, W);
+		ROUNDS8(8, W);
+		ROUNDS8(16, SCHED);
+		ROUNDS8(24, SCHED);
+		ROUNDS8(32, SCHED);
+		ROUNDS8(40, SCHED);
+		ROUNDS8(48, SCHED);
+		ROUNDS8(56, SCHED);
+
+		a = st->h[0] += a; b = st->h[1] += b;
+		c = st->h[2] += c; d = st->h[3] += d;
+		e = st->h[4] += e; f = st->h[5] += f;
+		g = st->h[6] += g; h = st->h[7] += h;
+
+		data += SHA256_BLOCK_SIZE;
+	}
+}
+
+void sha256_init(sha256_state_t *st) {
+	st->h[0] = 0x6a09e667;
+	st->h[1] = 0xbb67ae85;
+	st->h[2] = 0x3c6ef372;
+	st->h[3] = 0xa54ff53a;
+	st->h[4] = 0x510e527f;
+	st->h[5] = 0x9b05688c;
+	st->h[6] = 0x1f83d9ab;
+	st->h[7] = 0x5be0cd19;
+	st->count = 0;
+}
+
+void sha256_append(sha256_state_t *st, const void *data, size_t len) {
+	const uint8_t *p = data;
+	size_t offset = st->count & (SHA256_BLOCK_SIZE - 1);
+	size_t copy;
+
+	st->count += len;
+
+	/* Process an initial partial block. */
+	if (offset) {
+		copy = SHA256_BLOCK_SIZE - offset;
+		if (copy > len) {
+			copy = len;
+		}
+		memcpy(st->buf + offset, p, copy);
+		if (offset + copy < SHA256_BLOCK_SIZE) {
+			return;
+		}
+		p += copy;
+		len -= copy;
+		sha256_process(st, st->buf, 1);
+	}
+
+	/* Process full blocks straight from the data. */
+	if (len >= SHA256_BLOCK_SIZE) {
+		sha256_process(st, p, len / SHA256_BLOCK_SIZE);
+		p += len & ~(size_t) (SHA256_BLOCK_SIZE - 1);
+		len &= SHA256_BLOCK_SIZE - 1;
+	}
+
+	/* Keep a final partial block. */
+	if (len) {
+		memcpy(st->buf, p, len);
+	}
+}
+
+void sha256_finish(sha256_state_t *st, uint8_t digest[SHA256_DIGEST_SIZE]) {
+	size_t offset = st->count & (SHA256_BLOCK_SIZE - 1);
+	uint64_t nbits = st->count << 3;
+	int i;
+
+	st->buf[offset++] = 0x80;
+	if (offset > SHA256_BLOCK_SIZE - 8) {
+		memset(st->buf + offset, 0, SHA256_BLOCK_SIZE - offset);
+		sha256_process(st, st->buf, 1);
+		offset = 0;
+	}
+	memset(st->buf + offset, 0, SHA256_BLOCK_SIZE - 8 - offset);
+
+	for (i = 0; i < 8; i++) {
+		st->buf[SHA256_BLOCK_SIZE - 1 - i] = (uint8_t) (nbits >> (8 * i));
+	}
+	sha256_process(st, st->buf, 1);
+
+	for (i = 0; i < 8; i++) {
+		digest[4 * i + 0] = (uint8_t) (st->h[i] >> 24);
+		digest[4 * i + 1] = (uint8_t) (st->h[i] >> 16);
+		digest[4 * i + 2] = (uint8_t) (st->h[i] >> 8);
+		digest[4 * i + 3] = (uint8_t) st->h[i];
+	}
+}
+
+uint8_t *sha256_count(const void *data, size_t len,
+		uint8_t digest[SHA256_DIGEST_SIZE]) {
+	sha256_state_t st;
+
+	sha256_init(&st);
+	sha256_append(&st, data, len);
+	sha256_finish(&st, digest);
+
+	return digest;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file
+ * @brief SHA-256 (FIPS 180-4)
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef LIB_SHA256_H_
+#define LIB_SHA256_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE  64
+
+typedef struct sha256_state {
+	uint32_t h[8];
+	uint64_t count;                   /* message length in bytes */
+	uint8_t buf[SHA256_BLOCK_SIZE];   /* accumulate block */
+} sha256_state_t;
+
+extern void sha256_init(sha256_state_t *st);
+extern void sha256_append(sha256_state_t *st, const void *data, size_t len);
+extern void sha256_finish(sha256_state_t *st,
+		uint8_t digest[SHA256_DIGEST_SIZE]);
+
+extern uint8_t *sha256_count(const void *data, size_t len,
+		uint8_t digest[SHA256_DIGEST_SIZE]);
+
+#endif /* LIB_SHA256_H_ */
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief XTS-AES mode (IEEE 1619) for data units of whole cipher blocks
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/crypt/aes.h>
+
+int xts_set_key(struct xts_ctx *ctx, const uint8_t *key, size_t key_len) {
+	size_t half = key_len / 2;
+	int ret;
+
+	if ((key_len != 32) && (key_len != 64)) {
+		return -EINVAL;
+	}
+
+	if ((0 != (ret = aes_set_encrypt_key(&ctx->enc, key, half)))
+			|| (0 != (ret = aes_set_decrypt_key(&ctx->dec, key, half)))
+			|| (0 != (ret = aes_set_encrypt_key(&ctx->tweak, key + half, half)))) {
+		return ret;
+	}
+
+	return 0;
+}
+
+static inline void xts_xor(uint8_t *dst, const uint8_t *a, const uint8_t *b) {
+	uint32_t x[4], y[4];
+	int i;
+
+	memcpy(x, a, AES_BLOCK_SIZE);
+	memcpy(y, b, AES_BLOCK_SIZE);
+	for (i = 0; i < 4; i++) {
+		x[i] ^= y[i];
+	}
+	memcpy(dst, x, AES_BLOCK_SIZE);
+}
+
+/* Multiplies the tweak by x in GF(2^128), bytes are little-endian */
+static inline void xts_mul_alpha(uint8_t t[AES_BLOCK_SIZE]) {
+	uint8_t carry = t[AES_BLOCK_SIZE - 1] >> 7;
+	int i;
+
+	for (i = AES_BLOCK_SIZE - 1; i > 0; i--) {
+		t[i] = (t[i] << 1) | (t[i - 1] >> 7);
+	}
+	t[0] = (t[0] << 1) ^ (carry ? 0x87 : 0);
+}
+
+static int xts_crypt(const struct xts_ctx *ctx, const struct aes_ctx *key,
+		void (*cipher)(const struct aes_ctx *, const uint8_t *, uint8_t *),
+		uint64_t unit, size_t unit_size,
+		const uint8_t *in, uint8_t *out, size_t len) {
+	uint8_t t[AES_BLOCK_SIZE], buf[AES_BLOCK_SIZE];
+	size_t off;
+	int i;
+
+	if ((unit_size == 0) || (unit_size % AES_BLOCK_SIZE)
+			|| (len % unit_size)) {
+		return -EINVAL;
+	}
+
+	for (; len != 0; len -= unit_size, unit++) {
+		for (i = 0; i < AES_BLOCK_SIZE; i++) {
+			t[i] = i < 8 ? (uint8_t) (unit >> (8 * i)) : 0;
+		}
+		aes_encrypt(&ctx->tweak, t, t);
+
+		for (off = 0; off < unit_size; off += AES_BLOCK_SIZE) {
+			xts_xor(buf, in, t);
+			cipher(key, buf, buf);
+			xts_xor(out, buf, t);
+			xts_mul_alpha(t);
+
+			in += AES_BLOCK_SIZE;
+			out += AES_BLOCK_SIZE;
+		}
+	}
+
+	return 0;
+}
+
+int xts_encrypt(const struct xts_ctx *ctx, uint64_t unit, size_t unit_size,
+		const uint8_t *in, uint8_t *out, size_t len) {
+	return xts_crypt(ctx, &ctx->enc, aes_encrypt, unit, unit_size,
+			in, out, len);
+}
+
+int xts_decrypt(const struct xts_ctx *ctx, uint64_t unit, size_t unit_size,
+		const uint8_t *in, uint8_t *out, size_t len) {
+	return xts_crypt(ctx, &ctx->dec, aes_decrypt, unit, unit_size,
+			in, out, len);
+}
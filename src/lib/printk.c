@@ -32,3 +32,7 @@ int printk(const char *format, ...) {
 int vprintk(const char *format, va_list args) {
 	return __print(printk_printchar, NULL, format, args);
 }
+
+int vprintk_fmt(struct print_fmt *fmt, va_list args) {
+	return __print_fmt(printk_printchar, NULL, NULL, fmt, args);
+}
@@ -9,6 +9,7 @@
 
 #include <embox/unit.h>
 #include <mem/page.h>
+#include <mem/mem_account.h>
 
 EMBOX_UNIT_INIT(heap_init);
 
@@ -18,6 +19,8 @@ EMBOX_UNIT_INIT(heap_init);
 #define ALLOCATOR_NAME OPTION_GET(STRING,allocator_name)
 
 struct page_allocator *ALLOCATOR_NAME;
+MEM_ACCOUNT_DEF(ALLOCATOR_NAME, "heap", &ALLOCATOR_NAME,
+		page_allocator_account_stat);
 extern char HEAP_START;
 extern char HEAP_END;
 
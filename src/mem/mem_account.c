@@ -0,0 +1,12 @@
+/**
+ * @file
+ * @brief Registry of statically reserved memory regions
+ *
+ * @date 17.10.2026
+ */
+
+#include <util/array.h>
+
+#include <mem/mem_account.h>
+
+ARRAY_SPREAD_DEF(const struct mem_account *const, __mem_account_registry);
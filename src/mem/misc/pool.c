@@ -19,12 +19,23 @@
 #include <stdint.h>
 #include <util/member.h>
 
+static inline void pool_used_inc(struct pool *pl) {
+	if (++pl->used > pl->max_used) {
+		pl->max_used = pl->used;
+	}
+}
+
 void * pool_alloc(struct pool *pl) {
 	void *obj;
 
 	assert(pl != NULL);
 
+	if (pl->elastic) {
+		return pl->elastic->ops->alloc(pl);
+	}
+
 	if (!slist_empty(&pl->free_blocks)) {
+		pool_used_inc(pl);
 		return (void *)slist_remove_first_link(&pl->free_blocks);
 	}
 
@@ -32,9 +43,11 @@ void * pool_alloc(struct pool *pl) {
 		obj = pl->bound_free;
 		pl->bound_free += pl->obj_size;
 		assert(pl->bound_free <= pl->memory + pl->pool_size);
+		pool_used_inc(pl);
 		return obj;
 	}
 
+	pl->exhausted++;
 	return NULL;
 }
 
@@ -43,12 +56,38 @@ void pool_free(struct pool *pl, void *obj) {
 	assert(obj != NULL);
 	assert(pool_belong(pl, obj));
 
+	if (pl->elastic) {
+		pl->elastic->ops->free(pl, obj);
+		return;
+	}
+
 	obj = slist_link_init((struct slist_link *)obj);
 	slist_add_first_link(obj, &pl->free_blocks);
+	pl->used--;
 }
 
 int pool_belong(const struct pool *pl, const void *obj) {
+	if (pl->elastic) {
+		return pl->elastic->ops->belong(pl, obj);
+	}
+
 	return (pl->memory <= obj)
 			&& (obj + pl->obj_size <= pl->memory + pl->pool_size)
 			&& ((obj - pl->memory) % pl->obj_size == 0);
 }
+
+void pool_account_stat(const void *pool, struct mem_account_stat *st) {
+	const struct pool *pl = pool;
+
+	st->reserved = pl->pool_size;
+	st->obj_size = pl->obj_size;
+	st->total = pl->pool_size / pl->obj_size;
+	st->used = pl->used;
+	st->max_used = pl->max_used;
+	st->failed = pl->exhausted;
+
+	if (pl->elastic) {
+		st->reserved += pl->elastic->chunk_bytes;
+		st->total += pl->elastic->objects;
+	}
+}
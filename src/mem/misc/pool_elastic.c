@@ -0,0 +1,306 @@
+/**
+ * @file
+ * @brief Pools growing by page chunks up to a limit
+ * @details Statically reserved objects are used first, as in a fixed pool.
+ *     When they are over, a chunk of pages is taken from the physical page
+ *     allocator and all its objects are put to the free list. Each chunk
+ *     counts its allocated objects, so chunks with no allocated objects can
+ *     be returned when the page allocator runs out of memory. Chunks are
+ *     aligned to their power of 2 size, so the chunk of an object is found
+ *     by masking its address.
+ *
+ * @date 17.10.2026
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hal/ipl.h>
+#include <mem/misc/pool.h>
+#include <mem/page.h>
+#include <mem/phymem.h>
+#include <util/array.h>
+#include <util/binalign.h>
+#include <util/math.h>
+
+#include <framework/mod/options.h>
+
+#define CHUNK_PAGES OPTION_GET(NUMBER, chunk_pages)
+
+struct pool_chunk {
+	struct pool_chunk *next;
+	size_t pages;
+	size_t nr;   /* objects in the chunk */
+	size_t used; /* objects allocated */
+	char *objs;
+};
+
+ARRAY_SPREAD_DEF(struct pool *const, __pool_elastic_registry);
+
+static int pool_in_static(const struct pool *pl, const void *obj) {
+	return (pl->memory <= obj) && (obj < pl->memory + pl->pool_size);
+}
+
+/* @a obj must be taken from a chunk */
+static inline struct pool_chunk *pool_chunk_of(const struct pool *pl,
+		const void *obj) {
+	uintptr_t mask = pl->elastic->chunk_pages * PAGE_SIZE() - 1;
+
+	return (struct pool_chunk *) ((uintptr_t) obj & ~mask);
+}
+
+static int pool_chunk_has(const struct pool *pl,
+		const struct pool_chunk *chunk, const void *obj) {
+	return (void *) chunk->objs <= obj
+			&& obj < (void *) (chunk->objs + chunk->nr * pl->obj_size);
+}
+
+static size_t pool_chunk_pages(const struct pool *pl) {
+	size_t need, pages;
+
+	need = max((size_t) CHUNK_PAGES, (sizeof(struct pool_chunk)
+			+ pl->elastic->obj_align + pl->obj_size + PAGE_SIZE() - 1)
+			/ PAGE_SIZE());
+
+	pages = 1;
+	while (pages < need) {
+		pages <<= 1;
+	}
+
+	return pages;
+}
+
+/* Takes @a pages pages aligned to their size. When the first try is not
+ * aligned, takes twice as much and returns the excess */
+static void *pool_chunk_alloc(size_t pages) {
+	uintptr_t size = pages * PAGE_SIZE();
+	char *mem, *aligned;
+	size_t head;
+
+	mem = phymem_alloc(pages);
+	if (!mem || !((uintptr_t) mem & (size - 1))) {
+		return mem;
+	}
+	phymem_free(mem, pages);
+
+	mem = phymem_alloc(2 * pages - 1);
+	if (!mem) {
+		return NULL;
+	}
+
+	aligned = (char *) binalign_bound((uintptr_t) mem, size);
+	head = (aligned - mem) / PAGE_SIZE();
+	if (head) {
+		phymem_free(mem, head);
+	}
+	if (pages - 1 - head) {
+		phymem_free(aligned + size, pages - 1 - head);
+	}
+
+	return aligned;
+}
+
+static struct pool_chunk *pool_grow(struct pool *pl) {
+	struct pool_elastic *el = pl->elastic;
+	struct pool_chunk *chunk;
+	size_t pages, objects, i;
+
+	objects = pl->pool_size / pl->obj_size + el->objects;
+	if (objects >= el->max_objects) {
+		return NULL;
+	}
+
+	if (!el->chunk_pages) {
+		el->chunk_pages = pool_chunk_pages(pl);
+	}
+	pages = el->chunk_pages;
+
+	chunk = pool_chunk_alloc(pages);
+	if (!chunk) {
+		return NULL;
+	}
+
+	chunk->pages = pages;
+	chunk->used = 0;
+	chunk->objs = (char *) binalign_bound((uintptr_t) (chunk + 1),
+			el->obj_align);
+	chunk->nr = ((char *) chunk + pages * PAGE_SIZE() - chunk->objs)
+			/ pl->obj_size;
+	chunk->nr = min(chunk->nr, el->max_objects - objects);
+
+	/* In reverse order, so objects are taken from the chunk start */
+	for (i = chunk->nr; i > 0; i--) {
+		struct slist_link *link;
+
+		link = (struct slist_link *) (chunk->objs + (i - 1) * pl->obj_size);
+		slist_add_first_link(slist_link_init(link), &pl->free_blocks);
+	}
+
+	chunk->next = el->chunks;
+	el->chunks = chunk;
+	el->objects += chunk->nr;
+	el->chunk_bytes += pages * PAGE_SIZE();
+
+	return chunk;
+}
+
+static void *pool_elastic_take(struct pool *pl) {
+	void *obj;
+
+	if (!slist_empty(&pl->free_blocks)) {
+		return slist_remove_first_link(&pl->free_blocks);
+	}
+
+	if (pl->bound_free != pl->memory + pl->pool_size) {
+		obj = pl->bound_free;
+		pl->bound_free += pl->obj_size;
+		return obj;
+	}
+
+	return NULL;
+}
+
+static void *pool_elastic_alloc(struct pool *pl) {
+	struct pool_chunk *chunk;
+	void *obj;
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	{
+		obj = pool_elastic_take(pl);
+		if (!obj && pool_grow(pl)) {
+			obj = pool_elastic_take(pl);
+		}
+
+		if (obj) {
+			if (!pool_in_static(pl, obj)) {
+				chunk = pool_chunk_of(pl, obj);
+				assert(pool_chunk_has(pl, chunk, obj));
+				chunk->used++;
+			}
+			if (++pl->used > pl->max_used) {
+				pl->max_used = pl->used;
+			}
+		} else {
+			pl->exhausted++;
+		}
+	}
+	ipl_restore(ipl);
+
+	return obj;
+}
+
+static void pool_elastic_free(struct pool *pl, void *obj) {
+	struct pool_chunk *chunk;
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	{
+		if (!pool_in_static(pl, obj)) {
+			chunk = pool_chunk_of(pl, obj);
+			assert(pool_chunk_has(pl, chunk, obj));
+			chunk->used--;
+		}
+
+		slist_add_first_link(slist_link_init(obj), &pl->free_blocks);
+		pl->used--;
+	}
+	ipl_restore(ipl);
+}
+
+static int pool_elastic_belong(const struct pool *pl, const void *obj) {
+	struct pool_chunk *chunk;
+	int ret = 0;
+	ipl_t ipl;
+
+	if (pool_in_static(pl, obj)) {
+		return (obj - pl->memory) % pl->obj_size == 0;
+	}
+
+	/* An arbitrary pointer can't be masked to a chunk, look it up in the
+	 * list. Used only for checks, not on alloc and free paths */
+	ipl = ipl_save();
+	{
+		for (chunk = pl->elastic->chunks; chunk; chunk = chunk->next) {
+			if (pool_chunk_has(pl, chunk, obj)) {
+				ret = ((char *) obj - chunk->objs) % pl->obj_size == 0;
+				break;
+			}
+		}
+	}
+	ipl_restore(ipl);
+
+	return ret;
+}
+
+const struct pool_elastic_ops __pool_elastic_ops = {
+	.alloc  = pool_elastic_alloc,
+	.free   = pool_elastic_free,
+	.belong = pool_elastic_belong,
+};
+
+size_t pool_shrink(struct pool *pl) {
+	struct pool_elastic *el = pl->elastic;
+	struct pool_chunk *chunk, **pchunk, *idle = NULL;
+	struct slist_link *link;
+	struct slist keep;
+	size_t released = 0;
+	ipl_t ipl;
+
+	if (!el) {
+		return 0;
+	}
+
+	ipl = ipl_save();
+	{
+		for (pchunk = &el->chunks; (chunk = *pchunk); ) {
+			if (chunk->used) {
+				pchunk = &chunk->next;
+				continue;
+			}
+			*pchunk = chunk->next;
+			chunk->next = idle;
+			idle = chunk;
+		}
+
+		if (!idle) {
+			ipl_restore(ipl);
+			return 0;
+		}
+
+		/* Drop objects of idle chunks from the free list. Chunks left in
+		 * the list have allocated objects, so any chunk having none is idle */
+		slist_init(&keep);
+		while (!slist_empty(&pl->free_blocks)) {
+			link = slist_remove_first_link(&pl->free_blocks);
+			if (pool_in_static(pl, link) || pool_chunk_of(pl, link)->used) {
+				slist_add_first_link(link, &keep);
+			}
+		}
+		while (!slist_empty(&keep)) {
+			slist_add_first_link(slist_remove_first_link(&keep),
+					&pl->free_blocks);
+		}
+
+		while ((chunk = idle)) {
+			idle = chunk->next;
+			el->objects -= chunk->nr;
+			el->chunk_bytes -= chunk->pages * PAGE_SIZE();
+			released += chunk->pages * PAGE_SIZE();
+			phymem_free(chunk, chunk->pages);
+		}
+	}
+	ipl_restore(ipl);
+
+	return released;
+}
+
+static void pool_elastic_reclaim(void) {
+	struct pool *pl;
+
+	array_spread_foreach(pl, __pool_elastic_registry) {
+		pool_shrink(pl);
+	}
+}
+PHYMEM_RECLAIM_HANDLER(pool_elastic_reclaim);
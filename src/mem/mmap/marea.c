@@ -10,9 +10,9 @@
 #include <module/embox/mem/mmap_api.h>
 
 //TODO const number of struct marea
-POOL_DEF(marea_pool, struct marea, 0x400)
+POOL_DEF(marea_pool, struct marea, 0x400);
 
-POOL_DEF(phy_page_pool, struct phy_page, 0xFFFF)
+POOL_DEF(phy_page_pool, struct phy_page, 0xFFFF);
 
 struct marea *marea_create(uint32_t start, uint32_t end, uint32_t flags, bool is_allocated) {
 	struct marea *marea;
@@ -26,8 +26,6 @@ struct marea *marea_create(uint32_t start, uint32_t end, uint32_t flags, bool is
 	marea->flags = flags;
 	marea->is_allocated = is_allocated;
 
-	dlist_head_init(&marea->mmap_link);
-
 	return marea;
 }
 
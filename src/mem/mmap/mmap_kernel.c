@@ -7,7 +7,7 @@
 
 #include <stddef.h>
 
-#include <util/dlist.h>
+#include <util/rbtree.h>
 
 #include <kernel/task.h>
 #include <kernel/task/kernel_task.h>
@@ -27,21 +27,23 @@ static struct emmap early_emmap = {
 #endif
 	NULL,
 	0,
-	DLIST_INIT(early_emmap.marea_list)
+	RB_TREE_INIT(mmap_marea_augment)
 };
 
 extern int vmem_map_kernel(void);
 
 int mmap_kernel_init(void) {
 	int ret;
+	struct rb_node *node;
 	struct marea *marea;
 	struct emmap *emmap;
 
 	emmap = task_resource_mmap(task_kernel_task());
 
-	dlist_foreach_entry(marea, &early_emmap.marea_list, mmap_link) {
-		dlist_del_init(&marea->mmap_link);
-		dlist_add_next(&marea->mmap_link, &emmap->marea_list);
+	while ((node = rb_first(&early_emmap.marea_tree))) {
+		marea = rb_entry(node, struct marea, mmap_node);
+		rb_erase(&early_emmap.marea_tree, node);
+		mmap_add_marea(emmap, marea);
 	}
 	ret = vmem_map_kernel();
 	assert(ret == 0);
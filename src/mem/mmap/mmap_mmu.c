@@ -62,30 +62,98 @@ void mmap_do_marea_unmap(struct emmap *mmap, struct marea *marea) {
 	vmem_unmap_region(mmap->ctx, marea->start, len);
 }
 
-struct marea *mmap_find_marea(struct emmap *mmap, mmu_vaddr_t vaddr) {
-	struct marea *marea;
-	dlist_foreach_entry(marea, &mmap->marea_list, mmap_link) {
-		if (INSIDE(vaddr, marea->start, marea->end)) {
+#define marea_of(node) rb_entry(node, struct marea, mmap_node)
+
+/*
+ * Areas placed by mmap_place_marea() don't overlap, but device memory and
+ * kernel sections are added as they are, and may overlap each other. So
+ * the tree is ordered by start and augmented with the greatest end in the
+ * subtree, a subtree is skipped when it ends before the address.
+ */
+void mmap_marea_augment(struct rb_node *node) {
+	struct marea *marea = marea_of(node), *child;
+
+	marea->max_end = marea->end;
+	if ((child = marea_of(node->left)) && child->max_end > marea->max_end) {
+		marea->max_end = child->max_end;
+	}
+	if ((child = marea_of(node->right)) && child->max_end > marea->max_end) {
+		marea->max_end = child->max_end;
+	}
+}
+
+/* Area with @a vaddr inside and the greatest start, so a mapping starting
+ * at @a vaddr is preferred to an enclosing one */
+static struct marea *mmap_marea_stab(struct rb_node *node, mmu_vaddr_t vaddr) {
+	struct marea *marea, *found;
+
+	while (node && vaddr < marea_of(node)->max_end) {
+		marea = marea_of(node);
+		if (vaddr < marea->start) {
+			node = node->left;
+			continue;
+		}
+		found = mmap_marea_stab(node->right, vaddr);
+		if (found) {
+			return found;
+		}
+		if (vaddr < marea->end) {
+			return marea;
+		}
+		node = node->left;
+	}
+
+	return NULL;
+}
+
+/* Any area intersecting [start, end) */
+static struct marea *mmap_marea_overlap(struct rb_node *node,
+		uint32_t start, uint32_t end) {
+	struct marea *marea, *found;
+
+	while (node && start < marea_of(node)->max_end) {
+		marea = marea_of(node);
+		if (end <= marea->start) {
+			node = node->left;
+			continue;
+		}
+		if (start < marea->end) {
 			return marea;
 		}
+		found = mmap_marea_overlap(node->left, start, end);
+		if (found) {
+			return found;
+		}
+		node = node->right;
 	}
+
 	return NULL;
 }
 
+struct marea *mmap_find_marea(struct emmap *mmap, mmu_vaddr_t vaddr) {
+	return mmap_marea_stab(mmap->marea_tree.root, vaddr);
+}
+
 static int mmap_check_marea(struct emmap *mmap, struct marea *marea) {
-	if (mmap_find_marea(mmap, marea->start)
-			|| mmap_find_marea(mmap, marea->end)) {
+	if (mmap_marea_overlap(mmap->marea_tree.root, marea->start, marea->end)) {
 		return -EEXIST;
 	}
 	return 0;
 }
 
+static int marea_cmp(struct rb_node *node1, struct rb_node *node2) {
+	uintptr_t start1 = marea_of(node1)->start;
+	uintptr_t start2 = marea_of(node2)->start;
+
+	return start1 < start2 ? -1 : start1 > start2;
+}
+
 void mmap_add_marea(struct emmap *mmap, struct marea *marea) {
-	dlist_add_prev(&marea->mmap_link, &mmap->marea_list);
+	rb_insert(&mmap->marea_tree, &marea->mmap_node, marea_cmp);
 }
 
-void mmap_del_marea(struct marea *marea) {
-	dlist_del(&marea->mmap_link);
+void mmap_del_marea(struct emmap *mmap, struct marea *marea) {
+	rb_erase(&mmap->marea_tree, &marea->mmap_node);
 }
 
 void mmap_add_phy_page(struct emmap *mmap, struct phy_page *phy_page) {
@@ -108,7 +176,7 @@ struct phy_page *mmap_find_phy_page(struct emmap *mmap, void *start) {
 
 void mmap_init(struct emmap *mmap) {
 	int err;
-	dlist_init(&mmap->marea_list);
+	rb_tree_init(&mmap->marea_tree, mmap_marea_augment);
 	dlist_init(&mmap->page_list);
 
 	if ((err = vmem_init_context(&mmap->ctx))) {
@@ -131,10 +199,14 @@ void mmap_free(struct emmap *mmap) {
 }
 
 void mmap_clear(struct emmap *mmap) {
+	struct rb_node *node;
 	struct marea *marea;
 	struct phy_page *phy_page;
 
-	dlist_foreach_entry(marea, &mmap->marea_list, mmap_link) {
+	while ((node = rb_first(&mmap->marea_tree))) {
+		marea = marea_of(node);
+		rb_erase(&mmap->marea_tree, node);
+
 		vmem_unmap_region(mmap->ctx, marea->start, mmu_size_align(marea->end - marea->start));
 
 		marea_destroy(marea);
@@ -180,32 +252,33 @@ error:
 }
 
 struct marea *mmap_alloc_marea(struct emmap *mmap, size_t size, uint32_t flags) {
-	struct dlist_head *item = &mmap->marea_list;
-	uint32_t s_ptr = mem_start;
+	struct rb_node *node;
 	struct marea *marea;
+	uint32_t s_ptr = mem_start;
 
 	size = MAREA_ALIGN_UP(size);
 
-	do {
-		if ((marea = mmap_place_marea(mmap, s_ptr, s_ptr + size, flags))) {
-			return marea;
+	/* First fit: areas are visited in address order */
+	rb_foreach(node, &mmap->marea_tree) {
+		marea = marea_of(node);
+		if (marea->end <= s_ptr) {
+			continue;
 		}
-
-		item = item->next;
-		if (item == &mmap->marea_list) {
+		if (marea->start >= s_ptr + size) {
 			break;
 		}
-
-		marea = dlist_entry(item, struct marea, mmap_link);
 		s_ptr = MAREA_ALIGN_UP(marea->end);
-	} while(1);
+	}
 
-	return NULL;
+	return mmap_place_marea(mmap, s_ptr, s_ptr + size, flags);
 }
 
 static void mmap_unmap_on_error(struct emmap *emmap, struct marea *err_ma) {
+	struct rb_node *node;
 	struct marea *marea;
-	dlist_foreach_entry(marea, &emmap->marea_list, mmap_link) {
+
+	rb_foreach(node, &emmap->marea_tree) {
+		marea = marea_of(node);
 		if (marea == err_ma) {
 			break;
 		}
@@ -214,10 +287,12 @@ static void mmap_unmap_on_error(struct emmap *emmap, struct marea *err_ma) {
 }
 
 int mmap_mapping(struct emmap *emmap) {
+	struct rb_node *node;
 	struct marea *marea;
 	int err;
 
-	dlist_foreach_entry(marea, &emmap->marea_list, mmap_link) {
+	rb_foreach(node, &emmap->marea_tree) {
+		marea = marea_of(node);
 		err = mmap_do_marea_map(emmap, marea);
 		if (err) {
 			goto out_err;
@@ -232,9 +307,11 @@ out_err:
 }
 
 int mmap_inherit(struct emmap *mmap, struct emmap *p_mmap) {
+	struct rb_node *node;
 	struct marea *marea, *new_marea;
 
-	dlist_foreach_entry(marea, &p_mmap->marea_list, mmap_link) {
+	rb_foreach(node, &p_mmap->marea_tree) {
+		marea = marea_of(node);
 		if (!(new_marea = marea_create(marea->start, marea->end, marea->flags, marea->is_allocated))) {
 			return -ENOMEM;
 		}
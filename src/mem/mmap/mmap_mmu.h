@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <util/dlist.h>
+#include <util/rbtree.h>
 #include <hal/mmu.h>
 
 struct marea {
@@ -19,7 +20,8 @@ struct marea {
 	uint32_t flags;
 	uint32_t is_allocated;
 
-	struct dlist_head mmap_link;
+	struct rb_node mmap_node; /**< in emmap::marea_tree ordered by start */
+	uint32_t max_end;         /**< greatest end in the subtree */
 };
 
 struct phy_page {
@@ -34,12 +36,15 @@ struct emmap {
 
 	mmu_ctx_t ctx;
 
-	struct dlist_head marea_list;
+	struct rb_tree marea_tree;
 	struct dlist_head page_list;
 };
 
+/* Device and kernel mappings may overlap, so the tree is an interval tree */
+extern void mmap_marea_augment(struct rb_node *node);
+
 extern void mmap_add_marea(struct emmap *mmap, struct marea *marea);
-extern void mmap_del_marea(struct marea *marea);
+extern void mmap_del_marea(struct emmap *mmap, struct marea *marea);
 extern struct marea *mmap_find_marea(struct emmap *mmap, mmu_vaddr_t vaddr);
 extern int mmap_kernel_inited(void);
 extern struct emmap *mmap_early_emmap(void);
@@ -154,7 +154,7 @@ void marea_destroy(struct marea *marea) {
 void mmap_add_marea(struct emmap *mmap, struct marea *marea) {
 }
 
-void mmap_del_marea(struct marea *marea) {
+void mmap_del_marea(struct emmap *mmap, struct marea *marea) {
 }
 
 int mmap_do_marea_map(struct emmap *mmap, struct marea *marea) {
@@ -31,7 +31,7 @@ struct emmap {
 typedef uintptr_t mmu_vaddr_t;
 
 extern void mmap_add_marea(struct emmap *mmap, struct marea *marea);
-extern void mmap_del_marea(struct marea *marea);
+extern void mmap_del_marea(struct emmap *mmap, struct marea *marea);
 extern struct marea *mmap_find_marea(struct emmap *mmap, mmu_vaddr_t vaddr);
 extern int mmap_kernel_inited(void);
 extern struct emmap *mmap_early_emmap(void);
@@ -17,6 +17,7 @@
 #include <util/math.h>
 
 #include <mem/page.h>
+#include <mem/mem_account.h>
 #include <embox/unit.h>
 
 //TODO page : have no synchronization
@@ -56,6 +57,9 @@ static void mark_n_busy(struct page_allocator *allocator,
 	}
 
 	allocator->free -= page_q * allocator->page_size;
+	if (allocator->free < allocator->min_free) {
+		allocator->min_free = allocator->free;
+	}
 }
 
 static void mark_n_free(struct page_allocator *allocator,
@@ -133,6 +137,7 @@ struct page_allocator *page_allocator_init(char *start, size_t len, size_t page_
 	allocator->pages_n = pages;
 	allocator->page_size = page_size;
 	allocator->free = pages * page_size;
+	allocator->min_free = allocator->free;
 	allocator->bitmap_len = bitmap_len;
 	allocator->bitmap = (unsigned long *)((uintptr_t)&allocator->bitmap + sizeof(allocator->bitmap));
 
@@ -146,3 +151,20 @@ int page_belong(struct page_allocator *allocator, void *page) {
 	void *pages_end = allocator->pages_start + allocator->pages_n * allocator->page_size;
 	return allocator->pages_start <= page && page < pages_end;
 }
+
+void page_allocator_account_stat(const void *allocator_ptr,
+		struct mem_account_stat *st) {
+	const struct page_allocator *allocator =
+			*(struct page_allocator *const *) allocator_ptr;
+
+	memset(st, 0, sizeof(*st));
+	if (!allocator) {
+		return;
+	}
+
+	st->reserved = allocator->pages_n * allocator->page_size;
+	st->obj_size = allocator->page_size;
+	st->total = allocator->pages_n;
+	st->used = (st->reserved - allocator->free) / allocator->page_size;
+	st->max_used = (st->reserved - allocator->min_free) / allocator->page_size;
+}
@@ -9,6 +9,7 @@
 #include <sys/mman.h>
 #include <mem/phymem.h>
 #include <mem/page.h>
+#include <util/array.h>
 #include <util/binalign.h>
 #include <kernel/printk.h>
 
@@ -43,7 +44,25 @@ static int phymem_init(void) {
 	return phymem_alloc_start == va ? 0 : -EIO;
 }
 
+ARRAY_SPREAD_DEF(const phymem_reclaim_ft, __phymem_reclaim_handlers);
+
 void *phymem_alloc(size_t page_number) {
+	phymem_reclaim_ft reclaim;
+	void *page;
+
+	if (!__phymem_allocator) {
+		return NULL;
+	}
+
+	page = page_alloc(__phymem_allocator, page_number);
+	if (page || ARRAY_SPREAD_SIZE(__phymem_reclaim_handlers) == 0) {
+		return page;
+	}
+
+	array_spread_foreach(reclaim, __phymem_reclaim_handlers) {
+		reclaim();
+	}
+
 	return page_alloc(__phymem_allocator, page_number);
 }
 
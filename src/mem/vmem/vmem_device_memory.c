@@ -116,7 +116,7 @@ int munmap(void *addr, size_t size) {
 		return SET_ERRNO(ENOENT);
 	}
 
-	mmap_del_marea(marea);
+	mmap_del_marea(emmap, marea);
 
 	if (mmap_kernel_inited()) {
 		mmap_do_marea_unmap(emmap, marea);
@@ -6,8 +6,10 @@
  * @author Ilia Vaprol
  */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -20,7 +22,11 @@
 
 #include <net/l3/ipv4/ip.h>
 #include <sys/socket.h>
+#include <kernel/thread/sync/cond.h>
+#include <kernel/thread/sync/mutex.h>
+#include <kernel/time/time.h>
 #include <util/log.h>
+#include <util/math.h>
 #include <framework/mod/options.h>
 
 
@@ -29,6 +35,14 @@
  */
 #define MODOPS_DNS_QUERY_TIMEOUT OPTION_GET(NUMBER, dns_query_timeout)
 
+/**
+ * Resolver cache: number of entries, TTL limit and TTL of failed lookups
+ * (in seconds)
+ */
+#define MODOPS_DNS_CACHE_SIZE    OPTION_GET(NUMBER, cache_size)
+#define MODOPS_DNS_CACHE_TTL_MAX OPTION_GET(NUMBER, cache_ttl_max)
+#define MODOPS_DNS_NEGATIVE_TTL  OPTION_GET(NUMBER, negative_ttl)
+
 union dns_msg {
 	char raw[DNS_MAX_MESSAGE_SZ];
 	struct {
@@ -37,6 +51,60 @@ union dns_msg {
 	} msg;
 };
 
+/**
+ * One query to the nameserver. Few of them can be sent at once.
+ */
+struct dns_req {
+	struct dns_q query;
+	struct dns_cache_entry *pending;
+	int sent;
+	int ret;
+	size_t msg_sz;
+	union dns_msg msg; /* request, and reply when it's received */
+};
+
+enum dns_cache_state {
+	DNS_CACHE_FREE,
+	DNS_CACHE_PENDING,  /* the query is sent */
+	DNS_CACHE_FAILED,   /* the query is failed, the entry is free */
+	DNS_CACHE_VALID,
+	DNS_CACHE_NEGATIVE, /* the name doesn't exist */
+};
+
+struct dns_cache_entry {
+	struct dns_q query;
+	enum dns_cache_state state;
+	int error;         /* result of a failed query */
+	unsigned int gen;  /* incremented when the pending query is done */
+	time_t expires;
+	unsigned long used;
+	size_t msg_sz;
+	union dns_msg msg;
+};
+
+#define DNS_CACHE_MISS 1
+
+/* A and AAAA queries of dns_query_addr() */
+#define DNS_REQ_MAX    2
+
+static struct dns_cache_entry dns_cache[MODOPS_DNS_CACHE_SIZE];
+static unsigned long dns_cache_clock;
+static struct dns_cache_stats dns_stats;
+static unsigned long long dns_latency_total;
+static struct mutex dns_cache_lock = MUTEX_INIT_STATIC;
+static cond_t dns_cache_cond = COND_INIT_STATIC;
+
+/* Query ids and source ports are random, so an off-path host can't
+ * easily forge a reply */
+static uint32_t dns_rand_state;
+static struct mutex dns_rand_lock = MUTEX_INIT_STATIC;
+
+#define DNS_PORT_RANDOM_MIN   49152
+#define DNS_PORT_RANDOM_TRIES 4
+
+static int dns_reply_match(const struct dns_req *req,
+		const union dns_msg *reply, size_t reply_sz);
+
 static int name_to_label(const char *name, char *buff, size_t buff_sz) {
 	char *dot;
 	size_t bytes_left, field_sz;
@@ -183,13 +251,64 @@ static int dns_q_format(struct dns_q *query, char *buff, size_t buff_sz) {
 	return 0;
 }
 
+static struct timespec dns_time(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts;
+}
+
+/* xorshift32 stirred with the time of each call, which is not known to
+ * a remote host precisely */
+static uint32_t dns_rand(void) {
+	struct timespec ts;
+	uint32_t x;
+
+	ts = dns_time();
+
+	mutex_lock(&dns_rand_lock);
+	x = dns_rand_state ^ (uint32_t)ts.tv_nsec ^ ((uint32_t)ts.tv_sec << 20);
+	if (!x) {
+		x = 0x9e3779b9;
+	}
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	dns_rand_state = x;
+	mutex_unlock(&dns_rand_lock);
+
+	return x;
+}
+
+static uint16_t dns_id_next(void) {
+	return (uint16_t)dns_rand();
+}
+
+/* Binds to a random port, the socket is bound on connect() otherwise */
+static void dns_bind_random(int sock) {
+	struct sockaddr_in addr;
+	int i;
+
+	memset(&addr, 0, sizeof addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+	for (i = 0; i < DNS_PORT_RANDOM_TRIES; i++) {
+		addr.sin_port = htons(DNS_PORT_RANDOM_MIN
+				+ dns_rand() % (65536 - DNS_PORT_RANDOM_MIN));
+		if (0 == bind(sock, (struct sockaddr *)&addr, sizeof addr)) {
+			return;
+		}
+	}
+}
+
 static int dns_query_format(struct dns_q *query, union dns_msg *dm, size_t *out_dm_sz) {
 	int ret;
 	size_t data_sz;
 
 	/* Setup header fields */
 	memset(&dm->msg.hdr, 0, sizeof dm->msg.hdr);
-	dm->msg.hdr.id = 0x1234; /* TODO */
+	dm->msg.hdr.id = dns_id_next();
 	dm->msg.hdr.qr = DNS_MSG_TYPE_QUERY;
 	dm->msg.hdr.opcode = DNS_OPER_CODE_QUERY;
 	dm->msg.hdr.rd = 1;
@@ -210,75 +329,129 @@ static int dns_query_format(struct dns_q *query, union dns_msg *dm, size_t *out_
 	return 0;
 }
 
-static int dns_query_execute(union dns_msg *req, size_t req_sz,
-		union dns_msg *rep, size_t *out_rep_sz) {
+static void dns_stats_sent(int nreqs, struct timespec start) {
+	struct timespec end;
+
+	end = dns_time();
+
+	mutex_lock(&dns_cache_lock);
+	dns_stats.sent += nreqs;
+	dns_latency_total += (end.tv_sec - start.tv_sec) * MSEC_PER_SEC
+			+ (end.tv_nsec - start.tv_nsec) / NSEC_PER_MSEC;
+	dns_stats.latency_ms = dns_latency_total / dns_stats.sent;
+	mutex_unlock(&dns_cache_lock);
+}
+
+/**
+ * Sends all requests at once and waits for replies in any order
+ */
+static void dns_query_execute(struct dns_req **reqs, int nreqs) {
 	static const struct timeval timeout = {
 		.tv_sec = MODOPS_DNS_QUERY_TIMEOUT / MSEC_PER_SEC,
 		.tv_usec = (MODOPS_DNS_QUERY_TIMEOUT % MSEC_PER_SEC) * USEC_PER_MSEC,
 	};
-	int sock;
+	int sock, ret, left, i;
 	ssize_t bytes;
-	struct sockaddr_in nameserver_addr;
+	struct sockaddr_in nameserver_addr, from_addr;
+	socklen_t from_len;
+	union dns_msg reply;
+	struct timespec start;
+
+	start = dns_time();
+	for (i = 0; i < nreqs; i++) {
+		reqs[i]->ret = -EINPROGRESS;
+	}
 
 	/* Setup dns_host structure */
 	memset(&nameserver_addr, 0, sizeof nameserver_addr);
 	nameserver_addr.sin_family = AF_INET;
 	nameserver_addr.sin_port = htons(DNS_PORT_NUMBER);
 	if (!inet_aton(dns_get_nameserver(), &nameserver_addr.sin_addr)) {
-		return -EINVAL;
+		ret = -EINVAL;
+		goto out;
 	}
 
 	/* Create socket */
 	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	if (sock == -1) {
-		return -errno;
+		ret = -errno;
+		goto out;
 	}
 
+	dns_bind_random(sock);
+
 	if (-1 == connect(sock, (struct sockaddr *)&nameserver_addr,
 				sizeof nameserver_addr)) {
-		close(sock);
-		return -errno;
+		ret = -errno;
+		goto out_close;
 	}
 
 	if (-1 == setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO,
 				&timeout, sizeof timeout)) {
-		close(sock);
-		return -errno;
+		ret = -errno;
+		goto out_close;
 	}
 
-	while (1) {
-		/* Send request */
-		bytes = send(sock, &req->raw[0], req_sz, 0);
-		if (bytes != req_sz) {
-			close(sock);
-			return -errno;
+	/* Send requests */
+	for (i = 0; i < nreqs; i++) {
+		bytes = send(sock, &reqs[i]->msg.raw[0], reqs[i]->msg_sz, 0);
+		if (bytes != reqs[i]->msg_sz) {
+			ret = -errno;
+			goto out_close;
 		}
+	}
 
-		do {
-			/* Receive reply */
-			bytes = recv(sock, &rep->raw[0], sizeof *rep, 0);
-			if (bytes == -1) {
-				close(sock);
-				return -errno;
-			}
-		} while (bytes < sizeof(struct dnshdr)); /* bad size, try again */
+	for (left = nreqs; left; ) {
+		/* Receive reply */
+		from_len = sizeof from_addr;
+		bytes = recvfrom(sock, &reply.raw[0], sizeof reply, 0,
+				(struct sockaddr *)&from_addr, &from_len);
+		if (bytes == -1) {
+			ret = -errno;
+			goto out_close;
+		}
+		if (bytes < sizeof(struct dnshdr)) {
+			continue; /* bad size, try again */
+		}
+		if (from_len < sizeof from_addr
+				|| from_addr.sin_family != AF_INET
+				|| from_addr.sin_port != nameserver_addr.sin_port
+				|| from_addr.sin_addr.s_addr
+					!= nameserver_addr.sin_addr.s_addr) {
+			continue; /* not from the nameserver */
+		}
 
 		/* Is it my? */
-		if (req->msg.hdr.id != rep->msg.hdr.id) {
+		for (i = 0; i < nreqs; i++) {
+			if (reqs[i]->ret == -EINPROGRESS
+					&& dns_reply_match(reqs[i], &reply, bytes)) {
+				break;
+			}
+		}
+		if (i == nreqs) {
 			continue;
 		}
 
-		/* all ok, done */
-		break;
+		memcpy(&reqs[i]->msg, &reply, bytes);
+		reqs[i]->msg_sz = (size_t)bytes;
+		reqs[i]->ret = 0;
+		left--;
 	}
 
+	/* all ok, done */
+	ret = 0;
+
+out_close:
 	/* Close our socket */
 	close(sock);
+out:
+	for (i = 0; i < nreqs; i++) {
+		if (reqs[i]->ret == -EINPROGRESS) {
+			reqs[i]->ret = ret;
+		}
+	}
 
-	/* Setup result size */
-	*out_rep_sz = (size_t)bytes;
-
-	return 0;
+	dns_stats_sent(nreqs, start);
 }
 
 static int dns_q_parse(struct dns_q *q, const char *data,
@@ -349,6 +522,42 @@ static int dns_rr_ptr_parse(struct dns_rr *rr, const char *data, size_t field_sz
 			&rr->rdata.ptr.ptrdname[0], NULL);
 }
 
+static int dns_rr_soa_parse(struct dns_rr *rr, const char *data, size_t field_sz,
+		const char *buff, size_t buff_sz) {
+	int ret;
+	size_t name_sz;
+	uint32_t field_val[5];
+	const char *end;
+
+	end = data + field_sz;
+
+	ret = label_to_name(data, buff, buff_sz, sizeof rr->rdata.soa.mname,
+			&rr->rdata.soa.mname[0], &name_sz);
+	if (ret != 0) {
+		return ret;
+	}
+	data += name_sz;
+
+	ret = label_to_name(data, buff, buff_sz, sizeof rr->rdata.soa.rname,
+			&rr->rdata.soa.rname[0], &name_sz);
+	if (ret != 0) {
+		return ret;
+	}
+	data += name_sz;
+
+	if (data + sizeof field_val != end) {
+		return -EINVAL;
+	}
+	memcpy(&field_val[0], data, sizeof field_val);
+	rr->rdata.soa.serial = ntohl(field_val[0]);
+	rr->rdata.soa.refresh = ntohl(field_val[1]);
+	rr->rdata.soa.retry = ntohl(field_val[2]);
+	rr->rdata.soa.expire = ntohl(field_val[3]);
+	rr->rdata.soa.minimum = ntohl(field_val[4]);
+
+	return 0;
+}
+
 static int dns_rr_aaaa_parse(struct dns_rr *rr, const char *data, size_t field_sz,
 		const char *buff, size_t buff_sz) {
 	if (field_sz != sizeof rr->rdata.aaaa.address) {
@@ -432,6 +641,9 @@ static int dns_rr_parse(struct dns_rr *rr, const char *data,
 	case DNS_RR_TYPE_CNAME:
 		ret = dns_rr_cname_parse(rr, curr, field_sz, buff, buff_sz);
 		break;
+	case DNS_RR_TYPE_SOA:
+		ret = dns_rr_soa_parse(rr, curr, field_sz, buff, buff_sz);
+		break;
 	case DNS_RR_TYPE_PTR:
 		ret = dns_rr_ptr_parse(rr, curr, field_sz, buff, buff_sz);
 		break;
@@ -449,7 +661,8 @@ static int dns_rr_parse(struct dns_rr *rr, const char *data,
 	return 0;
 }
 
-static int dns_result_parse(union dns_msg *dm, size_t dm_sz,
+/* Parses sections of a reply regardless of its result code */
+static int dns_sections_parse(union dns_msg *dm, size_t dm_sz,
 		struct dns_result *out_result) {
 	int ret;
 	const char *curr;
@@ -460,16 +673,6 @@ static int dns_result_parse(union dns_msg *dm, size_t dm_sz,
 	curr = &dm->msg.data[0];
 	memset(out_result, 0, sizeof *out_result);
 
-	/* Parse Header section */
-	if (dm->msg.hdr.qr != DNS_MSG_TYPE_REPLY) {
-		return -EINVAL;
-	}
-
-	if (dm->msg.hdr.rcode != DNS_RESP_CODE_OK) {
-		log_error("dns_result_parse: error: DNS result code is %d!\n", dm->msg.hdr.rcode);
-		return -1;
-	}
-
 	/* Parse Question section */
 	amount = htons(dm->msg.hdr.qdcount);
 	if (amount != 0) {
@@ -568,7 +771,8 @@ static int dns_result_parse(union dns_msg *dm, size_t dm_sz,
 
 	/* That's all */
 	if (curr != &dm->raw[dm_sz]) {
-		return -EINVAL;
+		ret = -EINVAL;
+		goto error;
 	}
 
 	/* All ok, done */
@@ -579,45 +783,368 @@ error:
 	return ret;
 }
 
-static int dns_execute(struct dns_q *query, struct dns_result *out_result) {
-	int ret;
-	union dns_msg msg_in, msg_out;
-	size_t msg_in_sz = 0;
-	size_t msg_out_sz;
+static int dns_result_parse(union dns_msg *dm, size_t dm_sz,
+		struct dns_result *out_result) {
+	memset(out_result, 0, sizeof *out_result);
 
-	ret = dns_query_format(query, &msg_out, &msg_out_sz);
-	if (ret != 0) {
-		return ret;
+	/* Parse Header section */
+	if (dm->msg.hdr.qr != DNS_MSG_TYPE_REPLY) {
+		return -EINVAL;
 	}
 
-	ret = dns_query_execute(&msg_out, msg_out_sz, &msg_in, &msg_in_sz);
-	if (ret != 0) {
-		return ret;
+	if (dm->msg.hdr.rcode == DNS_RESP_CODE_NONAME) {
+		return -ENOENT;
+	}
+	if (dm->msg.hdr.rcode != DNS_RESP_CODE_OK) {
+		log_error("dns_result_parse: error: DNS result code is %d!\n", dm->msg.hdr.rcode);
+		return -1;
 	}
 
-	ret = dns_result_parse(&msg_in, msg_in_sz, out_result);
-	if (ret != 0) {
-		return ret;
+	return dns_sections_parse(dm, dm_sz, out_result);
+}
+
+static int dns_q_equal(const struct dns_q *a, const struct dns_q *b) {
+	return a->qtype == b->qtype && a->qclass == b->qclass
+		&& 0 == strcasecmp(&a->qname[0], &b->qname[0]);
+}
+
+/* The reply has the id of the request and repeats its only question */
+static int dns_reply_match(const struct dns_req *req,
+		const union dns_msg *reply, size_t reply_sz) {
+	struct dns_q q;
+	size_t q_sz;
+
+	if (reply->msg.hdr.id != req->msg.msg.hdr.id
+			|| reply->msg.hdr.qr != DNS_MSG_TYPE_REPLY
+			|| ntohs(reply->msg.hdr.qdcount) != 1) {
+		return 0;
 	}
 
-	return 0;
+	if (0 != dns_q_parse(&q, &reply->msg.data[0], &reply->raw[0], reply_sz,
+			&q_sz)) {
+		return 0;
+	}
+
+	return dns_q_equal(&q, &req->query);
 }
 
-int dns_query(const char *qname, enum dns_type qtype, enum dns_class qclass,
-		struct dns_result *out_result) {
-	struct dns_q query;
+/* Free entries go first, then the least recently used one */
+static int dns_cache_victim_better(const struct dns_cache_entry *ce,
+		const struct dns_cache_entry *victim) {
+	if (!victim) {
+		return 1;
+	}
+	if ((ce->state == DNS_CACHE_FREE || ce->state == DNS_CACHE_FAILED)
+			!= (victim->state == DNS_CACHE_FREE || victim->state == DNS_CACHE_FAILED)) {
+		return ce->state == DNS_CACHE_FREE || ce->state == DNS_CACHE_FAILED;
+	}
+	return ce->used < victim->used;
+}
+
+/**
+ * Looks for the query in the cache. If the same query is in flight, waits
+ * for it when @a wait is set.
+ *
+ * @return 0 if the reply is copied to @a req, a negative error of a cached
+ *     failure or DNS_CACHE_MISS. On a miss, req->pending is the entry to
+ *     be completed with dns_cache_done(), or NULL if nothing can be cached.
+ */
+static int dns_cache_lookup(struct dns_req *req, int wait) {
+	struct dns_cache_entry *ce, *victim;
+	unsigned int gen;
+	time_t now;
+	int i, ret;
+
+	req->pending = NULL;
+
+	mutex_lock(&dns_cache_lock);
+	dns_stats.queries++;
+again:
+	now = dns_time().tv_sec;
+	victim = NULL;
+	ce = NULL;
+
+	for (i = 0; i < MODOPS_DNS_CACHE_SIZE; i++) {
+		ce = &dns_cache[i];
+		if (ce->state >= DNS_CACHE_VALID && ce->expires <= now) {
+			ce->state = DNS_CACHE_FREE;
+		}
+		if (ce->state != DNS_CACHE_FREE && ce->state != DNS_CACHE_FAILED
+				&& dns_q_equal(&ce->query, &req->query)) {
+			break;
+		}
+		if (ce->state != DNS_CACHE_PENDING
+				&& dns_cache_victim_better(ce, victim)) {
+			victim = ce;
+		}
+	}
+
+	if (i == MODOPS_DNS_CACHE_SIZE) {
+		if (victim) {
+			memcpy(&victim->query, &req->query, sizeof victim->query);
+			victim->state = DNS_CACHE_PENDING;
+			req->pending = victim;
+		}
+		ret = DNS_CACHE_MISS;
+		goto out;
+	}
+
+	switch (ce->state) {
+	case DNS_CACHE_VALID:
+		dns_stats.hits++;
+		ce->used = ++dns_cache_clock;
+		memcpy(&req->msg, &ce->msg, ce->msg_sz);
+		req->msg_sz = ce->msg_sz;
+		ret = 0;
+		break;
+	case DNS_CACHE_NEGATIVE:
+		dns_stats.neg_hits++;
+		ce->used = ++dns_cache_clock;
+		ret = ce->error;
+		break;
+	default:
+		if (!wait) {
+			ret = DNS_CACHE_MISS;
+			break;
+		}
+
+		dns_stats.coalesced++;
+		gen = ce->gen;
+		while (ce->gen == gen) {
+			cond_wait(&dns_cache_cond, &dns_cache_lock);
+		}
+		if (ce->gen == gen + 1 && ce->state == DNS_CACHE_FAILED) {
+			ret = ce->error;
+			break;
+		}
+		/* The reply is cached or the entry is already reused */
+		goto again;
+	}
+
+out:
+	mutex_unlock(&dns_cache_lock);
+
+	return ret;
+}
+
+static void dns_cache_done(struct dns_req *req, uint32_t ttl) {
+	struct dns_cache_entry *ce = req->pending;
+
+	if (!ce) {
+		return;
+	}
+
+	mutex_lock(&dns_cache_lock);
+	if (req->ret == 0 && ttl != 0
+			&& dns_reply_match(req, &req->msg, req->msg_sz)
+			&& dns_q_equal(&req->query, &ce->query)) {
+		ce->state = DNS_CACHE_VALID;
+		ce->expires = dns_time().tv_sec + ttl;
+		memcpy(&ce->msg, &req->msg, req->msg_sz);
+		ce->msg_sz = req->msg_sz;
+	} else if (req->ret == -ENOENT && ttl != 0) {
+		ce->state = DNS_CACHE_NEGATIVE;
+		ce->expires = dns_time().tv_sec + ttl;
+		ce->error = req->ret;
+	} else if (req->ret != 0) {
+		/* Waiters get the same error */
+		ce->state = DNS_CACHE_FAILED;
+		ce->error = req->ret;
+	} else {
+		/* Not cacheable, waiters query themselves */
+		ce->state = DNS_CACHE_FREE;
+	}
+	ce->used = ++dns_cache_clock;
+	ce->gen++;
+	cond_broadcast(&dns_cache_cond);
+	mutex_unlock(&dns_cache_lock);
+}
+
+/* Negative answers are kept as long as SOA of the zone tells (RFC 2308) */
+static uint32_t dns_negative_ttl(const struct dns_result *result) {
+	uint32_t ttl;
+	size_t i;
+
+	ttl = min((uint32_t)MODOPS_DNS_CACHE_TTL_MAX,
+			(uint32_t)MODOPS_DNS_NEGATIVE_TTL);
+	for (i = 0; i < result->nscount; ++i) {
+		if (result->ns[i].rtype == DNS_RR_TYPE_SOA) {
+			ttl = min(ttl, min(result->ns[i].rttl,
+					(uint32_t)result->ns[i].rdata.soa.minimum));
+		}
+	}
+
+	return ttl;
+}
+
+/**
+ * Time to keep the reply: the least TTL of answers, or the negative TTL
+ * for a reply without answers and for NXDOMAIN.
+ */
+static uint32_t dns_reply_ttl(struct dns_req *req,
+		const struct dns_result *result) {
+	struct dns_result nx_result;
+	uint32_t ttl;
+	size_t i;
+
+	if (req->ret == -ENOENT) {
+		/* The result is empty, SOA is in the authority section */
+		if (0 != dns_sections_parse(&req->msg, req->msg_sz, &nx_result)) {
+			return MODOPS_DNS_NEGATIVE_TTL;
+		}
+		ttl = dns_negative_ttl(&nx_result);
+		dns_result_free(&nx_result);
+		return ttl;
+	}
+	if (req->ret != 0) {
+		return 0;
+	}
+
+	if (result->ancount == 0) {
+		return dns_negative_ttl(result);
+	}
+
+	ttl = MODOPS_DNS_CACHE_TTL_MAX;
+	for (i = 0; i < result->ancount; ++i) {
+		ttl = min(ttl, result->an[i].rttl);
+	}
+
+	return ttl;
+}
+
+static int dns_req_init(struct dns_req *req, const char *qname,
+		enum dns_type qtype, enum dns_class qclass) {
 	size_t qname_sz;
 
 	qname_sz = strlen(qname) + 1;
-	if (qname_sz > sizeof query.qname) {
+	if (qname_sz > sizeof req->query.qname) {
 		return -EINVAL;
 	}
 
-	memcpy(&query.qname[0], qname, qname_sz);
-	query.qtype = qtype;
-	query.qclass = qclass;
+	memcpy(&req->query.qname[0], qname, qname_sz);
+	req->query.qtype = qtype;
+	req->query.qclass = qclass;
+	req->sent = 0;
+
+	return 0;
+}
+
+/**
+ * Resolves requests from the hosts file, the cache or the nameserver.
+ * Requests which are not answered locally are sent together. On failure
+ * the result is left empty.
+ */
+static void dns_resolve(struct dns_req *reqs, int nreqs,
+		struct dns_result *results) {
+	struct dns_req *to_send[DNS_REQ_MAX];
+	int i, nsend;
+
+	assert(nreqs <= DNS_REQ_MAX);
+
+	nsend = 0;
+	for (i = 0; i < nreqs; i++) {
+		memset(&results[i], 0, sizeof results[i]);
+
+		if (0 == dns_hosts_lookup(&reqs[i].query, &results[i])) {
+			mutex_lock(&dns_cache_lock);
+			dns_stats.queries++;
+			dns_stats.hosts_hits++;
+			mutex_unlock(&dns_cache_lock);
+			reqs[i].ret = 0;
+			continue;
+		}
+
+		/* Only a single query waits for another one, several queries
+		 * could wait for each other otherwise */
+		reqs[i].ret = dns_cache_lookup(&reqs[i], nreqs == 1);
+		if (reqs[i].ret == 0) {
+			reqs[i].ret = dns_result_parse(&reqs[i].msg, reqs[i].msg_sz,
+					&results[i]);
+		} else if (reqs[i].ret == DNS_CACHE_MISS) {
+			reqs[i].ret = dns_query_format(&reqs[i].query, &reqs[i].msg,
+					&reqs[i].msg_sz);
+			if (reqs[i].ret == 0) {
+				reqs[i].sent = 1;
+				to_send[nsend++] = &reqs[i];
+			} else {
+				dns_cache_done(&reqs[i], 0);
+			}
+		}
+	}
+
+	if (nsend != 0) {
+		dns_query_execute(to_send, nsend);
+	}
+
+	for (i = 0; i < nreqs; i++) {
+		if (!reqs[i].sent) {
+			continue;
+		}
+		if (reqs[i].ret == 0) {
+			reqs[i].ret = dns_result_parse(&reqs[i].msg, reqs[i].msg_sz,
+					&results[i]);
+		}
+		dns_cache_done(&reqs[i], dns_reply_ttl(&reqs[i], &results[i]));
+	}
+
+	for (i = 0; i < nreqs; i++) {
+		if (reqs[i].ret != 0) {
+			memset(&results[i], 0, sizeof results[i]);
+		}
+	}
+}
+
+int dns_query(const char *qname, enum dns_type qtype, enum dns_class qclass,
+		struct dns_result *out_result) {
+	struct dns_req req;
+	int ret;
+
+	ret = dns_req_init(&req, qname, qtype, qclass);
+	if (ret != 0) {
+		return ret;
+	}
+
+	dns_resolve(&req, 1, out_result);
+
+	return req.ret;
+}
+
+int dns_query_addr(const char *qname, struct dns_result *out_a,
+		struct dns_result *out_aaaa) {
+	struct dns_req reqs[2];
+	struct dns_result results[2];
+	int ret;
 
-	return dns_execute(&query, out_result);
+	ret = dns_req_init(&reqs[0], qname, DNS_RR_TYPE_A, DNS_RR_CLASS_IN);
+	if (ret != 0) {
+		return ret;
+	}
+	dns_req_init(&reqs[1], qname, DNS_RR_TYPE_AAAA, DNS_RR_CLASS_IN);
+
+	dns_resolve(&reqs[0], 2, &results[0]);
+
+	*out_a = results[0];
+	*out_aaaa = results[1];
+
+	return reqs[0].ret == 0 || reqs[1].ret == 0 ? 0 : reqs[0].ret;
+}
+
+void dns_cache_get_stats(struct dns_cache_stats *stats) {
+	mutex_lock(&dns_cache_lock);
+	memcpy(stats, &dns_stats, sizeof *stats);
+	mutex_unlock(&dns_cache_lock);
+}
+
+void dns_cache_flush(void) {
+	int i;
+
+	mutex_lock(&dns_cache_lock);
+	for (i = 0; i < MODOPS_DNS_CACHE_SIZE; i++) {
+		if (dns_cache[i].state != DNS_CACHE_PENDING) {
+			dns_cache[i].state = DNS_CACHE_FREE;
+		}
+	}
+	mutex_unlock(&dns_cache_lock);
 }
 
 int dns_result_free(struct dns_result *result) {
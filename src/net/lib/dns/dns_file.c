@@ -6,9 +6,15 @@
  * @author Ilia Vaprol
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
 
+#include <kernel/thread/sync/mutex.h>
 #include <util/err.h>
 
 #include <net/lib/dns.h>
@@ -21,6 +27,27 @@
 #define NAMESERVER_DEFAULT OPTION_STRING_GET(nameserver)
 #define RESOLV_FILE        OPTION_STRING_GET(resolv_file)
 
+/**
+ * Hosts file, which is looked up before the nameserver (empty to disable)
+ */
+#define HOSTS_FILE         OPTION_STRING_GET(hosts_file)
+#define HOSTS_MAX          OPTION_GET(NUMBER, hosts_max)
+
+struct dns_host {
+	char name[DNS_MAX_NAME_SZ];
+	uint16_t rtype;
+	uint16_t rdlength;
+	char address[IPv6_ADDR_LEN];
+};
+
+/* The hosts file is parsed again only when it is changed */
+static struct dns_host dns_hosts[HOSTS_MAX];
+static int dns_hosts_count;
+static int dns_hosts_loaded;
+static time_t dns_hosts_mtime;
+static size_t dns_hosts_size;
+static struct mutex dns_hosts_lock = MUTEX_INIT_STATIC;
+
 static char nameserver_ip[16]; /* only for IPv4 */
 
 const char *dns_get_nameserver(void) {
@@ -75,3 +102,124 @@ char *dns_init_nameserver(char *nameserver) {
 
 	return res;
 }
+
+static void dns_hosts_load(void) {
+	FILE *file;
+	char buf[0x80];
+	char address[IPv6_ADDR_LEN];
+	char *token, *name, *saveptr;
+	struct dns_host *host;
+	uint16_t rtype, rdlength;
+
+	dns_hosts_count = 0;
+
+	file = fopen(HOSTS_FILE, "r");
+	if (file == NULL) {
+		return;
+	}
+
+	while (NULL != fgets(buf, sizeof(buf), file)) {
+		token = strchr(buf, '#');
+		if (token != NULL) {
+			*token = '\0';
+		}
+
+		token = strtok_r(buf, " \t\r\n", &saveptr);
+		if (token == NULL) {
+			continue;
+		}
+		if (1 == inet_pton(AF_INET, token, address)) {
+			rtype = DNS_RR_TYPE_A;
+			rdlength = IP_ADDR_LEN;
+		} else if (1 == inet_pton(AF_INET6, token, address)) {
+			rtype = DNS_RR_TYPE_AAAA;
+			rdlength = IPv6_ADDR_LEN;
+		} else {
+			continue;
+		}
+
+		while (NULL != (name = strtok_r(NULL, " \t\r\n", &saveptr))) {
+			if (dns_hosts_count == HOSTS_MAX) {
+				goto out;
+			}
+			if (strlen(name) >= sizeof host->name) {
+				continue;
+			}
+
+			host = &dns_hosts[dns_hosts_count++];
+			strcpy(host->name, name);
+			host->rtype = rtype;
+			host->rdlength = rdlength;
+			memcpy(host->address, address, rdlength);
+		}
+	}
+out:
+	fclose(file);
+}
+
+int dns_hosts_lookup(const struct dns_q *query, struct dns_result *out_result) {
+	struct stat st;
+	struct dns_host *host;
+	struct dns_rr *rr;
+	int i, amount;
+
+	if (HOSTS_FILE[0] == '\0' || query->qclass != DNS_RR_CLASS_IN
+			|| (query->qtype != DNS_RR_TYPE_A
+				&& query->qtype != DNS_RR_TYPE_AAAA)) {
+		return -ENOENT;
+	}
+
+	if (0 != stat(HOSTS_FILE, &st)) {
+		return -ENOENT;
+	}
+
+	mutex_lock(&dns_hosts_lock);
+
+	if (!dns_hosts_loaded || st.st_mtime != dns_hosts_mtime
+			|| st.st_size != dns_hosts_size) {
+		dns_hosts_load();
+		dns_hosts_loaded = 1;
+		dns_hosts_mtime = st.st_mtime;
+		dns_hosts_size = st.st_size;
+	}
+
+	amount = 0;
+	for (i = 0, host = dns_hosts; i < dns_hosts_count; ++i, ++host) {
+		if (host->rtype == query->qtype
+				&& 0 == strcasecmp(host->name, &query->qname[0])) {
+			amount++;
+		}
+	}
+
+	if (amount == 0) {
+		mutex_unlock(&dns_hosts_lock);
+		return -ENOENT;
+	}
+
+	rr = calloc(amount, sizeof *rr);
+	if (rr == NULL) {
+		mutex_unlock(&dns_hosts_lock);
+		return -ENOMEM;
+	}
+
+	memset(out_result, 0, sizeof *out_result);
+	out_result->ancount = amount;
+	out_result->an = rr;
+
+	for (i = 0, host = dns_hosts; i < dns_hosts_count; ++i, ++host) {
+		if (host->rtype != query->qtype
+				|| 0 != strcasecmp(host->name, &query->qname[0])) {
+			continue;
+		}
+		strcpy(&rr->rname[0], host->name);
+		rr->rtype = host->rtype;
+		rr->rclass = DNS_RR_CLASS_IN;
+		rr->rdlength = host->rdlength;
+		memcpy(&rr->rdata, host->address, host->rdlength);
+		rr++;
+	}
+
+	mutex_unlock(&dns_hosts_lock);
+
+	return 0;
+}
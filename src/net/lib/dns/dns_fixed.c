@@ -6,6 +6,8 @@
  * @author Ilia Vaprol
  */
 
+#include <errno.h>
+
 #include <net/lib/dns.h>
 
 #include <framework/mod/options.h>
@@ -18,3 +20,7 @@
 const char * dns_get_nameserver(void) {
 	return MODOPS_NAMESERVER;
 }
+
+int dns_hosts_lookup(const struct dns_q *query, struct dns_result *out_result) {
+	return -ENOENT;
+}
@@ -89,6 +89,32 @@ enum clnt_stat clnt_call(struct client *clnt, __u32 procnum, xdrproc_t inproc,
 	return (*clnt->ops->call)(clnt, procnum, inproc, in, outproc, out, wait);
 }
 
+enum clnt_stat clnt_call_many(struct client *clnt, struct rpc_call *calls,
+		int count, struct timeval wait) {
+	enum clnt_stat stat;
+	int i;
+
+	assert(clnt != NULL);
+	assert(clnt->ops != NULL);
+	assert((calls != NULL) || (count == 0));
+
+	if (clnt->ops->call_many != NULL) {
+		return (*clnt->ops->call_many)(clnt, calls, count, wait);
+	}
+
+	stat = RPC_SUCCESS;
+	for (i = 0; i < count; i++) {
+		calls[i].status = clnt_call(clnt, calls[i].procnum,
+				calls[i].inproc, calls[i].in,
+				calls[i].outproc, calls[i].out, wait);
+		if ((stat == RPC_SUCCESS) && (calls[i].status != RPC_SUCCESS)) {
+			stat = calls[i].status;
+		}
+	}
+
+	return stat;
+}
+
 void clnt_geterr(struct client *clnt, struct rpc_err *perr) {
 	assert(clnt != NULL);
 	assert(clnt->ops != NULL);
@@ -84,22 +84,42 @@ exit_with_error:
 	return NULL;
 }
 
-static enum clnt_stat clnttcp_call(struct client *clnt, uint32_t procnum,
-		xdrproc_t inproc, char *in, xdrproc_t outproc, char *out,
-		struct timeval timeout) {
+static enum clnt_stat reply_status(struct rpc_msg *msg) {
+	if (msg->type != REPLY) {
+		return RPC_CANTDECODERES;
+	}
+	if (msg->b.reply.stat != MSG_ACCEPTED) {
+		return msg->b.reply.r.rejected.stat == RPC_MISMATCH
+				? RPC_VERSMISMATCH : RPC_AUTHERROR;
+	}
+	switch (msg->b.reply.r.accepted.stat) {
+	case SUCCESS:
+		return RPC_SUCCESS;
+	case PROG_UNAVAIL:
+		return RPC_PROGUNAVAIL;
+	case PROG_MISMATCH:
+		return RPC_PROGVERSMISMATCH;
+	case PROC_UNAVAIL:
+		return RPC_PROCUNAVAIL;
+	default:
+		return RPC_CANTDECODEARGS;
+	}
+}
+
+/*
+ * All calls are written to the stream before the first reply is read, so
+ * the server works on them concurrently. Replies are matched by xid, which
+ * also lets us drop a late reply to a call that has timed out before.
+ */
+static enum clnt_stat clnttcp_call_many(struct client *clnt,
+		struct rpc_call *calls, int count, struct timeval timeout) {
 	struct xdr xstream;
 	struct rpc_msg msg_reply, msg_call;
+	enum clnt_stat stat;
+	uint32_t xid;
+	int i, pending;
 
-	assert((clnt != NULL) && (inproc != NULL));
-
-	msg_call.xid = (uint32_t)rand();
-	msg_call.type = CALL;
-	msg_call.b.call.rpcvers = RPC_VERSION;
-	msg_call.b.call.prog = clnt->prognum;
-	msg_call.b.call.vers = clnt->versnum;
-	msg_call.b.call.proc = procnum;
-	memcpy(&msg_call.b.call.cred, &clnt->ath->cred, sizeof clnt->ath->cred);
-	memcpy(&msg_call.b.call.verf, &clnt->ath->verf, sizeof clnt->ath->verf);
+	assert((clnt != NULL) && ((calls != NULL) || (count == 0)));
 
 	if (-1 == setsockopt(clnt->sock, SOL_SOCKET, SO_RCVTIMEO,
 				&timeout, sizeof timeout)) {
@@ -108,41 +128,120 @@ static enum clnt_stat clnttcp_call(struct client *clnt, uint32_t procnum,
 		return clnt->err.status = RPC_SYSTEMERROR;
 	}
 
+	for (i = 0; i < count; i++) {
+		calls[i].status = RPC_INPROGRESS;
+	}
+
 	xdrrec_create(&xstream, clnt->extra.tcp.sendsz, clnt->extra.tcp.recvsz,
 			(char *)clnt, (xdrrec_hnd_t)readtcp, (xdrrec_hnd_t)writetcp);
 
 	xstream.oper = XDR_ENCODE;
 
 	clnt->err.status = RPC_SUCCESS;
-	if (!xdr_rpc_msg(&xstream, &msg_call)
-			|| !(*inproc)(&xstream, in)) {
-		if (clnt->err.status == RPC_SUCCESS) {
-			clnt->err.status = RPC_CANTENCODEARGS;
+	xid = (uint32_t)rand();
+	for (i = 0; i < count; i++) {
+		calls[i].xid = xid + i;
+
+		msg_call.xid = calls[i].xid;
+		msg_call.type = CALL;
+		msg_call.b.call.rpcvers = RPC_VERSION;
+		msg_call.b.call.prog = clnt->prognum;
+		msg_call.b.call.vers = clnt->versnum;
+		msg_call.b.call.proc = calls[i].procnum;
+		memcpy(&msg_call.b.call.cred, &clnt->ath->cred, sizeof clnt->ath->cred);
+		memcpy(&msg_call.b.call.verf, &clnt->ath->verf, sizeof clnt->ath->verf);
+
+		assert(calls[i].inproc != NULL);
+		if (!xdr_rpc_msg(&xstream, &msg_call)
+				|| !(*calls[i].inproc)(&xstream, calls[i].in)) {
+			if (clnt->err.status == RPC_SUCCESS) {
+				clnt->err.status = RPC_CANTENCODEARGS;
+			}
+			goto exit_with_status;
 		}
-		goto exit_with_status;
-	}
 
-	if (!xdrrec_endofrecord(&xstream, 1)) {
-		clnt->err.status = RPC_CANTSEND;
-		goto exit_with_status;
+		if (!xdrrec_endofrecord(&xstream, 1)) {
+			clnt->err.status = RPC_CANTSEND;
+			goto exit_with_status;
+		}
 	}
 
 	xstream.oper = XDR_DECODE;
 
-	msg_reply.b.reply.r.accepted.d.result.decoder = outproc;
-	msg_reply.b.reply.r.accepted.d.result.param = out;
-	assert(clnt->err.status == RPC_SUCCESS);
-	if (!xdr_rpc_msg(&xstream, &msg_reply)) {
-		if (clnt->err.status == RPC_SUCCESS) {
-			clnt->err.status = RPC_CANTDECODERES;
+	pending = count;
+	while (pending > 0) {
+		if (!xdr_u_int(&xstream, &msg_reply.xid)) {
+			if (clnt->err.status == RPC_SUCCESS) {
+				clnt->err.status = RPC_CANTDECODERES;
+			}
+			goto exit_with_status;
+		}
+
+		for (i = 0; i < count; i++) {
+			if ((calls[i].status == RPC_INPROGRESS)
+					&& (calls[i].xid == msg_reply.xid)) {
+				break;
+			}
+		}
+
+		if (i < count) {
+			msg_reply.b.reply.r.accepted.d.result.decoder = calls[i].outproc;
+			msg_reply.b.reply.r.accepted.d.result.param = calls[i].out;
+			if (!xdr_rpc_msg_body(&xstream, &msg_reply)) {
+				if (clnt->err.status != RPC_SUCCESS) {
+					goto exit_with_status; /* transport failure */
+				}
+				calls[i].status = RPC_CANTDECODERES;
+			}
+			else {
+				calls[i].status = reply_status(&msg_reply);
+			}
+			pending--;
+		}
+		else {
+			log_debug("drop reply with unknown xid %u", msg_reply.xid);
+		}
+
+		/* Step over the unread tail of the record */
+		if (!xdrrec_skiprecord(&xstream)) {
+			if (clnt->err.status == RPC_SUCCESS) {
+				clnt->err.status = RPC_CANTRECV;
+			}
+			goto exit_with_status;
 		}
-		goto exit_with_status;
 	}
 
-	assert(clnt->err.status == RPC_SUCCESS);
 exit_with_status:
 	xdr_destroy(&xstream);
-	return clnt->err.status;
+
+	stat = clnt->err.status;
+	for (i = 0; i < count; i++) {
+		if (calls[i].status == RPC_INPROGRESS) {
+			assert(clnt->err.status != RPC_SUCCESS);
+			calls[i].status = clnt->err.status;
+		}
+		if ((stat == RPC_SUCCESS) && (calls[i].status != RPC_SUCCESS)) {
+			stat = calls[i].status;
+		}
+	}
+
+	return clnt->err.status = stat;
+}
+
+static enum clnt_stat clnttcp_call(struct client *clnt, uint32_t procnum,
+		xdrproc_t inproc, char *in, xdrproc_t outproc, char *out,
+		struct timeval timeout) {
+	struct rpc_call call;
+
+	assert((clnt != NULL) && (inproc != NULL));
+
+	call.procnum = procnum;
+	call.inproc = inproc;
+	call.in = in;
+	call.outproc = outproc;
+	call.out = out;
+
+	return clnttcp_call_many(clnt, &call, 1, timeout);
 }
 
 static void clnttcp_geterr(struct client *clnt, struct rpc_err *perr) {
@@ -189,6 +288,7 @@ static int writetcp(struct client *clnt, char *buff, size_t len) {
 
 static const struct clnt_ops clnttcp_ops = {
 		.call = clnttcp_call,
+		.call_many = clnttcp_call_many,
 		.geterr = clnttcp_geterr,
 		.destroy = clnttcp_destroy
 };
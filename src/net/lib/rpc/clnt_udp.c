@@ -166,9 +166,15 @@ recv_again:
 	}
 
 	xdrmem_create(&xstream, buff, res, XDR_DECODE);
+	if (!xdr_u_int(&xstream, &msg_reply.xid)
+			|| (msg_reply.xid != msg_call.xid)) {
+		/* reply to a previous (retransmitted) call */
+		xdr_destroy(&xstream);
+		goto recv_again;
+	}
 	msg_reply.b.reply.r.accepted.d.result.decoder = outproc;
 	msg_reply.b.reply.r.accepted.d.result.param = out;
-	if (!xdr_rpc_msg(&xstream, &msg_reply)) {
+	if (!xdr_rpc_msg_body(&xstream, &msg_reply)) {
 		clnt->err.status = RPC_CANTDECODERES;
 		xdr_destroy(&xstream);
 		goto exit_with_status;
@@ -90,7 +90,7 @@ int xdr_reply_body(struct xdr *xs, struct reply_body *rb) {
 	return XDR_SUCCESS;
 }
 
-int xdr_rpc_msg(struct xdr *xs, struct rpc_msg *msg) {
+int xdr_rpc_msg_body(struct xdr *xs, struct rpc_msg *msg) {
 	static const struct xdr_discrim msg_dscrm[] = {
 			{ CALL, (xdrproc_t)xdr_call_body },
 			{ REPLY, (xdrproc_t)xdr_reply_body },
@@ -101,8 +101,7 @@ int xdr_rpc_msg(struct xdr *xs, struct rpc_msg *msg) {
 	assert(msg != NULL);
 
 	msg_type = msg->type;
-	if (!xdr_u_int(xs, &msg->xid)
-			|| !xdr_union(xs, &msg_type, &msg->b, msg_dscrm, NULL)) {
+	if (!xdr_union(xs, &msg_type, &msg->b, msg_dscrm, NULL)) {
 		return XDR_FAILURE;
 	}
 
@@ -110,3 +109,9 @@ int xdr_rpc_msg(struct xdr *xs, struct rpc_msg *msg) {
 
 	return XDR_SUCCESS;
 }
+
+int xdr_rpc_msg(struct xdr *xs, struct rpc_msg *msg) {
+	assert(msg != NULL);
+
+	return xdr_u_int(xs, &msg->xid) && xdr_rpc_msg_body(xs, msg);
+}
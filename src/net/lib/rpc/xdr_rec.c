@@ -182,57 +182,97 @@ static int flush_data(struct xdr *xs, char is_last) {
 	return XDR_SUCCESS;
 }
 
-static int prepare_data(struct xdr *xs, uint32_t necessary) {
-	int res, bytes;
-	uint32_t len;
+static int read_header(struct xdr *xs) {
+	union xdrrec_hdr hdr;
 
-	/* Can we give required amount of data? */
-	if (necessary <= xs->extra.rec.in_prep) {
-		return XDR_SUCCESS;
+	if ((*xs->extra.rec.in_hnd)(xs->extra.rec.handle,
+			(char *)&hdr, sizeof hdr) != sizeof hdr) {
+		return XDR_FAILURE;
 	}
+	hdr.unit = decode_unit(hdr.unit);
+	xs->extra.rec.in_last = hdr.h.is_last;
+	xs->extra.rec.in_left = hdr.h.len;
 
-	/* How much bytes left in current message? */
-	if (xs->extra.rec.in_left != 0) {
-		len = xs->extra.rec.in_left;
-	}
-	else {
-		union xdrrec_hdr hdr;
-		if ((xs->extra.rec.in_prep != 0)
-				&& xs->extra.rec.in_last) {
-			return XDR_FAILURE;
+	return XDR_SUCCESS;
+}
+
+static int prepare_data(struct xdr *xs, uint32_t necessary) {
+	int res;
+	size_t room;
+
+	/* A stream socket may hand out a fragment in several pieces, so keep
+	 * receiving until the required amount of data is buffered */
+	while (necessary > xs->extra.rec.in_prep) {
+		/* How much bytes left in current message? */
+		if (xs->extra.rec.in_left == 0) {
+			if ((xs->extra.rec.in_prep != 0)
+					&& xs->extra.rec.in_last) {
+				return XDR_FAILURE;
+			}
+			if (!read_header(xs)) {
+				return XDR_FAILURE;
+			}
+			continue;
+		}
+
+		/* Prepare memory for in-coming bytes */
+		assert(xs->extra.rec.in_curr + xs->extra.rec.in_prep <= xs->extra.rec.in_boundry);
+		room = xs->extra.rec.in_boundry - xs->extra.rec.in_curr
+				- xs->extra.rec.in_prep;
+		if (room < min(xs->extra.rec.in_left, necessary)) {
+			memmove(xs->extra.rec.in_base, xs->extra.rec.in_curr, xs->extra.rec.in_prep);
+			xs->extra.rec.in_curr = xs->extra.rec.in_base;
+			room = xs->extra.rec.in_boundry - xs->extra.rec.in_curr
+					- xs->extra.rec.in_prep;
+		}
+		if (room == 0) {
+			return XDR_FAILURE; /* the buffer is too small */
 		}
-		if ((*xs->extra.rec.in_hnd)(xs->extra.rec.handle,
-				(char *)&hdr, sizeof hdr) != sizeof hdr) {
+
+		/* Receiving of data */
+		res = (*xs->extra.rec.in_hnd)(xs->extra.rec.handle,
+				xs->extra.rec.in_curr + xs->extra.rec.in_prep,
+				min(xs->extra.rec.in_left, room));
+		if (res <= 0) {
 			return XDR_FAILURE;
 		}
-		hdr.unit = decode_unit(hdr.unit);
-		xs->extra.rec.in_last = hdr.h.is_last;
-		len = hdr.h.len;
-	}
 
-	/* Prepare memory for in-coming bytes */
-	assert(xs->extra.rec.in_curr + xs->extra.rec.in_prep <= xs->extra.rec.in_boundry);
-	if (xs->extra.rec.in_boundry - xs->extra.rec.in_curr - xs->extra.rec.in_prep < len) {
-		memmove(xs->extra.rec.in_base, xs->extra.rec.in_curr, xs->extra.rec.in_prep);
-		xs->extra.rec.in_curr = xs->extra.rec.in_base;
+		assert(res <= xs->extra.rec.in_left);
+		xs->extra.rec.in_prep += res;
+		xs->extra.rec.in_left -= res;
 	}
 
-	/* How much bytes we will try receive ? */
-	bytes = min(len, xs->extra.rec.in_boundry - xs->extra.rec.in_curr
-			- xs->extra.rec.in_prep);
+	return XDR_SUCCESS;
+}
 
-	/* Receiving of data */
-	res = (*xs->extra.rec.in_hnd)(xs->extra.rec.handle,
-			xs->extra.rec.in_curr + xs->extra.rec.in_prep, bytes);
-	if (res <= 0) {
-		return XDR_FAILURE;
-	}
+int xdrrec_skiprecord(struct xdr *xs) {
+	int res;
 
-	xs->extra.rec.in_prep += res;
-	assert(res <= len);
-	xs->extra.rec.in_left = len - res;
+	assert(xs != NULL);
 
-	return necessary <= xs->extra.rec.in_prep ? XDR_SUCCESS : XDR_FAILURE;
+	/* Drop whatever is left of the current record, so the next getunit
+	 * starts with the header of the following one */
+	xs->extra.rec.in_curr = xs->extra.rec.in_base;
+	xs->extra.rec.in_prep = 0;
+
+	while ((xs->extra.rec.in_left != 0) || !xs->extra.rec.in_last) {
+		if (xs->extra.rec.in_left == 0) {
+			if (!read_header(xs)) {
+				return XDR_FAILURE;
+			}
+			continue;
+		}
+
+		res = (*xs->extra.rec.in_hnd)(xs->extra.rec.handle, xs->extra.rec.in_base,
+				min(xs->extra.rec.in_left,
+					xs->extra.rec.in_boundry - xs->extra.rec.in_base));
+		if (res <= 0) {
+			return XDR_FAILURE;
+		}
+		xs->extra.rec.in_left -= res;
+	}
+
+	return XDR_SUCCESS;
 }
 
 static const struct xdr_ops xdrrec_ops = {
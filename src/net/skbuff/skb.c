@@ -29,7 +29,14 @@
 #include <framework/mod/options.h>
 
 #define MODOPS_AMOUNT_SKB       OPTION_GET(NUMBER, amount_skb)
+#define MODOPS_AMOUNT_SKB_MAX   OPTION_GET(NUMBER, amount_skb_max)
+
+#if MODOPS_AMOUNT_SKB_MAX > MODOPS_AMOUNT_SKB
+POOL_DEF_ELASTIC(skb_pool, struct sk_buff, MODOPS_AMOUNT_SKB,
+		MODOPS_AMOUNT_SKB_MAX);
+#else
 POOL_DEF(skb_pool, struct sk_buff, MODOPS_AMOUNT_SKB);
+#endif
 
 struct sk_buff * skb_wrap(size_t size, struct sk_buff_data *skb_data) {
 	return skb_wrap_local(size, skb_data, &skb_pool);
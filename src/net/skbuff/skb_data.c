@@ -26,6 +26,7 @@
 #include <framework/mod/options.h>
 
 #define MODOPS_AMOUNT_SKB_DATA  OPTION_GET(NUMBER, amount_skb_data)
+#define MODOPS_AMOUNT_SKB_DATA_MAX OPTION_GET(NUMBER, amount_skb_data_max)
 #define MODOPS_DATA_SIZE        OPTION_GET(NUMBER, data_size)
 #define MODOPS_DATA_ALIGN       OPTION_GET(NUMBER, data_align)
 #define MODOPS_DATA_PADTO       OPTION_GET(NUMBER, data_padto)
@@ -55,7 +56,12 @@ struct sk_buff_data {
 	char __data[];
 } DATA_ATTR;
 
+#if MODOPS_AMOUNT_SKB_DATA_MAX > MODOPS_AMOUNT_SKB_DATA
+POOL_DEF_ELASTIC(skb_data_pool, struct sk_buff_data_fixed,
+		MODOPS_AMOUNT_SKB_DATA, MODOPS_AMOUNT_SKB_DATA_MAX);
+#else
 POOL_DEF(skb_data_pool, struct sk_buff_data_fixed, MODOPS_AMOUNT_SKB_DATA);
+#endif
 
 void *skb_get_data_pointner(struct sk_buff_data *skb_data) {
 	return skb_data->__data + IP_ALIGN_SIZE;
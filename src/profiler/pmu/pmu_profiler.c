@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @brief Hardware performance counters: counting and overflow sampling
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <hal/ipl.h>
+#include <hal/pmu.h>
+#include <kernel/irq.h>
+#include <kernel/sched.h>
+#include <kernel/task.h>
+#include <kernel/thread.h>
+
+#include <profiler/pmu/pmu_profiler.h>
+#include <profiler/sampling/raw_sample.h>
+
+static const char *const pmu_event_names[PMU_EV_TOTAL] = {
+	[PMU_EV_CYCLES]        = "cycles",
+	[PMU_EV_INSTRUCTIONS]  = "instructions",
+	[PMU_EV_CACHE_MISSES]  = "cache-misses",
+	[PMU_EV_BRANCH_MISSES] = "branch-misses",
+};
+
+static enum pmu_event count_ev[THREAD_PMU_COUNTERS];
+static int count_n;
+static volatile unsigned int count_mask;
+
+static int sample_cnt = -1;
+static uint32_t sample_period;
+
+const char *pmu_event_name(enum pmu_event ev) {
+	return ev < PMU_EV_TOTAL ? pmu_event_names[ev] : NULL;
+}
+
+unsigned int pmu_count_mask(void) {
+	return count_mask;
+}
+
+int pmu_count_events(enum pmu_event *ev) {
+	int i;
+
+	if (ev) {
+		for (i = 0; i < count_n; i++) {
+			ev[i] = count_ev[i];
+		}
+	}
+
+	return count_n;
+}
+
+static void pmu_count_reset_threads(void) {
+	struct task *task;
+	struct thread *t;
+
+	sched_lock();
+	{
+		task_foreach(task) {
+			task_foreach_thread(t, task) {
+				thread_pmu_init(&t->pmu);
+			}
+		}
+	}
+	sched_unlock();
+}
+
+int pmu_count_start(const enum pmu_event *ev, int n) {
+	int avail, i, res;
+	ipl_t ipl;
+
+	avail = pmu_counters_total() - (sample_cnt >= 0 ? 1 : 0);
+	if (n <= 0 || n > THREAD_PMU_COUNTERS || n > avail) {
+		return -EINVAL;
+	}
+
+	pmu_count_stop();
+
+	ipl = ipl_save();
+	{
+		for (i = 0; i < n; i++) {
+			res = pmu_counter_setup(i, ev[i], 0);
+			if (res) {
+				ipl_restore(ipl);
+				return res;
+			}
+			count_ev[i] = ev[i];
+		}
+		count_n = n;
+	}
+	ipl_restore(ipl);
+
+	pmu_count_reset_threads();
+
+	ipl = ipl_save();
+	{
+		for (i = 0; i < n; i++) {
+			pmu_counter_enable(i);
+		}
+		count_mask = (1 << n) - 1;
+	}
+	ipl_restore(ipl);
+
+	return 0;
+}
+
+void pmu_count_stop(void) {
+	ipl_t ipl;
+	int i;
+
+	ipl = ipl_save();
+	{
+		/* Hand the current slice over to running thread */
+		thread_pmu_switch(&thread_self()->pmu, &thread_self()->pmu);
+
+		for (i = 0; i < count_n; i++) {
+			pmu_counter_disable(i);
+		}
+		count_mask = 0;
+	}
+	ipl_restore(ipl);
+}
+
+static irq_return_t pmu_overflow_handler(unsigned int irq_nr, void *data) {
+	unsigned int status;
+
+	status = pmu_overflow_status();
+	if (sample_cnt < 0 || !(status & (1 << sample_cnt))) {
+		pmu_overflow_clear(status);
+		return IRQ_NONE;
+	}
+
+	pmu_counter_write(sample_cnt, -(uint64_t) sample_period);
+
+	sample_raw_capture();
+
+	pmu_overflow_clear(status);
+
+	return IRQ_HANDLED;
+}
+
+int pmu_sample_start(enum pmu_event ev, uint32_t period) {
+	int cnt, res;
+
+	if (period == 0 || pmu_irq_nr() < 0) {
+		return -EINVAL;
+	}
+
+	pmu_sample_stop();
+
+	cnt = pmu_counters_total() - 1;
+	if (cnt < count_n) {
+		return -EBUSY;
+	}
+
+	res = pmu_counter_setup(cnt, ev, 1);
+	if (res) {
+		return res;
+	}
+
+	res = irq_attach(pmu_irq_nr(), pmu_overflow_handler, 0, NULL, "pmu");
+	if (res) {
+		return res;
+	}
+
+	sample_cnt = cnt;
+	sample_period = period;
+
+	pmu_counter_write(cnt, -(uint64_t) period);
+	pmu_counter_enable(cnt);
+
+	return 0;
+}
+
+void pmu_sample_stop(void) {
+	if (sample_cnt < 0) {
+		return;
+	}
+
+	pmu_counter_disable(sample_cnt);
+	irq_detach(pmu_irq_nr(), NULL);
+	sample_cnt = -1;
+}
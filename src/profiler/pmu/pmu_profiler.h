@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Hardware performance counters: counting and overflow sampling
+ *
+ * Counting mode programs counters starting from 0, sampling mode takes the
+ * last counter of the unit. Both act on the CPU of the caller.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef PROFILER_PMU_PMU_PROFILER_H_
+#define PROFILER_PMU_PMU_PROFILER_H_
+
+#include <stdint.h>
+
+#include <hal/pmu.h>
+
+struct thread;
+
+extern const char *pmu_event_name(enum pmu_event ev);
+
+/**
+ * Starts counting @a n events, event @c ev[i] goes to counter @c i.
+ * Counters are zeroed and accounted per thread on every context switch.
+ */
+extern int pmu_count_start(const enum pmu_event *ev, int n);
+extern void pmu_count_stop(void);
+
+/** @return Number of counted events, fills @a ev if not NULL. */
+extern int pmu_count_events(enum pmu_event *ev);
+
+/** @return Bit mask of counters used by counting mode. */
+extern unsigned int pmu_count_mask(void);
+
+/** @return Events counted on behalf of @a t since counting was started. */
+extern uint64_t pmu_count_thread(struct thread *t, int cnt);
+
+/**
+ * Samples call chain into the raw sampling profiler every @a period
+ * occurrences of @a ev.
+ */
+extern int pmu_sample_start(enum pmu_event ev, uint32_t period);
+extern void pmu_sample_stop(void);
+
+#endif /* PROFILER_PMU_PMU_PROFILER_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief Accounts hardware counters to threads on context switch
+ *
+ * @date 17.10.2026
+ */
+
+#include <string.h>
+
+#include <hal/pmu.h>
+#include <kernel/thread.h>
+#include <kernel/thread/thread_pmu.h>
+
+#include <profiler/pmu/pmu_profiler.h>
+
+void thread_pmu_init(struct thread_pmu *tp) {
+	memset(tp, 0, sizeof(*tp));
+}
+
+void thread_pmu_switch(struct thread_pmu *prev, struct thread_pmu *next) {
+	unsigned int mask;
+	int i;
+
+	mask = pmu_count_mask();
+
+	/* Counter runs from zero for every slice, so the value read is
+	 * exactly what the outgoing thread has spent */
+	for (i = 0; mask && i < THREAD_PMU_COUNTERS; i++, mask >>= 1) {
+		if (mask & 1) {
+			prev->count[i] += pmu_counter_read(i);
+			pmu_counter_write(i, 0);
+		}
+	}
+}
+
+uint64_t pmu_count_thread(struct thread *t, int cnt) {
+	uint64_t res;
+
+	if (cnt < 0 || cnt >= THREAD_PMU_COUNTERS) {
+		return 0;
+	}
+
+	res = t->pmu.count[cnt];
+	if (t == thread_self() && (pmu_count_mask() & (1 << cnt))) {
+		res += pmu_counter_read(cnt);
+	}
+
+	return res;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file
+ * @brief
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef THREAD_PMU_IMPL_H_
+#define THREAD_PMU_IMPL_H_
+
+#include <stdint.h>
+
+#include <framework/mod/options.h>
+
+#define THREAD_PMU_COUNTERS \
+	OPTION_MODULE_GET(embox__profiler__pmu__pmu_profiler, NUMBER, counters)
+
+struct thread_pmu {
+	uint64_t count[THREAD_PMU_COUNTERS];
+};
+
+extern void thread_pmu_init(struct thread_pmu *tp);
+extern void thread_pmu_switch(struct thread_pmu *prev,
+		struct thread_pmu *next);
+
+#endif /* THREAD_PMU_IMPL_H_ */
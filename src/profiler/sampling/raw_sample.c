@@ -0,0 +1,289 @@
+/**
+ * @file
+ * @brief Sampling profiler storing raw call-chain addresses
+ *
+ * Timer handler only walks the stack and copies return addresses into a
+ * per-CPU single-producer ring. Everything else (aggregation, symbol lookup)
+ * is done in the context of the reader.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <execinfo.h>
+
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/printk.h>
+#include <kernel/thread/sync/mutex.h>
+#include <kernel/time/timer.h>
+#include <util/math.h>
+
+#include <framework/mod/options.h>
+
+#include <profiler/sampling/raw_sample.h>
+
+#define SAMPLE_RAW_INTERVAL   OPTION_GET(NUMBER, interval)
+#define SAMPLE_RAW_RING_SIZE  OPTION_GET(NUMBER, ring_size)
+#define SAMPLE_RAW_TABLE_SIZE OPTION_GET(NUMBER, table_size)
+#define SAMPLE_RAW_MAX_DEPTH  OPTION_GET(NUMBER, max_depth)
+#define SAMPLE_RAW_SKIP       OPTION_GET(NUMBER, skip_frames)
+
+/* Frames of the sampler, from backtrace() to the caller of the capture */
+#define SAMPLE_RAW_OWN_MAX    8
+
+/* Stack walk inside the handler includes the handler itself */
+#define SAMPLE_RAW_BT_SIZE \
+	(SAMPLE_RAW_MAX_DEPTH + SAMPLE_RAW_SKIP + SAMPLE_RAW_OWN_MAX)
+
+#define __barrier() __asm__ __volatile__("" : : : "memory")
+
+struct raw_sample {
+	int depth;
+	void *pc[SAMPLE_RAW_MAX_DEPTH];
+};
+
+/* Indexes are free running, slot is taken modulo ring size. Only the timer
+ * handler on the owning CPU moves head, only the reader moves tail. */
+struct raw_sample_ring {
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	volatile unsigned int dropped;
+	struct raw_sample samples[SAMPLE_RAW_RING_SIZE];
+};
+
+struct raw_sample_stack {
+	uint32_t hash;
+	unsigned int count;
+	struct raw_sample chain;
+};
+
+static struct raw_sample_ring sample_ring __cpudata__;
+
+static struct raw_sample_stack sample_table[SAMPLE_RAW_TABLE_SIZE];
+static unsigned int table_dropped;
+static struct mutex table_mutex = MUTEX_INIT_STATIC;
+
+static bool is_running = false;
+static sys_timer_t *sampling_timer;
+
+/* Frames up to @a caller (a return address) are the sampler's own, and
+ * @a extra frames more are dropped too */
+static void __attribute__((noinline)) sample_raw_capture_from(void *caller,
+		int extra) {
+	struct raw_sample_ring *ring;
+	struct raw_sample *s;
+	void *bt[SAMPLE_RAW_BT_SIZE];
+	unsigned int head;
+	ipl_t ipl;
+	int n, skip;
+
+	n = backtrace(bt, SAMPLE_RAW_BT_SIZE);
+
+	/* The number of own frames depends on the architecture and inlining */
+	for (skip = 0; skip < n && skip < SAMPLE_RAW_OWN_MAX; skip++) {
+		if (bt[skip] == caller) {
+			break;
+		}
+	}
+	skip = skip < n && skip < SAMPLE_RAW_OWN_MAX ? skip + 1 : 0;
+	skip += extra;
+
+	n = min(n - skip, SAMPLE_RAW_MAX_DEPTH);
+	if (n <= 0) {
+		return;
+	}
+
+	/* Timer and PMU overflow may both sample on the same CPU, keep a
+	 * single producer per ring by closing interrupts for the copy only */
+	ipl = ipl_save();
+	{
+		ring = cpudata_ptr(&sample_ring);
+
+		head = ring->head;
+		if (head - ring->tail >= SAMPLE_RAW_RING_SIZE) {
+			ring->dropped++;
+		} else {
+			s = &ring->samples[head % SAMPLE_RAW_RING_SIZE];
+			s->depth = n;
+			memcpy(s->pc, &bt[skip], n * sizeof(void *));
+
+			__barrier();
+			ring->head = head + 1;
+		}
+	}
+	ipl_restore(ipl);
+}
+
+/* Not inlined, so the return address is in the caller */
+void __attribute__((noinline)) sample_raw_capture(void) {
+	sample_raw_capture_from(__builtin_return_address(0), 0);
+}
+
+static void __attribute__((noinline)) sample_raw_timer_handler(
+		sys_timer_t *timer, void *param) {
+	/* Drop the timer strategy too */
+	sample_raw_capture_from(__builtin_return_address(0), SAMPLE_RAW_SKIP);
+}
+
+static uint32_t sample_raw_hash(const struct raw_sample *s) {
+	uint32_t hash = 2166136261u;
+	int i;
+
+	for (i = 0; i < s->depth; i++) {
+		hash = (hash ^ (uint32_t) (uintptr_t) s->pc[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+static int sample_raw_chain_eq(const struct raw_sample *a,
+		const struct raw_sample *b) {
+	return a->depth == b->depth
+		&& !memcmp(a->pc, b->pc, a->depth * sizeof(void *));
+}
+
+/* Must be called with table_mutex held */
+static void sample_raw_account(const struct raw_sample *s) {
+	struct raw_sample_stack *st;
+	uint32_t hash;
+	int i, idx;
+
+	hash = sample_raw_hash(s);
+	idx = hash % SAMPLE_RAW_TABLE_SIZE;
+
+	for (i = 0; i < SAMPLE_RAW_TABLE_SIZE; i++) {
+		st = &sample_table[idx];
+
+		if (st->count == 0) {
+			st->hash = hash;
+			st->chain = *s;
+			st->count = 1;
+			return;
+		}
+
+		if (st->hash == hash && sample_raw_chain_eq(&st->chain, s)) {
+			st->count++;
+			return;
+		}
+
+		idx = (idx + 1) % SAMPLE_RAW_TABLE_SIZE;
+	}
+
+	table_dropped++;
+}
+
+/* Must be called with table_mutex held */
+static void sample_raw_drain(void) {
+	struct raw_sample_ring *ring;
+	unsigned int tail, head;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &sample_ring);
+
+		head = ring->head;
+		__barrier();
+
+		for (tail = ring->tail; tail != head; tail++) {
+			sample_raw_account(&ring->samples[tail % SAMPLE_RAW_RING_SIZE]);
+		}
+
+		__barrier();
+		ring->tail = tail;
+	}
+}
+
+int sample_raw_for_each(sample_raw_cb_t cb, void *arg) {
+	struct raw_sample_stack *st;
+	int i, res = 0;
+
+	mutex_lock(&table_mutex);
+
+	sample_raw_drain();
+
+	for (i = 0; i < SAMPLE_RAW_TABLE_SIZE; i++) {
+		st = &sample_table[i];
+		if (st->count == 0) {
+			continue;
+		}
+
+		cb(st->chain.pc, st->chain.depth, st->count, arg);
+		res++;
+	}
+
+	mutex_unlock(&table_mutex);
+
+	return res;
+}
+
+unsigned int sample_raw_dropped(void) {
+	unsigned int res;
+	int cpu;
+
+	res = table_dropped;
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		res += cpudata_cpu_ptr(cpu, &sample_ring)->dropped;
+	}
+
+	return res;
+}
+
+void sample_raw_reset(void) {
+	struct raw_sample_ring *ring;
+	int cpu;
+
+	mutex_lock(&table_mutex);
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		ring = cpudata_cpu_ptr(cpu, &sample_ring);
+		ring->tail = ring->head;
+		ring->dropped = 0;
+	}
+
+	memset(sample_table, 0, sizeof(sample_table));
+	table_dropped = 0;
+
+	mutex_unlock(&table_mutex);
+}
+
+bool sample_raw_is_running(void) {
+	return is_running;
+}
+
+int sample_raw_start(int interval) {
+	int res;
+
+	if (is_running) {
+		sample_raw_stop();
+	}
+
+	interval = (interval == 0) ? SAMPLE_RAW_INTERVAL : interval;
+
+	res = timer_set(&sampling_timer, TIMER_PERIODIC, interval,
+			sample_raw_timer_handler, NULL);
+	if (res) {
+		printk("Failed to install timer\n");
+		return res;
+	}
+
+	is_running = true;
+
+	return ENOERR;
+}
+
+int sample_raw_stop(void) {
+	if (!is_running) {
+		return ENOERR;
+	}
+
+	is_running = false;
+	timer_close(sampling_timer);
+
+	return ENOERR;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief Low-overhead sampling profiler collecting raw call-chain addresses
+ *
+ * Samples are stored as plain return addresses into per-CPU ring buffers
+ * and aggregated by exact call chain. Symbol lookup is left to the reader.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef PROFILER_SAMPLING_RAW_SAMPLE_H_
+#define PROFILER_SAMPLING_RAW_SAMPLE_H_
+
+#include <stdbool.h>
+
+/**
+ * Called for every aggregated call chain.
+ *
+ * @param pc Return addresses, innermost frame first
+ * @param depth Number of valid entries in @a pc
+ * @param count How many times this exact chain was sampled
+ * @param arg User argument passed to #sample_raw_for_each
+ */
+typedef void (*sample_raw_cb_t)(void *const *pc, int depth,
+		unsigned int count, void *arg);
+
+/**
+ * Records call chain of the caller into current CPU buffer. Safe to call
+ * from interrupt context, used by other sample sources (e.g. PMU overflow).
+ */
+extern void sample_raw_capture(void);
+
+extern int sample_raw_start(int interval);
+extern int sample_raw_stop(void);
+extern bool sample_raw_is_running(void);
+
+/** Discards all collected samples. */
+extern void sample_raw_reset(void);
+
+/**
+ * Drains per-CPU buffers into the aggregation table and walks it.
+ *
+ * @return Number of distinct call chains visited
+ */
+extern int sample_raw_for_each(sample_raw_cb_t cb, void *arg);
+
+/** Samples lost because a ring buffer or the aggregation table was full. */
+extern unsigned int sample_raw_dropped(void);
+
+#endif /* PROFILER_SAMPLING_RAW_SAMPLE_H_ */
@@ -0,0 +1,204 @@
+/**
+ * @file
+ * @brief Allocation-free tracing into per-CPU ring buffers
+ *
+ * Each CPU owns a ring with a single producer (interrupts are closed only
+ * for the time of copying one record) and the reader moves the tail.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <hal/cpu.h>
+#include <hal/ipl.h>
+#include <kernel/cpu/cpudata.h>
+#include <kernel/thread.h>
+#include <kernel/time/clock_source.h>
+
+#include <util/array.h>
+
+#include <profiler/tracing/trace.h>
+#include <profiler/tracing/ring_trace.h>
+
+#include <embox/unit.h>
+#include <framework/mod/options.h>
+
+#include "cyg_profile.h"
+
+#define RING_TRACE_SIZE  OPTION_GET(NUMBER, ring_size)
+#define RING_TRACE_CHUNK 32
+
+#define __barrier() __asm__ __volatile__("" : : : "memory")
+
+EMBOX_UNIT_INIT(ring_trace_init);
+
+ARRAY_SPREAD_DEF_TERMINATED(struct __trace_point *,
+		__trace_points_array, NULL);
+ARRAY_SPREAD_DEF_TERMINATED(struct __trace_block *,
+		__trace_blocks_array, NULL);
+
+struct ring_trace_buf {
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	volatile unsigned int lost;
+	struct ring_trace_rec rec[RING_TRACE_SIZE];
+};
+
+static struct ring_trace_buf trace_buf __cpudata__;
+
+static struct clock_source *rt_cs;
+
+volatile int __ring_trace_enabled;
+
+void __ring_trace_record(int type, const void *addr) {
+	struct ring_trace_buf *rb;
+	struct ring_trace_rec *r;
+	unsigned int head;
+	ipl_t ipl;
+
+	ipl = ipl_save();
+	{
+		rb = cpudata_ptr(&trace_buf);
+
+		head = rb->head;
+		if (head - rb->tail >= RING_TRACE_SIZE) {
+			rb->lost++;
+		} else {
+			r = &rb->rec[head % RING_TRACE_SIZE];
+			r->time = clock_source_get_hwcycles(rt_cs);
+			r->addr = (uintptr_t) addr;
+			r->thread = thread_self()->id;
+			r->type = type;
+			r->cpu = cpu_get_id();
+
+			__barrier();
+			rb->head = head + 1;
+		}
+	}
+	ipl_restore(ipl);
+}
+
+static void ring_trace_func_enter(void *func, void *caller) {
+	if (__ring_trace_on()) {
+		__ring_trace_record(RT_FUNC_ENTER, func);
+	}
+}
+
+static void ring_trace_func_exit(void *func, void *caller) {
+	if (__ring_trace_on()) {
+		__ring_trace_record(RT_FUNC_EXIT, func);
+	}
+}
+
+void ring_trace_enable(void) {
+	if (rt_cs) {
+		__ring_trace_enabled = 1;
+	}
+}
+
+void ring_trace_disable(void) {
+	__ring_trace_enabled = 0;
+}
+
+int ring_trace_read(struct ring_trace_rec *buf, int n) {
+	struct ring_trace_buf *rb;
+	unsigned int head, tail;
+	int cpu, cnt = 0;
+
+	for (cpu = 0; cpu < NCPU && cnt < n; cpu++) {
+		rb = cpudata_cpu_ptr(cpu, &trace_buf);
+
+		head = rb->head;
+		__barrier();
+
+		for (tail = rb->tail; tail != head && cnt < n; tail++) {
+			buf[cnt++] = rb->rec[tail % RING_TRACE_SIZE];
+		}
+
+		__barrier();
+		rb->tail = tail;
+	}
+
+	return cnt;
+}
+
+int ring_trace_stream(int fd, int with_header) {
+	struct ring_trace_rec chunk[RING_TRACE_CHUNK];
+	struct ring_trace_hdr hdr;
+	int n, total = 0;
+	size_t len;
+
+	if (with_header) {
+		hdr.magic = RING_TRACE_MAGIC;
+		hdr.rec_size = sizeof(struct ring_trace_rec);
+		hdr.cycle_hz = rt_cs && rt_cs->counter_device ?
+				rt_cs->counter_device->cycle_hz : 0;
+
+		if (write(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+			return -EIO;
+		}
+	}
+
+	while ((n = ring_trace_read(chunk, RING_TRACE_CHUNK)) > 0) {
+		len = n * sizeof(struct ring_trace_rec);
+		if (write(fd, chunk, len) != len) {
+			return -EIO;
+		}
+		total += n;
+	}
+
+	return total;
+}
+
+unsigned int ring_trace_lost(void) {
+	unsigned int res = 0;
+	int cpu;
+
+	for (cpu = 0; cpu < NCPU; cpu++) {
+		res += cpudata_cpu_ptr(cpu, &trace_buf)->lost;
+	}
+
+	return res;
+}
+
+time64_t trace_block_diff(struct __trace_block *tb) {
+	return -1;
+}
+
+time64_t trace_block_get_time(struct __trace_block *tb) {
+	return -1;
+}
+
+int trace_point_get_value(struct __trace_point *tp) {
+	return tp->count;
+}
+
+struct __trace_point *trace_point_get_by_name(const char *name) {
+	struct __trace_point *tp;
+
+	array_spread_nullterm_foreach(tp, __trace_points_array) {
+		if (!strcmp(tp->name, name)) {
+			return tp;
+		}
+	}
+
+	return NULL;
+}
+
+static int ring_trace_init(void) {
+	rt_cs = clock_source_get_best(CS_WITHOUT_IRQ);
+	if (rt_cs && !rt_cs->counter_device) {
+		rt_cs = NULL;
+	}
+
+	ARRAY_SPREAD_DECLARE(cyg_func, __cyg_handler_enter_array);
+	ARRAY_SPREAD_DECLARE(cyg_func, __cyg_handler_exit_array);
+	ARRAY_SPREAD_ADD(__cyg_handler_enter_array, &ring_trace_func_enter);
+	ARRAY_SPREAD_ADD(__cyg_handler_exit_array, &ring_trace_func_exit);
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Allocation-free tracing into per-CPU ring buffers
+ *
+ * Every trace block enter/leave, trace point hit and instrumented function
+ * entry/exit is stored as a fixed-size record. Records are consumed by
+ * #ring_trace_read() or streamed to any file descriptor (file or socket)
+ * by #ring_trace_stream().
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef PROFILER_TRACING_RING_TRACE_H_
+#define PROFILER_TRACING_RING_TRACE_H_
+
+#include <stdint.h>
+
+#define RING_TRACE_MAGIC 0x43525452 /* "RTRC" */
+
+enum ring_trace_type {
+	RT_BLOCK_ENTER = 1,
+	RT_BLOCK_LEAVE,
+	RT_POINT,
+	RT_FUNC_ENTER,
+	RT_FUNC_EXIT,
+};
+
+struct ring_trace_rec {
+	uint64_t time;     /**< Clock source cycles */
+	uint64_t addr;     /**< Trace block, trace point or function */
+	uint32_t thread;   /**< Thread id */
+	uint16_t type;     /**< enum ring_trace_type */
+	uint16_t cpu;
+};
+
+/* Written once at the beginning of every stream */
+struct ring_trace_hdr {
+	uint32_t magic;
+	uint32_t rec_size;
+	uint64_t cycle_hz;
+};
+
+extern void ring_trace_enable(void);
+extern void ring_trace_disable(void);
+
+/**
+ * Moves up to @a n records from per-CPU rings into @a buf.
+ * @return Number of records read
+ */
+extern int ring_trace_read(struct ring_trace_rec *buf, int n);
+
+/**
+ * Writes stream header followed by all buffered records to @a fd.
+ * @return Number of records written or negative error
+ */
+extern int ring_trace_stream(int fd, int with_header);
+
+/** Records lost because a ring was full. */
+extern unsigned int ring_trace_lost(void);
+
+#endif /* PROFILER_TRACING_RING_TRACE_H_ */
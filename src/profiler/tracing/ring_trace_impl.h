@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Trace points and blocks recorded into per-CPU rings
+ *
+ * Disabled tracing costs a single load and a branch predicted not taken.
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef PROFILER_TRACING_RING_TRACE_IMPL_H_
+#define PROFILER_TRACING_RING_TRACE_IMPL_H_
+
+#include <stdbool.h>
+
+#include <util/array.h>
+#include <util/location.h>
+
+#include <profiler/tracing/ring_trace.h>
+
+struct __trace_point {
+	const char *name;
+	struct location_func location;
+	int count;
+	bool active;
+};
+
+struct __trace_block {
+	const char *name;
+	struct location_func location;
+	bool active;
+};
+
+extern volatile int __ring_trace_enabled;
+
+extern void __ring_trace_record(int type, const void *addr);
+
+#define __ring_trace_on() \
+	__builtin_expect(__ring_trace_enabled, 0)
+
+#define __TRACE_POINT_DEF(_name, tp_name)   \
+		struct __trace_point _name = {      \
+			.name = tp_name,                \
+			.location = LOCATION_FUNC_INIT, \
+			.count = 0,                     \
+			.active = true,                 \
+		};                                  \
+		ARRAY_SPREAD_DECLARE(struct __trace_point *, \
+				__trace_points_array);               \
+		ARRAY_SPREAD_ADD(__trace_points_array, &_name)
+
+#define __TRACE_BLOCK_DEF(tb_name)                  \
+	static struct __trace_block tb_name  = {        \
+			.name  = #tb_name,                      \
+			.location = LOCATION_FUNC_INIT,         \
+			.active = true,                         \
+	};                                              \
+	ARRAY_SPREAD_DECLARE(struct __trace_block *,    \
+			__trace_blocks_array);                  \
+	ARRAY_SPREAD_ADD(__trace_blocks_array, &tb_name)
+
+static inline void __tracepoint_handle(struct __trace_point *tp) {
+	if (__ring_trace_on() && tp->active) {
+		tp->count++;
+		__ring_trace_record(RT_POINT, tp);
+	}
+}
+
+static inline void trace_block_enter(struct __trace_block *tb) {
+	if (__ring_trace_on() && tb->active) {
+		__ring_trace_record(RT_BLOCK_ENTER, tb);
+	}
+}
+
+static inline void trace_block_leave(struct __trace_block *tb) {
+	if (__ring_trace_on() && tb->active) {
+		__ring_trace_record(RT_BLOCK_LEAVE, tb);
+	}
+}
+
+#define __trace_point_set(tp_pointer) \
+		__tracepoint_handle(tp_pointer)
+
+#define __tp_ref(__name) \
+	({                                                        \
+		static struct __trace_point __tp = {                  \
+			.name = __name,                                   \
+			.location = LOCATION_FUNC_INIT,                   \
+			.count = 0,                                       \
+			.active = true,                                   \
+		};                                                    \
+		ARRAY_SPREAD_DECLARE(struct __trace_point *,          \
+				__trace_points_array);                        \
+		ARRAY_SPREAD_ADD(__trace_points_array, &__tp);        \
+		&__tp;                                                \
+	})
+
+#define __trace_point(__name) \
+	__tracepoint_handle(__tp_ref(__name))
+
+#endif /* PROFILER_TRACING_RING_TRACE_IMPL_H_ */
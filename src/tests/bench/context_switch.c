@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Context switch cost: two threads yielding to each other.
+ *
+ * @date 17.10.2026
+ */
+
+#include <kernel/thread.h>
+#include <util/err.h>
+
+#include <embox/bench.h>
+
+static struct thread *peer;
+static volatile int peer_stop;
+
+static void *peer_run(void *arg) {
+	while (!peer_stop) {
+		thread_yield();
+	}
+	return NULL;
+}
+
+static int ctx_setup(void) {
+	peer_stop = 0;
+	peer = thread_create(0, peer_run, NULL);
+	return err(peer);
+}
+
+static void ctx_teardown(void) {
+	peer_stop = 1;
+	thread_join(peer, NULL);
+}
+
+/* Each iteration is a round trip: switch to the peer and back */
+EMBOX_BENCH_FIXTURE(context_switch, "thread_yield() round trip between two threads",
+		ctx_setup, ctx_teardown) {
+	thread_yield();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @brief CRC32, MD5 and SHA-256 throughput on a block of data.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <embox/bench.h>
+
+#include <lib/crypt/crc32.h>
+#include <lib/crypt/md5.h>
+#include <lib/crypt/sha256.h>
+
+#include <framework/mod/options.h>
+
+#define BLOCK_SIZE OPTION_GET(NUMBER, block_size)
+
+static unsigned char *block;
+/* Keeps results from being optimized out */
+static volatile unsigned long crc;
+static uint8_t digest[SHA256_DIGEST_SIZE];
+
+static int crypt_setup(void) {
+	int i;
+
+	block = malloc(BLOCK_SIZE);
+	if (!block) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < BLOCK_SIZE; i++) {
+		block[i] = (unsigned char) (i * 31);
+	}
+
+	return 0;
+}
+
+static void crypt_teardown(void) {
+	free(block);
+}
+
+EMBOX_BENCH_FIXTURE(crc32, "CRC32 of a block", crypt_setup, crypt_teardown) {
+	crc = count_crc32(block, block + BLOCK_SIZE);
+}
+
+EMBOX_BENCH_FIXTURE(md5, "MD5 of a block", crypt_setup, crypt_teardown) {
+	md5_count(block, BLOCK_SIZE, digest);
+}
+
+EMBOX_BENCH_FIXTURE(sha256, "SHA-256 of a block", crypt_setup, crypt_teardown) {
+	sha256_count(block, BLOCK_SIZE, digest);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @brief File system: write and read back one block of a file.
+ *
+ * @date 17.10.2026
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <embox/bench.h>
+
+#include <framework/mod/options.h>
+
+#define FILE_PATH  OPTION_STRING_GET(path)
+#define BLOCK_SIZE OPTION_GET(NUMBER, block_size)
+
+static int fd = -1;
+static char block[BLOCK_SIZE];
+
+static int rw_setup(void) {
+	fd = open(FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	return fd < 0 ? -1 : 0;
+}
+
+static void rw_teardown(void) {
+	close(fd);
+	unlink(FILE_PATH);
+}
+
+EMBOX_BENCH_FIXTURE(file_rw, "write() and read() of one block of a file",
+		rw_setup, rw_teardown) {
+	lseek(fd, 0, SEEK_SET);
+	write(fd, block, sizeof(block));
+	lseek(fd, 0, SEEK_SET);
+	read(fd, block, sizeof(block));
+}
@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @brief Heap allocator: malloc() and free() of a small block.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdlib.h>
+
+#include <embox/bench.h>
+
+#include <framework/mod/options.h>
+
+#define BLOCK_SIZE OPTION_GET(NUMBER, block_size)
+
+EMBOX_BENCH(malloc_free, "malloc() and free() of one block") {
+	free(malloc(BLOCK_SIZE));
+}
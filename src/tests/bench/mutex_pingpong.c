@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @brief Mutex ping-pong: two threads passing the turn under one mutex.
+ *
+ * @date 17.10.2026
+ */
+
+#include <kernel/thread.h>
+#include <kernel/thread/sync/cond.h>
+#include <kernel/thread/sync/mutex.h>
+#include <util/err.h>
+
+#include <embox/bench.h>
+
+static struct thread *peer;
+static struct mutex pp_mutex;
+static cond_t pp_cond;
+static int pp_turn; /* 0 - main thread, 1 - peer, -1 - peer must exit */
+
+static void *peer_run(void *arg) {
+	mutex_lock(&pp_mutex);
+	while (1) {
+		while (pp_turn == 0) {
+			cond_wait(&pp_cond, &pp_mutex);
+		}
+		if (pp_turn < 0) {
+			break;
+		}
+		pp_turn = 0;
+		cond_signal(&pp_cond);
+	}
+	mutex_unlock(&pp_mutex);
+
+	return NULL;
+}
+
+static int pp_setup(void) {
+	mutex_init(&pp_mutex);
+	cond_init(&pp_cond, NULL);
+	pp_turn = 0;
+
+	peer = thread_create(0, peer_run, NULL);
+	return err(peer);
+}
+
+static void pp_teardown(void) {
+	mutex_lock(&pp_mutex);
+	pp_turn = -1;
+	cond_signal(&pp_cond);
+	mutex_unlock(&pp_mutex);
+
+	thread_join(peer, NULL);
+}
+
+EMBOX_BENCH_FIXTURE(mutex_pingpong, "mutex and condition ping-pong round trip",
+		pp_setup, pp_teardown) {
+	mutex_lock(&pp_mutex);
+	pp_turn = 1;
+	cond_signal(&pp_cond);
+	while (pp_turn == 1) {
+		cond_wait(&pp_cond, &pp_mutex);
+	}
+	mutex_unlock(&pp_mutex);
+}
@@ -0,0 +1,21 @@
+/**
+ * @file
+ * @brief snprintf() of a typical status line.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdio.h>
+
+#include <embox/bench.h>
+
+static char line[128];
+
+EMBOX_BENCH(snprintf_mixed, "snprintf() of text, integers and a string") {
+	snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\nContent-Length: %u\r\n",
+			200, "OK", 123456u);
+}
+
+EMBOX_BENCH(snprintf_float, "snprintf() of a fixed point float") {
+	snprintf(line, sizeof(line), "temp=%.2f load=%.3f", 36.6, 0.125);
+}
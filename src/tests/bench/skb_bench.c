@@ -0,0 +1,23 @@
+/**
+ * @file
+ * @brief Network buffers: skb_alloc() and skb_free() of a full frame.
+ *
+ * @date 17.10.2026
+ */
+
+#include <net/skbuff.h>
+
+#include <embox/bench.h>
+
+#include <framework/mod/options.h>
+
+#define SKB_SIZE OPTION_GET(NUMBER, skb_size)
+
+EMBOX_BENCH(skb_alloc, "skb_alloc() and skb_free() of one frame") {
+	struct sk_buff *skb;
+
+	skb = skb_alloc(SKB_SIZE);
+	if (skb) {
+		skb_free(skb);
+	}
+}
@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief UDP over loopback: datagram sent to itself and received back.
+ *
+ * @date 17.10.2026
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <embox/bench.h>
+
+#include <framework/mod/options.h>
+
+#define MSG_SIZE OPTION_GET(NUMBER, msg_size)
+#define PORT     OPTION_GET(NUMBER, port)
+
+static int sock = -1;
+static struct sockaddr_in addr;
+static char msg[MSG_SIZE];
+
+static int lo_setup(void) {
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+		close(sock);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void lo_teardown(void) {
+	close(sock);
+}
+
+EMBOX_BENCH_FIXTURE(udp_loopback, "UDP datagram to itself over loopback",
+		lo_setup, lo_teardown) {
+	sendto(sock, msg, sizeof(msg), 0, (struct sockaddr *) &addr, sizeof(addr));
+	recv(sock, msg, sizeof(msg), 0);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief memcpy(), memmove(), memset() and strlen() on blocks from 8 bytes
+ *   to 1 Mb.
+ *
+ * @date 17.10.2026
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <embox/bench.h>
+
+#include <framework/mod/options.h>
+
+#define MAX_SIZE OPTION_GET(NUMBER, max_size)
+
+/* Room for misaligning source and destination */
+#define BUF_SIZE (MAX_SIZE + 64)
+
+static char *buf_src, *buf_dst;
+/* Keeps strlen() calls from being optimized out */
+static volatile size_t str_len;
+
+static int str_setup(void) {
+	buf_src = malloc(BUF_SIZE);
+	buf_dst = malloc(BUF_SIZE);
+	if (!buf_src || !buf_dst) {
+		free(buf_src);
+		free(buf_dst);
+		return -ENOMEM;
+	}
+
+	memset(buf_src, 'a', BUF_SIZE);
+	buf_src[BUF_SIZE - 1] = '\0';
+
+	return 0;
+}
+
+static void str_teardown(void) {
+	free(buf_src);
+	free(buf_dst);
+}
+
+#define STR_BENCH(name, desc, op, size) \
+	EMBOX_BENCH_FIXTURE(name, desc, str_setup, str_teardown) { \
+		op(size); \
+	}
+
+#define MEMCPY(size) \
+	memcpy(buf_dst, buf_src, (size) > MAX_SIZE ? MAX_SIZE : (size))
+#define MEMCPY_UNALIGNED(size) \
+	memcpy(buf_dst + 3, buf_src + 1, (size) > MAX_SIZE ? MAX_SIZE : (size))
+#define MEMMOVE(size) \
+	memmove(buf_dst + 8, buf_dst, (size) > MAX_SIZE ? MAX_SIZE : (size))
+#define MEMSET(size) \
+	memset(buf_dst, 0, (size) > MAX_SIZE ? MAX_SIZE : (size))
+/* The string ends at the end of buf_src */
+#define STRLEN(size) \
+	strlen(buf_src + BUF_SIZE - 1 - ((size) > MAX_SIZE ? MAX_SIZE : (size)))
+
+STR_BENCH(memcpy_8, "memcpy() of 8 bytes",
+		MEMCPY, 8)
+STR_BENCH(memcpy_64, "memcpy() of 64 bytes",
+		MEMCPY, 64)
+STR_BENCH(memcpy_512, "memcpy() of 512 bytes",
+		MEMCPY, 512)
+STR_BENCH(memcpy_4k, "memcpy() of 4 Kb",
+		MEMCPY, 4096)
+STR_BENCH(memcpy_64k, "memcpy() of 64 Kb",
+		MEMCPY, 65536)
+STR_BENCH(memcpy_1m, "memcpy() of 1 Mb",
+		MEMCPY, 1048576)
+STR_BENCH(memcpy_ua_64, "memcpy() of 64 bytes, misaligned",
+		MEMCPY_UNALIGNED, 64)
+STR_BENCH(memcpy_ua_4k, "memcpy() of 4 Kb, misaligned",
+		MEMCPY_UNALIGNED, 4096)
+STR_BENCH(memcpy_ua_1m, "memcpy() of 1 Mb, misaligned",
+		MEMCPY_UNALIGNED, 1048576)
+STR_BENCH(memmove_64, "overlapping memmove() of 64 bytes",
+		MEMMOVE, 64)
+STR_BENCH(memmove_4k, "overlapping memmove() of 4 Kb",
+		MEMMOVE, 4096)
+STR_BENCH(memmove_1m, "overlapping memmove() of 1 Mb",
+		MEMMOVE, 1048576)
+STR_BENCH(memset_8, "memset() of 8 bytes",
+		MEMSET, 8)
+STR_BENCH(memset_512, "memset() of 512 bytes",
+		MEMSET, 512)
+STR_BENCH(memset_4k, "memset() of 4 Kb",
+		MEMSET, 4096)
+STR_BENCH(memset_1m, "memset() of 1 Mb",
+		MEMSET, 1048576)
+
+EMBOX_BENCH_FIXTURE(strlen_64, "strlen() of 64 bytes",
+		str_setup, str_teardown) {
+	str_len = STRLEN(64);
+}
+
+EMBOX_BENCH_FIXTURE(strlen_4k, "strlen() of 4 Kb",
+		str_setup, str_teardown) {
+	str_len = STRLEN(4096);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief TFTP download of one file with negotiated block and window size.
+ * @details Needs a TFTP server holding the file: the host's tftpd, or
+ *   "tftp -s" run in the background for a loopback measurement. One
+ *   iteration is the whole transfer, so keep the file small enough.
+ *
+ * @date 17.10.2026
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <embox/bench.h>
+
+#include <framework/cmd/api.h>
+#include <framework/mod/options.h>
+
+#define SERVER     OPTION_STRING_GET(server)
+#define FILE_NAME  OPTION_STRING_GET(file)
+#define LOCAL_PATH OPTION_STRING_GET(local)
+#define BLKSIZE    OPTION_GET(NUMBER, blksize)
+#define WINDOWSIZE OPTION_GET(NUMBER, windowsize)
+
+static const struct cmd *tftp;
+static char blksize[8], windowsize[8];
+static char *argv[] = {
+	"tftp", "-g", "-B", blksize, "-W", windowsize,
+	"-o", LOCAL_PATH, FILE_NAME, SERVER, NULL
+};
+
+static int tftp_setup(void) {
+	tftp = cmd_lookup("tftp");
+	if (tftp == NULL) {
+		return -1;
+	}
+
+	snprintf(blksize, sizeof(blksize), "%d", BLKSIZE);
+	snprintf(windowsize, sizeof(windowsize), "%d", WINDOWSIZE);
+
+	return 0;
+}
+
+static void tftp_teardown(void) {
+	unlink(LOCAL_PATH);
+}
+
+EMBOX_BENCH_FIXTURE(tftp_get, "tftp -g of one file",
+		tftp_setup, tftp_teardown) {
+	cmd_exec(tftp, sizeof(argv) / sizeof(argv[0]) - 1, argv);
+}
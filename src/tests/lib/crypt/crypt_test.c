@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @brief Test unit for lib/crypt digests and ciphers.
+ *
+ * @date 17.10.2026
+ */
+
+#include <embox/test.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <lib/crypt/crc32.h>
+#include <lib/crypt/md5.h>
+#include <lib/crypt/sha256.h>
+#include <lib/crypt/aes.h>
+
+EMBOX_TEST_SUITE("lib/crypt test");
+
+static const char check_str[] = "123456789";
+
+/* Buffer for unaligned and odd length inputs: byte i is i * 31 */
+static unsigned char block[1000 + 1];
+
+static void fill_block(unsigned char *p, size_t len) {
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		p[i] = (unsigned char) (i * 31);
+	}
+}
+
+TEST_CASE("CRC32 of the check string") {
+	unsigned char *s = (unsigned char *) check_str;
+
+	test_assert_equal(count_crc32(s, s + strlen(check_str)), 0xcbf43926UL);
+}
+
+TEST_CASE("CRC32 of an unaligned block is accumulated in parts") {
+	unsigned char *p = block + 1;
+	unsigned long crc;
+
+	fill_block(p, 1000);
+
+	test_assert_equal(count_crc32(p, p + 1000), 0x91f43decUL);
+
+	crc = crc32_accumulate(0xFFFFFFFFUL, p, 13);
+	crc = crc32_accumulate(crc, p + 13, 1000 - 13);
+	test_assert_equal(crc ^ 0xFFFFFFFFUL, 0x91f43decUL);
+}
+
+TEST_CASE("MD5 of the check string") {
+	static const uint8_t expected[16] = {
+		0x25, 0xf9, 0xe7, 0x94, 0x32, 0x3b, 0x45, 0x38,
+		0x85, 0xf5, 0x18, 0x1f, 0x1b, 0x62, 0x4d, 0x0b,
+	};
+	md5_byte_t digest[16];
+
+	md5_count((const md5_byte_t *) check_str, strlen(check_str), digest);
+	test_assert_mem_equal(digest, expected, sizeof(expected));
+}
+
+TEST_CASE("MD5 of a block appended in parts") {
+	static const uint8_t expected[16] = {
+		0xbf, 0x38, 0xfd, 0x44, 0xdf, 0xb3, 0x82, 0xdf,
+		0x1a, 0x50, 0xee, 0x14, 0xad, 0x83, 0xc4, 0x6c,
+	};
+	md5_state_t state;
+	md5_byte_t digest[16];
+
+	fill_block(block + 1, 1000);
+
+	md5_init(&state);
+	md5_append(&state, block + 1, 100);
+	md5_append(&state, block + 101, 900);
+	md5_finish(&state, digest);
+	test_assert_mem_equal(digest, expected, sizeof(expected));
+}
+
+TEST_CASE("SHA-256 of the two block FIPS 180-4 example") {
+	static const char msg[] =
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	static const uint8_t expected[SHA256_DIGEST_SIZE] = {
+		0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8,
+		0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+		0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+		0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+	};
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	sha256_count(msg, strlen(msg), digest);
+	test_assert_mem_equal(digest, expected, sizeof(expected));
+}
+
+TEST_CASE("SHA-256 of a block appended in parts") {
+	static const uint8_t expected[SHA256_DIGEST_SIZE] = {
+		0x94, 0x5a, 0xcd, 0xf5, 0x75, 0xd6, 0xa2, 0x43,
+		0x0b, 0xf4, 0xd6, 0x16, 0x3e, 0x1d, 0x03, 0xb4,
+		0xb0, 0xb8, 0x96, 0xfc, 0xef, 0x10, 0x7c, 0x8b,
+		0x24, 0xbf, 0x7f, 0xf0, 0x7a, 0x62, 0x1f, 0xa3,
+	};
+	sha256_state_t state;
+	uint8_t digest[SHA256_DIGEST_SIZE];
+
+	fill_block(block + 1, 1000);
+
+	sha256_init(&state);
+	sha256_append(&state, block + 1, 63);
+	sha256_append(&state, block + 64, 937);
+	sha256_finish(&state, digest);
+	test_assert_mem_equal(digest, expected, sizeof(expected));
+}
+
+TEST_CASE("AES-128 of the FIPS 197 example block") {
+	static const uint8_t key[16] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	};
+	static const uint8_t plain[16] = {
+		0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+		0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+	};
+	static const uint8_t cipher[16] = {
+		0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+		0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a,
+	};
+	struct aes_ctx ctx;
+	uint8_t buf[16];
+
+	test_assert_zero(aes_set_encrypt_key(&ctx, key, sizeof(key)));
+	aes_encrypt(&ctx, plain, buf);
+	test_assert_mem_equal(buf, cipher, sizeof(cipher));
+
+	test_assert_zero(aes_set_decrypt_key(&ctx, key, sizeof(key)));
+	aes_decrypt(&ctx, buf, buf);
+	test_assert_mem_equal(buf, plain, sizeof(plain));
+}
+
+TEST_CASE("XTS-AES-128 of the IEEE 1619 vector 2 in place") {
+	static const uint8_t expected[32] = {
+		0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e,
+		0x39, 0x33, 0x40, 0x38, 0xac, 0xef, 0x83, 0x8b,
+		0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80, 0xad, 0xc4,
+		0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0,
+	};
+	struct xts_ctx ctx;
+	uint8_t key[32];
+	uint8_t buf[32];
+
+	memset(key, 0x11, 16);
+	memset(key + 16, 0x22, 16);
+	test_assert_zero(xts_set_key(&ctx, key, sizeof(key)));
+
+	memset(buf, 0x44, sizeof(buf));
+	test_assert_zero(xts_encrypt(&ctx, 0x3333333333ULL, 32, buf, buf, 32));
+	test_assert_mem_equal(buf, expected, sizeof(expected));
+
+	test_assert_zero(xts_decrypt(&ctx, 0x3333333333ULL, 32, buf, buf, 32));
+	memset(key, 0x44, sizeof(key));
+	test_assert_mem_equal(buf, key, sizeof(buf));
+}
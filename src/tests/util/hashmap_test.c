@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief Test unit for util/hashmap.
+ *
+ * @date 17.10.2026
+ */
+
+#include <embox/test.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <util/array.h>
+#include <util/hashmap.h>
+
+EMBOX_TEST_SUITE("util/hashmap test");
+
+#define KEYS_NUM 1000
+
+static uintptr_t keys[KEYS_NUM];
+static struct hashmap_slot slots[8];
+static struct hashmap map;
+
+static size_t get_hash(void *key) {
+	/* Collides a lot on purpose */
+	return *(uintptr_t *) key & 0x3f;
+}
+
+static int cmp_keys(void *key1, void *key2) {
+	return *(uintptr_t *) key1 != *(uintptr_t *) key2;
+}
+
+static int case_setup(void) {
+	int i;
+
+	for (i = 0; i < KEYS_NUM; i++) {
+		keys[i] = i * 7;
+	}
+	hashmap_init(&map, slots, ARRAY_SIZE(slots), get_hash, cmp_keys);
+
+	return 0;
+}
+
+static int case_teardown(void) {
+	hashmap_destroy(&map);
+	return 0;
+}
+
+TEST_SETUP(case_setup);
+TEST_TEARDOWN(case_teardown);
+
+TEST_CASE("Put and get a single element") {
+	uintptr_t other = 1;
+
+	test_assert_zero(hashmap_put(&map, &keys[0], &keys[1]));
+	test_assert_equal(hashmap_get(&map, &keys[0]), &keys[1]);
+	test_assert_null(hashmap_get(&map, &other));
+	test_assert_equal(hashmap_count(&map), 1);
+}
+
+TEST_CASE("Map grows and keeps all elements while resizing") {
+	int i, j;
+
+	for (i = 0; i < KEYS_NUM; i++) {
+		test_assert_zero(hashmap_put(&map, &keys[i], &keys[i]));
+
+		/* Every element is found in the middle of a resize as well */
+		for (j = 0; j <= i; j += 13) {
+			test_assert_equal(hashmap_get(&map, &keys[j]), &keys[j]);
+		}
+	}
+	test_assert_equal(hashmap_count(&map), KEYS_NUM);
+}
+
+TEST_CASE("Deleted elements are not found, others are") {
+	uintptr_t key;
+	int i;
+
+	for (i = 0; i < KEYS_NUM; i++) {
+		hashmap_put(&map, &keys[i], &keys[i]);
+	}
+	for (i = 0; i < KEYS_NUM; i += 2) {
+		test_assert_equal(hashmap_del(&map, &keys[i]), &keys[i]);
+	}
+
+	for (i = 0; i < KEYS_NUM; i++) {
+		key = keys[i];
+		if (i % 2) {
+			test_assert_equal(hashmap_get(&map, &key), &keys[i]);
+		} else {
+			test_assert_null(hashmap_get(&map, &key));
+			test_assert_null(hashmap_del(&map, &key));
+		}
+	}
+	test_assert_equal(hashmap_count(&map), KEYS_NUM / 2);
+}
+
+TEST_CASE("Iteration visits every key once") {
+	static char seen[KEYS_NUM];
+	uintptr_t **key;
+	int i, n;
+
+	memset(seen, 0, sizeof(seen));
+	for (i = 0; i < 100; i++) {
+		hashmap_put(&map, &keys[i], NULL);
+	}
+
+	n = 0;
+	for (key = hashmap_get_key_first(&map); key != NULL;
+			key = hashmap_get_key_next(&map, key)) {
+		i = *key - keys;
+		test_assert(i >= 0 && i < 100);
+		test_assert_zero(seen[i]);
+		seen[i] = 1;
+		n++;
+	}
+	test_assert_equal(n, 100);
+}
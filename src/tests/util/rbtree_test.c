@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Test unit for util/rbtree.
+ *
+ * @date 17.10.2026
+ */
+
+#include <embox/test.h>
+
+#include <util/array.h>
+#include <util/rbtree.h>
+
+EMBOX_TEST_SUITE("util/rbtree test");
+
+struct interval {
+	int start;
+	int end;
+	int max_end; /* of the subtree */
+	struct rb_node node;
+};
+
+#define ITEMS_NUM 200
+
+static struct interval items[ITEMS_NUM];
+static struct rb_tree tree;
+
+static void interval_augment(struct rb_node *node) {
+	struct interval *it = rb_entry(node, struct interval, node);
+	struct interval *child;
+
+	it->max_end = it->end;
+	if ((child = rb_entry(node->left, struct interval, node))
+			&& child->max_end > it->max_end) {
+		it->max_end = child->max_end;
+	}
+	if ((child = rb_entry(node->right, struct interval, node))
+			&& child->max_end > it->max_end) {
+		it->max_end = child->max_end;
+	}
+}
+
+static int interval_cmp(struct rb_node *node1, struct rb_node *node2) {
+	return rb_entry(node1, struct interval, node)->start
+		- rb_entry(node2, struct interval, node)->start;
+}
+
+/* @return black height of the subtree or -1 if rules are broken */
+static int check_subtree(struct rb_node *node) {
+	struct interval *it;
+	int left, right, max_end;
+
+	if (node == NULL) {
+		return 1;
+	}
+	if (node->color == RB_RED && ((node->left && node->left->color == RB_RED)
+			|| (node->right && node->right->color == RB_RED))) {
+		return -1;
+	}
+	if ((node->left && node->left->parent != node)
+			|| (node->right && node->right->parent != node)) {
+		return -1;
+	}
+
+	left = check_subtree(node->left);
+	right = check_subtree(node->right);
+	if (left < 0 || left != right) {
+		return -1;
+	}
+
+	it = rb_entry(node, struct interval, node);
+	max_end = it->max_end;
+	interval_augment(node);
+	if (max_end != it->max_end) {
+		return -1;
+	}
+
+	return left + node->color;
+}
+
+static int case_setup(void) {
+	int i;
+
+	rb_tree_init(&tree, interval_augment);
+	for (i = 0; i < ITEMS_NUM; i++) {
+		/* Starts are a permutation of 0..ITEMS_NUM-1 */
+		items[i].start = (i * 37) % ITEMS_NUM;
+		items[i].end = items[i].start + (i * 13) % 50;
+	}
+
+	return 0;
+}
+
+TEST_SETUP(case_setup);
+
+TEST_CASE("Nodes are iterated in order in both directions") {
+	struct rb_node *node;
+	int i;
+
+	for (i = 0; i < ITEMS_NUM; i++) {
+		rb_insert(&tree, &items[i].node, interval_cmp);
+	}
+
+	i = 0;
+	rb_foreach(node, &tree) {
+		test_assert_equal(rb_entry(node, struct interval, node)->start, i++);
+	}
+	test_assert_equal(i, ITEMS_NUM);
+
+	for (node = rb_last(&tree); node; node = rb_prev(node)) {
+		test_assert_equal(rb_entry(node, struct interval, node)->start, --i);
+	}
+	test_assert_zero(i);
+}
+
+TEST_CASE("Tree stays balanced and augmented on insertion and erasure") {
+	int i;
+
+	for (i = 0; i < ITEMS_NUM; i++) {
+		rb_insert(&tree, &items[i].node, interval_cmp);
+		test_assert(check_subtree(tree.root) > 0);
+	}
+
+	for (i = 0; i < ITEMS_NUM; i += 3) {
+		rb_erase(&tree, &items[i].node);
+		test_assert(check_subtree(tree.root) > 0);
+	}
+	for (i = 1; i < ITEMS_NUM; i += 3) {
+		rb_erase(&tree, &items[i].node);
+		test_assert(check_subtree(tree.root) > 0);
+	}
+	for (i = 2; i < ITEMS_NUM; i += 3) {
+		rb_erase(&tree, &items[i].node);
+		test_assert(check_subtree(tree.root) > 0);
+	}
+
+	test_assert(rb_empty(&tree));
+}
@@ -0,0 +1,336 @@
+/**
+ * @file
+ * @brief Robin Hood hash map with incremental resize
+ *
+ * @details Every key sits at its home slot (hash & mask) or after it, and
+ *   an insertion displaces entries which are closer to their home than the
+ *   inserted one. Probe lengths stay short and a lookup stops as soon as it
+ *   meets an entry closer to its home than the key would be. Deletion
+ *   shifts the rest of the cluster back, so there are no tombstones.
+ *
+ *   While a larger table is being filled, the old one is drained from its
+ *   beginning by the same deletion. All slots below move_pos stay empty,
+ *   so clusters in the old table are never broken and lookups may probe it
+ *   as usual.
+ *
+ * @date 17.10.2026
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <util/hashmap.h>
+#include <util/member.h>
+#include <mem/sysmalloc.h>
+
+/* Slots of the old table examined per update. The old table of N slots is
+ * drained in at most 2N steps, well before the new one (2N slots holding
+ * at most 7/8 N entries) reaches its own limit. */
+#define HASHMAP_MOVE_STEP 4
+
+/* Entries allowed in a table: 7/8 of slots, and at least one slot is empty */
+static inline unsigned int hashmap_limit(struct hashmap_table *t) {
+	return t->mask - (t->mask >> 3);
+}
+
+static inline unsigned int hashmap_dist(struct hashmap_table *t,
+		unsigned int idx, uint32_t hash) {
+	return (idx - hash) & t->mask;
+}
+
+/* Caller's hashes are often block numbers or addresses, which fill only a
+ * part of the power-of-two table if taken as is */
+static uint32_t hashmap_hash(struct hashmap *map, void *key) {
+	uint64_t h = map->get_hash_key(key);
+	uint32_t x = (uint32_t) (h ^ (h >> 32));
+
+	x ^= x >> 16;
+	x *= 0x85ebca6b;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35;
+	x ^= x >> 16;
+
+	return x ? x : 1;
+}
+
+static void hashmap_table_insert(struct hashmap_table *t,
+		struct hashmap_slot ent) {
+	struct hashmap_slot *s, tmp;
+	unsigned int idx, dist, sdist;
+
+	idx = ent.hash & t->mask;
+	dist = 0;
+	while (1) {
+		s = &t->slots[idx];
+		if (!s->hash) {
+			*s = ent;
+			break;
+		}
+
+		sdist = hashmap_dist(t, idx, s->hash);
+		if (sdist < dist) {
+			tmp = *s;
+			*s = ent;
+			ent = tmp;
+			dist = sdist;
+		}
+
+		idx = (idx + 1) & t->mask;
+		dist++;
+	}
+
+	t->cnt++;
+}
+
+static struct hashmap_slot *hashmap_table_find(struct hashmap *map,
+		struct hashmap_table *t, void *key, uint32_t hash) {
+	struct hashmap_slot *s;
+	unsigned int idx, dist;
+
+	if (!t->cnt) {
+		return NULL;
+	}
+
+	idx = hash & t->mask;
+	dist = 0;
+	while (1) {
+		s = &t->slots[idx];
+		if (!s->hash || hashmap_dist(t, idx, s->hash) < dist) {
+			return NULL;
+		}
+		if ((s->hash == hash) && (0 == map->cmp(key, s->key))) {
+			return s;
+		}
+
+		idx = (idx + 1) & t->mask;
+		dist++;
+	}
+}
+
+static void hashmap_table_remove(struct hashmap_table *t,
+		struct hashmap_slot *s) {
+	struct hashmap_slot *next;
+	unsigned int idx;
+
+	idx = s - t->slots;
+	while (1) {
+		next = &t->slots[(idx + 1) & t->mask];
+		if (!next->hash || !hashmap_dist(t, next - t->slots, next->hash)) {
+			break;
+		}
+		t->slots[idx] = *next;
+		idx = next - t->slots;
+	}
+	t->slots[idx].hash = 0;
+
+	t->cnt--;
+}
+
+static void hashmap_table_free(struct hashmap *map, struct hashmap_table *t) {
+	if (t->slots && (t->slots != map->static_slots)) {
+		sysfree(t->slots);
+	}
+	t->slots = NULL;
+	t->mask = t->cnt = 0;
+}
+
+static void hashmap_move(struct hashmap *map, unsigned int steps) {
+	struct hashmap_table *old = &map->old;
+	struct hashmap_slot *s;
+
+	if (!old->slots) {
+		return;
+	}
+
+	while (old->cnt && steps--) {
+		s = &old->slots[map->move_pos];
+		if (!s->hash) {
+			map->move_pos++;
+			continue;
+		}
+		/* The cluster shifts back into move_pos, look at it again */
+		hashmap_table_insert(&map->cur, *s);
+		hashmap_table_remove(old, s);
+	}
+
+	if (!old->cnt) {
+		hashmap_table_free(map, old);
+	}
+}
+
+static void hashmap_grow(struct hashmap *map) {
+	struct hashmap_slot *slots;
+	unsigned int size;
+
+	/* Normally finished long ago, see HASHMAP_MOVE_STEP */
+	hashmap_move(map, -1);
+
+	size = 2 * (map->cur.mask + 1);
+	slots = sysmalloc(size * sizeof(*slots));
+	if (!slots) {
+		return;
+	}
+	memset(slots, 0, size * sizeof(*slots));
+
+	map->old = map->cur;
+	map->cur.slots = slots;
+	map->cur.mask = size - 1;
+	map->cur.cnt = 0;
+	map->move_pos = 0;
+}
+
+struct hashmap *hashmap_init(struct hashmap *map, struct hashmap_slot *slots,
+		unsigned int size, ht_hash_ft get_hash, ht_cmp_ft cmp) {
+	assert(map && slots);
+	assert(size && !(size & (size - 1)));
+
+	memset(map, 0, sizeof(*map));
+	memset(slots, 0, size * sizeof(*slots));
+
+	map->cur.slots = map->static_slots = slots;
+	map->cur.mask = map->static_mask = size - 1;
+	map->get_hash_key = get_hash;
+	map->cmp = cmp;
+
+	return map;
+}
+
+void hashmap_destroy(struct hashmap *map) {
+	assert(map);
+
+	hashmap_table_free(map, &map->old);
+	hashmap_table_free(map, &map->cur);
+
+	map->cur.slots = map->static_slots;
+	map->cur.mask = map->static_mask;
+	memset(map->cur.slots, 0, (map->cur.mask + 1) * sizeof(*map->cur.slots));
+}
+
+int hashmap_put(struct hashmap *map, void *key, void *value) {
+	struct hashmap_slot ent;
+	unsigned int cnt;
+
+	assert(map);
+
+	ent.hash = hashmap_hash(map, key);
+	ent.key = key;
+	ent.value = value;
+
+	hashmap_move(map, HASHMAP_MOVE_STEP);
+
+	if (map->cur.cnt >= hashmap_limit(&map->cur)) {
+		hashmap_grow(map);
+	}
+	if (map->cur.cnt >= map->cur.mask) {
+		map->failed++;
+		return -ENOMEM;
+	}
+
+	hashmap_table_insert(&map->cur, ent);
+
+	cnt = hashmap_count(map);
+	if (cnt > map->max_cnt) {
+		map->max_cnt = cnt;
+	}
+
+	return 0;
+}
+
+void *hashmap_get(struct hashmap *map, void *key) {
+	struct hashmap_slot *s;
+	uint32_t hash;
+
+	assert(map);
+
+	hash = hashmap_hash(map, key);
+
+	s = hashmap_table_find(map, &map->cur, key, hash);
+	if (!s) {
+		s = hashmap_table_find(map, &map->old, key, hash);
+	}
+
+	return s ? s->value : NULL;
+}
+
+void *hashmap_del(struct hashmap *map, void *key) {
+	struct hashmap_table *t;
+	struct hashmap_slot *s;
+	uint32_t hash;
+	void *value;
+
+	assert(map);
+
+	hash = hashmap_hash(map, key);
+
+	t = &map->cur;
+	s = hashmap_table_find(map, t, key, hash);
+	if (!s) {
+		t = &map->old;
+		s = hashmap_table_find(map, t, key, hash);
+		if (!s) {
+			return NULL;
+		}
+	}
+
+	value = s->value;
+	hashmap_table_remove(t, s);
+
+	hashmap_move(map, HASHMAP_MOVE_STEP);
+
+	return value;
+}
+
+/* Old table goes first, then the current one */
+static void *hashmap_scan(struct hashmap *map, struct hashmap_table *t,
+		unsigned int idx) {
+	while (1) {
+		if (t->slots) {
+			for (; idx <= t->mask; idx++) {
+				if (t->slots[idx].hash) {
+					return &t->slots[idx].key;
+				}
+			}
+		}
+		if (t == &map->cur) {
+			return NULL;
+		}
+		t = &map->cur;
+		idx = 0;
+	}
+}
+
+void *hashmap_get_key_first(struct hashmap *map) {
+	assert(map);
+
+	return hashmap_scan(map, &map->old, 0);
+}
+
+void *hashmap_get_key_next(struct hashmap *map, void *prev_key) {
+	struct hashmap_slot *s;
+	struct hashmap_table *t;
+
+	assert(map && prev_key);
+
+	s = member_cast_out(prev_key, struct hashmap_slot, key);
+
+	t = &map->cur;
+	if (map->old.slots && (s >= map->old.slots)
+			&& (s <= &map->old.slots[map->old.mask])) {
+		t = &map->old;
+	}
+
+	return hashmap_scan(map, t, (s - t->slots) + 1);
+}
+
+void hashmap_account_stat(const void *obj, struct mem_account_stat *st) {
+	const struct hashmap *map = obj;
+
+	st->obj_size = sizeof(struct hashmap_slot);
+	st->total = map->cur.mask + 1;
+	st->reserved = st->total * st->obj_size;
+	st->used = map->cur.cnt + map->old.cnt;
+	st->max_used = map->max_cnt;
+	st->failed = map->failed;
+}
@@ -31,6 +31,7 @@ struct hashtable *hashtable_init(struct hashtable *ht, unsigned int table_size,
 	ht->table_size = table_size;
 	ht->cmp = cmp;
 	dlist_init(&ht->all);
+	ht->cnt = ht->max_cnt = 0;
 
 	return ht;
 }
@@ -62,6 +63,10 @@ int hashtable_put(struct hashtable *ht, struct hashtable_item *ht_item) {
 	ht->table[idx].cnt ++;
 	dlist_add_next(&ht_item->lnk, &ht->table[idx].list);
 
+	if (++ht->cnt > ht->max_cnt) {
+		ht->max_cnt = ht->cnt;
+	}
+
 	dlist_add_prev(dlist_head_init(&ht_item->general_lnk), &ht->all);
 
 	return ENOERR;
@@ -99,6 +104,7 @@ struct hashtable_item *hashtable_del(struct hashtable *ht, void *key) {
 			dlist_del_init(&htel->general_lnk);
 
 			ht->table[idx].cnt--;
+			ht->cnt--;
 
 			return htel;
 		}
@@ -154,3 +160,14 @@ void *hashtable_get_key_next(struct hashtable *ht, void *prev_key) {
 	htel = dlist_first_entry(&htel->general_lnk, struct hashtable_item, general_lnk);
 	return &htel->key;
 }
+
+void hashtable_account_stat(const void *table, struct mem_account_stat *st) {
+	const struct hashtable *ht = table;
+
+	/* Items are allocated by users, only buckets are reserved here */
+	st->reserved = HASHTABLE_BUFFER_SIZE(ht->table_size);
+	st->obj_size = 0;
+	st->total = ht->table_size;
+	st->used = ht->cnt;
+	st->max_used = ht->max_cnt;
+}
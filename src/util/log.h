@@ -10,9 +10,12 @@
 #ifndef UTIL_LOG_H_
 #define UTIL_LOG_H_
 
+#include <compiler.h>
 #include <framework/mod/self.h>
 #include <util/logging.h>
 
+#include <module/embox/compat/libc/stdio/print.h>
+
 /**
  * Logger structure binding a specific module and logging params.
  */
@@ -26,18 +29,33 @@ struct logger {
  */
 extern struct logger mod_logger __attribute__ ((weak));
 
+static inline void __log_format_check(const char *fmt, ...)
+		_PRINTF_FORMAT(1, 2);
+static inline void __log_format_check(const char *fmt, ...) { }
+
 /**
  * Logs a formatted message in a way specified by the module logger. A
  * resulting message has a following format:
  * "level: function: message"
  *
+ * Arguments are checked against the format at compile time. The format is
+ * parsed on the first use only.
+ *
  * @param level Message logging level
  * @param fmt   printf-like format of the message
  */
 #define log_logp(level, fmt, ...) \
 	if (&mod_logger) \
-		logging_raw(&mod_logger.logging, level, "%s: %s: " fmt "\n", \
-					log_levels[level-1], __func__, ## __VA_ARGS__)
+		logging_fmt(&mod_logger.logging, level, \
+			({ \
+				static struct print_fmt __log_fmt = \
+					PRINT_FMT_INIT("%s: %s: " fmt "\n"); \
+				if (0) \
+					__log_format_check("%s: %s: " fmt "\n", \
+						"", "", ## __VA_ARGS__); \
+				&__log_fmt; \
+			}), \
+			log_levels[level-1], __func__, ## __VA_ARGS__)
 
 /**
  * Logs a raw message in a way specified by the module logger.
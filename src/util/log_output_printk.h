@@ -0,0 +1,19 @@
+/**
+ * @file
+ * @brief Synchronous logging straight to the diag console
+ *
+ * @date 17.10.2026
+ */
+
+#ifndef UTIL_LOG_OUTPUT_PRINTK_H_
+#define UTIL_LOG_OUTPUT_PRINTK_H_
+
+#include <kernel/printk.h>
+
+#define __logging_vprint(level, fmt, args) \
+	vprintk(fmt, args)
+
+#define __logging_vprint_fmt(level, pfmt, args) \
+	vprintk_fmt(pfmt, args)
+
+#endif /* UTIL_LOG_OUTPUT_PRINTK_H_ */
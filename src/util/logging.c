@@ -9,9 +9,10 @@
 #include <assert.h>
 #include <stdarg.h>
 
-#include <kernel/printk.h>
 #include <util/logging.h>
 
+#include <module/embox/util/log_output.h>
+
 char *log_levels[LOG_DEBUG] = {
 	"error",
 	"warning",
@@ -26,7 +27,20 @@ void logging_raw(struct logging *logging, int level, const char* fmt, ...) {
 		va_list args;
 
 		va_start(args, fmt);
-		vprintk(fmt, args);
+		__logging_vprint(level, fmt, args);
+		va_end(args);
+	}
+}
+
+void logging_fmt(struct logging *logging, int level,
+		struct print_fmt *fmt, ...) {
+	assert(logging);
+
+	if (level <= logging->level) {
+		va_list args;
+
+		va_start(args, fmt);
+		__logging_vprint_fmt(level, fmt, args);
 		va_end(args);
 	}
 }
@@ -9,6 +9,8 @@
 #ifndef UTIL_LOGGING_H_
 #define UTIL_LOGGING_H_
 
+#include <compiler.h>
+
 /**
  * Logging level, decreasing by fatality.
  */
@@ -40,6 +42,14 @@ extern char *log_levels[];
  * @param fmt     printf-like format of the message
  */
 extern void logging_raw(struct logging *logging, int level,
-	const char* fmt, ...);
+	const char* fmt, ...) _PRINTF_FORMAT(3, 4);
+
+struct print_fmt;
+
+/**
+ * Same as logging_raw() for a format parsed once, see PRINT_FMT_INIT().
+ */
+extern void logging_fmt(struct logging *logging, int level,
+	struct print_fmt *fmt, ...);
 
 #endif /* UTIL_LOGGING_H_ */
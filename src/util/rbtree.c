@@ -0,0 +1,305 @@
+/**
+ * @file
+ * @brief Implementation of methods in util/rbtree.h
+ *
+ * @details Augmented data is brought up to date along the whole changed
+ *   path before rebalancing, after that rotations only have to recompute
+ *   the two nodes they move: the set of nodes below the upper one is kept.
+ *
+ * @date 17.10.2026
+ */
+
+#include <assert.h>
+
+#include <util/rbtree.h>
+
+static inline int rb_is_black(struct rb_node *node) {
+	return node == NULL || node->color == RB_BLACK;
+}
+
+static void rb_propagate(struct rb_tree *tree, struct rb_node *node) {
+	if (!tree->augment) {
+		return;
+	}
+
+	for (; node != NULL; node = node->parent) {
+		tree->augment(node);
+	}
+}
+
+static void rb_replace_child(struct rb_tree *tree, struct rb_node *parent,
+		struct rb_node *old, struct rb_node *new) {
+	if (parent == NULL) {
+		tree->root = new;
+	} else if (parent->left == old) {
+		parent->left = new;
+	} else {
+		parent->right = new;
+	}
+}
+
+static void rb_rotate_left(struct rb_tree *tree, struct rb_node *x) {
+	struct rb_node *y = x->right;
+
+	x->right = y->left;
+	if (y->left) {
+		y->left->parent = x;
+	}
+	y->parent = x->parent;
+	rb_replace_child(tree, x->parent, x, y);
+	y->left = x;
+	x->parent = y;
+
+	if (tree->augment) {
+		tree->augment(x);
+		tree->augment(y);
+	}
+}
+
+static void rb_rotate_right(struct rb_tree *tree, struct rb_node *x) {
+	struct rb_node *y = x->left;
+
+	x->left = y->right;
+	if (y->right) {
+		y->right->parent = x;
+	}
+	y->parent = x->parent;
+	rb_replace_child(tree, x->parent, x, y);
+	y->right = x;
+	x->parent = y;
+
+	if (tree->augment) {
+		tree->augment(x);
+		tree->augment(y);
+	}
+}
+
+void rb_insert_fixup(struct rb_tree *tree, struct rb_node *node) {
+	struct rb_node *parent, *gparent, *uncle;
+
+	node->color = RB_RED;
+	rb_propagate(tree, node);
+
+	while ((parent = node->parent) && parent->color == RB_RED) {
+		/* Red parent is never the root */
+		gparent = parent->parent;
+
+		if (parent == gparent->left) {
+			uncle = gparent->right;
+			if (!rb_is_black(uncle)) {
+				parent->color = uncle->color = RB_BLACK;
+				gparent->color = RB_RED;
+				node = gparent;
+				continue;
+			}
+			if (node == parent->right) {
+				rb_rotate_left(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = RB_BLACK;
+			gparent->color = RB_RED;
+			rb_rotate_right(tree, gparent);
+		} else {
+			uncle = gparent->left;
+			if (!rb_is_black(uncle)) {
+				parent->color = uncle->color = RB_BLACK;
+				gparent->color = RB_RED;
+				node = gparent;
+				continue;
+			}
+			if (node == parent->left) {
+				rb_rotate_right(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = RB_BLACK;
+			gparent->color = RB_RED;
+			rb_rotate_left(tree, gparent);
+		}
+	}
+
+	tree->root->color = RB_BLACK;
+}
+
+void rb_insert(struct rb_tree *tree, struct rb_node *node, rb_cmp_ft cmp) {
+	struct rb_node **link = &tree->root;
+	struct rb_node *parent = NULL;
+
+	while (*link) {
+		parent = *link;
+		link = cmp(node, parent) < 0 ? &parent->left : &parent->right;
+	}
+
+	rb_link(node, parent, link);
+	rb_insert_fixup(tree, node);
+}
+
+static void rb_transplant(struct rb_tree *tree, struct rb_node *old,
+		struct rb_node *new) {
+	rb_replace_child(tree, old->parent, old, new);
+	if (new) {
+		new->parent = old->parent;
+	}
+}
+
+/* @a node took a black node's place and lacks one black, it may be NULL */
+static void rb_erase_fixup(struct rb_tree *tree, struct rb_node *node,
+		struct rb_node *parent) {
+	struct rb_node *sibling;
+
+	while (node != tree->root && rb_is_black(node)) {
+		/* The sibling exists: its subtree has at least one black node */
+		if (node == parent->left) {
+			sibling = parent->right;
+			if (sibling->color == RB_RED) {
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_left(tree, parent);
+				sibling = parent->right;
+			}
+			if (rb_is_black(sibling->left) && rb_is_black(sibling->right)) {
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (rb_is_black(sibling->right)) {
+				sibling->left->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_right(tree, sibling);
+				sibling = parent->right;
+			}
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->right->color = RB_BLACK;
+			rb_rotate_left(tree, parent);
+		} else {
+			sibling = parent->left;
+			if (sibling->color == RB_RED) {
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_right(tree, parent);
+				sibling = parent->left;
+			}
+			if (rb_is_black(sibling->left) && rb_is_black(sibling->right)) {
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (rb_is_black(sibling->left)) {
+				sibling->right->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_left(tree, sibling);
+				sibling = parent->left;
+			}
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->left->color = RB_BLACK;
+			rb_rotate_right(tree, parent);
+		}
+		node = tree->root;
+	}
+
+	if (node) {
+		node->color = RB_BLACK;
+	}
+}
+
+void rb_erase(struct rb_tree *tree, struct rb_node *node) {
+	struct rb_node *child, *parent, *next;
+	int color;
+
+	assert(tree && node);
+
+	if (!node->left || !node->right) {
+		child = node->left ? node->left : node->right;
+		parent = node->parent;
+		color = node->color;
+		rb_transplant(tree, node, child);
+	} else {
+		/* Replace the node with its successor, which has no left child */
+		next = node->right;
+		while (next->left) {
+			next = next->left;
+		}
+		child = next->right;
+		color = next->color;
+
+		if (next->parent == node) {
+			parent = next;
+		} else {
+			parent = next->parent;
+			rb_transplant(tree, next, child);
+			next->right = node->right;
+			next->right->parent = next;
+		}
+		rb_transplant(tree, node, next);
+		next->left = node->left;
+		next->left->parent = next;
+		next->color = node->color;
+	}
+
+	rb_propagate(tree, parent);
+
+	if (color == RB_BLACK) {
+		rb_erase_fixup(tree, child, parent);
+	}
+}
+
+struct rb_node *rb_first(struct rb_tree *tree) {
+	struct rb_node *node = tree->root;
+
+	if (node) {
+		while (node->left) {
+			node = node->left;
+		}
+	}
+	return node;
+}
+
+struct rb_node *rb_last(struct rb_tree *tree) {
+	struct rb_node *node = tree->root;
+
+	if (node) {
+		while (node->right) {
+			node = node->right;
+		}
+	}
+	return node;
+}
+
+struct rb_node *rb_next(struct rb_node *node) {
+	struct rb_node *parent;
+
+	if (node->right) {
+		node = node->right;
+		while (node->left) {
+			node = node->left;
+		}
+		return node;
+	}
+
+	while ((parent = node->parent) && node == parent->right) {
+		node = parent;
+	}
+	return parent;
+}
+
+struct rb_node *rb_prev(struct rb_node *node) {
+	struct rb_node *parent;
+
+	if (node->left) {
+		node = node->left;
+		while (node->right) {
+			node = node->right;
+		}
+		return node;
+	}
+
+	while ((parent = node->parent) && node == parent->left) {
+		node = parent;
+	}
+	return parent;
+}
@@ -28,14 +28,18 @@ void QEmboxCursor::emboxCursorReset(struct fb_info *fb) {
 void QEmboxCursor::emboxCursorRedraw(struct fb_info *fb, int x, int y) {
 	if (inited) {
 		flushDirtyRect(fb, __calculateCursorLocation(fb, mouseX, mouseY));
+		fb_damage(fb, mouseX, mouseY, cursor_W, cursor_H);
 	} else {
 		inited = 1;
 	}
 	storeDirtyRect(fb,  __calculateCursorLocation(fb, x, y));
 	drawCursor(fb, __calculateCursorLocation(fb, x, y));
+	fb_damage(fb, x, y, cursor_W, cursor_H);
 
 	mouseX = x;
 	mouseY = y;
+
+	fb_flush(fb);
 }
 
 static unsigned char *__calculateCursorLocation(struct fb_info *fb, int x, int y) {
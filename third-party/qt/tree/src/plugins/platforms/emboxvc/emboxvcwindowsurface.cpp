@@ -363,10 +363,7 @@ QPaintDevice *QEmboxVCWindowSurface::paintDevice()
 
 void QEmboxVCWindowSurface::flush(QWidget *widget, const QRegion &region, const QPoint &offset)
 {
-    Q_UNUSED(region);
-    Q_UNUSED(offset);
-
-    int i, shift;
+    int i;
 
     int x, y;
     if (widget) {
@@ -380,17 +377,35 @@ void QEmboxVCWindowSurface::flush(QWidget *widget, const QRegion &region, const
     	return;
     }
 
-    int bpp = vc->emboxVC.fb->var.bits_per_pixel / 8;
-    char *begin = vc->emboxVC.fb->screen_base + (y * vc->emboxVC.fb->var.xres + x) * bpp;
+    struct fb_info *fb = vc->emboxVC.fb;
+    int bpp = fb->var.bits_per_pixel / 8;
+    char *begin = fb->screen_base + (y * fb->var.xres + x) * bpp;
+
+    /* Draw only changed parts of the image, whole one if not known */
+    QVector<QRect> rects;
+    if (region.isEmpty()) {
+    	rects.append(mImage.rect());
+    } else {
+    	rects = region.translated(offset).rects();
+    }
 
-    /* Draw image */
-    for (i = 0, shift = 0; i < mImage.height(); i++ , shift += vc->emboxVC.fb->var.xres * bpp) {
-    	memcpy(begin + shift, (const void *)mImage.constScanLine(i), mImage.bytesPerLine());
+    foreach (QRect rect, rects) {
+    	rect &= mImage.rect();
+    	if (rect.isEmpty()) {
+    		continue;
+    	}
+
+    	for (i = rect.top(); i <= rect.bottom(); i++) {
+    		memcpy(begin + (i * fb->var.xres + rect.left()) * bpp,
+    				(const void *)(mImage.constScanLine(i) + rect.left() * bpp),
+    				rect.width() * bpp);
+    	}
+    	fb_damage(fb, x + rect.left(), y + rect.top(), rect.width(), rect.height());
     }
 
-    /* Reset cursor on new image and redraw */
-    vc->cursor->emboxCursorReset(vc->emboxVC.fb);
-    vc->cursor->emboxCursorRedraw(vc->emboxVC.fb, vc->mouseX, vc->mouseY);
+    /* Reset cursor on new image and redraw, it flushes the damage */
+    vc->cursor->emboxCursorReset(fb);
+    vc->cursor->emboxCursorRedraw(fb, vc->mouseX, vc->mouseY);
 }
 
 void QEmboxVCWindowSurface::resize(const QSize &size)